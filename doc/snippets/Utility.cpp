@@ -33,6 +33,9 @@
 #include "Corrade/Utility/Arguments.h"
 #include "Corrade/Utility/Assert.h"
 #include "Corrade/Utility/Configuration.h"
+#include "Corrade/Utility/DebugCategory.h"
+#include "Corrade/Utility/DebugSink.h"
+#include "Corrade/Utility/DebugTrace.h"
 #include "Corrade/Utility/Directory.h"
 #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)) || defined(CORRADE_TARGET_EMSCRIPTEN)
 #include "Corrade/Utility/FileWatcher.h"
@@ -373,6 +376,46 @@ Utility::Debug{} << "Value:" << Utility::Debug::nospace << "\n"
 /* [Debug-newline] */
 }
 
+{
+/* [DebugSink] */
+std::ofstream log{"log.txt"};
+Utility::DebugSink sink{log};
+Utility::Debug redirectOutput{sink.output()};
+
+// Lines from all threads are written to log.txt as a whole
+Utility::Debug{} << "Value:" << 16;
+/* [DebugSink] */
+}
+
+{
+/* [DebugTrace] */
+std::ofstream log{"trace.bin", std::ofstream::binary};
+Utility::DebugTrace trace{log};
+Utility::Debug redirectOutput{trace.output()};
+
+// The values are recorded without formatting, decode with corrade-trace
+Utility::Debug{} << "Value:" << 16 << 3.5f;
+/* [DebugTrace] */
+}
+
+{
+float time{}, elapsed{};
+/* [DebugCategory] */
+Utility::DebugCategory physics{"physics"};
+
+// Not evaluated unless enabled with setLevel()
+CORRADE_LOG(physics, Verbose) << "Stepping the simulation by" << elapsed;
+CORRADE_LOG(physics, Warning) << "Simulation is lagging behind by" << time;
+/* [DebugCategory] */
+
+for(std::size_t i = 0; i != 1000; ++i) {
+/* [DebugCategory-sampling] */
+// Prints only every 100th collision
+CORRADE_LOG_EVERY_N(physics, Debug, 100) << "Collision of object" << i;
+/* [DebugCategory-sampling] */
+}
+}
+
 {
 struct {
     bool broken() { return true; }
@@ -434,6 +477,15 @@ std::string s = Utility::formatString("path {{ fill: #{:6x}; stroke: #{:6x}; }}"
 /* [formatString-type-precision] */
 }
 
+{
+std::size_t offset{};
+/* [formatString-compiled] */
+std::string s = Utility::formatString(CORRADE_FORMAT("{} at {:x}"),
+    "corrupted header", offset);
+/* [formatString-compiled] */
+static_cast<void>(s);
+}
+
 {
 void addShaderSource(Containers::ArrayView<char>);
 /* [formatInto-buffer] */
@@ -475,6 +527,49 @@ if(watcher.hasChanged()) {
 }
 /* [FileWatcher] */
 }
+
+{
+/* [FileWatcherSet] */
+Utility::FileWatcherSet watchers;
+for(const char* file: {"shaders/flat.vert", "shaders/flat.frag"})
+    watchers.add(file);
+
+// in the main application loop
+for(std::size_t id: watchers.changed()) {
+    Utility::Debug{} << "recompiling" << watchers.filename(id);
+    // ...
+}
+/* [FileWatcherSet] */
+}
+
+{
+Utility::FileWatcherSet watchers;
+bool exitRequested = false;
+/* [FileWatcherSet-wait] */
+watchers.setDebounceTime(50);
+while(!exitRequested) for(std::size_t id: watchers.waitAny()) {
+    Utility::Debug{} << "reimporting" << watchers.filename(id);
+    // ...
+}
+/* [FileWatcherSet-wait] */
+}
+
+{
+/* [DirectoryWatcher] */
+Utility::DirectoryWatcher watcher{"assets",
+    Utility::DirectoryWatcher::Flag::CompareContents};
+
+// in the main application loop
+for(const std::pair<std::string, Utility::DirectoryWatcher::Change>& change:
+    watcher.changes())
+{
+    if(change.second == Utility::DirectoryWatcher::Change::Deleted)
+        Utility::Debug{} << "unloading" << change.first;
+    else
+        Utility::Debug{} << "reimporting" << change.first;
+}
+/* [DirectoryWatcher] */
+}
 #endif
 
 {
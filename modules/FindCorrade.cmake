@@ -16,10 +16,12 @@
 # components, which are:
 #
 #  Containers                   - Containers library
+#  DebugSink                    - DebugSink library
 #  PluginManager                - PluginManager library
 #  TestSuite                    - TestSuite library
 #  Utility                      - Utility library
 #  rc                           - corrade-rc executable
+#  trace                        - corrade-trace executable
 #
 # Example usage with specifying additional components is::
 #
@@ -319,6 +321,8 @@ foreach(_component ${Corrade_FIND_COMPONENTS})
 
     if(_component STREQUAL Containers)
         set(_CORRADE_${_COMPONENT}_DEPENDENCIES Utility)
+    elseif(_component STREQUAL DebugSink)
+        set(_CORRADE_${_COMPONENT}_DEPENDENCIES Utility)
     elseif(_component STREQUAL Interconnect)
         set(_CORRADE_${_COMPONENT}_DEPENDENCIES Utility)
     elseif(_component STREQUAL PluginManager)
@@ -348,9 +352,9 @@ if(Corrade_FIND_COMPONENTS)
 endif()
 
 # Component distinction
-set(_CORRADE_LIBRARY_COMPONENTS "^(Containers|Interconnect|PluginManager|TestSuite|Utility)$")
+set(_CORRADE_LIBRARY_COMPONENTS "^(Containers|DebugSink|Interconnect|PluginManager|TestSuite|Utility)$")
 set(_CORRADE_HEADER_ONLY_COMPONENTS "^(Containers)$")
-set(_CORRADE_EXECUTABLE_COMPONENTS "^(rc)$")
+set(_CORRADE_EXECUTABLE_COMPONENTS "^(rc|trace)$")
 
 # Find all components
 foreach(_component ${Corrade_FIND_COMPONENTS})
@@ -454,10 +458,22 @@ foreach(_component ${Corrade_FIND_COMPONENTS})
                 set_property(TARGET Corrade::${_component} APPEND PROPERTY
                     INTERFACE_LINK_LIBRARIES "log")
             endif()
+
+        # DebugSink library runs a background thread
+        elseif(_component STREQUAL DebugSink)
+            find_package(Threads REQUIRED)
+            set_property(TARGET Corrade::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES Threads::Threads)
         endif()
 
         # Find library includes
-        if(_component MATCHES ${_CORRADE_LIBRARY_COMPONENTS})
+        # DebugSink has its header in Utility
+        if(_component STREQUAL DebugSink)
+            find_path(_CORRADE_${_COMPONENT}_INCLUDE_DIR
+                NAMES DebugSink.h
+                HINTS ${CORRADE_INCLUDE_DIR}/Corrade/Utility)
+            mark_as_advanced(_CORRADE_${_COMPONENT}_INCLUDE_DIR)
+        elseif(_component MATCHES ${_CORRADE_LIBRARY_COMPONENTS})
             find_path(_CORRADE_${_COMPONENT}_INCLUDE_DIR
                 NAMES ${_component}.h
                 HINTS ${CORRADE_INCLUDE_DIR}/Corrade/${_component})
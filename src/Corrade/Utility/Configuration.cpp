@@ -26,18 +26,123 @@
 #include "Configuration.h"
 
 #include <algorithm>
-#include <sstream>
+#include <cerrno>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
 #include <utility>
 #include <vector>
 
+/* Unix, Emscripten file access */
+#if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Windows file access */
+#ifdef CORRADE_TARGET_WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+#endif
+
 #include "Corrade/Containers/Array.h"
 #include "Corrade/Utility/Assert.h"
+#include "Corrade/Utility/ConfigurationParser.h"
 #include "Corrade/Utility/Debug.h"
 #include "Corrade/Utility/Directory.h"
-#include "Corrade/Utility/String.h"
+#include "Corrade/Utility/XXHash3.h"
+#ifdef CORRADE_TARGET_WINDOWS
+#include "Corrade/Utility/Unicode.h"
+#endif
 
 namespace Corrade { namespace Utility {
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+struct Configuration::MappedData {
+    Containers::Array<const char, Directory::MapDeleter> data;
+};
+#endif
+
+namespace {
+    /* Binary cache file header. All numbers are in native endianness, a
+       cache created on a platform with a different one is detected through
+       the endian marker. */
+    struct CacheHeader {
+        char magic[4];
+        std::uint16_t endian;
+        std::uint8_t version;
+        std::uint8_t flags;
+        std::uint64_t sourceSize;
+        char sourceHash[8];
+    };
+
+    static_assert(sizeof(CacheHeader) == 24, "improper size of CacheHeader");
+
+    constexpr const char CacheMagic[4]{'C', 'C', 'F', 'G'};
+    constexpr std::uint16_t CacheEndian = 0x0102;
+    constexpr std::uint8_t CacheVersion = 1;
+
+    /* The groups are loaded recursively. The header hash covers only the
+       source file, so a corrupted cache could otherwise nest the groups
+       deep enough to overflow the stack. Deeper hierarchies are loaded by
+       parsing the file instead. */
+    constexpr std::size_t CacheMaxDepth = 256;
+
+    enum: std::uint8_t {
+        CacheSkipComments = 1 << 0,
+        CacheHasBom = 1 << 1,
+        CacheWindowsEol = 1 << 2
+    };
+
+    /* After the header, each group is stored as a 32-bit value count,
+       followed by the keys and values, a 32-bit subgroup count and the
+       subgroup names followed by their contents. Strings are stored as a
+       32-bit size followed by the (not null-terminated) data. */
+    struct CacheReader {
+        bool read(std::uint32_t& value) {
+            if(std::size_t(end - it) < sizeof(std::uint32_t)) return false;
+            std::memcpy(&value, it, sizeof(std::uint32_t));
+            it += sizeof(std::uint32_t);
+            return true;
+        }
+
+        bool read(Containers::ArrayView<const char>& string) {
+            std::uint32_t size;
+            if(!read(size) || std::size_t(end - it) < size) return false;
+            string = {it, size};
+            it += size;
+            return true;
+        }
+
+        const char* it;
+        const char* end;
+    };
+
+    void cacheWrite(std::string& out, const std::uint32_t value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(std::uint32_t));
+    }
+
+    void cacheWrite(std::string& out, const char* const data, const std::size_t size) {
+        cacheWrite(out, std::uint32_t(size));
+        out.append(data, size);
+    }
+}
+
+/* Loads and saves the binary cache */
+class Configuration::Cache {
+    public:
+        static bool load(Configuration& configuration, const std::string& filename, Containers::ArrayView<const char> source);
+        static void save(const Configuration& configuration, const std::string& filename, Containers::ArrayView<const char> source);
+
+    private:
+        static bool load(Configuration& configuration, CacheReader& reader, ConfigurationGroup* group, std::size_t depth);
+        static void save(std::string& out, const ConfigurationGroup* group);
+};
+
 Configuration::Configuration(const Flags flags): ConfigurationGroup(this), _flags(static_cast<InternalFlag>(std::uint32_t(flags))) {}
 
 Configuration::Configuration(const std::string& filename, const Flags flags): ConfigurationGroup(this), _filename(flags & Flag::ReadOnly ? std::string() : filename), _flags(static_cast<InternalFlag>(std::uint32_t(flags))|InternalFlag::IsValid) {
@@ -50,7 +155,39 @@ Configuration::Configuration(const std::string& filename, const Flags flags): Co
         return;
     }
 
-    if(parse(Directory::read(filename))) return;
+    /* In read-only mode the values are views into the file data, which has
+       to be kept around. Map the file if possible, silently falling back to
+       reading it if that fails (mapping an empty file fails, for example). */
+    Containers::ArrayView<const char> data;
+    Containers::Array<char> readData;
+    if(flags & Flag::ReadOnly) {
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        {
+            Error silence{nullptr};
+            _mappedData.emplace(Directory::mapRead(filename));
+        }
+        data = _mappedData->data;
+        if(!_mappedData->data)
+        #endif
+        {
+            _data = Directory::read(filename);
+            data = _data;
+        }
+    } else {
+        readData = Directory::read(filename);
+        data = readData;
+    }
+
+    /* Populate the tree from the binary cache if it's up-to-date, otherwise
+       parse the file and update the cache */
+    if(flags & Flag::Cache) {
+        const std::string cacheFilename = filename + ".cache";
+        if(Cache::load(*this, cacheFilename, data)) return;
+        if(parse(data)) {
+            Cache::save(*this, cacheFilename, data);
+            return;
+        }
+    } else if(parse(data)) return;
 
     /* Error, reset everything back */
     _filename = {};
@@ -66,10 +203,21 @@ Configuration::Configuration(std::istream& in, const Flags flags): Configuration
 
     /** @todo deprecate and remove completely */
     const std::string data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
-    if(parse({data.data(), data.size()})) _flags |= InternalFlag::IsValid;
+
+    /* In read-only mode the values are views into the data, keep a copy */
+    if(flags & Flag::ReadOnly) {
+        _data = Containers::Array<char>{Containers::NoInit, data.size()};
+        std::copy(data.begin(), data.end(), _data.begin());
+        if(parse(_data)) _flags |= InternalFlag::IsValid;
+    } else if(parse({data.data(), data.size()})) _flags |= InternalFlag::IsValid;
 }
 
-Configuration::Configuration(Configuration&& other): ConfigurationGroup{std::move(other)}, _filename{std::move(other._filename)}, _flags{other._flags} {
+Configuration::Configuration(Configuration&& other): ConfigurationGroup{std::move(other)}, _filename{std::move(other._filename)}, _flags{other._flags},
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    _mappedData{std::move(other._mappedData)},
+    #endif
+    _data{std::move(other._data)}
+{
     /* Redirect configuration pointer to this instance */
     setConfigurationPointer(this);
 }
@@ -80,6 +228,10 @@ Configuration& Configuration::operator=(Configuration&& other) {
     ConfigurationGroup::operator=(std::move(other));
     _filename = std::move(other._filename);
     _flags = other._flags;
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    _mappedData = std::move(other._mappedData);
+    #endif
+    _data = std::move(other._data);
 
     /* Redirect configuration pointer to this instance */
     setConfigurationPointer(this);
@@ -101,262 +253,420 @@ void Configuration::setFilename(std::string filename) {
 
 namespace {
     constexpr const char Bom[] = "\xEF\xBB\xBF";
+
+    constexpr bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\f' || c == '\v' || c == '\r' || c == '\n';
+    }
 }
 
-bool Configuration::parse(Containers::ArrayView<const char> in) {
-    try {
-        /* Oh, BOM, eww */
-        if(in.size() >= 3 && in[0] == Bom[0] && in[1] == Bom[1] && in[2] == Bom[2]) {
-            _flags |= InternalFlag::HasBom;
-            in = in.suffix(3);
+/* Builds the group tree from parser events */
+class Configuration::Parser: public ConfigurationParser {
+    public:
+        explicit Parser(Configuration& configuration, Containers::ArrayView<const char> data): _configuration(configuration), _data{data}, _groups(1, &configuration) {}
+
+    private:
+        void doGroupBegin(const Containers::ArrayView<const char> name) override {
+            ConfigurationGroup* const group = new ConfigurationGroup(&_configuration);
+            _groups.back()->_groups.push_back({std::string{name, name.size()}, group});
+            _groups.push_back(group);
         }
 
-        /* Parse file */
-        CORRADE_INTERNAL_ASSERT_OUTPUT(parse(in, this, {}).empty());
+        void doGroupEnd() override {
+            _groups.pop_back();
+        }
+
+        void doValue(const Containers::ArrayView<const char> key, const Containers::ArrayView<const char> value) override {
+            ConfigurationGroup::Value item;
+            item.key = text(key);
+            item.value = text(value);
+            _groups.back()->_values.push_back(std::move(item));
+        }
+
+        void doComment(const Containers::ArrayView<const char> line) override {
+            if(_configuration._flags & InternalFlag::SkipComments) return;
+
+            /* Empty lines are stored as values with empty key and value */
+            ConfigurationGroup::Value item;
+            item.value = text(line);
+            _groups.back()->_values.push_back(std::move(item));
+        }
+
+        void doError(const char* const message) override {
+            Error() << "Utility::Configuration::Configuration():" << message;
+        }
+
+        /* In a read-only configuration the text is referenced directly,
+           unless it's a temporary produced by the parser */
+        ConfigurationGroup::Text text(const Containers::ArrayView<const char> text) const {
+            if((_configuration._flags & InternalFlag::ReadOnly) && text.begin() >= _data.begin() && text.end() <= _data.end())
+                return ConfigurationGroup::Text{text.data(), text.size()};
+            return std::string{text.data(), text.size()};
+        }
+
+        Configuration& _configuration;
+        Containers::ArrayView<const char> _data;
+        std::vector<ConfigurationGroup*> _groups;
+};
 
-    } catch(const std::string& e) {
-        Error() << "Utility::Configuration::Configuration():" << e;
+bool Configuration::parse(const Containers::ArrayView<const char> in) {
+    Parser parser{*this, in};
+    if(!parser.parse(in)) {
         clear();
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        _mappedData = nullptr;
+        #endif
+        _data = nullptr;
         return false;
     }
 
+    if(parser.hasBom()) _flags |= InternalFlag::HasBom;
+    if(parser.hasWindowsEol()) _flags |= InternalFlag::WindowsEol;
+
+    /* The parser fills the groups directly, bypassing the index updates */
+    updateIndices();
     return true;
 }
 
-Containers::ArrayView<const char> Configuration::parse(Containers::ArrayView<const char> in, ConfigurationGroup* group, const std::string& fullPath) {
-    CORRADE_INTERNAL_ASSERT(fullPath.empty() || String::endsWith(fullPath, '/'));
-
-    std::string buffer;
-
-    /* Parse file */
-    bool multiLineValue = false;
-    while(!in.empty()) {
-        const Containers::ArrayView<const char> currentLine = in;
-
-        /* Extract the line and ignore the newline character after it, if any */
-        const char* end = std::find(in.begin(), in.end(), '\n');
-        buffer.assign(in.begin(), end);
-        in = in.suffix(end == in.end() ? end : end + 1);
-
-        /* Windows EOL */
-        if(!buffer.empty() && buffer.back() == '\r')
-            _flags |= InternalFlag::WindowsEol;
-
-        /* Multi-line value */
-        if(multiLineValue) {
-            /* End of multi-line value */
-            if(String::trim(buffer) == "\"\"\"") {
-                /* Remove trailing newline, if present */
-                if(!group->_values.back().value.empty()) {
-                    CORRADE_INTERNAL_ASSERT(group->_values.back().value.back() == '\n');
-                    group->_values.back().value.resize(group->_values.back().value.size()-1);
-                }
+bool Configuration::Cache::load(Configuration& configuration, const std::string& filename, const Containers::ArrayView<const char> source) {
+    if(!Directory::exists(filename)) return false;
 
-                multiLineValue = false;
-                continue;
-            }
+    /* Map the cache if possible, as with the source file in read-only mode */
+    Containers::ArrayView<const char> data;
+    #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+    Containers::Array<const char, Directory::MapDeleter> mappedData;
+    {
+        Error silence{nullptr};
+        mappedData = Directory::mapRead(filename);
+    }
+    data = mappedData;
+    #endif
+    Containers::Array<char> readData;
+    if(!data) {
+        readData = Directory::read(filename);
+        data = readData;
+    }
 
-            /* Remove Windows EOL, if present */
-            if(!buffer.empty() && buffer.back() == '\r') buffer.resize(buffer.size()-1);
+    /* Check that the cache is for this exact file and these flags */
+    CacheHeader header;
+    if(data.size() < sizeof(CacheHeader)) return false;
+    std::memcpy(&header, data, sizeof(CacheHeader));
+    const std::uint8_t skipComments = configuration._flags & InternalFlag::SkipComments ? CacheSkipComments : 0;
+    if(std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 ||
+       header.endian != CacheEndian ||
+       header.version != CacheVersion ||
+       (header.flags & CacheSkipComments) != skipComments ||
+       header.sourceSize != source.size() ||
+       std::memcmp(header.sourceHash, XXHash3<8>::digest(source).byteArray(), sizeof(header.sourceHash)) != 0)
+        return false;
 
-            /* Append it (with newline) to current value */
-            group->_values.back().value += buffer;
-            group->_values.back().value += '\n';
-            continue;
-        }
+    /* Populate the tree. The data might be corrupted, in that case parse
+       the source as if there was no cache. */
+    CacheReader reader{data + sizeof(CacheHeader), data.end()};
+    if(!load(configuration, reader, &configuration, 0) || reader.it != reader.end) {
+        configuration.clear();
+        return false;
+    }
 
-        /* Trim buffer */
-        String::trimInPlace(buffer);
-
-        /* Empty line */
-        if(buffer.empty()) {
-            if(_flags & InternalFlag::SkipComments) continue;
-
-            /* Save it only if this is not the last one */
-            if(in) group->_values.emplace_back();
-
-        /* Group header */
-        } else if(buffer[0] == '[') {
-
-            /* Check ending bracket */
-            if(buffer[buffer.size()-1] != ']')
-                throw std::string("missing closing bracket for a group header");
-
-            const std::string nextGroup = String::trim(buffer.substr(1, buffer.size()-2));
-
-            if(nextGroup.empty())
-                throw std::string("empty group name");
-
-            /* This is a subgroup of this one, parse recursively */
-            if(String::beginsWith(nextGroup, fullPath)) {
-                ConfigurationGroup::Group g;
-
-                /* If the subgroup has a shorthand for multiple nesting, call
-                   parse() on this same line again but with nested group and
-                   larger fullPath */
-                const std::size_t groupEnd = nextGroup.find('/', fullPath.size());
-                if(groupEnd != std::string::npos) {
-                    if(groupEnd == fullPath.size())
-                        throw std::string("empty subgroup name");
-
-                    g.name = nextGroup.substr(fullPath.size(), groupEnd - fullPath.size());
-                    g.group = new ConfigurationGroup(_configuration);
-                    /* Add the group before attempting any other parsing, as it
-                       could throw an exception and the group would otherwise
-                       be leaked */
-                    group->_groups.push_back(std::move(g));
-                    in = parse(currentLine, g.group, nextGroup.substr(0, groupEnd + 1));
-
-                /* Otherwise call parse() on the next line */
-                } else {
-                    g.name = nextGroup.substr(fullPath.size());
-                    g.group = new ConfigurationGroup(_configuration);
-                    /* Add the group before attempting any other parsing, as it
-                       could throw an exception and the group would otherwise
-                       be leaked */
-                    group->_groups.push_back(std::move(g));
-                    in = parse(in, g.group, nextGroup + '/');
-                }
+    configuration.updateIndices();
 
-            /* Otherwise it's a subgroup of some parent, return the control
-               back to caller (again with this line) */
-            } else return currentLine;
+    if(header.flags & CacheHasBom) configuration._flags |= InternalFlag::HasBom;
+    if(header.flags & CacheWindowsEol) configuration._flags |= InternalFlag::WindowsEol;
 
-        /* Comment */
-        } else if(buffer[0] == '#' || buffer[0] == ';') {
-            if(_flags & InternalFlag::SkipComments) continue;
+    /* In read-only mode the values are views into the cache, which replaces
+       the source data */
+    if(configuration._flags & InternalFlag::ReadOnly) {
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        configuration._mappedData.emplace(std::move(mappedData));
+        #endif
+        configuration._data = std::move(readData);
+    }
 
-            ConfigurationGroup::Value item;
-            item.value = buffer;
-            group->_values.push_back(item);
+    return true;
+}
 
-        /* Key/value pair */
-        } else {
-            const std::size_t splitter = buffer.find_first_of('=');
-            if(splitter == std::string::npos)
-                throw std::string("missing equals for a value");
+bool Configuration::Cache::load(Configuration& configuration, CacheReader& reader, ConfigurationGroup* const group, const std::size_t depth) {
+    if(depth > CacheMaxDepth) return false;
 
-            ConfigurationGroup::Value item;
-            item.key = String::trim(buffer.substr(0, splitter));
-            item.value = String::trim(buffer.substr(splitter+1));
+    auto text = [&](const Containers::ArrayView<const char> data) -> ConfigurationGroup::Text {
+        if(configuration._flags & InternalFlag::ReadOnly)
+            return ConfigurationGroup::Text{data.data(), data.size()};
+        return std::string{data.data(), data.size()};
+    };
 
-            /* Start of multi-line value */
-            if(item.value == "\"\"\"") {
-                item.value = "";
-                multiLineValue = true;
+    /* Each value takes at least eight bytes, don't reserve more than what
+       can fit into the rest of the data in case the count is garbage */
+    std::uint32_t valueCount;
+    if(!reader.read(valueCount) || valueCount > std::size_t(reader.end - reader.it)/8)
+        return false;
+    group->_values.reserve(valueCount);
+    for(std::uint32_t i = 0; i != valueCount; ++i) {
+        Containers::ArrayView<const char> key, value;
+        if(!reader.read(key) || !reader.read(value)) return false;
+        group->_values.push_back({text(key), text(value)});
+    }
 
-            /* Remove quotes, if present */
-            /** @todo Check `"` characters better */
-            } else if(!item.value.empty() && item.value[0] == '"') {
-                if(item.value.size() < 2 || item.value[item.value.size()-1] != '"')
-                    throw std::string("missing closing quote for a value");
+    std::uint32_t groupCount;
+    if(!reader.read(groupCount)) return false;
+    for(std::uint32_t i = 0; i != groupCount; ++i) {
+        Containers::ArrayView<const char> name;
+        if(!reader.read(name)) return false;
 
-                item.value = item.value.substr(1, item.value.size()-2);
-            }
+        /* Add the group before populating it so it gets deleted on error */
+        ConfigurationGroup* const subgroup = new ConfigurationGroup(&configuration);
+        group->_groups.push_back({std::string{name.data(), name.size()}, subgroup});
+        if(!load(configuration, reader, subgroup, depth + 1)) return false;
+    }
 
-            group->_values.push_back(item);
+    return true;
+}
+
+namespace {
+
+/* Replaces contents of a file with given data by writing them to a uniquely
+   named temporary file next to it and moving that over the original. A
+   failure in the middle of writing thus can't leave a truncated file behind,
+   concurrent writers don't clobber each other's temporary files and readers
+   see either the old or the new contents, never a mix of the two. */
+bool replaceFile(const std::string& filename, const Containers::ArrayView<const char> data) {
+    std::string path = filename;
+
+    #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    /* Moving a file over a symlink would replace the link itself, resolve it
+       to the file it points to. Done by hand instead of using realpath() so
+       dangling links get resolved as well. */
+    for(std::size_t i = 0; i != 32; ++i) {
+        char target[4096];
+        const ssize_t size = readlink(path.data(), target, sizeof(target));
+        if(size <= 0 || std::size_t(size) == sizeof(target)) break;
+        if(target[0] == '/') path.assign(target, size);
+        else path = path.substr(0, path.find_last_of('/') + 1) + std::string{target, std::size_t(size)};
+    }
+    #endif
+
+    /* Unique name for the temporary file, the process ID and a counter make
+       collisions unlikely and O_EXCL below makes sure an existing file is
+       never overwritten */
+    static unsigned int counter = 0;
+    std::string temporary;
+    int fd = -1;
+    for(std::size_t i = 0; i != 100 && fd == -1; ++i) {
+        #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+        temporary = path + ".tmp" + std::to_string(getpid()) + "." + std::to_string(counter++);
+        fd = open(temporary.data(), O_WRONLY|O_CREAT|O_EXCL, 0666);
+        #else
+        temporary = path + ".tmp" + std::to_string(_getpid()) + "." + std::to_string(counter++);
+        fd = _wopen(Unicode::widen(temporary).data(), _O_WRONLY|_O_CREAT|_O_EXCL|_O_BINARY, _S_IREAD|_S_IWRITE);
+        #endif
+        if(fd == -1 && errno != EEXIST) break;
+    }
+    if(fd == -1) return false;
+
+    /* Keep permissions and ownership of the original file. Unprivileged
+       users can't give the file away, so try at least keeping the group. */
+    #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    struct stat st;
+    if(stat(path.data(), &st) == 0) {
+        fchmod(fd, st.st_mode & 07777);
+        if(fchown(fd, st.st_uid, st.st_gid) != 0 && fchown(fd, -1, st.st_gid) != 0) {
+            /* Neither worked, the file is owned by the current user */
         }
     }
+    #endif
+
+    /* Write the data and make sure they're on the disk before the move,
+       otherwise a crash could leave an empty file in place of the original */
+    bool success = true;
+    for(std::size_t written = 0; success && written != data.size(); ) {
+        #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+        const ssize_t size = write(fd, data + written, data.size() - written);
+        #else
+        const int size = _write(fd, data + written, unsigned(std::min(data.size() - written, std::size_t(0x40000000))));
+        #endif
+        if(size <= 0) success = false;
+        else written += size;
+    }
+    #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    if(success && fsync(fd) != 0) success = false;
+    if(close(fd) != 0) success = false;
+    #else
+    if(success && _commit(fd) != 0) success = false;
+    if(_close(fd) != 0) success = false;
+    #endif
+
+    if(success && Directory::move(temporary, path)) return true;
+    Directory::rm(temporary);
+    return false;
+}
 
-    if(multiLineValue)
-        throw std::string{"missing closing quotes for a multi-line value"};
+}
 
-    /* This was the last group */
-    return in;
+void Configuration::Cache::save(const Configuration& configuration, const std::string& filename, const Containers::ArrayView<const char> source) {
+    CacheHeader header{};
+    std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.endian = CacheEndian;
+    header.version = CacheVersion;
+    if(configuration._flags & InternalFlag::SkipComments)
+        header.flags |= CacheSkipComments;
+    if(configuration._flags & InternalFlag::HasBom)
+        header.flags |= CacheHasBom;
+    if(configuration._flags & InternalFlag::WindowsEol)
+        header.flags |= CacheWindowsEol;
+    header.sourceSize = source.size();
+    std::memcpy(header.sourceHash, XXHash3<8>::digest(source).byteArray(), sizeof(header.sourceHash));
+
+    /* The cache is roughly the size of the source */
+    std::string out;
+    out.reserve(sizeof(CacheHeader) + source.size());
+    out.append(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+    save(out, &configuration);
+
+    /* Write through a temporary file so a concurrently loading process
+       never sees a partially written cache. Failures are not fatal, the
+       file just gets parsed again next time. */
+    Error silence{nullptr};
+    replaceFile(filename, {out.data(), out.size()});
+}
+
+void Configuration::Cache::save(std::string& out, const ConfigurationGroup* const group) {
+    cacheWrite(out, std::uint32_t(group->_values.size()));
+    for(const Value& value: group->_values) {
+        cacheWrite(out, value.key.data(), value.key.size());
+        cacheWrite(out, value.value.data(), value.value.size());
+    }
+
+    cacheWrite(out, std::uint32_t(group->_groups.size()));
+    for(const Group& g: group->_groups) {
+        cacheWrite(out, g.name.data(), g.name.size());
+        save(out, g.group);
+    }
 }
 
 bool Configuration::save(const std::string& filename) {
-    /* Save to a stringstream and then write it as a string to the file. Doing
-       it this way to avoid issues with Unicode filenames on Windows. */
-    /** @todo get rid of streams altogether */
-    std::ostringstream out;
-    save(out);
-    if(Directory::writeString(filename, out.str()))
-        return true;
+    /* Serialize everything into a single buffer and replace the file with
+       it. Besides being atomic, this also doesn't overwrite data that a
+       read-only configuration may still have mapped. */
+    const std::string data = saveToString();
+    if(replaceFile(filename, {data.data(), data.size()})) return true;
 
     Error() << "Utility::Configuration::save(): cannot open file" << filename;
     return false;
 }
 
 void Configuration::save(std::ostream& out) {
-    /* BOM, if user explicitly wants that crap */
-    if((_flags & InternalFlag::PreserveBom) && (_flags & InternalFlag::HasBom))
-        out.write(Bom, 3);
+    const std::string data = saveToString();
+    out.write(data.data(), data.size());
+}
 
+bool Configuration::save() {
+    if(_filename.empty()) return false;
+    return save(_filename);
+}
+
+std::string Configuration::saveToString() const {
     /* EOL character */
-    std::string eol;
-    if(_flags & (InternalFlag::ForceWindowsEol|InternalFlag::WindowsEol) && !(_flags & InternalFlag::ForceUnixEol)) eol = "\r\n";
-    else eol = "\n";
+    const char* const eol = _flags & (InternalFlag::ForceWindowsEol|InternalFlag::WindowsEol) && !(_flags & InternalFlag::ForceUnixEol) ? "\r\n" : "\n";
+    const std::size_t eolSize = std::strlen(eol);
+
+    /* Reserve the whole output upfront so the string doesn't need to be
+       reallocated while filling it */
+    std::string out;
+    out.reserve(3 + saveSize(this, eolSize, 0));
+
+    /* BOM, if user explicitly wants that crap */
+    if((_flags & InternalFlag::PreserveBom) && (_flags & InternalFlag::HasBom))
+        out.append(Bom, 3);
 
-    /** @todo Checking file.good() after every operation */
     /** @todo Backup file */
 
     /* Recursively save all groups */
-    save(out, eol, this, {});
+    std::string path;
+    save(out, eol, this, path);
+    return out;
 }
 
-bool Configuration::save() {
-    if(_filename.empty()) return false;
-    return save(_filename);
-}
+std::size_t Configuration::saveSize(const ConfigurationGroup* const group, const std::size_t eolSize, const std::size_t pathSize) const {
+    std::size_t size = 0;
 
-namespace {
-    constexpr bool isWhitespace(char c) {
-        return c == ' ' || c == '\t' || c == '\f' || c == '\v' || c == '\r' || c == '\n';
+    /* Key, value, the `=` and possibly also quotes and newlines */
+    for(const Value& value: group->_values) {
+        size += value.key.size() + value.value.size() + 1 + eolSize;
+        if(!value.key.empty()) size += 2;
+    }
+
+    for(const Group& g: group->_groups) {
+        const std::size_t nameSize = pathSize + (pathSize ? 1 : 0) + g.name.size();
+        size += nameSize + 2 + eolSize + saveSize(g.group, eolSize, nameSize);
     }
+
+    return size;
 }
 
-void Configuration::save(std::ostream& out, const std::string& eol, ConfigurationGroup* group, const std::string& fullPath) const {
+void Configuration::save(std::string& out, const char* const eol, const ConfigurationGroup* const group, std::string& path) const {
     CORRADE_INTERNAL_ASSERT(group->configuration() == this);
-    std::string buffer;
 
     /* Foreach all items in the group */
     for(const Value& value: group->_values) {
+        const char* const valueBegin = value.value.data();
+        const char* const valueEnd = valueBegin + value.value.size();
+
         /* Key/value pair */
         if(!value.key.empty()) {
+            out.append(value.key.data(), value.key.size());
+
             /* Multi-line value */
-            if(value.value.find_first_of('\n') != std::string::npos) {
+            if(std::find(valueBegin, valueEnd, '\n') != valueEnd) {
+                out += "=\"\"\"";
+                out += eol;
+
                 /* Replace \n with `eol` */
-                /** @todo fixme: ugly and slow */
-                std::string valueString = value.value;
-                std::size_t pos = 0;
-                while((pos = valueString.find_first_of('\n', pos)) != std::string::npos) {
-                    valueString.replace(pos, 1, eol);
-                    pos += eol.size();
+                for(const char* c = valueBegin; c != valueEnd; ++c) {
+                    if(*c == '\n') out += eol;
+                    else out += *c;
                 }
 
-                buffer = value.key + "=\"\"\"" + eol + valueString + eol + "\"\"\"" + eol;
+                out += eol;
+                out += "\"\"\"";
 
             /* Value with leading/trailing spaces */
-            } else if(!value.value.empty() && (isWhitespace(value.value.front()) || isWhitespace(value.value.back()))) {
-                buffer = value.key + "=\"" + value.value + '"' + eol;
+            } else if(valueBegin != valueEnd && (isWhitespace(*valueBegin) || isWhitespace(*(valueEnd - 1)))) {
+                out += "=\"";
+                out.append(valueBegin, valueEnd);
+                out += '"';
 
             /* Value without spaces */
-            } else buffer = value.key + '=' + value.value + eol;
+            } else {
+                out += '=';
+                out.append(valueBegin, valueEnd);
+            }
         }
 
         /* Comment / empty line */
-        else buffer = value.value + eol;
+        else out.append(valueBegin, valueEnd);
 
-        out.write(buffer.data(), buffer.size());
+        out += eol;
     }
 
-    /* Recursively process all subgroups */
+    /* Recursively process all subgroups. The path is extended in place for
+       each of them and shortened back after. */
+    const std::size_t pathSize = path.size();
     for(std::size_t i = 0; i != group->_groups.size(); ++i) {
         const Group& g = group->_groups[i];
 
         /* Subgroup name */
-        std::string name = g.name;
-        if(!fullPath.empty()) name = fullPath + '/' + name;
+        if(pathSize) path += '/';
+        path += g.name;
 
         /* Omit the name if the group is a first subgroup of given name, has no
            values and only subgroups */
         if(!((i == 0 || group->_groups[i - 1].name != g.name) && g.group->_values.empty() && !g.group->_groups.empty())) {
-            buffer = '[' + name + ']' + eol;
-            out.write(buffer.data(), buffer.size());
+            out += '[';
+            out += path;
+            out += ']';
+            out += eol;
         }
 
-        save(out, eol, g.group, name);
+        save(out, eol, g.group, path);
+        path.resize(pathSize);
     }
 }
 
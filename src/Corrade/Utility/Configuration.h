@@ -33,7 +33,9 @@
 #include <string>
 #include <iosfwd>
 
+#include "Corrade/Containers/Array.h"
 #include "Corrade/Containers/EnumSet.h"
+#include "Corrade/Containers/Pointer.h"
 #include "Corrade/Utility/ConfigurationGroup.h"
 #include "Corrade/Utility/visibility.h"
 
@@ -189,6 +191,30 @@ class=AbstractFactoryListenerProviderDelegate
 class=BeanFactoryListenerProviderDelegateGarbageAllocator
 @endcode
 
+@section Utility-Configuration-streaming Streaming parsing
+
+The whole file is parsed into a tree of @ref ConfigurationGroup instances
+upon construction. If you need just a small part of a large file, use
+@ref ConfigurationParser directly, which reports the groups and values as
+they are encountered without storing them anywhere.
+
+@section Utility-Configuration-cache Binary cache
+
+Tools that load the same large files on every startup can pass
+@ref Flag::Cache to the constructor. After the file is parsed, the resulting
+group tree is written in a compact binary form next to it, into a file with
+the same name and a `.cache` suffix. On the next load the cache file is
+memory-mapped and the tree is populated from it directly instead of parsing
+the text again. Together with @ref Flag::ReadOnly the keys and values are
+then views into the mapped cache.
+
+The cache is keyed on size and a @ref XXHash3 digest of the source file and
+on flags affecting the parsing, so it's never used for a file that changed
+since. Cache files from a different version of the format or from a platform
+with different endianness are ignored and regenerated as well. Errors when
+writing the cache (such as when the file is in a read-only location) are
+silently ignored. Saving the configuration always writes the text format.
+
 @todo Renaming, copying groups
 @todo EOL autodetection according to system on unsure/new files (default is
     preserve)
@@ -237,9 +263,22 @@ class CORRADE_UTILITY_EXPORT Configuration: public ConfigurationGroup {
             /**
              * Open the file read-only, which means faster access to elements
              * and less memory used. Filename is not saved to avoid overwriting
-             * the file with @ref save(). See also @ref Flag::SkipComments.
+             * the file with @ref save(). The file is memory-mapped on
+             * platforms that support it (or read into a single buffer
+             * otherwise) and keys and values are stored as views into it
+             * instead of being copied, which means just a few allocations
+             * for the whole file. The data is kept alive for the whole
+             * lifetime of the configuration, values modified or added later,
+             * as well as copies of its groups, own their data. See also
+             * @ref Flag::SkipComments.
              */
-            ReadOnly        = 1 << 5
+            ReadOnly        = 1 << 5,
+
+            /**
+             * Cache the parsed file in a binary form. See
+             * @ref Utility-Configuration-cache for more information.
+             */
+            Cache           = 1 << 6
         };
 
         /**
@@ -337,6 +376,7 @@ class CORRADE_UTILITY_EXPORT Configuration: public ConfigurationGroup {
             Truncate        = std::uint32_t(Flag::Truncate),
             SkipComments    = std::uint32_t(Flag::SkipComments),
             ReadOnly        = std::uint32_t(Flag::ReadOnly),
+            Cache           = std::uint32_t(Flag::Cache),
 
             IsValid = 1 << 16,
             HasBom = 1 << 17,
@@ -348,14 +388,27 @@ class CORRADE_UTILITY_EXPORT Configuration: public ConfigurationGroup {
 
         CORRADE_ENUMSET_FRIEND_OPERATORS(InternalFlags)
 
+        class Parser;
+        class Cache;
+
         CORRADE_UTILITY_LOCAL bool parse(Containers::ArrayView<const char> in);
-        CORRADE_UTILITY_LOCAL Containers::ArrayView<const char> parse(Containers::ArrayView<const char> in, ConfigurationGroup* group, const std::string& fullPath);
-        CORRADE_UTILITY_LOCAL void save(std::ostream& out, const std::string& eol, ConfigurationGroup* group, const std::string& fullPath) const;
+        CORRADE_UTILITY_LOCAL std::string saveToString() const;
+        CORRADE_UTILITY_LOCAL std::size_t saveSize(const ConfigurationGroup* group, std::size_t eolSize, std::size_t pathSize) const;
+        CORRADE_UTILITY_LOCAL void save(std::string& out, const char* eol, const ConfigurationGroup* group, std::string& path) const;
 
         CORRADE_UTILITY_LOCAL void setConfigurationPointer(ConfigurationGroup* group);
 
         std::string _filename;
         InternalFlags _flags;
+
+        /* Data referenced by values in a read-only configuration. The mapped
+           file is behind a pointer so this header doesn't need to include
+           Directory.h for the deleter type. */
+        #if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+        struct MappedData;
+        Containers::Pointer<MappedData> _mappedData;
+        #endif
+        Containers::Array<char> _data;
 };
 
 CORRADE_ENUMSET_OPERATORS(Configuration::Flags)
@@ -25,22 +25,88 @@
 
 #include "ConfigurationGroup.h"
 
+#include <cstring>
+
 #include "Corrade/Utility/Assert.h"
 #include "Corrade/Utility/Configuration.h"
 
 namespace Corrade { namespace Utility {
 
+namespace {
+    /* Groups with fewer items than this are searched linearly, as that's
+       faster than hashing and saves the memory for the index */
+    constexpr std::size_t IndexThreshold = 32;
+}
+
+ConfigurationGroup::Text::Text(const char* const data, const std::size_t size) noexcept: _view{}, _viewSize{} {
+    /* Empty views are stored as empty owned strings, which don't allocate */
+    if(size) {
+        _view = data;
+        _viewSize = size;
+    }
+}
+
+auto ConfigurationGroup::Text::operator=(const Text& other) -> Text& {
+    _owned = other.str();
+    _view = nullptr;
+    _viewSize = 0;
+    return *this;
+}
+
+bool ConfigurationGroup::Text::operator==(const std::string& other) const {
+    return size() == other.size() && std::memcmp(data(), other.data(), other.size()) == 0;
+}
+
+void ConfigurationGroup::Text::own() {
+    if(!_view) return;
+    _owned.assign(_view, _viewSize);
+    _view = nullptr;
+    _viewSize = 0;
+}
+
+template<class T, class Name> void ConfigurationGroup::Index::update(const std::vector<T>& items, Name T::*name) {
+    if(items.size() < IndexThreshold) {
+        if(count) reset();
+        return;
+    }
+
+    /* Items were removed without resetting the index, start over */
+    if(count > items.size()) reset();
+
+    /* Index items appended since the last update */
+    for(; count != items.size(); ++count)
+        positions[std::string(items[count].*name)].push_back(count);
+}
+
+auto ConfigurationGroup::Index::find(const std::string& name) const -> const std::vector<std::size_t>* {
+    const auto found = positions.find(name);
+    return found != positions.end() ? &found->second : nullptr;
+}
+
+void ConfigurationGroup::Index::reset() {
+    positions.clear();
+    count = 0;
+}
+
 ConfigurationGroup::ConfigurationGroup(): _configuration(nullptr) {}
 
 ConfigurationGroup::ConfigurationGroup(Configuration* configuration): _configuration(configuration) {}
 
-ConfigurationGroup::ConfigurationGroup(const ConfigurationGroup& other): _values(other._values), _groups(other._groups), _configuration(nullptr) {
+ConfigurationGroup::ConfigurationGroup(const ConfigurationGroup& other): _values(other._values), _groups(other._groups), _valueIndex(other._valueIndex), _groupIndex(other._groupIndex), _configuration(nullptr) {
     /* Deep copy groups */
     for(Group& group: _groups)
         group.group = new ConfigurationGroup(*group.group);
 }
 
-ConfigurationGroup::ConfigurationGroup(ConfigurationGroup&& other): _values(std::move(other._values)), _groups(std::move(other._groups)), _configuration(nullptr) {
+ConfigurationGroup::ConfigurationGroup(ConfigurationGroup&& other): _values(std::move(other._values)), _groups(std::move(other._groups)), _valueIndex(std::move(other._valueIndex)), _groupIndex(std::move(other._groupIndex)), _configuration(nullptr) {
+    other._valueIndex.reset();
+    other._groupIndex.reset();
+
+    /* Values of a group taken out of a read-only configuration may point to
+       data owned by the configuration, which this group can outlive. Only
+       the configuration itself moves the data along with its root group. */
+    if(other._configuration && other._configuration != &other) ownValues();
+
     /* Reset configuration pointer for subgroups */
     for(Group& group: _groups)
         group.group->_configuration = nullptr;
@@ -54,6 +120,8 @@ ConfigurationGroup& ConfigurationGroup::operator=(const ConfigurationGroup& othe
     /* _configuration stays the same */
     _values = other._values;
     _groups = other._groups;
+    _valueIndex = other._valueIndex;
+    _groupIndex = other._groupIndex;
 
     /* Deep copy groups */
     for(Group& group: _groups) {
@@ -72,6 +140,13 @@ ConfigurationGroup& ConfigurationGroup::operator=(ConfigurationGroup&& other) {
     /* _configuration stays the same */
     _values = std::move(other._values);
     _groups = std::move(other._groups);
+    _valueIndex = std::move(other._valueIndex);
+    _groupIndex = std::move(other._groupIndex);
+    other._valueIndex.reset();
+    other._groupIndex.reset();
+
+    /* See the move constructor for details */
+    if(other._configuration && other._configuration != &other) ownValues();
 
     /* Redirect configuration pointer for subgroups */
     for(Group& group: _groups)
@@ -86,14 +161,17 @@ ConfigurationGroup::~ConfigurationGroup() {
 }
 
 auto ConfigurationGroup::findGroup(const std::string& name, const unsigned int index) -> std::vector<Group>::iterator {
-    unsigned int foundIndex = 0;
-    for(auto it = _groups.begin(); it != _groups.end(); ++it)
-        if(it->name == name && foundIndex++ == index) return it;
-
-    return _groups.end();
+    const auto it = const_cast<const ConfigurationGroup&>(*this).findGroup(name, index);
+    return _groups.begin() + (it - _groups.cbegin());
 }
 
 auto ConfigurationGroup::findGroup(const std::string& name, const unsigned int index) const -> std::vector<Group>::const_iterator {
+    if(_groupIndex.covers(_groups.size())) {
+        const std::vector<std::size_t>* const positions = _groupIndex.find(name);
+        return positions && index < positions->size() ?
+            _groups.begin() + (*positions)[index] : _groups.end();
+    }
+
     unsigned int foundIndex = 0;
     for(auto it = _groups.begin(); it != _groups.end(); ++it)
         if(it->name == name && foundIndex++ == index) return it;
@@ -106,6 +184,11 @@ bool ConfigurationGroup::hasGroup(const std::string& name, const unsigned int in
 }
 
 unsigned int ConfigurationGroup::groupCount(const std::string& name) const {
+    if(_groupIndex.covers(_groups.size())) {
+        const std::vector<std::size_t>* const positions = _groupIndex.find(name);
+        return positions ? positions->size() : 0;
+    }
+
     unsigned int count = 0;
     for(const Group& group: _groups)
         if(group.name == name) ++count;
@@ -126,6 +209,15 @@ const ConfigurationGroup* ConfigurationGroup::group(const std::string& name, uns
 std::vector<ConfigurationGroup*> ConfigurationGroup::groups(const std::string& name) {
     std::vector<ConfigurationGroup*> found;
 
+    if(_groupIndex.covers(_groups.size())) {
+        if(const std::vector<std::size_t>* const positions = _groupIndex.find(name)) {
+            found.reserve(positions->size());
+            for(const std::size_t position: *positions)
+                found.push_back(_groups[position].group);
+        }
+        return found;
+    }
+
     for(Group& group: _groups)
         if(group.name == name) found.push_back(group.group);
 
@@ -135,6 +227,15 @@ std::vector<ConfigurationGroup*> ConfigurationGroup::groups(const std::string& n
 std::vector<const ConfigurationGroup*> ConfigurationGroup::groups(const std::string& name) const {
     std::vector<const ConfigurationGroup*> found;
 
+    if(_groupIndex.covers(_groups.size())) {
+        if(const std::vector<std::size_t>* const positions = _groupIndex.find(name)) {
+            found.reserve(positions->size());
+            for(const std::size_t position: *positions)
+                found.push_back(_groups[position].group);
+        }
+        return found;
+    }
+
     for(const Group& group: _groups)
         if(group.name == name) found.push_back(group.group);
 
@@ -154,6 +255,7 @@ void ConfigurationGroup::addGroup(const std::string& name, ConfigurationGroup* g
 
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
     _groups.push_back({name, group});
+    _groupIndex.update(_groups, &Group::name);
 }
 
 ConfigurationGroup* ConfigurationGroup::addGroup(const std::string& name) {
@@ -168,6 +270,8 @@ bool ConfigurationGroup::removeGroup(const std::string& name, unsigned int index
 
     delete it->group;
     _groups.erase(it);
+    _groupIndex.reset();
+    _groupIndex.update(_groups, &Group::name);
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
     return true;
 }
@@ -177,6 +281,8 @@ bool ConfigurationGroup::removeGroup(ConfigurationGroup* const group) {
         if(it->group == group) {
             delete it->group;
             _groups.erase(it);
+            _groupIndex.reset();
+            _groupIndex.update(_groups, &Group::name);
             if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
             return true;
         }
@@ -191,11 +297,19 @@ void ConfigurationGroup::removeAllGroups(const std::string& name) {
         delete (_groups.begin()+i)->group;
         _groups.erase(_groups.begin()+i);
     }
+    _groupIndex.reset();
+    _groupIndex.update(_groups, &Group::name);
 
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
 }
 
 auto ConfigurationGroup::findValue(const std::string& key, const unsigned int index) const -> std::vector<Value>::const_iterator {
+    if(_valueIndex.covers(_values.size())) {
+        const std::vector<std::size_t>* const positions = _valueIndex.find(key);
+        return positions && index < positions->size() ?
+            _values.begin() + (*positions)[index] : _values.end();
+    }
+
     unsigned int foundIndex = 0;
     for(auto it = _values.begin(); it != _values.end(); ++it)
         if(it->key == key && foundIndex++ == index) return it;
@@ -204,11 +318,26 @@ auto ConfigurationGroup::findValue(const std::string& key, const unsigned int in
 }
 
 auto ConfigurationGroup::findValue(const std::string& key, const unsigned int index) -> std::vector<Value>::iterator {
-    unsigned int foundIndex = 0;
-    for(auto it = _values.begin(); it != _values.end(); ++it)
-        if(it->key == key && foundIndex++ == index) return it;
+    const auto it = const_cast<const ConfigurationGroup&>(*this).findValue(key, index);
+    return _values.begin() + (it - _values.cbegin());
+}
 
-    return _values.end();
+void ConfigurationGroup::ownValues() {
+    for(Value& value: _values) {
+        value.key.own();
+        value.value.own();
+    }
+
+    for(Group& group: _groups)
+        group.group->ownValues();
+}
+
+void ConfigurationGroup::updateIndices() {
+    _valueIndex.update(_values, &Value::key);
+    _groupIndex.update(_groups, &Group::name);
+
+    for(Group& group: _groups)
+        group.group->updateIndices();
 }
 
 bool ConfigurationGroup::hasValues() const {
@@ -231,6 +360,11 @@ bool ConfigurationGroup::hasValue(const std::string& key, const unsigned int ind
 }
 
 unsigned int ConfigurationGroup::valueCount(const std::string& key) const {
+    if(_valueIndex.covers(_values.size())) {
+        const std::vector<std::size_t>* const positions = _valueIndex.find(key);
+        return positions ? positions->size() : 0;
+    }
+
     unsigned int count = 0;
     for(const Value& value: _values)
         if(value.key == key) ++count;
@@ -240,37 +374,92 @@ unsigned int ConfigurationGroup::valueCount(const std::string& key) const {
 
 std::string ConfigurationGroup::valueInternal(const std::string& key, const unsigned int index, ConfigurationValueFlags) const {
     const auto it = findValue(key, index);
-    return it != _values.end() ? it->value : std::string();
+    return it != _values.end() ? it->value.str() : std::string();
 }
 
 std::vector<std::string> ConfigurationGroup::valuesInternal(const std::string& key, ConfigurationValueFlags) const {
     std::vector<std::string> found;
 
+    if(_valueIndex.covers(_values.size())) {
+        if(const std::vector<std::size_t>* const positions = _valueIndex.find(key)) {
+            found.reserve(positions->size());
+            for(const std::size_t position: *positions)
+                found.push_back(_values[position].value.str());
+        }
+        return found;
+    }
+
     for(const Value& value: _values)
-        if(value.key == key) found.push_back(value.value);
+        if(value.key == key) found.push_back(value.value.str());
 
     return found;
 }
 
+std::size_t ConfigurationGroup::valuesInternal(const std::string& key, void* const out, const std::size_t size, const Converter converter, const ConfigurationValueFlags flags) const {
+    std::size_t count = 0;
+
+    if(_valueIndex.covers(_values.size())) {
+        if(const std::vector<std::size_t>* const positions = _valueIndex.find(key)) {
+            for(const std::size_t position: *positions) {
+                const Text& value = _values[position].value;
+                if(count < size) converter(out, count, value.data(), value.size(), flags);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    for(const Value& value: _values) {
+        if(value.key != key) continue;
+        if(count < size) converter(out, count, value.value.data(), value.value.size(), flags);
+        ++count;
+    }
+
+    return count;
+}
+
+std::size_t ConfigurationGroup::valueComponentsInternal(const std::string& key, const unsigned int index, void* const out, const std::size_t size, const Converter converter, const ConfigurationValueFlags flags) const {
+    const auto found = findValue(key, index);
+    if(found == _values.end()) return 0;
+
+    auto isWhitespace = [](const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    };
+
+    std::size_t count = 0;
+    const char* it = found->value.data();
+    const char* const end = it + found->value.size();
+    for(;;) {
+        while(it != end && isWhitespace(*it)) ++it;
+        if(it == end) break;
+
+        const char* const componentBegin = it;
+        while(it != end && !isWhitespace(*it)) ++it;
+        if(count < size) converter(out, count, componentBegin, it - componentBegin, flags);
+        ++count;
+    }
+
+    return count;
+}
+
 bool ConfigurationGroup::setValueInternal(const std::string& key, std::string value, const unsigned int index, ConfigurationValueFlags) {
     CORRADE_ASSERT(!key.empty(), "Utility::ConfigurationGroup::setValue(): empty key", false);
     CORRADE_ASSERT(key.find_first_of("\n=") == std::string::npos,
         "Utility::ConfigurationGroup::setValue(): disallowed character in key", false);
 
-    unsigned int foundIndex = 0;
-    for(Value& v: _values) {
-        if(v.key == key && foundIndex++ == index) {
-            v.value = std::move(value);
-            if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
-            return true;
-        }
+    const auto found = findValue(key, index);
+    if(found != _values.end()) {
+        found->value = std::move(value);
+        if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
+        return true;
     }
 
     /* Wanted to set value with index much larger than what we have */
-    if(index > foundIndex) return false;
+    if(index > valueCount(key)) return false;
 
     /* No value with that name was found, add new */
     _values.push_back({key, std::move(value)});
+    _valueIndex.update(_values, &Value::key);
 
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
     return true;
@@ -282,6 +471,7 @@ void ConfigurationGroup::addValueInternal(std::string key, std::string value, Co
         "Utility::ConfigurationGroup::addValue(): disallowed character in key", );
 
     _values.push_back({std::move(key), std::move(value)});
+    _valueIndex.update(_values, &Value::key);
 
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
 }
@@ -293,6 +483,8 @@ bool ConfigurationGroup::removeValue(const std::string& key, const unsigned int
     if(it == _values.end()) return false;
 
     _values.erase(it);
+    _valueIndex.reset();
+    _valueIndex.update(_values, &Value::key);
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
     return true;
 }
@@ -304,16 +496,20 @@ void ConfigurationGroup::removeAllValues(const std::string& key) {
     for(int i = _values.size()-1; i >= 0; --i) {
         if(_values[i].key == key) _values.erase(_values.begin()+i);
     }
+    _valueIndex.reset();
+    _valueIndex.update(_values, &Value::key);
 
     if(_configuration) _configuration->_flags |= Configuration::InternalFlag::Changed;
 }
 
 void ConfigurationGroup::clear() {
     _values.clear();
+    _valueIndex.reset();
 
     for(Group& group: _groups)
         delete group.group;
     _groups.clear();
+    _groupIndex.reset();
 }
 
 }}
@@ -31,8 +31,10 @@
 
 #include <utility>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "Corrade/Containers/Array.h"
 #include "Corrade/Utility/ConfigurationValue.h"
 #include "Corrade/Utility/Utility.h"
 #include "Corrade/Utility/visibility.h"
@@ -44,7 +46,19 @@ namespace Corrade { namespace Utility {
 
 Provides access to values and subgroups. See @ref Configuration class
 documentation for usage example.
-@todo Faster access to elements via multimap, find() and equal_range()
+
+@section Utility-ConfigurationGroup-lookup Lookup complexity
+
+Values and subgroups are stored in insertion order, which is preserved on
+@ref Configuration::save(). For small groups the lookup is a linear scan, once
+a group has more than a few dozen values or subgroups, a hash index mapping
+each key / group name to positions of all its occurrences is maintained,
+making @ref value(), @ref hasValue(), @ref setValue(), @ref group() and
+related functions amortized constant-time. The index is extended when values
+or groups are added and rebuilt when they are removed, so adding is amortized
+constant-time but removing is linear. The index is only ever modified by
+non-@cpp const @ce functions, which means @cpp const @ce lookup functions can
+be called on the same group from multiple threads at once.
 */
 class CORRADE_UTILITY_EXPORT ConfigurationGroup {
     friend Configuration;
@@ -278,6 +292,75 @@ class CORRADE_UTILITY_EXPORT ConfigurationGroup {
          */
         template<class T = std::string> std::vector<T> values(const std::string& key, ConfigurationValueFlags flags = ConfigurationValueFlags()) const;
 
+        /**
+         * @brief Write all values with given key into an array
+         * @param key       Key
+         * @param out       Where to put the values
+         * @param flags     Flags
+         * @return Count of all values with given key
+         *
+         * Converts values with given key directly into @p out, without
+         * creating any intermediate strings for builtin types. If there's
+         * more values than @p out can hold, only the first
+         * @cpp out.size() @ce are written, the rest of @p out is left
+         * untouched if there's less of them. Compare the returned count to
+         * the view size to detect either case.
+         * @see @ref valueCount(const std::string&) const,
+         *      @ref valueComponents()
+         */
+        template<class T> std::size_t values(const std::string& key, Containers::ArrayView<T> out, ConfigurationValueFlags flags = ConfigurationValueFlags()) const;
+
+        /**
+         * @brief All values with given key in an array
+         *
+         * Like @ref values(const std::string&, ConfigurationValueFlags) const,
+         * but returns the values in a single allocation and without
+         * creating any intermediate strings for builtin types. The type is
+         * expected to be default-constructible.
+         * @see @ref values(const std::string&, Containers::ArrayView<T>, ConfigurationValueFlags) const
+         */
+        template<class T> Containers::Array<T> valueArray(const std::string& key, ConfigurationValueFlags flags = ConfigurationValueFlags()) const;
+
+        /**
+         * @brief Write whitespace-separated components of a value into an array
+         * @param key       Key
+         * @param out       Where to put the components
+         * @param index     Value index. Default is first found value.
+         * @param flags     Flags
+         * @return Count of all components in the value
+         *
+         * Splits a value such as @cb{.ini} weights=0.25 0.5 0.25 @ce on
+         * whitespace and converts each component directly into @p out,
+         * without creating any intermediate strings for builtin types. If
+         * there's more components than @p out can hold, only the first
+         * @cpp out.size() @ce are written. If the value doesn't exist,
+         * nothing is written and @cpp 0 @ce is returned.
+         */
+        template<class T> std::size_t valueComponents(const std::string& key, Containers::ArrayView<T> out, unsigned int index = 0, ConfigurationValueFlags flags = ConfigurationValueFlags()) const;
+
+        /** @overload
+         * Calls the above with @p index set to `0`.
+         */
+        template<class T> std::size_t valueComponents(const std::string& key, Containers::ArrayView<T> out, ConfigurationValueFlags flags) const {
+            return valueComponents(key, out, 0, flags);
+        }
+
+        /**
+         * @brief Whitespace-separated components of a value in an array
+         *
+         * Like @ref valueComponents(const std::string&, Containers::ArrayView<T>, unsigned int, ConfigurationValueFlags) const,
+         * but returns the components in a newly allocated array. The type is
+         * expected to be default-constructible.
+         */
+        template<class T> Containers::Array<T> valueComponentsArray(const std::string& key, unsigned int index = 0, ConfigurationValueFlags flags = ConfigurationValueFlags()) const;
+
+        /** @overload
+         * Calls the above with @p index set to `0`.
+         */
+        template<class T> Containers::Array<T> valueComponentsArray(const std::string& key, ConfigurationValueFlags flags) const {
+            return valueComponentsArray<T>(key, 0, flags);
+        }
+
         /**
          * @brief Set string value
          * @param key       Key. The key must not be empty and must not contain
@@ -391,8 +474,40 @@ class CORRADE_UTILITY_EXPORT ConfigurationGroup {
         void clear();
 
     private:
+        /* Either an owned string or, in a read-only configuration, a view
+           into the data kept alive by the Configuration. Copies are always
+           owned so they can outlive the source data. */
+        class CORRADE_UTILITY_LOCAL Text {
+            public:
+                /*implicit*/ Text() noexcept: _view{}, _viewSize{} {}
+                /*implicit*/ Text(std::string owned) noexcept: _owned{std::move(owned)}, _view{}, _viewSize{} {}
+                explicit Text(const char* data, std::size_t size) noexcept;
+
+                Text(const Text& other): _owned{other.str()}, _view{}, _viewSize{} {}
+                Text(Text&&) noexcept = default;
+                Text& operator=(const Text& other);
+                Text& operator=(Text&&) noexcept = default;
+
+                const char* data() const { return _view ? _view : _owned.data(); }
+                std::size_t size() const { return _view ? _viewSize : _owned.size(); }
+                bool empty() const { return !size(); }
+                std::string str() const { return _view ? std::string{_view, _viewSize} : _owned; }
+                explicit operator std::string() const { return str(); }
+
+                bool operator==(const std::string& other) const;
+                bool operator!=(const std::string& other) const { return !operator==(other); }
+
+                /* Convert a view to an owned string */
+                void own();
+
+            private:
+                std::string _owned;
+                const char* _view;
+                std::size_t _viewSize;
+        };
+
         struct CORRADE_UTILITY_LOCAL Value {
-            std::string key, value;
+            Text key, value;
         };
 
         struct CORRADE_UTILITY_LOCAL Group {
@@ -400,6 +515,20 @@ class CORRADE_UTILITY_EXPORT ConfigurationGroup {
             ConfigurationGroup* group;
         };
 
+        /* Mapping from a key / group name to positions of all its
+           occurrences in _values / _groups. Covers the first `count` items
+           and is updated by every modification, const lookups only read it
+           and fall back to a linear search if it doesn't cover all items. */
+        struct CORRADE_UTILITY_LOCAL Index {
+            template<class T, class Name> void update(const std::vector<T>& items, Name T::*name);
+            bool covers(std::size_t size) const { return count && count == size; }
+            const std::vector<std::size_t>* find(const std::string& name) const;
+            void reset();
+
+            std::unordered_map<std::string, std::vector<std::size_t>> positions;
+            std::size_t count{};
+        };
+
         CORRADE_UTILITY_LOCAL explicit ConfigurationGroup(Configuration* configuration);
 
         CORRADE_UTILITY_LOCAL std::vector<Group>::iterator findGroup(const std::string& name, unsigned int index);
@@ -407,13 +536,33 @@ class CORRADE_UTILITY_EXPORT ConfigurationGroup {
         CORRADE_UTILITY_LOCAL std::vector<Value>::iterator findValue(const std::string& key, unsigned int index);
         CORRADE_UTILITY_LOCAL std::vector<Value>::const_iterator findValue(const std::string& key, unsigned int index) const;
 
+        /* Convert all views in this group and its subgroups to owned
+           strings */
+        CORRADE_UTILITY_LOCAL void ownValues();
+
+        /* Index all values and groups in this group and its subgroups, used
+           after filling the tree directly */
+        CORRADE_UTILITY_LOCAL void updateIndices();
+
         std::string valueInternal(const std::string& key, unsigned int index, ConfigurationValueFlags flags) const;
         std::vector<std::string> valuesInternal(const std::string& key, ConfigurationValueFlags flags) const;
+
+        /* Converts a string to the i-th item of a typed array */
+        typedef void(*Converter)(void*, std::size_t, const char*, std::size_t, ConfigurationValueFlags);
+        template<class T> static void convert(void* out, std::size_t i, const char* data, std::size_t size, ConfigurationValueFlags flags) {
+            Implementation::configurationValueFromString(data, size, flags, static_cast<T*>(out)[i]);
+        }
+
+        /* Convert up to `size` values / value components, return the total
+           count of them */
+        std::size_t valuesInternal(const std::string& key, void* out, std::size_t size, Converter converter, ConfigurationValueFlags flags) const;
+        std::size_t valueComponentsInternal(const std::string& key, unsigned int index, void* out, std::size_t size, Converter converter, ConfigurationValueFlags flags) const;
         bool setValueInternal(const std::string& key, std::string value, unsigned int number, ConfigurationValueFlags flags);
         void addValueInternal(std::string key, std::string value, ConfigurationValueFlags flags);
 
         std::vector<Value> _values;
         std::vector<Group> _groups;
+        Index _valueIndex, _groupIndex;
 
         Configuration* _configuration;
 };
@@ -445,6 +594,26 @@ template<class T> std::vector<T> ConfigurationGroup::values(const std::string& k
     return values;
 }
 
+template<class T> std::size_t ConfigurationGroup::values(const std::string& key, const Containers::ArrayView<T> out, const ConfigurationValueFlags flags) const {
+    return valuesInternal(key, out.data(), out.size(), convert<T>, flags);
+}
+
+template<class T> Containers::Array<T> ConfigurationGroup::valueArray(const std::string& key, const ConfigurationValueFlags flags) const {
+    Containers::Array<T> out{Containers::ValueInit, valueCount(key)};
+    valuesInternal(key, out.data(), out.size(), convert<T>, flags);
+    return out;
+}
+
+template<class T> std::size_t ConfigurationGroup::valueComponents(const std::string& key, const Containers::ArrayView<T> out, const unsigned int index, const ConfigurationValueFlags flags) const {
+    return valueComponentsInternal(key, index, out.data(), out.size(), convert<T>, flags);
+}
+
+template<class T> Containers::Array<T> ConfigurationGroup::valueComponentsArray(const std::string& key, const unsigned int index, const ConfigurationValueFlags flags) const {
+    Containers::Array<T> out{Containers::ValueInit, valueComponentsInternal(key, index, nullptr, 0, nullptr, flags)};
+    valueComponentsInternal(key, index, out.data(), out.size(), convert<T>, flags);
+    return out;
+}
+
 }}
 
 #endif
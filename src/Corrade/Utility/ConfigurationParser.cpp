@@ -0,0 +1,241 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ConfigurationParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Corrade/Utility/Assert.h"
+#include "Corrade/Utility/Debug.h"
+
+namespace Corrade { namespace Utility {
+
+namespace {
+    constexpr const char Bom[] = "\xEF\xBB\xBF";
+
+    constexpr bool isWhitespace(char c) {
+        return c == ' ' || c == '\t' || c == '\f' || c == '\v' || c == '\r' || c == '\n';
+    }
+
+    Containers::ArrayView<const char> trim(Containers::ArrayView<const char> string) {
+        const char* begin = string.begin();
+        const char* end = string.end();
+        while(begin != end && isWhitespace(*begin)) ++begin;
+        while(end != begin && isWhitespace(*(end - 1))) --end;
+        return string.slice(begin, end);
+    }
+
+    bool equals(const Containers::ArrayView<const char> a, const char* const b, const std::size_t size) {
+        return a.size() == size && std::memcmp(a.data(), b, size) == 0;
+    }
+
+    bool beginsWith(const Containers::ArrayView<const char> a, const std::string& prefix) {
+        return a.size() >= prefix.size() && std::memcmp(a.data(), prefix.data(), prefix.size()) == 0;
+    }
+
+    constexpr const char MultiLineQuotes[] = "\"\"\"";
+}
+
+ConfigurationParser::ConfigurationParser() = default;
+
+ConfigurationParser::~ConfigurationParser() = default;
+
+bool ConfigurationParser::parse(Containers::ArrayView<const char> in) {
+    _hasBom = _hasWindowsEol = false;
+
+    /* Oh, BOM, eww */
+    if(in.size() >= 3 && in[0] == Bom[0] && in[1] == Bom[1] && in[2] == Bom[2]) {
+        _hasBom = true;
+        in = in.suffix(3);
+    }
+
+    /* Path of the innermost open group including a trailing slash, empty for
+       the root. Each open group has its path length saved in the stack so
+       the path can be shortened again when the group gets closed. */
+    std::string fullPath;
+    std::vector<std::size_t> openGroups;
+
+    /* The lines are processed as views into the input, data are copied only
+       for multi-line values with Windows line endings */
+    const char* multiLineValue = nullptr;
+    Containers::ArrayView<const char> multiLineKey;
+    std::string multiLineCopy;
+    while(!in.empty()) {
+        /* Extract the line and ignore the newline character after it, if any */
+        const char* end = std::find(in.begin(), in.end(), '\n');
+        Containers::ArrayView<const char> line = in.prefix(end);
+        in = in.suffix(end == in.end() ? end : end + 1);
+
+        /* Windows EOL */
+        if(!line.empty() && line.back() == '\r')
+            _hasWindowsEol = true;
+
+        /* Multi-line value. All lines are taken verbatim until the closing
+           quotes, so the value is a contiguous range of the input. */
+        if(multiLineValue) {
+            /* End of multi-line value */
+            if(equals(trim(line), MultiLineQuotes, 3)) {
+                Containers::ArrayView<const char> value{multiLineValue, std::size_t(line.begin() - multiLineValue)};
+
+                /* Remove trailing newline, if present */
+                if(!value.empty()) {
+                    CORRADE_INTERNAL_ASSERT(value.back() == '\n');
+                    value = value.prefix(value.size() - 1);
+                }
+
+                /* Remove Windows EOLs, if present. This needs a copy. */
+                if(std::search(value.begin(), value.end(), "\r\n", "\r\n" + 2) != value.end()) {
+                    multiLineCopy.clear();
+                    multiLineCopy.reserve(value.size());
+                    for(std::size_t i = 0; i != value.size(); ++i)
+                        if(value[i] != '\r' || i + 1 == value.size() || value[i + 1] != '\n')
+                            multiLineCopy += value[i];
+                    /* The last line doesn't have its newline in the view */
+                    if(!multiLineCopy.empty() && multiLineCopy.back() == '\r')
+                        multiLineCopy.pop_back();
+                    value = {multiLineCopy.data(), multiLineCopy.size()};
+                }
+
+                doValue(multiLineKey, value);
+                multiLineValue = nullptr;
+            }
+
+            continue;
+        }
+
+        /* Trim the line */
+        line = trim(line);
+
+        /* Empty line. Reported also if it's the last line of the file, the
+           original parser meant to skip that one, but its check was for a
+           null view and thus never fired, so the line was always kept. */
+        if(line.empty()) {
+            doComment(line);
+
+        /* Group header */
+        } else if(line[0] == '[') {
+
+            /* Check ending bracket */
+            if(line.back() != ']') {
+                doError("missing closing bracket for a group header");
+                return false;
+            }
+
+            const Containers::ArrayView<const char> name = trim(line.slice(1, line.size() - 1));
+            if(name.empty()) {
+                doError("empty group name");
+                return false;
+            }
+
+            /* Close all groups that the new one isn't nested in */
+            while(!beginsWith(name, fullPath)) {
+                doGroupEnd();
+                fullPath.resize(openGroups.back());
+                openGroups.pop_back();
+            }
+
+            /* Open the nested groups. If the header has a shorthand for
+               multiple nesting, each level gets its own group. */
+            for(;;) {
+                const Containers::ArrayView<const char> rest = name.suffix(fullPath.size());
+                const char* const groupEnd = std::find(rest.begin(), rest.end(), '/');
+                if(groupEnd == rest.begin() && groupEnd != rest.end()) {
+                    doError("empty subgroup name");
+                    return false;
+                }
+
+                doGroupBegin(rest.prefix(groupEnd));
+                openGroups.push_back(fullPath.size());
+                fullPath.append(rest.begin(), groupEnd);
+                fullPath += '/';
+
+                if(groupEnd == rest.end()) break;
+            }
+
+        /* Comment */
+        } else if(line[0] == '#' || line[0] == ';') {
+            doComment(line);
+
+        /* Key/value pair */
+        } else {
+            const char* const splitter = std::find(line.begin(), line.end(), '=');
+            if(splitter == line.end()) {
+                doError("missing equals for a value");
+                return false;
+            }
+
+            const Containers::ArrayView<const char> key = trim(line.prefix(splitter));
+            Containers::ArrayView<const char> value = trim(line.suffix(splitter + 1));
+
+            /* Start of multi-line value, the value itself is reported when
+               the closing quotes are found */
+            if(equals(value, MultiLineQuotes, 3)) {
+                multiLineValue = in.begin();
+                multiLineKey = key;
+                continue;
+            }
+
+            /* Remove quotes, if present */
+            /** @todo Check `"` characters better */
+            if(!value.empty() && value[0] == '"') {
+                if(value.size() < 2 || value.back() != '"') {
+                    doError("missing closing quote for a value");
+                    return false;
+                }
+
+                value = value.slice(1, value.size() - 1);
+            }
+
+            doValue(key, value);
+        }
+    }
+
+    if(multiLineValue) {
+        doError("missing closing quotes for a multi-line value");
+        return false;
+    }
+
+    /* Close all groups that are still open */
+    for(std::size_t i = 0; i != openGroups.size(); ++i) doGroupEnd();
+
+    return true;
+}
+
+void ConfigurationParser::doGroupBegin(Containers::ArrayView<const char>) {}
+
+void ConfigurationParser::doGroupEnd() {}
+
+void ConfigurationParser::doValue(Containers::ArrayView<const char>, Containers::ArrayView<const char>) {}
+
+void ConfigurationParser::doComment(Containers::ArrayView<const char>) {}
+
+void ConfigurationParser::doError(const char* const message) {
+    Error() << "Utility::ConfigurationParser::parse():" << message;
+}
+
+}}
@@ -0,0 +1,174 @@
+#ifndef Corrade_Utility_ConfigurationParser_h
+#define Corrade_Utility_ConfigurationParser_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Corrade::Utility::ConfigurationParser
+ */
+
+#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/Utility/Utility.h"
+#include "Corrade/Utility/visibility.h"
+
+namespace Corrade { namespace Utility {
+
+/**
+@brief Event-based configuration file parser
+
+Parses the file format described in @ref Utility-Configuration-usage without
+building a @ref ConfigurationGroup tree. Instead, the parser calls a virtual
+function for every group header, key/value pair and comment it encounters,
+which makes it possible to filter or process huge files without holding all
+their contents in memory. @ref Configuration itself is implemented on top of
+this class.
+
+Subclass it and override the functions for events you're interested in, all
+of them have an empty default implementation. Then call @ref parse():
+
+@code{.cpp}
+struct: Utility::ConfigurationParser {
+    void doGroupBegin(Containers::ArrayView<const char> name) override {
+        inPlugin = ++depth == 1 && std::string{name, name.size()} == "plugin";
+    }
+    void doGroupEnd() override {
+        --depth;
+        inPlugin = false;
+    }
+    void doValue(Containers::ArrayView<const char> key, Containers::ArrayView<const char> value) override {
+        if(inPlugin && std::string{key, key.size()} == "name")
+            names.emplace_back(value, value.size());
+    }
+
+    int depth{};
+    bool inPlugin{};
+    std::vector<std::string> names;
+} parser;
+parser.parse(Utility::Directory::mapRead("plugins.conf"));
+@endcode
+
+@section Utility-ConfigurationParser-events Events
+
+-   A group header calls @ref doGroupBegin() with the group name. Group
+    headers with a nesting shorthand such as @cb{.ini} [a/b/c] @ce call it
+    once for each nested group that's not already open. When a header for a
+    group that's not nested in the current one is encountered, and at the end
+    of the file, @ref doGroupEnd() is called for each open group that gets
+    closed. That means the calls are always properly paired, reflecting the
+    hierarchy @ref Configuration would build.
+-   A key/value pair calls @ref doValue() with whitespace and quotes already
+    stripped. Multi-line values are reported once their closing quotes are
+    found, with the first and last line break removed.
+-   A comment line calls @ref doComment() with the whole line, including the
+    leading @cb{.ini} # @ce or @cb{.ini} ; @ce. Empty lines call it with an
+    empty view.
+
+All views passed to the event functions point into the parsed data, with the
+exception of multi-line values with Windows line endings, which are
+converted to use just @cpp '\n' @ce in a temporary buffer that's valid only
+for the duration of the call.
+
+If the input can't be parsed, @ref doError() is called with a message and
+the parsing stops. Events for the part of the file before the error are
+already reported at that point.
+*/
+class CORRADE_UTILITY_EXPORT ConfigurationParser {
+    public:
+        /** @brief Constructor */
+        explicit ConfigurationParser();
+
+        /** @brief Destructor */
+        virtual ~ConfigurationParser();
+
+        /**
+         * @brief Parse given data
+         *
+         * Leading UTF-8 BOM is skipped and recorded in @ref hasBom(). Returns
+         * @cpp false @ce if a syntax error was encountered, @cpp true @ce
+         * otherwise. The parser can be reused for parsing another data.
+         */
+        bool parse(Containers::ArrayView<const char> data);
+
+        /** @brief Whether the last parsed data had a UTF-8 BOM */
+        bool hasBom() const { return _hasBom; }
+
+        /**
+         * @brief Whether the last parsed data had Windows line endings
+         *
+         * Returns @cpp true @ce if at least one line ended with
+         * @cpp "\r\n" @ce.
+         */
+        bool hasWindowsEol() const { return _hasWindowsEol; }
+
+    #ifdef DOXYGEN_GENERATING_OUTPUT
+    protected:
+    #else
+    private:
+    #endif
+        /**
+         * @brief Group header
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doGroupBegin(Containers::ArrayView<const char> name);
+
+        /**
+         * @brief End of a group
+         *
+         * Called for the innermost open group. Default implementation does
+         * nothing.
+         */
+        virtual void doGroupEnd();
+
+        /**
+         * @brief Key/value pair
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doValue(Containers::ArrayView<const char> key, Containers::ArrayView<const char> value);
+
+        /**
+         * @brief Comment or empty line
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doComment(Containers::ArrayView<const char> line);
+
+        /**
+         * @brief Parse error
+         *
+         * Called with a null-terminated message describing the error. Default
+         * implementation prints it via @ref Error, prefixed with
+         * @cpp "Utility::ConfigurationParser::parse():" @ce.
+         */
+        virtual void doError(const char* message);
+
+    private:
+        bool _hasBom{}, _hasWindowsEol{};
+};
+
+}}
+
+#endif
@@ -25,48 +25,154 @@
 
 #include "ConfigurationValue.h"
 
-#include <sstream>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "Corrade/Utility/Implementation/numberConversion.h"
 
 namespace Corrade { namespace Utility {
 
 namespace Implementation {
-    template<class T> std::string BasicConfigurationValue<T>::toString(const T& value, ConfigurationValueFlags flags) {
-        std::ostringstream stream;
-
-        /* Hexadecimal / octal values, scientific notation */
-        if(flags & ConfigurationValueFlag::Hex)
-            stream.setf(std::istringstream::hex, std::istringstream::basefield);
-        else if(flags & ConfigurationValueFlag::Oct)
-            stream.setf(std::istringstream::oct, std::istringstream::basefield);
-        else if(flags & ConfigurationValueFlag::Scientific)
-            stream.setf(std::istringstream::scientific, std::istringstream::floatfield);
-
-        if(flags & ConfigurationValueFlag::Uppercase)
-            stream.setf(std::istringstream::uppercase);
+    namespace {
+        /* Printing and parsing the same way as std::ostream / std::istream
+           would, but without going through a stream, which is slow,
+           allocates and depends on the global locale */
+
+        template<class T> bool isNegative(const T value, std::true_type) { return value < T(0); }
+        template<class T> bool isNegative(T, std::false_type) { return false; }
+
+        template<class T> std::string integerToString(const T value, const ConfigurationValueFlags flags) {
+            /* Like with streams, hexadecimal and octal values are printed as
+               unsigned */
+            typedef typename std::make_unsigned<T>::type UnsignedT;
+            char buffer[24];
+            std::size_t size;
+            if(flags & ConfigurationValueFlag::Hex)
+                size = formatInteger(buffer, UnsignedT(value), 16, bool(flags & ConfigurationValueFlag::Uppercase));
+            else if(flags & ConfigurationValueFlag::Oct)
+                size = formatInteger(buffer, UnsignedT(value), 8, false);
+            else if(isNegative(value, std::is_signed<T>{})) {
+                buffer[0] = '-';
+                size = 1 + formatInteger(buffer + 1, UnsignedT(UnsignedT(0) - UnsignedT(value)), 10, false);
+            } else size = formatInteger(buffer, UnsignedT(value), 10, false);
+
+            return std::string{buffer, size};
+        }
+
+        /* Out-of-range values are saturated like with streams, negative
+           values wrap around for unsigned types */
+        template<class T> T integerFromParsed(const unsigned long long magnitude, const bool negative, const bool overflow, std::true_type) {
+            typedef typename std::make_unsigned<T>::type UnsignedT;
+            const unsigned long long max = static_cast<unsigned long long>(std::numeric_limits<T>::max());
+            if(negative) {
+                if(overflow || magnitude > max + 1) return std::numeric_limits<T>::min();
+                return T(UnsignedT(UnsignedT(0) - UnsignedT(magnitude)));
+            }
+            if(overflow || magnitude > max) return std::numeric_limits<T>::max();
+            return T(magnitude);
+        }
+        template<class T> T integerFromParsed(const unsigned long long magnitude, const bool negative, const bool overflow, std::false_type) {
+            if(overflow || magnitude > std::numeric_limits<T>::max())
+                return std::numeric_limits<T>::max();
+            return negative ? T(T(0) - T(magnitude)) : T(magnitude);
+        }
+
+        template<class T> T integerFromString(const char* const data, const std::size_t size, const ConfigurationValueFlags flags) {
+            const unsigned base = flags & ConfigurationValueFlag::Hex ? 16 :
+                flags & ConfigurationValueFlag::Oct ? 8 : 10;
+            unsigned long long magnitude;
+            bool negative, overflow;
+            if(!parseInteger(data, data + size, base, magnitude, negative, overflow))
+                return T{};
+
+            return integerFromParsed<T>(magnitude, negative, overflow, std::is_signed<T>{});
+        }
+
+        template<class T> std::string floatToString(const T value, const ConfigurationValueFlags flags) {
+            /* Hexadecimal and octal flags have no effect on floats, but they
+               still disable the scientific notation, like with streams */
+            char type = 'g';
+            if(!(flags & (ConfigurationValueFlag::Hex|ConfigurationValueFlag::Oct)) && (flags & ConfigurationValueFlag::Scientific))
+                type = 'e';
+            if(flags & ConfigurationValueFlag::Uppercase) type = char(type & ~0x20);
+
+            /* Start with the default stream precision of 6 and increase it
+               until the value survives a round trip. For most values this
+               ends up being the same output as with a stream, values that
+               need more digits are no longer silently truncated. */
+            const int maxPrecision = std::numeric_limits<T>::max_digits10 - (type == 'g' || type == 'G' ? 0 : 1);
+            char buffer[64];
+            std::size_t size;
+            for(int precision = 6; ; ++precision) {
+                size = formatFloatingPoint(buffer, sizeof(buffer), value, type, precision);
+                if(precision >= maxPrecision || !std::isfinite(value)) break;
+
+                T parsed;
+                parseFloatingPoint(buffer, buffer + size, parsed);
+                if(parsed == value) break;
+            }
+
+            return std::string{buffer, size};
+        }
+
+        template<class T> T floatFromString(const char* const data, const std::size_t size, ConfigurationValueFlags) {
+            T value;
+            parseFloatingPoint(data, data + size, value);
+            return value;
+        }
+
+        template<class T> struct Converter;
+        #define _c(type, function)                                          \
+            template<> struct Converter<type> {                             \
+                static std::string toString(const type value, const ConfigurationValueFlags flags) { \
+                    return function ## ToString(value, flags);              \
+                }                                                           \
+                static type fromString(const char* const data, const std::size_t size, const ConfigurationValueFlags flags) { \
+                    return function ## FromString<type>(data, size, flags); \
+                }                                                           \
+            };
+        _c(short, integer)
+        _c(unsigned short, integer)
+        _c(int, integer)
+        _c(unsigned int, integer)
+        _c(long, integer)
+        _c(unsigned long, integer)
+        _c(long long, integer)
+        _c(unsigned long long, integer)
+        _c(float, float)
+        _c(double, float)
+        _c(long double, float)
+        #undef _c
+
+        /* Strings are copied as-is on output and like with a stream only
+           the first whitespace-delimited word is taken on input */
+        template<> struct Converter<std::string> {
+            static std::string toString(const std::string& value, ConfigurationValueFlags) {
+                return value;
+            }
+            static std::string fromString(const char* const data, const std::size_t size, ConfigurationValueFlags) {
+                auto isWhitespace = [](const char c) {
+                    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+                };
+                const char* const end = data + size;
+                const char* begin = data;
+                while(begin != end && isWhitespace(*begin)) ++begin;
+                const char* wordEnd = begin;
+                while(wordEnd != end && !isWhitespace(*wordEnd)) ++wordEnd;
+                return std::string{begin, wordEnd};
+            }
+        };
+    }
 
-        stream << value;
-        return stream.str();
+    template<class T> std::string BasicConfigurationValue<T>::toString(const T& value, ConfigurationValueFlags flags) {
+        return Converter<T>::toString(value, flags);
     }
 
     template<class T> T BasicConfigurationValue<T>::fromString(const std::string& stringValue, ConfigurationValueFlags flags) {
         if(stringValue.empty()) return T{};
-
-        std::istringstream stream{stringValue};
-
-        /* Hexadecimal / octal values, scientific notation */
-        if(flags & ConfigurationValueFlag::Hex)
-            stream.setf(std::istringstream::hex, std::istringstream::basefield);
-        else if(flags & ConfigurationValueFlag::Oct)
-            stream.setf(std::istringstream::oct, std::istringstream::basefield);
-        else if(flags & ConfigurationValueFlag::Scientific)
-            stream.setf(std::istringstream::scientific, std::istringstream::floatfield);
-
-        if(flags & ConfigurationValueFlag::Uppercase)
-            stream.setf(std::istringstream::uppercase);
-
-        T value;
-        stream >> value;
-        return value;
+        return Converter<T>::fromString(stringValue.data(), stringValue.size(), flags);
     }
 
     template struct BasicConfigurationValue<short>;
@@ -83,6 +189,38 @@ namespace Implementation {
     template struct BasicConfigurationValue<long double>;
     #endif
     template struct BasicConfigurationValue<std::string>;
+
+    #define _c(type)                                                        \
+        void configurationValueFromString(const char* const data, const std::size_t size, const ConfigurationValueFlags flags, type& out) { \
+            out = size ? Converter<type>::fromString(data, size, flags) : 0; \
+        }
+    _c(short)
+    _c(unsigned short)
+    _c(int)
+    _c(unsigned int)
+    _c(long)
+    _c(unsigned long)
+    _c(long long)
+    _c(unsigned long long)
+    _c(float)
+    _c(double)
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    _c(long double)
+    #endif
+    #undef _c
+
+    void configurationValueFromString(const char* const data, const std::size_t size, ConfigurationValueFlags, bool& out) {
+        auto equals = [&](const char* string) {
+            return std::strlen(string) == size && std::memcmp(data, string, size) == 0;
+        };
+        out = equals("1") || equals("yes") || equals("y") || equals("true");
+    }
+
+    void configurationValueFromString(const char* const data, const std::size_t size, ConfigurationValueFlags, char32_t& out) {
+        unsigned long long value;
+        configurationValueFromString(data, size, ConfigurationValueFlag::Hex|ConfigurationValueFlag::Uppercase, value);
+        out = char32_t(value);
+    }
 }
 
 #ifndef DOXYGEN_GENERATING_OUTPUT
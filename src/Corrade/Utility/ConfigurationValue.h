@@ -228,6 +228,36 @@ template<> struct CORRADE_UTILITY_EXPORT ConfigurationValue<char32_t> {
     #endif
 };
 
+namespace Implementation {
+    /* Conversion from a string that's not null-terminated, writing to an
+       existing value. Used by ConfigurationGroup::values() and
+       valueComponents() that write into arrays. Builtin types are converted
+       directly, other types go through a temporary std::string and
+       ConfigurationValue::fromString(). */
+    template<class T> inline void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, T& out) {
+        out = ConfigurationValue<T>::fromString(std::string{data, size}, flags);
+    }
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, short& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, unsigned short& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, int& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, unsigned int& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, long& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, unsigned long& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, long long& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, unsigned long long& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, float& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, double& out);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, long double& out);
+    #endif
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, bool& out);
+    CORRADE_UTILITY_EXPORT void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags flags, char32_t& out);
+    /* Strings are taken verbatim, consistently with ConfigurationGroup::value() */
+    inline void configurationValueFromString(const char* data, std::size_t size, ConfigurationValueFlags, std::string& out) {
+        out.assign(data, size);
+    }
+}
+
 }}
 
 #endif
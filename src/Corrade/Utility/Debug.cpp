@@ -25,11 +25,16 @@
 
 #include "Debug.h"
 
+#include <atomic>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 
+#include "Corrade/Utility/DebugTrace.h"
+#include "Corrade/Utility/Implementation/debugSink.h"
+
 /* For isatty() on Unix-like systems */
 #ifdef CORRADE_TARGET_UNIX
 #include <unistd.h>
@@ -55,6 +60,38 @@
 
 namespace Corrade { namespace Utility {
 
+namespace Implementation {
+
+namespace {
+    std::atomic<const DebugSinkHooks*> debugSinkHooks{nullptr};
+
+    std::ostream* debugSinkLineOutput(std::ostream* const output) {
+        const DebugSinkHooks* const hooks = debugSinkHooks.load(std::memory_order_acquire);
+        return hooks ? hooks->lineOutput(output) : nullptr;
+    }
+
+    void debugSinkPublishLine() {
+        if(const DebugSinkHooks* const hooks = debugSinkHooks.load(std::memory_order_acquire))
+            hooks->publishLine();
+    }
+
+    std::ostream* debugSinkDestination(std::ostream* const output) {
+        const DebugSinkHooks* const hooks = debugSinkHooks.load(std::memory_order_acquire);
+        return hooks ? hooks->destination(output) : output;
+    }
+
+    void debugSinkFlush() {
+        if(const DebugSinkHooks* const hooks = debugSinkHooks.load(std::memory_order_acquire))
+            hooks->flush();
+    }
+}
+
+void setDebugSinkHooks(const DebugSinkHooks* const hooks) {
+    debugSinkHooks.store(hooks, std::memory_order_release);
+}
+
+}
+
 namespace {
 
 template<class T> inline void toStream(std::ostream& s, const T& value) {
@@ -65,12 +102,49 @@ template<> inline void toStream<Implementation::DebugOstreamFallback>(std::ostre
     value.apply(s);
 }
 
+/* Values that have a binary representation in a trace are recorded directly,
+   everything else is formatted to text */
+template<class T> inline void toTrace(std::ostream& s, const bool space, const T& value) {
+    if(space) s << ' ';
+    toStream(s, value);
+}
+
+inline void toTrace(std::ostream&, const bool space, const std::string& value) {
+    Implementation::debugTraceString(space, value.data(), value.size());
+}
+
+inline void toTrace(std::ostream&, const bool space, const char* const value) {
+    Implementation::debugTraceString(space, value, std::strlen(value));
+}
+
+inline void toTrace(std::ostream&, const bool space, const int value) { Implementation::debugTraceSigned(space, value); }
+inline void toTrace(std::ostream&, const bool space, const long value) { Implementation::debugTraceSigned(space, value); }
+inline void toTrace(std::ostream&, const bool space, const long long value) { Implementation::debugTraceSigned(space, value); }
+inline void toTrace(std::ostream&, const bool space, const unsigned value) { Implementation::debugTraceUnsigned(space, value); }
+inline void toTrace(std::ostream&, const bool space, const unsigned long value) { Implementation::debugTraceUnsigned(space, value); }
+inline void toTrace(std::ostream&, const bool space, const unsigned long long value) { Implementation::debugTraceUnsigned(space, value); }
+inline void toTrace(std::ostream&, const bool space, const float value) { Implementation::debugTraceFloat(space, value); }
+inline void toTrace(std::ostream&, const bool space, const double value) { Implementation::debugTraceDouble(space, value); }
+
 #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
 HANDLE streamOutputHandle(const std::ostream* s) {
     return s == &std::cout ? GetStdHandle(STD_OUTPUT_HANDLE) :
            s == &std::cerr ? GetStdHandle(STD_ERROR_HANDLE) :
            INVALID_HANDLE_VALUE;
 }
+
+/* Traces always record ANSI color indices */
+char ansiColor(const Debug::Color color) {
+    switch(color) {
+        case Debug::Color::Red: return 1;
+        case Debug::Color::Yellow: return 3;
+        case Debug::Color::Blue: return 4;
+        case Debug::Color::Cyan: return 6;
+        default: return char(color);
+    }
+}
+#else
+constexpr char ansiColor(const Debug::Color color) { return char(color); }
 #endif
 
 }
@@ -89,6 +163,15 @@ template<Debug::Color c, bool bold> Debug::Modifier Debug::colorInternal() {
         if(!debug._output || (debug._flags & InternalFlag::DisableColors)) return;
 
         debug._flags |= InternalFlag::ColorWritten|InternalFlag::ValueWritten;
+        if(debug._flags & InternalFlag::Trace) {
+            Implementation::debugTraceColor(ansiColor(c), bold, false);
+            #if !defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_UTILITY_USE_ANSI_COLORS)
+            _globalColor = c;
+            _globalColorBold = bold;
+            #endif
+            return;
+        }
+
         #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
         HANDLE h = streamOutputHandle(debug._output);
         if(h != INVALID_HANDLE_VALUE) SetConsoleTextAttribute(h,
@@ -109,6 +192,17 @@ inline void Debug::resetColorInternal() {
 
     _flags &= ~InternalFlag::ColorWritten;
     _flags |= InternalFlag::ValueWritten;
+    if(_flags & InternalFlag::Trace) {
+        #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
+        Implementation::debugTraceColor(9, false, true);
+        #else
+        Implementation::debugTraceColor(ansiColor(_previousColor), _previousColorBold, true);
+        _globalColor = _previousColor;
+        _globalColorBold = _previousColorBold;
+        #endif
+        return;
+    }
+
     #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
     HANDLE h = streamOutputHandle(_output);
     if(h != INVALID_HANDLE_VALUE)
@@ -176,7 +270,10 @@ std::ostream* Debug::output() { return _globalOutput; }
 std::ostream* Warning::output() { return _globalWarningOutput; }
 std::ostream* Error::output() { return _globalErrorOutput; }
 
-bool Debug::isTty(std::ostream* const output) {
+bool Debug::isTty(std::ostream* output) {
+    /* If the output goes through a sink, query its destination instead */
+    output = Implementation::debugSinkDestination(output);
+
     /* On Windows with WINAPI colors check the stream output handle */
     #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
     return streamOutputHandle(output) != INVALID_HANDLE_VALUE;
@@ -243,7 +340,8 @@ bool Error::isTty() { return Debug::isTty(_globalErrorOutput); }
 Debug::Debug(std::ostream* const output, const Flags flags): _flags{InternalFlag(static_cast<unsigned char>(flags))|InternalFlag::NoSpaceBeforeNextValue} {
     /* Save previous global output and replace it with current one */
     _previousGlobalOutput = _globalOutput;
-    _globalOutput = _output = output;
+    _globalOutput = output;
+    setOutput(output);
 
     /* Save previous global color */
     #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
@@ -262,19 +360,39 @@ Debug::Debug(std::ostream* const output, const Flags flags): _flags{InternalFlag
 Warning::Warning(std::ostream* const output, const Flags flags): Debug{flags} {
     /* Save previous global output and replace it with current one */
     _previousGlobalWarningOutput = _globalWarningOutput;
-    _globalWarningOutput = _output = output;
+    _globalWarningOutput = output;
+    setOutput(output);
 }
 
 Error::Error(std::ostream* const output, const Flags flags): Debug{flags} {
     /* Save previous global output and replace it with current one */
     _previousGlobalErrorOutput = _globalErrorOutput;
-    _globalErrorOutput = _output = output;
+    _globalErrorOutput = output;
+    setOutput(output);
 }
 
 Debug::Debug(const Flags flags): Debug{_globalOutput, flags} {}
 Warning::Warning(const Flags flags): Warning{_globalWarningOutput, flags} {}
 Error::Error(const Flags flags): Error{_globalErrorOutput, flags} {}
 
+void Debug::setOutput(std::ostream* const output) {
+    _flags &= ~(InternalFlag::Sink|InternalFlag::Trace);
+
+    /* If the output is a trace, record the values to a thread-local buffer
+       instead, which gets written as a whole on destruction */
+    if(std::ostream* const recordOutput = Implementation::debugTraceRecordOutput(output)) {
+        _output = recordOutput;
+        _flags |= InternalFlag::Trace;
+
+    /* If the output is a sink, write to a thread-local line buffer instead,
+       which gets published as a whole on destruction */
+    } else if(std::ostream* const lineOutput = Implementation::debugSinkLineOutput(output)) {
+        _output = lineOutput;
+        _flags |= InternalFlag::Sink;
+
+    } else _output = output;
+}
+
 void Debug::cleanupOnDestruction() {
     /* Reset output color */
     resetColorInternal();
@@ -283,6 +401,14 @@ void Debug::cleanupOnDestruction() {
     if(_output && (_flags & InternalFlag::ValueWritten) && !(_flags & InternalFlag::NoNewlineAtTheEnd))
         *_output << std::endl;
 
+    /* Publish the line to the sink */
+    if(_flags & InternalFlag::Sink)
+        Implementation::debugSinkPublishLine();
+
+    /* Write the record to the trace */
+    if(_flags & InternalFlag::Trace)
+        Implementation::debugTracePublishRecord();
+
     /* Reset previous global output */
     _globalOutput = _previousGlobalOutput;
 }
@@ -309,6 +435,11 @@ Fatal::~Fatal() {
     Error::cleanupOnDestruction();
     Debug::cleanupOnDestruction();
 
+    /* Make sure the message gets written if the output goes through a sink
+       or a trace */
+    Implementation::debugSinkFlush();
+    Implementation::debugTraceFlush();
+
     std::exit(_exitCode);
 }
 
@@ -316,11 +447,15 @@ template<class T> Debug& Debug::print(const T& value) {
     if(!_output) return *this;
 
     /* Separate values with spaces, if enabled */
-    if(_flags & InternalFlag::NoSpaceBeforeNextValue)
-        _flags &= ~InternalFlag::NoSpaceBeforeNextValue;
-    else *_output << ' ';
-
-    toStream(*_output, value);
+    const bool space = !(_flags & InternalFlag::NoSpaceBeforeNextValue);
+    _flags &= ~InternalFlag::NoSpaceBeforeNextValue;
+
+    if(_flags & InternalFlag::Trace)
+        toTrace(*_output, space, value);
+    else {
+        if(space) *_output << ' ';
+        toStream(*_output, value);
+    }
 
     _flags |= InternalFlag::ValueWritten;
     return *this;
@@ -329,6 +464,13 @@ template<class T> Debug& Debug::print(const T& value) {
 Debug& Debug::operator<<(const std::string& value) { return print(value); }
 
 Debug& Debug::operator<<(const void* const value) {
+    if(_output && (_flags & InternalFlag::Trace)) {
+        Implementation::debugTracePointer(!(_flags & InternalFlag::NoSpaceBeforeNextValue), value);
+        _flags &= ~InternalFlag::NoSpaceBeforeNextValue;
+        _flags |= InternalFlag::ValueWritten;
+        return *this;
+    }
+
     std::ostringstream o;
     o << "0x" << std::hex << reinterpret_cast<std::uintptr_t>(value);
     return print(o.str());
@@ -344,6 +486,8 @@ Debug& Debug::operator<<(unsigned long value) { return print(value); }
 Debug& Debug::operator<<(unsigned long long value) { return print(value); }
 Debug& Debug::operator<<(float value) {
     if(!_output) return *this;
+    /* Traces record the value and the precision is applied when decoding */
+    if(_flags & InternalFlag::Trace) return print(value);
     /* The default. Source: http://en.cppreference.com/w/cpp/io/ios_base/precision,
        Wikipedia says 6-digit number can be converted back and forth without
        loss: https://en.wikipedia.org/wiki/Single-precision_floating-point_format
@@ -353,6 +497,7 @@ Debug& Debug::operator<<(float value) {
 }
 Debug& Debug::operator<<(double value) {
     if(!_output) return *this;
+    if(_flags & InternalFlag::Trace) return print(value);
     /* Wikipedia says 15-digit number can be converted back and forth without
        loss: https://en.wikipedia.org/wiki/Double-precision_floating-point_format
        Kept in sync with format(). */
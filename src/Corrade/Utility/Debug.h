@@ -447,12 +447,17 @@ class CORRADE_UTILITY_EXPORT Debug {
             DisableColors = 1 << 1,
             NoSpaceBeforeNextValue = 1 << 2,
             ValueWritten = 1 << 3,
-            ColorWritten = 1 << 4
+            ColorWritten = 1 << 4,
+            /* Writing to a thread-local line buffer of a DebugSink */
+            Sink = 1 << 5,
+            /* Recording to a thread-local record of a DebugTrace */
+            Trace = 1 << 6
         };
         typedef Containers::EnumSet<InternalFlag> InternalFlags;
 
         CORRADE_ENUMSET_FRIEND_OPERATORS(InternalFlags)
 
+        CORRADE_UTILITY_LOCAL void setOutput(std::ostream* output); /* Needed for Warning and Error */
         CORRADE_UTILITY_LOCAL void cleanupOnDestruction(); /* Needed for Fatal */
 
         InternalFlags _flags;
@@ -532,19 +537,6 @@ template<class Iterable> Debug& operator<<(typename std::enable_if<IsIterable<It
 }
 
 namespace Implementation {
-    /** @todo C++14: use std::make_index_sequence and std::integer_sequence */
-    template<std::size_t ...> struct Sequence {};
-
-    #ifndef DOXYGEN_GENERATING_OUTPUT
-    /* E.g. GenerateSequence<3>::Type is Sequence<0, 1, 2> */
-    template<std::size_t N, std::size_t ...sequence> struct GenerateSequence:
-        GenerateSequence<N-1, N-1, sequence...> {};
-
-    template<std::size_t ...sequence> struct GenerateSequence<0, sequence...> {
-        typedef Sequence<sequence...> Type;
-    };
-    #endif
-
     /* Used by operator<<(Debug&, std::tuple<>...) */
     template<class T> inline void tupleDebugOutput(Debug&, const T&, Sequence<>) {}
     template<class T, std::size_t i, std::size_t ...sequence> void tupleDebugOutput(Debug& debug, const T& tuple, Sequence<i, sequence...>) {
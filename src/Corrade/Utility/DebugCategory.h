@@ -0,0 +1,236 @@
+#ifndef Corrade_Utility_DebugCategory_h
+#define Corrade_Utility_DebugCategory_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+/** @file
+ * @brief Class @ref Corrade::Utility::DebugCategory, macro @ref CORRADE_LOG(), @ref CORRADE_LOG_EVERY_N(), @ref CORRADE_LOG_MINIMUM_LEVEL
+ */
+
+#include <atomic>
+#include <cstddef>
+
+#include "Corrade/Utility/Assert.h"
+#include "Corrade/Utility/Debug.h"
+
+#ifndef CORRADE_LOG_MINIMUM_LEVEL
+/**
+@brief Minimum compiled-in log level
+
+Numeric value of the lowest @ref Corrade::Utility::DebugCategory::Level "DebugCategory::Level"
+that gets compiled in. @ref CORRADE_LOG() and @ref CORRADE_LOG_EVERY_N()
+statements with a lower level are never executed and their arguments are
+never evaluated. The condition is a compile-time constant, so in optimized
+builds the statements are removed as dead code. Can
+be defined by the user before including the
+@ref Corrade/Utility/DebugCategory.h header, if not defined it's
+@cpp 0 @ce, thus all levels are compiled in:
+
+-   @cpp 0 @ce --- @ref Corrade::Utility::DebugCategory::Level::Verbose "Level::Verbose"
+    and higher
+-   @cpp 1 @ce --- @ref Corrade::Utility::DebugCategory::Level::Debug "Level::Debug"
+    and higher
+-   @cpp 2 @ce --- @ref Corrade::Utility::DebugCategory::Level::Warning "Level::Warning"
+    and higher
+-   @cpp 3 @ce --- @ref Corrade::Utility::DebugCategory::Level::Error "Level::Error"
+    only
+-   @cpp 4 @ce --- nothing
+*/
+#define CORRADE_LOG_MINIMUM_LEVEL 0
+#endif
+
+namespace Corrade { namespace Utility {
+
+/**
+@brief Debug output category
+
+Named category of debug output with a runtime-adjustable verbosity level,
+used together with the @ref CORRADE_LOG() and @ref CORRADE_LOG_EVERY_N()
+macros:
+
+@snippet Utility.cpp DebugCategory
+
+Unlike redirecting @ref Debug to @cpp nullptr @ce, statements filtered out by
+the category level don't evaluate any of their arguments --- the only runtime
+cost is a single relaxed atomic load. Statements below
+@ref CORRADE_LOG_MINIMUM_LEVEL don't even do that and are removed as dead code
+in optimized builds.
+
+The constructor is @cpp constexpr @ce, so global categories are initialized at
+compile time and it's safe to use them from constructors of other global
+objects. The level can be changed at any time from any thread.
+*/
+class DebugCategory {
+    public:
+        /**
+         * @brief Verbosity level
+         *
+         * @see @ref CORRADE_LOG_MINIMUM_LEVEL
+         */
+        enum class Level: unsigned char {
+            /** Verbose output, printed with @ref Utility::Debug */
+            Verbose = 0,
+
+            /** Debug output, printed with @ref Utility::Debug */
+            Debug = 1,
+
+            /** Warning output, printed with @ref Utility::Warning */
+            Warning = 2,
+
+            /** Error output, printed with @ref Utility::Error */
+            Error = 3,
+
+            /**
+             * No output. Can be used only with @ref setLevel() to disable
+             * the category completely.
+             */
+            Off = 4
+        };
+
+        /**
+         * @brief Constructor
+         * @param name      Category name
+         * @param level     Lowest level that gets printed
+         *
+         * The @p name is not copied, expects that it's a global string.
+         */
+        constexpr explicit DebugCategory(const char* name, Level level = Level::Debug) noexcept: _name{name}, _level{static_cast<unsigned char>(level)} {}
+
+        /** @brief Copying is not allowed */
+        DebugCategory(const DebugCategory&) = delete;
+
+        /** @brief Copying is not allowed */
+        DebugCategory& operator=(const DebugCategory&) = delete;
+
+        /** @brief Category name */
+        constexpr const char* name() const { return _name; }
+
+        /** @brief Lowest level that gets printed */
+        Level level() const {
+            return Level(_level.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * @brief Set the lowest level that gets printed
+         *
+         * Use @ref Level::Off to disable the category completely. Levels
+         * below @ref CORRADE_LOG_MINIMUM_LEVEL are not printed regardless of
+         * this setting.
+         */
+        void setLevel(Level level) {
+            _level.store(static_cast<unsigned char>(level), std::memory_order_relaxed);
+        }
+
+        /** @brief Whether given level is printed */
+        bool isEnabled(Level level) const {
+            return static_cast<unsigned char>(level) >= _level.load(std::memory_order_relaxed);
+        }
+
+    private:
+        const char* _name;
+        std::atomic<unsigned char> _level;
+};
+
+namespace Implementation {
+    /* Used by CORRADE_LOG(). A function instead of a plain comparison to
+       avoid constant condition warnings. */
+    #if CORRADE_LOG_MINIMUM_LEVEL > 0
+    constexpr bool debugLevelCompiled(DebugCategory::Level level) {
+        return static_cast<unsigned char>(level) >= CORRADE_LOG_MINIMUM_LEVEL;
+    }
+    #else
+    constexpr bool debugLevelCompiled(DebugCategory::Level) { return true; }
+    #endif
+
+    template<DebugCategory::Level> struct DebugLevelOutput;
+    template<> struct DebugLevelOutput<DebugCategory::Level::Verbose> { typedef Debug Type; };
+    template<> struct DebugLevelOutput<DebugCategory::Level::Debug> { typedef Debug Type; };
+    template<> struct DebugLevelOutput<DebugCategory::Level::Warning> { typedef Warning Type; };
+    template<> struct DebugLevelOutput<DebugCategory::Level::Error> { typedef Error Type; };
+
+    /* Used by CORRADE_LOG_EVERY_N(), one static instance per call site.
+       Trivially constant-initialized, so no guard is needed. */
+    struct DebugSampler {
+        bool next(std::size_t n) {
+            CORRADE_ASSERT(n, "CORRADE_LOG_EVERY_N(): sampling period has to be positive", false);
+            return _count.fetch_add(1, std::memory_order_relaxed) % n == 0;
+        }
+
+        std::atomic<std::size_t> _count;
+    };
+}
+
+}}
+
+/**
+@brief Print debug output for given category and level
+@param category     A @ref Corrade::Utility::DebugCategory "Utility::DebugCategory" instance
+@param level        One of @ref Corrade::Utility::DebugCategory::Level "DebugCategory::Level"
+    values except @cpp Off @ce, without the enum prefix
+
+Expands to a @ref Corrade::Utility::Debug "Utility::Debug" instance for
+@cpp Verbose @ce and @cpp Debug @ce levels, to
+@ref Corrade::Utility::Warning "Utility::Warning" for @cpp Warning @ce and to
+@ref Corrade::Utility::Error "Utility::Error" for @cpp Error @ce, thus
+printing to the usual outputs. If @p level is not enabled for @p category, the
+values passed to the instance are not evaluated at all. If @p level is below
+@ref CORRADE_LOG_MINIMUM_LEVEL, the statement is never executed and is removed
+as dead code in optimized builds.
+
+@snippet Utility.cpp DebugCategory
+
+@see @ref CORRADE_LOG_EVERY_N()
+*/
+#define CORRADE_LOG(category, level)                                        \
+    if(!(Corrade::Utility::Implementation::debugLevelCompiled(Corrade::Utility::DebugCategory::Level::level) && \
+         (category).isEnabled(Corrade::Utility::DebugCategory::Level::level))) {} \
+    else Corrade::Utility::Implementation::DebugLevelOutput<Corrade::Utility::DebugCategory::Level::level>::Type{}
+
+/**
+@brief Print sampled debug output for given category and level
+@param category     A @ref Corrade::Utility::DebugCategory "Utility::DebugCategory" instance
+@param level        One of @ref Corrade::Utility::DebugCategory::Level "DebugCategory::Level"
+    values except @cpp Off @ce, without the enum prefix
+@param n            Sampling period, has to be positive
+
+Same as @ref CORRADE_LOG(), but prints only the first of each @p n
+executions of given statement, counted across all threads. Useful for noisy
+call sites such as per-frame or per-item diagnostics. Executions filtered out
+by the @p category level are not counted. Passing zero as @p n is an
+assertion failure.
+
+@snippet Utility.cpp DebugCategory-sampling
+*/
+#define CORRADE_LOG_EVERY_N(category, level, n)                             \
+    if(!(Corrade::Utility::Implementation::debugLevelCompiled(Corrade::Utility::DebugCategory::Level::level) && \
+         (category).isEnabled(Corrade::Utility::DebugCategory::Level::level) && \
+         [&]() -> bool {                                                    \
+            static Corrade::Utility::Implementation::DebugSampler sampler;  \
+            return sampler.next(n);                                         \
+         }())) {}                                                           \
+    else Corrade::Utility::Implementation::DebugLevelOutput<Corrade::Utility::DebugCategory::Level::level>::Type{}
+
+#endif
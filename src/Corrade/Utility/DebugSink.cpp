@@ -0,0 +1,387 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "DebugSink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#include "Corrade/Containers/Array.h"
+#include "Corrade/Utility/Assert.h"
+#include "Corrade/Utility/Debug.h"
+#include "Corrade/Utility/Implementation/debugSink.h"
+
+namespace Corrade { namespace Utility {
+
+namespace {
+
+/* One ring buffer slot, sized to a cache line. A line spanning multiple
+   slots has the slot count stored in the first one. */
+struct Slot {
+    std::atomic<std::size_t> sequence;
+    std::uint16_t count;
+    std::uint16_t size;
+    char data[64 - sizeof(std::size_t) - 2*sizeof(std::uint16_t)];
+};
+
+static_assert(sizeof(Slot) == 64, "improper size of the ring buffer slot");
+
+enum: std::size_t {
+    SlotDataSize = sizeof(Slot::data),
+    /* The background thread writes to the destination after gathering this
+       many bytes, even if there's more data in the ring */
+    MaxBatchSize = 64*1024
+};
+
+struct Sink;
+
+/* Line buffer used by Debug instances writing to the sink. The line is kept
+   in a fixed-size array, only overly long lines spill into a heap-allocated
+   string. */
+class LineBuffer: public std::streambuf {
+    public:
+        /* If sink is null, the active one is used. If publishOnSync is set,
+           the contents are published on each flush, otherwise only on
+           explicit publish(). */
+        explicit LineBuffer(Sink* sink, bool publishOnSync): _sink{sink}, _publishOnSync{publishOnSync} {
+            setp(_storage, _storage + sizeof(_storage));
+        }
+
+        void publish();
+
+    private:
+        int_type overflow(int_type c) override {
+            _spill.append(pbase(), pptr() - pbase());
+            setp(_storage, _storage + sizeof(_storage));
+            if(!traits_type::eq_int_type(c, traits_type::eof()))
+                _spill += traits_type::to_char_type(c);
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override {
+            if(_publishOnSync) publish();
+            return 0;
+        }
+
+        Sink* _sink;
+        bool _publishOnSync;
+        std::string _spill;
+        char _storage[512];
+};
+
+struct Sink {
+    explicit Sink(std::ostream& destination, std::size_t slotCount);
+
+    void publish(const char* data, std::size_t size);
+    void wake();
+    bool drain();
+    void run();
+    void flush();
+
+    std::ostream& destination;
+    Containers::Array<Slot> slots;
+    const std::size_t mask;
+    /* Longer lines are split, so a single line can't fill the whole ring */
+    const std::size_t maxRecordSlots;
+
+    /* Producer side. Each thread reserves a range of slots by advancing the
+       head with a compare-and-swap and then commits the slots by updating
+       their sequence numbers. */
+    std::atomic<std::size_t> head{0};
+
+    /* Consumer side. Tail is touched only by the background thread, consumed
+       is published for flush(). */
+    std::size_t tail{0};
+    std::atomic<std::size_t> consumed{0};
+    std::string batch;
+
+    /* Waking up the background thread. The producers lock the mutex only if
+       the background thread is sleeping. */
+    std::atomic<bool> sleeping{false};
+    bool woken{false};
+    bool stopping{false};
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable flushedCondition;
+
+    /* Stream for Debug output redirection and for direct writes */
+    LineBuffer outputBuffer;
+    std::ostream output;
+
+    std::thread thread;
+};
+
+std::atomic<Sink*> activeSink{nullptr};
+
+Sink::Sink(std::ostream& destination, const std::size_t slotCount): destination(destination), slots{Containers::ValueInit, slotCount}, mask{slotCount - 1}, maxRecordSlots{std::min<std::size_t>(slotCount/2, 0xffff)}, outputBuffer{this, true}, output{&outputBuffer} {
+    /* A slot at given position is free if its sequence number is equal to the
+       position, after being filled it's set to position + 1 and after being
+       consumed to position + slot count */
+    for(std::size_t i = 0; i != slots.size(); ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+void Sink::publish(const char* data, std::size_t size) {
+    while(size) {
+        const std::size_t chunkSize = std::min(size, maxRecordSlots*SlotDataSize);
+        const std::size_t count = (chunkSize + SlotDataSize - 1)/SlotDataSize;
+
+        /* Reserve count consecutive slots. The slots are consumed in order,
+           so if the last one is free, all before it are free as well. */
+        std::size_t position = head.load(std::memory_order_relaxed);
+        for(;;) {
+            const std::size_t last = position + count - 1;
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(slots[last & mask].sequence.load(std::memory_order_acquire) - last);
+            if(difference == 0) {
+                if(head.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                    break;
+
+            /* The ring is full, wait until the background thread makes space
+               for us */
+            } else if(difference < 0) {
+                wake();
+                std::this_thread::yield();
+                position = head.load(std::memory_order_relaxed);
+
+            /* Another thread reserved the slots before us */
+            } else position = head.load(std::memory_order_relaxed);
+        }
+
+        for(std::size_t i = 0; i != count; ++i) {
+            Slot& slot = slots[(position + i) & mask];
+            const std::size_t slotSize = std::min<std::size_t>(chunkSize - i*SlotDataSize, SlotDataSize);
+            slot.count = i ? 0 : count;
+            slot.size = slotSize;
+            std::memcpy(slot.data, data + i*SlotDataSize, slotSize);
+        }
+
+        /* Commit the first slot last, the consumer looks only at that one.
+           Sequentially consistent so it's ordered with the load of the
+           sleeping flag below. */
+        for(std::size_t i = count - 1; i != 0; --i)
+            slots[(position + i) & mask].sequence.store(position + i + 1, std::memory_order_release);
+        slots[position & mask].sequence.store(position + 1, std::memory_order_seq_cst);
+
+        data += chunkSize;
+        size -= chunkSize;
+    }
+
+    if(sleeping.load(std::memory_order_seq_cst)) wake();
+}
+
+void Sink::wake() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        woken = true;
+    }
+    wakeCondition.notify_one();
+}
+
+bool Sink::drain() {
+    batch.clear();
+    std::size_t position = tail;
+    while(batch.size() < MaxBatchSize) {
+        Slot& first = slots[position & mask];
+        if(first.sequence.load(std::memory_order_acquire) != position + 1)
+            break;
+
+        /* Copy the line out and immediately free the slots so the producers
+           can continue while we're writing */
+        const std::size_t count = first.count;
+        for(std::size_t i = 0; i != count; ++i) {
+            Slot& slot = slots[(position + i) & mask];
+            batch.append(slot.data, slot.size);
+            slot.sequence.store(position + i + slots.size(), std::memory_order_release);
+        }
+
+        position += count;
+    }
+
+    if(position == tail) return false;
+
+    destination.write(batch.data(), batch.size());
+    destination.flush();
+    tail = position;
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        consumed.store(position, std::memory_order_release);
+    }
+    flushedCondition.notify_all();
+    return true;
+}
+
+void Sink::run() {
+    for(;;) {
+        if(drain()) continue;
+
+        std::unique_lock<std::mutex> lock{mutex};
+        if(stopping) break;
+
+        /* Announce we're going to sleep and check the ring again, a producer
+           that committed before seeing the flag would not wake us up */
+        sleeping.store(true, std::memory_order_seq_cst);
+        if(slots[tail & mask].sequence.load(std::memory_order_seq_cst) == tail + 1) {
+            sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        wakeCondition.wait(lock, [this]{ return woken || stopping; });
+        sleeping.store(false, std::memory_order_relaxed);
+        woken = false;
+    }
+}
+
+void Sink::flush() {
+    /* Everything reserved so far. Slots that are reserved but not committed
+       yet will get committed eventually. */
+    const std::size_t target = head.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> lock{mutex};
+    woken = true;
+    wakeCondition.notify_one();
+    flushedCondition.wait(lock, [&]{
+        return consumed.load(std::memory_order_acquire) >= target;
+    });
+}
+
+void LineBuffer::publish() {
+    Sink* const sink = _sink ? _sink : activeSink.load(std::memory_order_acquire);
+
+    if(sink) {
+        if(_spill.empty())
+            sink->publish(pbase(), pptr() - pbase());
+        else {
+            _spill.append(pbase(), pptr() - pbase());
+            sink->publish(_spill.data(), _spill.size());
+        }
+    }
+
+    _spill.clear();
+    setp(_storage, _storage + sizeof(_storage));
+}
+
+struct LineStream {
+    LineBuffer buffer{nullptr, false};
+    std::ostream stream{&buffer};
+};
+
+LineStream& threadLineStream() {
+    thread_local LineStream stream;
+    return stream;
+}
+
+std::ostream* debugSinkLineOutput(std::ostream* const output) {
+    Sink* const sink = activeSink.load(std::memory_order_acquire);
+    if(!sink || output != &sink->output) return nullptr;
+    return &threadLineStream().stream;
+}
+
+void debugSinkPublishLine() {
+    threadLineStream().buffer.publish();
+}
+
+std::ostream* debugSinkDestination(std::ostream* const output) {
+    Sink* const sink = activeSink.load(std::memory_order_acquire);
+    if(!sink || output != &sink->output) return output;
+    return &sink->destination;
+}
+
+void debugSinkFlush() {
+    if(Sink* const sink = activeSink.load(std::memory_order_acquire))
+        sink->flush();
+}
+
+/* Installed into Debug for as long as the sink is active */
+const Implementation::DebugSinkHooks debugSinkHooks{
+    debugSinkLineOutput,
+    debugSinkPublishLine,
+    debugSinkDestination,
+    debugSinkFlush
+};
+
+}
+
+struct DebugSink::State: Sink {
+    using Sink::Sink;
+};
+
+DebugSink::DebugSink(std::ostream& destination, const std::size_t capacity) {
+    /* Power-of-two slot count, at least 16 slots */
+    std::size_t slotCount = 16;
+    while(slotCount*sizeof(Slot) < capacity) slotCount *= 2;
+    _state.reset(new State{destination, slotCount});
+
+    /* Done outside of the assert so the sink gets activated even with
+       CORRADE_NO_ASSERT */
+    Sink* expected = nullptr;
+    const bool activated = activeSink.compare_exchange_strong(expected, _state.get());
+    static_cast<void>(activated);
+    CORRADE_ASSERT(activated,
+        "Utility::DebugSink: only one sink can be active at a time", );
+
+    _state->thread = std::thread{&Sink::run, _state.get()};
+    if(activated) Implementation::setDebugSinkHooks(&debugSinkHooks);
+}
+
+DebugSink::~DebugSink() {
+    /* Flush the output stream in case it was written to directly */
+    _state->output.flush();
+
+    {
+        std::lock_guard<std::mutex> lock{_state->mutex};
+        _state->stopping = true;
+    }
+    _state->wakeCondition.notify_one();
+    if(_state->thread.joinable()) _state->thread.join();
+
+    /* Write whatever was published after the thread exited */
+    while(_state->drain());
+
+    Sink* expected = _state.get();
+    if(activeSink.compare_exchange_strong(expected, nullptr))
+        Implementation::setDebugSinkHooks(nullptr);
+}
+
+std::ostream* DebugSink::output() { return &_state->output; }
+
+std::ostream& DebugSink::destination() { return _state->destination; }
+
+std::size_t DebugSink::capacity() const { return _state->slots.size()*sizeof(Slot); }
+
+void DebugSink::flush() {
+    _state->output.flush();
+    _state->flush();
+}
+
+}}
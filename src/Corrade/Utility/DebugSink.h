@@ -0,0 +1,164 @@
+#ifndef Corrade_Utility_DebugSink_h
+#define Corrade_Utility_DebugSink_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Corrade::Utility::DebugSink
+ */
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "Corrade/Containers/Pointer.h"
+#include "Corrade/Utility/Utility.h"
+#include "Corrade/Utility/visibility.h"
+
+namespace Corrade { namespace Utility {
+
+/**
+@brief Buffered multi-threaded sink for debug output
+
+By default, each @ref Debug, @ref Warning or @ref Error instance writes its
+values directly to the output stream, which means output from multiple threads
+can get interleaved in the middle of a line and each line is a (potentially
+blocking) write to the underlying file or terminal. The sink solves both
+problems --- pass @ref output() to the usual scoped output redirection and
+all @ref Debug instances created with that output will accumulate their
+whole line in a thread-local buffer and publish it as a single unit on
+destruction. The lines are then written to @ref destination() in batches from
+a dedicated background thread:
+
+@snippet Utility.cpp DebugSink
+
+Existing @cpp Debug{} @ce call sites don't need to be changed, the sink is used
+for all instances that use the redirected global output, from any thread.
+
+@section Utility-DebugSink-behavior Behavior
+
+Published lines are stored in a fixed-size ring buffer, the capacity of which
+can be specified in the constructor. Publishing a line is lock-free --- it's
+just a compare-and-swap reserving space in the ring followed by a copy of the
+line contents. If the ring is full, the publishing thread waits until the
+background thread makes space for it, thus no output is ever lost. A line that
+doesn't fit into half of the ring is split into multiple parts, which may get
+interleaved with lines from other threads.
+
+Lines coming from a single thread are always written in the order they were
+published. Lines from different threads are written in the order they reserved
+space in the ring. The background thread is woken up when new data arrive,
+call @ref flush() to wait until everything published so far is written to
+@ref destination(). Destructing the sink flushes all remaining output. A
+@ref Fatal instance flushes the sink before exiting the application, so the
+last message doesn't get lost.
+
+@attention The sink has to outlive all @ref Debug instances that use it,
+    including ones created in other threads. Only one sink can be active at a
+    time. Writing to @ref output() directly instead of through @ref Debug is
+    possible as well, but the data are published only on each
+    @ref std::ostream::flush() and thus such writes are not safe to do from
+    multiple threads.
+
+Because @ref destination() is written to from a different thread, WINAPI-based
+coloring on Windows is not available when the sink is used; ANSI color codes
+work as usual. @ref Debug::isTty() queries the @ref destination() when called
+with @ref output().
+
+@section Utility-DebugSink-cmake Usage with CMake
+
+Because of the background thread, the sink is in a separate library, so
+users of the rest of the @ref Utility library don't need to link to the system
+threading library. Request the `DebugSink` component of the `Corrade` package
+and link to the `Corrade::DebugSink` target:
+
+@code{.cmake}
+find_package(Corrade REQUIRED DebugSink)
+
+# ...
+target_link_libraries(your-app PRIVATE Corrade::DebugSink)
+@endcode
+*/
+class CORRADE_DEBUGSINK_EXPORT DebugSink {
+    public:
+        /**
+         * @brief Constructor
+         * @param destination   Stream to write the output to
+         * @param capacity      Ring buffer capacity in bytes. Rounded up to a
+         *      power-of-two multiple of 64 bytes, at least 1 kB.
+         *
+         * Starts the background thread. Expects that no other sink is active.
+         */
+        explicit DebugSink(std::ostream& destination, std::size_t capacity = 256*1024);
+
+        /** @brief Copying is not allowed */
+        DebugSink(const DebugSink&) = delete;
+
+        /** @brief Moving is not allowed */
+        DebugSink(DebugSink&&) = delete;
+
+        /**
+         * @brief Destructor
+         *
+         * Writes all remaining output to @ref destination() and stops the
+         * background thread.
+         */
+        ~DebugSink();
+
+        /** @brief Copying is not allowed */
+        DebugSink& operator=(const DebugSink&) = delete;
+
+        /** @brief Moving is not allowed */
+        DebugSink& operator=(DebugSink&&) = delete;
+
+        /**
+         * @brief Output stream
+         *
+         * Pass this to the @ref Debug, @ref Warning or @ref Error constructor
+         * to redirect the output through the sink.
+         */
+        std::ostream* output();
+
+        /** @brief Destination stream */
+        std::ostream& destination();
+
+        /** @brief Ring buffer capacity in bytes */
+        std::size_t capacity() const;
+
+        /**
+         * @brief Flush the output
+         *
+         * Blocks until all lines published before this call are written to
+         * @ref destination() and the destination is flushed.
+         */
+        void flush();
+
+    private:
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
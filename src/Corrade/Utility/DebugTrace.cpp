@@ -0,0 +1,392 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "DebugTrace.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/Utility/Assert.h"
+#include "Corrade/Utility/Debug.h"
+#include "Corrade/Utility/Endianness.h"
+
+namespace Corrade { namespace Utility {
+
+namespace {
+
+/* Magic and version, written at the start of the trace */
+constexpr const char Header[]{'C', 'R', 'T', 'R', 'A', 'C', 'E', '\x01'};
+
+/* Each entry starts with a tag byte, the highest bit of which says whether
+   the value is preceded by a space. Text and String are followed by a
+   variable-length size and the data, Signed, Unsigned and Pointer by a
+   variable-length (zigzag-encoded for Signed) integer, Float and Double by
+   a little-endian IEEE 754 value, Color and ResetColor by a byte with the
+   ANSI color index in the lower bits and the highest bit set if bold. */
+enum Tag: std::uint8_t {
+    Text = 0,
+    String = 1,
+    Signed = 2,
+    Unsigned = 3,
+    Float = 4,
+    Double = 5,
+    Pointer = 6,
+    Color = 7,
+    ResetColor = 8,
+
+    SpaceBefore = 0x80
+};
+
+void appendVarint(std::string& out, std::uint64_t value) {
+    while(value >= 0x80) {
+        out += char(value|0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+struct Trace;
+
+/* Record of a single Debug instance. Text written through the stream is
+   gathered and recorded as a single entry right before the next value. */
+class RecordBuffer: public std::streambuf {
+    public:
+        /* If trace is null, the active one is used. If publishOnSync is
+           set, the contents are published on each flush, otherwise only on
+           explicit publish(). */
+        explicit RecordBuffer(Trace* trace, bool publishOnSync): _trace{trace}, _publishOnSync{publishOnSync} {}
+
+        void beginEntry(Tag tag, bool space) {
+            flushText();
+            _record += char(tag|(space ? SpaceBefore : 0));
+        }
+
+        std::string& record() { return _record; }
+
+        void publish();
+
+    private:
+        void flushText() {
+            if(_text.empty()) return;
+            _record += char(Text);
+            appendVarint(_record, _text.size());
+            _record += _text;
+            _text.clear();
+        }
+
+        int_type overflow(int_type c) override {
+            if(!traits_type::eq_int_type(c, traits_type::eof()))
+                _text += traits_type::to_char_type(c);
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char* data, std::streamsize size) override {
+            _text.append(data, size);
+            return size;
+        }
+
+        int sync() override {
+            if(_publishOnSync) publish();
+            return 0;
+        }
+
+        Trace* _trace;
+        bool _publishOnSync;
+        std::string _record, _text;
+};
+
+struct Trace {
+    explicit Trace(std::ostream& destination): destination(destination), outputBuffer{this, true}, output{&outputBuffer} {}
+
+    void write(const std::string& record) {
+        std::lock_guard<std::mutex> lock{mutex};
+        destination.write(record.data(), record.size());
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock{mutex};
+        destination.flush();
+    }
+
+    std::ostream& destination;
+    std::mutex mutex;
+
+    /* Stream for Debug output redirection and for direct writes */
+    RecordBuffer outputBuffer;
+    std::ostream output;
+};
+
+std::atomic<Trace*> activeTrace{nullptr};
+
+void RecordBuffer::publish() {
+    flushText();
+    if(_record.empty()) return;
+
+    if(Trace* const trace = _trace ? _trace : activeTrace.load(std::memory_order_acquire))
+        trace->write(_record);
+
+    _record.clear();
+}
+
+struct RecordStream {
+    RecordBuffer buffer{nullptr, false};
+    std::ostream stream{&buffer};
+};
+
+RecordStream& threadRecordStream() {
+    thread_local RecordStream stream;
+    return stream;
+}
+
+/* Writes an ANSI color escape sequence, the same as Debug does. Index 9 is
+   the default color. */
+void writeColor(std::ostream& out, const char color, const bool bold, const bool reset) {
+    if(reset && color == 9 && !bold) {
+        out << "\033[0m";
+        return;
+    }
+
+    const char code[]{'\033', '[', bold ? '1' : '0', ';', '3', char('0' + color), 'm'};
+    out.write(code, sizeof(code));
+}
+
+}
+
+struct DebugTrace::State: Trace {
+    using Trace::Trace;
+};
+
+DebugTrace::DebugTrace(std::ostream& destination): _state{new State{destination}} {
+    /* The exchange can't be a part of the assert expression, which is
+       compiled out with CORRADE_NO_ASSERT */
+    Trace* expected = nullptr;
+    const bool activated = activeTrace.compare_exchange_strong(expected, _state.get());
+    static_cast<void>(activated);
+    CORRADE_ASSERT(activated,
+        "Utility::DebugTrace: only one trace can be active at a time", );
+
+    destination.write(Header, sizeof(Header));
+}
+
+DebugTrace::~DebugTrace() {
+    flush();
+
+    Trace* expected = _state.get();
+    activeTrace.compare_exchange_strong(expected, nullptr);
+}
+
+std::ostream* DebugTrace::output() { return &_state->output; }
+
+std::ostream& DebugTrace::destination() { return _state->destination; }
+
+void DebugTrace::flush() {
+    _state->output.flush();
+    _state->flush();
+}
+
+bool DebugTrace::decode(const Containers::ArrayView<const char> data, std::ostream& out) {
+    if(data.size() < sizeof(Header) || std::memcmp(data.data(), Header, sizeof(Header)) != 0) {
+        Error() << "Utility::DebugTrace::decode(): invalid header";
+        return false;
+    }
+
+    const char* i = data.begin() + sizeof(Header);
+    const char* const end = data.end();
+
+    /* Returns false if the data end prematurely or the value is too long */
+    auto readVarint = [&](std::uint64_t& value) {
+        value = 0;
+        for(std::size_t shift = 0; shift < 64; shift += 7) {
+            if(i == end) return false;
+            const std::uint8_t byte = *i++;
+            value |= std::uint64_t(byte & 0x7f) << shift;
+            if(!(byte & 0x80)) return true;
+        }
+        return false;
+    };
+    auto readFixed = [&](void* value, std::size_t size) {
+        if(std::size_t(end - i) < size) return false;
+        std::memcpy(value, i, size);
+        i += size;
+        return true;
+    };
+
+    while(i != end) {
+        const std::uint8_t tag = *i++;
+        const std::size_t offset = i - data.begin() - 1;
+
+        if(tag & SpaceBefore) out << ' ';
+
+        bool ok = true;
+        switch(Tag(tag & ~SpaceBefore)) {
+            case Text:
+            case String: {
+                std::uint64_t size;
+                if(!(ok = readVarint(size) && std::uint64_t(end - i) >= size)) break;
+                out.write(i, size);
+                i += size;
+            } break;
+
+            case Signed: {
+                std::uint64_t value;
+                if(!(ok = readVarint(value))) break;
+                out << static_cast<long long>((value >> 1) ^ -static_cast<std::int64_t>(value & 1));
+            } break;
+
+            case Unsigned: {
+                std::uint64_t value;
+                if(!(ok = readVarint(value))) break;
+                out << static_cast<unsigned long long>(value);
+            } break;
+
+            case Float: {
+                std::uint32_t bits;
+                if(!(ok = readFixed(&bits, sizeof(bits)))) break;
+                Endianness::littleEndianInPlace(bits);
+                float value;
+                std::memcpy(&value, &bits, sizeof(bits));
+                /* Same precision as in Debug::operator<<(float) */
+                out << std::setprecision(6) << value;
+            } break;
+
+            case Double: {
+                std::uint64_t bits;
+                if(!(ok = readFixed(&bits, sizeof(bits)))) break;
+                Endianness::littleEndianInPlace(bits);
+                double value;
+                std::memcpy(&value, &bits, sizeof(bits));
+                /* Same precision as in Debug::operator<<(double) */
+                out << std::setprecision(15) << value;
+            } break;
+
+            case Pointer: {
+                std::uint64_t value;
+                if(!(ok = readVarint(value))) break;
+                const std::ios::fmtflags flags = out.flags();
+                out << "0x" << std::hex << value;
+                out.flags(flags);
+            } break;
+
+            case Color:
+            case ResetColor: {
+                if(!(ok = i != end)) break;
+                const std::uint8_t value = *i++;
+                writeColor(out, value & 0x7f, value & 0x80, (tag & ~SpaceBefore) == ResetColor);
+            } break;
+
+            default:
+                Error() << "Utility::DebugTrace::decode(): unknown entry" << (tag & ~SpaceBefore) << "at offset" << offset;
+                return false;
+        }
+
+        if(!ok) {
+            Error() << "Utility::DebugTrace::decode(): entry at offset" << offset << "is truncated";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+namespace Implementation {
+
+std::ostream* debugTraceRecordOutput(std::ostream* const output) {
+    Trace* const trace = activeTrace.load(std::memory_order_acquire);
+    if(!trace || output != &trace->output) return nullptr;
+    return &threadRecordStream().stream;
+}
+
+void debugTraceSigned(const bool space, const long long value) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(Signed, space);
+    /* Zigzag encoding so small negative values are short as well */
+    appendVarint(buffer.record(), (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63));
+}
+
+void debugTraceUnsigned(const bool space, const unsigned long long value) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(Unsigned, space);
+    appendVarint(buffer.record(), value);
+}
+
+void debugTraceFloat(const bool space, const float value) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(Float, space);
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Endianness::littleEndianInPlace(bits);
+    buffer.record().append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+void debugTraceDouble(const bool space, const double value) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(Double, space);
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Endianness::littleEndianInPlace(bits);
+    buffer.record().append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+void debugTracePointer(const bool space, const void* const value) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(Pointer, space);
+    appendVarint(buffer.record(), reinterpret_cast<std::uintptr_t>(value));
+}
+
+void debugTraceString(const bool space, const char* const data, const std::size_t size) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(String, space);
+    appendVarint(buffer.record(), size);
+    buffer.record().append(data, size);
+}
+
+void debugTraceColor(const char color, const bool bold, const bool reset) {
+    RecordBuffer& buffer = threadRecordStream().buffer;
+    buffer.beginEntry(reset ? ResetColor : Color, false);
+    buffer.record() += char(color|(bold ? 0x80 : 0));
+}
+
+void debugTracePublishRecord() {
+    threadRecordStream().buffer.publish();
+}
+
+void debugTraceFlush() {
+    if(Trace* const trace = activeTrace.load(std::memory_order_acquire)) {
+        trace->output.flush();
+        trace->flush();
+    }
+}
+
+}
+
+}}
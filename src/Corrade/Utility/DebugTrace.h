@@ -0,0 +1,165 @@
+#ifndef Corrade_Utility_DebugTrace_h
+#define Corrade_Utility_DebugTrace_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Corrade::Utility::DebugTrace
+ */
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "Corrade/Containers/Pointer.h"
+#include "Corrade/Utility/Utility.h"
+#include "Corrade/Utility/visibility.h"
+
+namespace Corrade { namespace Utility {
+
+/**
+@brief Binary trace output for debug output
+
+Instead of formatting the values passed to @ref Debug, @ref Warning or
+@ref Error into text, the trace records them in a compact binary form and
+leaves the formatting to an offline decoder. Pass @ref output() to the usual
+scoped output redirection and all @ref Debug instances created with that
+output will record their values to @ref destination():
+
+@snippet Utility.cpp DebugTrace
+
+The trace can be then converted to text using @ref decode() or the
+@ref corrade-trace "corrade-trace" utility. The decoded text is the same as
+the output of @ref Debug would be when writing to a stream directly.
+
+@section Utility-DebugTrace-values Recorded values
+
+Integers, @cpp float @ce and @cpp double @ce values, pointers, strings and
+colors set with @ref Debug::color(), @ref Debug::boldColor() or
+@ref Debug::resetColor() are recorded directly, without any formatting.
+Integers and pointers are stored as variable-length integers, strings are
+copied verbatim. All other values, such as @cpp long double @ce or types
+printed through their @ref std::ostream @cpp operator<<() @ce, are formatted
+to text when recorded, so custom @ref operator<<(Debug&, const T&)
+implementations work without any change.
+
+Each @ref Debug instance accumulates its whole line in a thread-local buffer
+and writes it to @ref destination() as a single unit on destruction, so lines
+from different threads don't get interleaved. Colors are always recorded as
+ANSI escape sequences, regardless of the platform the trace was recorded on.
+
+@attention The trace has to outlive all @ref Debug instances that use it,
+    including ones created in other threads. Only one trace can be active at
+    a time.
+
+@see @ref DebugSink
+*/
+class CORRADE_UTILITY_EXPORT DebugTrace {
+    public:
+        /**
+         * @brief Decode a trace to text
+         *
+         * Writes the text output corresponding to given trace data to @p out.
+         * If the data are not a valid trace, prints a message to
+         * @ref Error and returns @cpp false @ce.
+         */
+        static bool decode(Containers::ArrayView<const char> data, std::ostream& out);
+
+        /**
+         * @brief Constructor
+         * @param destination   Stream to write the trace to
+         *
+         * Writes a trace header to @p destination. Expects that no other trace
+         * is active. The stream should be opened in binary mode.
+         */
+        explicit DebugTrace(std::ostream& destination);
+
+        /** @brief Copying is not allowed */
+        DebugTrace(const DebugTrace&) = delete;
+
+        /** @brief Moving is not allowed */
+        DebugTrace(DebugTrace&&) = delete;
+
+        /**
+         * @brief Destructor
+         *
+         * Flushes the @ref destination().
+         */
+        ~DebugTrace();
+
+        /** @brief Copying is not allowed */
+        DebugTrace& operator=(const DebugTrace&) = delete;
+
+        /** @brief Moving is not allowed */
+        DebugTrace& operator=(DebugTrace&&) = delete;
+
+        /**
+         * @brief Output stream
+         *
+         * Pass this to the @ref Debug, @ref Warning or @ref Error constructor
+         * to redirect the output to the trace. Text written to this stream
+         * directly is recorded as-is on each @ref std::ostream::flush().
+         */
+        std::ostream* output();
+
+        /** @brief Destination stream */
+        std::ostream& destination();
+
+        /**
+         * @brief Flush the output
+         *
+         * Records text written to @ref output() directly and flushes the
+         * @ref destination().
+         */
+        void flush();
+
+    private:
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+namespace Implementation {
+    /* Used by Debug, returns a thread-local record stream if output is the
+       active trace output or nullptr otherwise. Text written to the stream is
+       recorded as-is. */
+    CORRADE_UTILITY_EXPORT std::ostream* debugTraceRecordOutput(std::ostream* output);
+    /* Record a value to the thread-local record, optionally preceded by a
+       space */
+    CORRADE_UTILITY_EXPORT void debugTraceSigned(bool space, long long value);
+    CORRADE_UTILITY_EXPORT void debugTraceUnsigned(bool space, unsigned long long value);
+    CORRADE_UTILITY_EXPORT void debugTraceFloat(bool space, float value);
+    CORRADE_UTILITY_EXPORT void debugTraceDouble(bool space, double value);
+    CORRADE_UTILITY_EXPORT void debugTracePointer(bool space, const void* value);
+    CORRADE_UTILITY_EXPORT void debugTraceString(bool space, const char* data, std::size_t size);
+    /* Record an ANSI color change or reset to the thread-local record */
+    CORRADE_UTILITY_EXPORT void debugTraceColor(char color, bool bold, bool reset);
+    /* Writes contents of the thread-local record to the trace */
+    CORRADE_UTILITY_EXPORT void debugTracePublishRecord();
+    /* Flushes the active trace, if any */
+    CORRADE_UTILITY_EXPORT void debugTraceFlush();
+}
+
+}}
+
+#endif
@@ -199,13 +199,15 @@ bool rm(const std::string& path) {
 }
 
 bool move(const std::string& oldPath, const std::string& newPath) {
-    return
-        #ifndef CORRADE_TARGET_WINDOWS
-        std::rename(oldPath.data(), newPath.data())
-        #else
-        _wrename(widen(oldPath).data(), widen(newPath).data())
-        #endif
-        == 0;
+    /* _wrename() fails if the destination exists, unlike rename() on POSIX
+       which replaces it atomically, so MoveFileExW() is used on all Windows
+       flavors. Copying is allowed to keep the ability of _wrename() to move
+       files across volumes. */
+    #ifndef CORRADE_TARGET_WINDOWS
+    return std::rename(oldPath.data(), newPath.data()) == 0;
+    #else
+    return MoveFileExW(widen(oldPath).data(), widen(newPath).data(), MOVEFILE_REPLACE_EXISTING|MOVEFILE_COPY_ALLOWED) != 0;
+    #endif
 }
 
 bool exists(const std::string& filename) {
@@ -516,7 +518,11 @@ bool write(const std::string& filename, const Containers::ArrayView<const void>
 
     Containers::ScopeGuard exit{f, std::fclose};
 
-    std::fwrite(data, 1, data.size(), f);
+    if(std::fwrite(data, 1, data.size(), f) != data.size()) {
+        Error{} << "Utility::Directory::write(): can't write to" << filename;
+        return false;
+    }
+
     return true;
 }
 
@@ -195,7 +195,10 @@ CORRADE_UTILITY_EXPORT bool rm(const std::string& path);
 @brief Move given file or directory
 
 Returns @cpp true @ce on success, @cpp false @ce otherwise. Expects that the
-paths are in UTF-8.
+paths are in UTF-8. If @p newPath is an existing file, it's replaced. On Unix
+and Windows the replacement is atomic when both paths are on the same
+filesystem, so it can be used to safely update a file by writing a temporary
+copy first.
 @see @ref read(), @ref write()
 */
 CORRADE_UTILITY_EXPORT bool move(const std::string& oldPath, const std::string& newPath);
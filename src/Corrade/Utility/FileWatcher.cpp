@@ -25,19 +25,95 @@
 
 #include "FileWatcher.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <unordered_map>
+#include <vector>
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include "Corrade/Containers/Array.h"
+#include "Corrade/Utility/Assert.h"
 #include "Corrade/Utility/Debug.h"
+#include "Corrade/Utility/Directory.h"
+#include "Corrade/Utility/System.h"
+#include "Corrade/Utility/XXHash3.h"
 
 #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)
 #include "Corrade/Utility/Unicode.h"
 #endif
 
+#if defined(__linux__)
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#define CORRADE_FILEWATCHER_INOTIFY
+#endif
+
 namespace Corrade { namespace Utility {
 
+namespace {
+
+#if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+typedef std::string NativeString;
+#elif defined(CORRADE_TARGET_WINDOWS)
+typedef std::wstring NativeString;
+#else
+#error
+#endif
+
+enum class PathType: std::uint8_t { File, Directory, Other };
+
+/* Returns false and leaves errno set if the file can't be queried. If type
+   is not null, it's filled with type of the path. Symlinks to directories
+   are reported as PathType::Other so recursive traversal doesn't end up in
+   a loop. */
+bool modificationTime(const NativeString& filename, std::uint64_t& time, PathType* const type = nullptr) {
+    #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    struct stat result{};
+    if(stat(filename.data(), &result) != 0)
+        return false;
+    if(type) {
+        if(S_ISDIR(result.st_mode)) {
+            struct stat link{};
+            *type = lstat(filename.data(), &link) == 0 && S_ISLNK(link.st_mode) ? PathType::Other : PathType::Directory;
+        } else *type = S_ISREG(result.st_mode) ? PathType::File : PathType::Other;
+    }
+    #elif defined(CORRADE_TARGET_WINDOWS)
+    struct _stat result;
+    if(_wstat(filename.data(), &result) != 0)
+        return false;
+    if(type) *type =
+        result.st_mode & _S_IFDIR ? PathType::Directory :
+        result.st_mode & _S_IFREG ? PathType::File : PathType::Other;
+    #else
+    #error
+    #endif
+
+    /* Linux (and Android) has st_mtim (and st_mtime is a preprocessor alias to
+       st_mtim.tv_sec), which offers nanosecond precision (though the actual
+       granularity is ~10s of ms). macOS has the same in an (arguably
+       nonstandard) st_mtimespec, but HFS+ has only second precision anyway:
+       https://developer.apple.com/library/archive/technotes/tn/tn1150.html#HFSPlusDates
+       Emscripten defines st_mtime but sets tv_nsec to zero:
+       https://github.com/kripken/emscripten/blob/52ff847187ee30fba48d611e64b5d10e2498fe0f/src/library_syscall.js#L66
+       Windows doesn't have either, we get seconds there at best. */
+    time =
+        #ifdef CORRADE_TARGET_APPLE
+        std::uint64_t(result.st_mtimespec.tv_sec)*1000000000 + std::uint64_t(result.st_mtimespec.tv_nsec)
+        #elif defined(st_mtime)
+        std::uint64_t(result.st_mtim.tv_sec)*1000000000 + std::uint64_t(result.st_mtim.tv_nsec)
+        #else
+        std::uint64_t(result.st_mtime)*1000000000
+        #endif
+        ;
+    return true;
+}
+
+}
+
 FileWatcher::FileWatcher(const std::string& filename):
     #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
     _filename{filename},
@@ -68,16 +144,8 @@ FileWatcher& FileWatcher::operator=(FileWatcher&&)
 bool FileWatcher::hasChanged() {
     if(!_valid) return false;
 
-    #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
-    struct stat result{};
-    if(stat(_filename.data(), &result) != 0)
-    #elif defined(CORRADE_TARGET_WINDOWS)
-    struct _stat result;
-    if(_wstat(_filename.data(), &result) != 0)
-    #else
-    #error
-    #endif
-    {
+    std::uint64_t time;
+    if(!modificationTime(_filename, time)) {
         Error{} << "Utility::FileWatcher: can't stat"
             #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
             << _filename
@@ -91,24 +159,6 @@ bool FileWatcher::hasChanged() {
         return false;
     }
 
-    /* Linux (and Android) has st_mtim (and st_mtime is a preprocessor alias to
-       st_mtim.tv_sec), which offers nanosecond precision (though the actual
-       granularity is ~10s of ms). macOS has the same in an (arguably
-       nonstandard) st_mtimespec, but HFS+ has only second precision anyway:
-       https://developer.apple.com/library/archive/technotes/tn/tn1150.html#HFSPlusDates
-       Emscripten defines st_mtime but sets tv_nsec to zero:
-       https://github.com/kripken/emscripten/blob/52ff847187ee30fba48d611e64b5d10e2498fe0f/src/library_syscall.js#L66
-       Windows doesn't have either, we get seconds there at best. */
-    const std::uint64_t time =
-        #ifdef CORRADE_TARGET_APPLE
-        std::uint64_t(result.st_mtimespec.tv_sec)*1000000000 + std::uint64_t(result.st_mtimespec.tv_nsec)
-        #elif defined(st_mtime)
-        std::uint64_t(result.st_mtim.tv_sec)*1000000000 + std::uint64_t(result.st_mtim.tv_nsec)
-        #else
-        std::uint64_t(result.st_mtime)*1000000000
-        #endif
-        ;
-
     /* Checking for the first time, report no change */
     if(_time == ~std::uint64_t{}) {
         _time = time;
@@ -124,4 +174,771 @@ bool FileWatcher::hasChanged() {
     return false;
 }
 
+bool FileWatcher::wait(const std::size_t timeout) {
+    if(!_valid) return false;
+
+    /* Start watching first so a change happening right after the check below
+       isn't missed */
+    FileWatcherSet watcher;
+    #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    watcher.add(_filename);
+    #elif defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)
+    watcher.add(Unicode::narrow(_filename));
+    #else
+    #error
+    #endif
+    if(hasChanged()) return true;
+
+    /* The content could change without the modification time being updated
+       if it happens quickly enough, so report the change regardless of
+       what hasChanged() says. It's called to update the time and validity. */
+    if(!watcher.wait(timeout).empty()) {
+        hasChanged();
+        return true;
+    }
+
+    return hasChanged();
+}
+
+namespace {
+    struct WatchedFile {
+        std::string filename;
+        #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)
+        std::wstring nativeFilename;
+        #endif
+        /* ~std::uint64_t{} if the file doesn't exist */
+        std::uint64_t time;
+        bool changed;
+    };
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    struct WatchedDirectory {
+        int wd;
+        /* Maps a filename (without the path) to ID of the watched file */
+        std::unordered_map<std::string, std::size_t> files;
+    };
+    #endif
+
+    /* How often are the files checked when waiting with Flag::Polling */
+    constexpr std::int64_t PollingInterval = 10;
+
+    /* Blocks until there's possibly something to read from the inotify
+       descriptor or the timeout (in milliseconds) expires, a negative timeout
+       means waiting indefinitely. With no descriptor (i.e., when polling)
+       just sleeps. Returns false if the timeout expired. */
+    bool block(const int fd, const std::int64_t timeout) {
+        if(fd == -1) {
+            System::sleep(timeout < 0 ? PollingInterval : timeout);
+            return true;
+        }
+
+        #ifdef CORRADE_FILEWATCHER_INOTIFY
+        /* If interrupted by a signal, report there's possibly something to
+           collect, the caller will then block again if there's not */
+        pollfd pfd{fd, POLLIN, 0};
+        return poll(&pfd, 1, timeout < 0 ? -1 : int(std::min(timeout, std::int64_t{0x7fffffff}))) != 0;
+        #else
+        CORRADE_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        #endif
+    }
+
+    /* Calls state.collect() until it finds changes or the timeout expires.
+       Editors might write a file in several steps, so then waits until there
+       are no new changes for the debounce time. The descriptor is queried
+       again after each collect(), as that might close it and fall back to
+       polling. */
+    template<class State> void waitForChanges(State& state, const std::int64_t timeout, const std::size_t debounceTime) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while(state.collect(), !state.hasChanges()) {
+            const int fd = state.descriptor();
+            std::int64_t remaining = -1;
+            if(timeout >= 0) {
+                remaining = timeout - std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+                if(remaining <= 0) return;
+            }
+
+            /* When polling, check the files again after a short while, unless
+               the timeout is even shorter */
+            if(fd == -1 && (remaining < 0 || remaining > PollingInterval))
+                remaining = PollingInterval;
+
+            block(fd, remaining);
+        }
+
+        if(debounceTime) while(block(state.descriptor(), debounceTime) && state.collect()) {}
+    }
+}
+
+struct FileWatcherSet::State {
+    Flags flags;
+    std::size_t debounceTime{};
+    std::vector<WatchedFile> files;
+    /* Maps a filename to its index in the files list, to find duplicates */
+    std::unordered_map<std::string, std::size_t> ids;
+    std::vector<std::size_t> changed;
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    int fd{-1};
+    /* Keyed by path. Multiple paths can point to the same directory, in that
+       case the watch descriptor is the same for all of them. */
+    std::unordered_map<std::string, WatchedDirectory> directories;
+    #endif
+
+    /* Updates modification time of given file, returns true if it changed */
+    bool update(WatchedFile& file) {
+        std::uint64_t time;
+        #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+        if(!modificationTime(file.filename, time))
+        #elif defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)
+        if(!modificationTime(file.nativeFilename, time))
+        #else
+        #error
+        #endif
+            time = ~std::uint64_t{};
+
+        const bool changed = time != ~std::uint64_t{} && time != file.time;
+        file.time = time;
+        return changed;
+    }
+
+    void markChanged(const std::size_t id) {
+        if(files[id].changed) return;
+        files[id].changed = true;
+        changed.push_back(id);
+    }
+
+    void clearChanged() {
+        for(const std::size_t id: changed) files[id].changed = false;
+        changed.clear();
+    }
+
+    /* Adds files that changed since the last time to the changed list,
+       returns how many changes were detected, including files that are
+       already in the list */
+    std::size_t collect();
+
+    bool hasChanges() const { return !changed.empty(); }
+
+    int descriptor() const {
+        #ifdef CORRADE_FILEWATCHER_INOTIFY
+        return fd;
+        #else
+        return -1;
+        #endif
+    }
+};
+
+std::size_t FileWatcherSet::State::collect() {
+    std::size_t count = 0;
+
+    /* Polling fallback, check all files */
+    if(flags & Flag::Polling) {
+        for(std::size_t i = 0; i != files.size(); ++i) if(update(files[i])) {
+            markChanged(i);
+            ++count;
+        }
+        return count;
+    }
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    /* Read all pending events. Each event is at most sizeof(inotify_event)
+       + NAME_MAX + 1 bytes, so at least one always fits. */
+    alignas(inotify_event) char buffer[4096];
+    bool overflow = false;
+    for(;;) {
+        const ssize_t size = read(fd, buffer, sizeof(buffer));
+        if(size <= 0) break;
+
+        for(const char* it = buffer; it < buffer + size; ) {
+            const inotify_event& event = *reinterpret_cast<const inotify_event*>(it);
+            it += sizeof(inotify_event) + event.len;
+
+            /* Some events were dropped, check everything below */
+            if(event.mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            /* The directory got removed, the watch is gone */
+            if(event.mask & IN_IGNORED) {
+                for(auto i = directories.begin(); i != directories.end(); ) {
+                    if(i->second.wd == event.wd) i = directories.erase(i);
+                    else ++i;
+                }
+                continue;
+            }
+
+            if(!event.len) continue;
+
+            /* Find the file in all directories with this descriptor. There's
+               usually just one. */
+            for(auto& directory: directories) {
+                if(directory.second.wd != event.wd) continue;
+                const auto found = directory.second.files.find(event.name);
+                if(found == directory.second.files.end()) continue;
+
+                WatchedFile& file = files[found->second];
+                if(event.mask & (IN_DELETE|IN_MOVED_FROM)) {
+                    file.time = ~std::uint64_t{};
+                    continue;
+                }
+
+                /* Content changes are reported always, even if they happen
+                   within the modification time granularity. For attribute
+                   changes check that it's the modification time that got
+                   updated. */
+                const bool changed = update(file);
+                if((event.mask & (IN_MODIFY|IN_CLOSE_WRITE|IN_CREATE|IN_MOVED_TO) && file.time != ~std::uint64_t{}) || changed) {
+                    markChanged(found->second);
+                    ++count;
+                }
+            }
+        }
+    }
+
+    if(overflow) for(std::size_t i = 0; i != files.size(); ++i) if(update(files[i])) {
+        markChanged(i);
+        ++count;
+    }
+    #endif
+
+    return count;
+}
+
+FileWatcherSet::FileWatcherSet(const Flags flags): _state{Containers::InPlaceInit} {
+    _state->flags = flags;
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    if(!(flags & Flag::Polling)) {
+        _state->fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+        if(_state->fd == -1) {
+            Warning{} << "Utility::FileWatcherSet: can't initialize inotify:" << std::strerror(errno) << Debug::nospace << ", falling back to polling";
+            _state->flags |= Flag::Polling;
+        }
+    }
+    #else
+    _state->flags |= Flag::Polling;
+    #endif
+}
+
+FileWatcherSet::FileWatcherSet(FileWatcherSet&&) noexcept = default;
+
+FileWatcherSet::~FileWatcherSet() {
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    /* The state might have been moved out */
+    if(_state && _state->fd != -1) close(_state->fd);
+    #endif
+}
+
+FileWatcherSet& FileWatcherSet::operator=(FileWatcherSet&&) noexcept = default;
+
+FileWatcherSet::Flags FileWatcherSet::flags() const { return _state->flags; }
+
+std::size_t FileWatcherSet::debounceTime() const { return _state->debounceTime; }
+
+FileWatcherSet& FileWatcherSet::setDebounceTime(const std::size_t time) {
+    _state->debounceTime = time;
+    return *this;
+}
+
+std::size_t FileWatcherSet::size() const { return _state->files.size(); }
+
+std::size_t FileWatcherSet::add(const std::string& filename) {
+    const std::size_t id = _state->files.size();
+    const auto inserted = _state->ids.emplace(filename, id);
+    if(!inserted.second) return inserted.first->second;
+
+    _state->files.push_back({filename,
+        #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)
+        Unicode::widen(filename),
+        #endif
+        ~std::uint64_t{}, false});
+
+    /* Start watching first and only then query the initial file status, so
+       a change happening in between isn't lost */
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    if(!(_state->flags & Flag::Polling)) [&]{
+        std::string path = Directory::path(filename);
+        if(path.empty()) path = ".";
+
+        auto found = _state->directories.find(path);
+        if(found == _state->directories.end()) {
+            /* Watch for everything that could change file contents or
+               replace the file with another. Attribute changes are included
+               as that's what's triggered by updating the modification time
+               alone. */
+            const int wd = inotify_add_watch(_state->fd, path.data(), IN_MODIFY|IN_ATTRIB|IN_CLOSE_WRITE|IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_ONLYDIR);
+            if(wd == -1) {
+                Error{} << "Utility::FileWatcherSet::add(): can't watch" << path << Debug::nospace << ":" << std::strerror(errno);
+                return;
+            }
+
+            found = _state->directories.emplace(std::move(path), WatchedDirectory{wd, {}}).first;
+        }
+
+        found->second.files.emplace(Directory::filename(filename), id);
+    }();
+    #endif
+
+    _state->update(_state->files.back());
+
+    return id;
+}
+
+const std::string& FileWatcherSet::filename(const std::size_t id) const {
+    CORRADE_ASSERT(id < _state->files.size(),
+        "Utility::FileWatcherSet::filename(): index" << id << "out of range for" << _state->files.size() << "files", _state->files[0].filename);
+    return _state->files[id].filename;
+}
+
+bool FileWatcherSet::isValid(const std::size_t id) const {
+    CORRADE_ASSERT(id < _state->files.size(),
+        "Utility::FileWatcherSet::isValid(): index" << id << "out of range for" << _state->files.size() << "files", {});
+    return _state->files[id].time != ~std::uint64_t{};
+}
+
+Containers::ArrayView<const std::size_t> FileWatcherSet::changed() {
+    _state->clearChanged();
+    _state->collect();
+    std::sort(_state->changed.begin(), _state->changed.end());
+    return {_state->changed.data(), _state->changed.size()};
+}
+
+Containers::ArrayView<const std::size_t> FileWatcherSet::wait(const std::size_t timeout) {
+    _state->clearChanged();
+    waitForChanges(*_state, std::int64_t(timeout), _state->debounceTime);
+    std::sort(_state->changed.begin(), _state->changed.end());
+    return {_state->changed.data(), _state->changed.size()};
+}
+
+Containers::ArrayView<const std::size_t> FileWatcherSet::waitAny() {
+    CORRADE_ASSERT(!_state->files.empty(),
+        "Utility::FileWatcherSet::waitAny(): no files to watch", {});
+    _state->clearChanged();
+    waitForChanges(*_state, -1, _state->debounceTime);
+    std::sort(_state->changed.begin(), _state->changed.end());
+    return {_state->changed.data(), _state->changed.size()};
+}
+
+namespace {
+    struct WatchedTreeFile {
+        std::uint64_t time;
+        /* Filled only with DirectoryWatcher::Flag::CompareContents */
+        XXHash3<8>::Digest hash;
+        /* Used for marking files that were found during a rescan */
+        bool seen;
+    };
+
+    /* Internal value for changes that cancelled each other, such as a file
+       being created and then deleted before the changes were queried */
+    constexpr DirectoryWatcher::Change ChangeCancelled = DirectoryWatcher::Change(0xff);
+
+    inline std::string joinRelative(const std::string& directory, const std::string& name) {
+        return directory.empty() ? name : directory + '/' + name;
+    }
+}
+
+struct DirectoryWatcher::State {
+    std::string path;
+    Flags flags;
+    bool valid = true;
+    std::size_t debounceTime{};
+
+    /* Keyed by path relative to the root */
+    std::unordered_map<std::string, WatchedTreeFile> files;
+    std::vector<std::pair<std::string, Change>> changes;
+    /* Index of the file in the changes list, to merge repeated changes */
+    std::unordered_map<std::string, std::size_t> changeIndex;
+    /* How many changes were detected in the last collect(), for debouncing */
+    std::size_t changeCount;
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    int fd{-1};
+    /* Watched directories relative to the root, the root is an empty
+       string */
+    std::unordered_map<int, std::string> directories;
+    std::unordered_map<std::string, int> directoryWatches;
+    #endif
+
+    NativeString nativePath(const std::string& relative) const {
+        const std::string absolute = joinRelative(path, relative);
+        #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
+        return absolute;
+        #elif defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)
+        return Unicode::widen(absolute);
+        #else
+        #error
+        #endif
+    }
+
+    bool isDirectory() const {
+        std::uint64_t time;
+        PathType type;
+        return modificationTime(nativePath({}), time, &type) && type == PathType::Directory;
+    }
+
+    XXHash3<8>::Digest hash(const std::string& relative) const {
+        if(!(flags & Flag::CompareContents)) return {};
+        /* If the file can't be read, it likely means it got deleted in the
+           meantime, so the default-constructed digest doesn't matter */
+        Error silence{nullptr};
+        return XXHash3<8>::digest(Directory::read(joinRelative(path, relative)));
+    }
+
+    void report(const std::string& relative, Change change);
+
+    /* Reports a file as created, or as modified if it's already known */
+    void fileCreated(const std::string& relative);
+    /* Checks if a known file got modified. If content is true, the
+       modification time isn't checked, as it might not change if the writes
+       happen in a fast succession. */
+    void fileModified(const std::string& relative, bool content);
+    void fileDeleted(const std::string& relative);
+    /* Reports all files in given directory (recursively) as deleted */
+    void directoryDeleted(const std::string& relative);
+
+    /* Lists the directory, adds watches for it and its subdirectories and
+       adds files that are not known yet. If report is false, they're not
+       reported as created (used for the initial scan). Known files are
+       marked as seen and checked for modifications. */
+    void scan(const std::string& relative, bool report);
+    /* Scans the whole tree and reports files that are not there anymore as
+       deleted. Used for polling and if the inotify event queue overflows. */
+    void rescan();
+
+    std::size_t collect();
+
+    /* Changes that cancelled each other don't count */
+    bool hasChanges() const {
+        for(const std::pair<std::string, Change>& change: changes)
+            if(change.second != ChangeCancelled) return true;
+        return false;
+    }
+
+    int descriptor() const {
+        #ifdef CORRADE_FILEWATCHER_INOTIFY
+        return fd;
+        #else
+        return -1;
+        #endif
+    }
+
+    void clearChanges() {
+        changes.clear();
+        changeIndex.clear();
+    }
+
+    /* Removes changes that cancelled each other and sorts the rest */
+    void finalizeChanges() {
+        changes.erase(std::remove_if(changes.begin(), changes.end(), [](const std::pair<std::string, Change>& change) {
+            return change.second == ChangeCancelled;
+        }), changes.end());
+        std::sort(changes.begin(), changes.end());
+    }
+};
+
+void DirectoryWatcher::State::report(const std::string& relative, const Change change) {
+    ++changeCount;
+
+    const auto found = changeIndex.find(relative);
+    if(found == changeIndex.end()) {
+        changeIndex.emplace(relative, changes.size());
+        changes.emplace_back(relative, change);
+        return;
+    }
+
+    /* Merge with the previous change. Created and then modified is still
+       created, created and then deleted is nothing, deleted and then created
+       is modified. */
+    Change& previous = changes[found->second].second;
+    if(previous == ChangeCancelled)
+        previous = change;
+    else if(previous == Change::Created && change == Change::Deleted)
+        previous = ChangeCancelled;
+    else if(previous == Change::Deleted && change == Change::Created)
+        previous = Change::Modified;
+    else if(previous == Change::Modified && change == Change::Deleted)
+        previous = Change::Deleted;
+}
+
+void DirectoryWatcher::State::fileCreated(const std::string& relative) {
+    if(files.find(relative) != files.end()) {
+        fileModified(relative, true);
+        return;
+    }
+
+    std::uint64_t time;
+    PathType type;
+    if(!modificationTime(nativePath(relative), time, &type) || type != PathType::File)
+        return;
+
+    files.emplace(relative, WatchedTreeFile{time, hash(relative), true});
+    report(relative, Change::Created);
+}
+
+void DirectoryWatcher::State::fileModified(const std::string& relative, const bool content) {
+    const auto found = files.find(relative);
+    if(found == files.end()) {
+        fileCreated(relative);
+        return;
+    }
+
+    std::uint64_t time;
+    if(!modificationTime(nativePath(relative), time)) {
+        fileDeleted(relative);
+        return;
+    }
+
+    WatchedTreeFile& file = found->second;
+    file.seen = true;
+    if(!content && time == file.time) return;
+    file.time = time;
+
+    /* Confirm the change by comparing contents, if requested */
+    if(flags & Flag::CompareContents) {
+        const XXHash3<8>::Digest hash = this->hash(relative);
+        if(hash == file.hash) return;
+        file.hash = hash;
+    }
+
+    report(relative, Change::Modified);
+}
+
+void DirectoryWatcher::State::fileDeleted(const std::string& relative) {
+    if(!files.erase(relative)) return;
+    report(relative, Change::Deleted);
+}
+
+void DirectoryWatcher::State::directoryDeleted(const std::string& relative) {
+    const std::string prefix = relative + '/';
+    for(auto it = files.begin(); it != files.end(); ) {
+        if(it->first.compare(0, prefix.size(), prefix) == 0) {
+            report(it->first, Change::Deleted);
+            it = files.erase(it);
+        } else ++it;
+    }
+
+    /* If the directory was moved away, the watches would stay, remove them.
+       If it was deleted, they're removed already and this is a no-op. */
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    if(fd != -1) for(auto it = directoryWatches.begin(); it != directoryWatches.end(); ) {
+        if(it->first == relative || it->first.compare(0, prefix.size(), prefix) == 0) {
+            inotify_rm_watch(fd, it->second);
+            directories.erase(it->second);
+            it = directoryWatches.erase(it);
+        } else ++it;
+    }
+    #endif
+}
+
+void DirectoryWatcher::State::scan(const std::string& relative, const bool report) {
+    const std::string absolute = joinRelative(path, relative);
+
+    /* Add the watch first so files created while listing aren't missed */
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    if(fd != -1 && directoryWatches.find(relative) == directoryWatches.end()) {
+        const int wd = inotify_add_watch(fd, absolute.data(), IN_MODIFY|IN_ATTRIB|IN_CLOSE_WRITE|IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_DELETE_SELF|IN_ONLYDIR);
+        if(wd == -1) {
+            /* Most likely the limit of watches was reached, watching the
+               tree partially would be confusing so fall back to polling
+               everything instead */
+            if(errno != ENOENT) {
+                Warning{} << "Utility::DirectoryWatcher: can't watch" << absolute << Debug::nospace << ":" << std::strerror(errno) << Debug::nospace << ", falling back to polling";
+                close(fd);
+                fd = -1;
+                flags |= Flag::Polling;
+                directories.clear();
+                directoryWatches.clear();
+            }
+        } else {
+            directories[wd] = relative;
+            directoryWatches[relative] = wd;
+        }
+    }
+    #endif
+
+    for(const std::string& name: Directory::list(absolute, Directory::Flag::SkipDotAndDotDot)) {
+        const std::string child = joinRelative(relative, name);
+        std::uint64_t time;
+        PathType type;
+        if(!modificationTime(nativePath(child), time, &type)) continue;
+
+        if(type == PathType::Directory) {
+            scan(child, report);
+        } else if(type == PathType::File) {
+            const auto found = files.find(child);
+            if(found != files.end()) {
+                fileModified(child, false);
+            } else {
+                files.emplace(child, WatchedTreeFile{time, hash(child), true});
+                if(report) this->report(child, Change::Created);
+            }
+        }
+    }
+}
+
+void DirectoryWatcher::State::rescan() {
+    for(auto& file: files) file.second.seen = false;
+
+    if(!isDirectory()) valid = false;
+    else scan({}, true);
+
+    for(auto it = files.begin(); it != files.end(); ) {
+        if(!it->second.seen) {
+            report(it->first, Change::Deleted);
+            it = files.erase(it);
+        } else ++it;
+    }
+}
+
+std::size_t DirectoryWatcher::State::collect() {
+    changeCount = 0;
+    if(!valid) return 0;
+
+    if(flags & Flag::Polling) {
+        rescan();
+        return changeCount;
+    }
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    /* Modifications are processed after all events are read, so a file
+       written in many small chunks is checked (and hashed) only once */
+    std::unordered_map<std::string, bool> modified;
+    bool overflow = false;
+    alignas(inotify_event) char buffer[4096];
+    for(;;) {
+        const ssize_t size = read(fd, buffer, sizeof(buffer));
+        if(size <= 0) break;
+
+        for(const char* it = buffer; it < buffer + size; ) {
+            const inotify_event& event = *reinterpret_cast<const inotify_event*>(it);
+            it += sizeof(inotify_event) + event.len;
+
+            if(event.mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            const auto directory = directories.find(event.wd);
+            if(directory == directories.end()) continue;
+
+            /* The directory got removed. If it's the root, the watch is
+               over. */
+            if(event.mask & IN_IGNORED) {
+                if(directory->second.empty()) valid = false;
+                directoryWatches.erase(directory->second);
+                directories.erase(directory);
+                continue;
+            }
+
+            if(!event.len) continue;
+
+            const std::string relative = joinRelative(directory->second, event.name);
+            if(event.mask & IN_ISDIR) {
+                if(event.mask & (IN_CREATE|IN_MOVED_TO))
+                    scan(relative, true);
+                else if(event.mask & (IN_DELETE|IN_MOVED_FROM))
+                    directoryDeleted(relative);
+
+            } else if(event.mask & (IN_DELETE|IN_MOVED_FROM)) {
+                modified.erase(relative);
+                fileDeleted(relative);
+
+            } else if(event.mask & (IN_CREATE|IN_MOVED_TO)) {
+                fileCreated(relative);
+
+            } else {
+                modified[relative] |= !!(event.mask & (IN_MODIFY|IN_CLOSE_WRITE));
+            }
+        }
+    }
+
+    for(const auto& file: modified) fileModified(file.first, file.second);
+
+    if(overflow) rescan();
+    #endif
+
+    return changeCount;
+}
+
+DirectoryWatcher::DirectoryWatcher(const std::string& path, const Flags flags): _state{Containers::InPlaceInit} {
+    _state->path = path;
+    _state->flags = flags;
+
+    if(!_state->isDirectory()) {
+        Error{} << "Utility::DirectoryWatcher:" << path << "is not a directory";
+        _state->valid = false;
+        return;
+    }
+
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    if(!(flags & Flag::Polling)) {
+        _state->fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+        if(_state->fd == -1) {
+            Warning{} << "Utility::DirectoryWatcher: can't initialize inotify:" << std::strerror(errno) << Debug::nospace << ", falling back to polling";
+            _state->flags |= Flag::Polling;
+        }
+    }
+    #else
+    _state->flags |= Flag::Polling;
+    #endif
+
+    _state->scan({}, false);
+}
+
+DirectoryWatcher::DirectoryWatcher(DirectoryWatcher&&) noexcept = default;
+
+DirectoryWatcher::~DirectoryWatcher() {
+    #ifdef CORRADE_FILEWATCHER_INOTIFY
+    /* The state might have been moved out */
+    if(_state && _state->fd != -1) close(_state->fd);
+    #endif
+}
+
+DirectoryWatcher& DirectoryWatcher::operator=(DirectoryWatcher&&) noexcept = default;
+
+const std::string& DirectoryWatcher::path() const { return _state->path; }
+
+DirectoryWatcher::Flags DirectoryWatcher::flags() const { return _state->flags; }
+
+bool DirectoryWatcher::isValid() const { return _state->valid; }
+
+std::size_t DirectoryWatcher::fileCount() const { return _state->files.size(); }
+
+std::size_t DirectoryWatcher::debounceTime() const { return _state->debounceTime; }
+
+DirectoryWatcher& DirectoryWatcher::setDebounceTime(const std::size_t time) {
+    _state->debounceTime = time;
+    return *this;
+}
+
+Containers::ArrayView<const std::pair<std::string, DirectoryWatcher::Change>> DirectoryWatcher::changes() {
+    _state->clearChanges();
+    _state->collect();
+    _state->finalizeChanges();
+    return {_state->changes.data(), _state->changes.size()};
+}
+
+Containers::ArrayView<const std::pair<std::string, DirectoryWatcher::Change>> DirectoryWatcher::wait(const std::size_t timeout) {
+    _state->clearChanges();
+    if(_state->valid)
+        waitForChanges(*_state, std::int64_t(timeout), _state->debounceTime);
+    _state->finalizeChanges();
+    return {_state->changes.data(), _state->changes.size()};
+}
+
+Debug& operator<<(Debug& debug, const DirectoryWatcher::Change value) {
+    switch(value) {
+        /* LCOV_EXCL_START */
+        #define _c(value) case DirectoryWatcher::Change::value: return debug << "Utility::DirectoryWatcher::Change::" #value;
+        _c(Created)
+        _c(Modified)
+        _c(Deleted)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+    }
+
+    return debug << "Utility::DirectoryWatcher::Change(" << Debug::nospace << reinterpret_cast<void*>(std::uint8_t(value)) << Debug::nospace << ")";
+}
+
 }}
@@ -26,11 +26,16 @@
 */
 
 /** @file
- * @brief Class @ref Corrade::Utility::FileWatcher
+ * @brief Class @ref Corrade::Utility::FileWatcher, @ref Corrade::Utility::FileWatcherSet, @ref Corrade::Utility::DirectoryWatcher
  */
 
 #include <string>
+#include <utility>
 
+#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/Containers/EnumSet.h"
+#include "Corrade/Containers/Pointer.h"
+#include "Corrade/Utility/Utility.h"
 #include "Corrade/Utility/visibility.h"
 
 namespace Corrade { namespace Utility {
@@ -44,6 +49,9 @@ usage:
 
 @snippet Utility.cpp FileWatcher
 
+Each @ref hasChanged() call queries the file status. If you need to watch
+many files at once, use @ref FileWatcherSet instead.
+
 @section Utility-FileWatcher-behavior Behavior
 
 The generic implementation (currently used on all supported systems) checks for
@@ -115,9 +123,26 @@ class CORRADE_UTILITY_EXPORT FileWatcher {
          *
          * Returns @cpp true @ce if the file modification time was updated
          * since the previous call, @cpp false @ce otherwise.
+         * @see @ref wait()
          */
         bool hasChanged();
 
+        /**
+         * @brief Wait for the file to change
+         * @param timeout   Timeout in milliseconds
+         *
+         * Blocks until the file changes or @p timeout expires. Returns
+         * @cpp true @ce if the file changed since the previous call to this
+         * function or to @ref hasChanged(), @cpp false @ce if the timeout
+         * expired or if the watcher is not valid. If you need to wait for
+         * many files at once, use @ref FileWatcherSet::wait() instead.
+         *
+         * On Linux the function sleeps until notified by the system, see
+         * @ref Utility-FileWatcherSet-behavior for details. On other systems
+         * it checks the file modification time periodically.
+         */
+        bool wait(std::size_t timeout);
+
     private:
         #if defined(CORRADE_TARGET_UNIX) || defined(CORRADE_TARGET_EMSCRIPTEN)
         std::string _filename;
@@ -129,6 +154,397 @@ class CORRADE_UTILITY_EXPORT FileWatcher {
         bool _valid = true;
         std::uint64_t _time;
 };
+
+/**
+@brief File watcher set
+
+Watches many files for changes at once, reporting all files that changed
+since the last check with a single non-blocking call. Example usage:
+
+@snippet Utility.cpp FileWatcherSet
+
+@section Utility-FileWatcherSet-behavior Behavior
+
+On Linux the set uses a single
+[inotify](https://man7.org/linux/man-pages/man7/inotify.7.html) file
+descriptor watching the directories containing the files, so @ref changed()
+is just a single @cpp read() @ce call when nothing changed, independently of
+the file count. Because directories are watched and not the files
+themselves, replacing a file by renaming another over it (which is what most
+editors do when saving) is reported as a change as well. A change in file
+attributes alone (such as a @cpp chmod @ce) is not reported, unless the
+modification time changed as well.
+
+On other systems, or with @ref Flag::Polling, the set falls back to checking
+modification time of every file on each @ref changed() call, with the same
+caveats as described in @ref Utility-FileWatcher-behavior "FileWatcher".
+
+@section Utility-FileWatcherSet-wait Waiting for changes
+
+Instead of calling @ref changed() periodically, tools that don't need to do
+anything else in the meantime can block in @ref wait() or @ref waitAny()
+until a file changes. On the inotify backend the thread sleeps until
+notified by the system, the polling fallback checks the files every 10
+milliseconds.
+
+Many editors write a file in several steps --- for example truncating it
+first and writing the contents afterwards, or saving into a temporary file,
+deleting the original and renaming the temporary file over it. Reacting to
+the first change could then mean reading an incomplete file. To avoid that,
+set a debounce time using @ref setDebounceTime(). The waiting functions then,
+after detecting the first change, wait until there are no further changes for
+the given time, and report all of them at once:
+
+@snippet Utility.cpp FileWatcherSet-wait
+
+Unlike with @ref FileWatcher, files that don't exist are not an error. A file
+that gets deleted is not reported as changed, but is reported once it gets
+created again. Removing a directory containing a watched file stops the
+watch on the inotify backend, however.
+
+@partialsupport Available only on @ref CORRADE_TARGET_UNIX "Unix" and non-RT
+    @ref CORRADE_TARGET_WINDOWS "Windows" platforms and on
+    @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten". The inotify backend is used
+    only on Linux and Android.
+*/
+class CORRADE_UTILITY_EXPORT FileWatcherSet {
+    public:
+        /**
+         * @brief Flag
+         *
+         * @see @ref Flags, @ref FileWatcherSet(Flags)
+         */
+        enum class Flag: std::uint8_t {
+            /**
+             * Check modification time of all files on every @ref changed()
+             * call instead of using system notifications. Implicitly set on
+             * systems where notifications are not available or where they
+             * failed to initialize.
+             */
+            Polling = 1 << 0
+        };
+
+        /**
+         * @brief Flags
+         *
+         * @see @ref FileWatcherSet(Flags)
+         */
+        typedef Containers::EnumSet<Flag> Flags;
+
+        /**
+         * @brief Constructor
+         *
+         * Creates an empty set. Use @ref add() to add files to it.
+         */
+        explicit FileWatcherSet(Flags flags = {});
+
+        /** @brief Copying is not allowed */
+        FileWatcherSet(const FileWatcherSet&) = delete;
+
+        /** @brief Move constructor */
+        FileWatcherSet(FileWatcherSet&&) noexcept;
+
+        /** @brief Copying is not allowed */
+        FileWatcherSet& operator=(const FileWatcherSet&) = delete;
+
+        /** @brief Move assignment */
+        FileWatcherSet& operator=(FileWatcherSet&&) noexcept;
+
+        ~FileWatcherSet();
+
+        /**
+         * @brief Flags
+         *
+         * Contains @ref Flag::Polling if it was passed to the constructor or
+         * if system notifications are not available.
+         */
+        Flags flags() const;
+
+        /**
+         * @brief Debounce time
+         *
+         * Time in milliseconds, default is @cpp 0 @ce.
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        std::size_t debounceTime() const;
+
+        /**
+         * @brief Set debounce time
+         * @return Reference to self (for method chaining)
+         *
+         * After the first change is detected, @ref wait() and @ref waitAny()
+         * collect further changes until there's none for @p time
+         * milliseconds. Doesn't affect @ref changed().
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        FileWatcherSet& setDebounceTime(std::size_t time);
+
+        /** @brief Count of watched files */
+        std::size_t size() const;
+
+        /**
+         * @brief Add a file to the set
+         *
+         * Returns an ID of the file, which is the count of files in the set
+         * before the call. If the file is already watched, returns its
+         * existing ID. The file doesn't need to exist, but on the inotify
+         * backend its directory has to --- if it doesn't, a message is
+         * printed to @ref Error and changes in the file are never reported.
+         */
+        std::size_t add(const std::string& filename);
+
+        /**
+         * @brief Filename
+         *
+         * The @p id is expected to be less than @ref size().
+         */
+        const std::string& filename(std::size_t id) const;
+
+        /**
+         * @brief Whether a file exists
+         *
+         * Returns @cpp true @ce if the file existed the last time
+         * @ref changed() was called (or, if not called yet, when it was
+         * added). The @p id is expected to be less than @ref size().
+         */
+        bool isValid(std::size_t id) const;
+
+        /**
+         * @brief Files that changed
+         *
+         * Returns IDs of files that were modified or created since the
+         * previous call (or, if not called yet, since they were added),
+         * sorted and each listed just once. Use @ref filename() to get their
+         * paths. Doesn't block. The returned view is valid until the next
+         * call to this function, @ref wait() or @ref waitAny() or until the
+         * set is destroyed.
+         */
+        Containers::ArrayView<const std::size_t> changed();
+
+        /**
+         * @brief Wait for files to change
+         * @param timeout   Timeout in milliseconds
+         *
+         * Like @ref changed(), but if no file changed since the previous
+         * call, blocks until any file changes or @p timeout expires. If
+         * @ref debounceTime() is non-zero, waits until the changes settle
+         * down afterwards, which can take longer than @p timeout. Returns an
+         * empty view if the timeout expired.
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        Containers::ArrayView<const std::size_t> wait(std::size_t timeout);
+
+        /**
+         * @brief Wait for any file to change
+         *
+         * Like @ref wait(), but blocks indefinitely, so the returned view is
+         * never empty. Expects that the set is not empty.
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        Containers::ArrayView<const std::size_t> waitAny();
+
+    private:
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+CORRADE_ENUMSET_OPERATORS(FileWatcherSet::Flags)
+
+/**
+@brief Directory tree watcher
+
+Watches a directory and all its subdirectories for files being created,
+modified or deleted. Example usage:
+
+@snippet Utility.cpp DirectoryWatcher
+
+@section Utility-DirectoryWatcher-behavior Behavior
+
+The whole tree is scanned on construction. On Linux, all directories in the
+tree are then watched with a single
+[inotify](https://man7.org/linux/man-pages/man7/inotify.7.html) descriptor
+and @ref changes() processes just the events that arrived since the last
+call, so its cost depends only on the amount of changes and not on the size
+of the tree. New subdirectories are watched as they appear. If the system
+limit of watched directories is reached, a message is printed to
+@ref Warning and the watcher falls back to polling.
+
+On other systems, or with @ref Flag::Polling, the whole tree is listed and
+modification time of every file is checked on each @ref changes() call, with
+the same caveats as described in
+@ref Utility-FileWatcher-behavior "FileWatcher".
+
+Only regular files are reported, directories themselves are not. Symbolic
+links to directories are not followed in order to avoid infinite loops.
+
+@section Utility-DirectoryWatcher-compare-contents Comparing file contents
+
+Tools commonly update the modification time of a file without changing its
+contents, for example when a build system touches its outputs, or when a
+file is regenerated with the same data. To avoid reacting to those, enable
+@ref Flag::CompareContents. A 64-bit @ref XXHash3 digest of each file is then
+calculated during the initial scan and a modification is reported only if
+the digest changes. This means all files in the tree are read on
+construction and each modified file is read again when a change is
+detected, so it's beneficial only if reacting to a change is more expensive
+than reading the file.
+
+@section Utility-DirectoryWatcher-wait Waiting for changes
+
+Similarly to @ref FileWatcherSet, it's possible to block in @ref wait() until
+a change arrives, optionally with a debounce time set via
+@ref setDebounceTime(). See @ref Utility-FileWatcherSet-wait for more
+information.
+
+@partialsupport Available only on @ref CORRADE_TARGET_UNIX "Unix" and non-RT
+    @ref CORRADE_TARGET_WINDOWS "Windows" platforms and on
+    @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten". The inotify backend is used
+    only on Linux and Android.
+*/
+class CORRADE_UTILITY_EXPORT DirectoryWatcher {
+    public:
+        /**
+         * @brief Flag
+         *
+         * @see @ref Flags, @ref DirectoryWatcher(const std::string&, Flags)
+         */
+        enum class Flag: std::uint8_t {
+            /**
+             * List the tree and check modification time of all files on
+             * every @ref changes() call instead of using system
+             * notifications. Implicitly set on systems where notifications
+             * are not available or where they failed to initialize.
+             */
+            Polling = 1 << 0,
+
+            /**
+             * Report a modification only if the file contents changed. See
+             * @ref Utility-DirectoryWatcher-compare-contents for more
+             * information.
+             */
+            CompareContents = 1 << 1
+        };
+
+        /**
+         * @brief Flags
+         *
+         * @see @ref DirectoryWatcher(const std::string&, Flags)
+         */
+        typedef Containers::EnumSet<Flag> Flags;
+
+        /**
+         * @brief Change
+         *
+         * @see @ref changes()
+         */
+        enum class Change: std::uint8_t {
+            Created,    /**< A file was created */
+            Modified,   /**< A file was modified */
+            Deleted     /**< A file was deleted */
+        };
+
+        /**
+         * @brief Constructor
+         *
+         * Scans the directory tree at @p path. If @p path is not a
+         * directory, a message is printed to @ref Error and the watcher is
+         * not valid.
+         */
+        explicit DirectoryWatcher(const std::string& path, Flags flags = {});
+
+        /** @brief Copying is not allowed */
+        DirectoryWatcher(const DirectoryWatcher&) = delete;
+
+        /** @brief Move constructor */
+        DirectoryWatcher(DirectoryWatcher&&) noexcept;
+
+        /** @brief Copying is not allowed */
+        DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+        /** @brief Move assignment */
+        DirectoryWatcher& operator=(DirectoryWatcher&&) noexcept;
+
+        ~DirectoryWatcher();
+
+        /** @brief Watched path */
+        const std::string& path() const;
+
+        /**
+         * @brief Flags
+         *
+         * Contains @ref Flag::Polling if it was passed to the constructor or
+         * if system notifications are not available.
+         */
+        Flags flags() const;
+
+        /**
+         * @brief Whether the watcher is valid
+         *
+         * Returns @cpp false @ce if the path wasn't a directory on
+         * construction or if the directory got deleted.
+         */
+        bool isValid() const;
+
+        /** @brief Count of files in the tree */
+        std::size_t fileCount() const;
+
+        /**
+         * @brief Debounce time
+         *
+         * Time in milliseconds, default is @cpp 0 @ce.
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        std::size_t debounceTime() const;
+
+        /**
+         * @brief Set debounce time
+         * @return Reference to self (for method chaining)
+         *
+         * After the first change is detected, @ref wait() collects further
+         * changes until there's none for @p time milliseconds. Doesn't
+         * affect @ref changes().
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        DirectoryWatcher& setDebounceTime(std::size_t time);
+
+        /**
+         * @brief Changes in the tree
+         *
+         * Returns files that were created, modified or deleted since the
+         * previous call (or, if not called yet, since construction), with
+         * paths relative to @ref path(), using forward slashes as directory
+         * separators, and sorted by the path. Each file is listed just
+         * once --- a file that was created and then modified is listed as
+         * created, a file that was deleted and then created again is listed
+         * as modified and a file that was created and deleted again is not
+         * listed at all. Doesn't block. The returned view is valid until the
+         * next call to this function or @ref wait() or until the watcher is
+         * destroyed.
+         */
+        Containers::ArrayView<const std::pair<std::string, Change>> changes();
+
+        /**
+         * @brief Wait for changes in the tree
+         * @param timeout   Timeout in milliseconds
+         *
+         * Like @ref changes(), but if nothing changed since the previous
+         * call, blocks until something changes or @p timeout expires. If
+         * @ref debounceTime() is non-zero, waits until the changes settle
+         * down afterwards, which can take longer than @p timeout. Returns an
+         * empty view if the timeout expired.
+         * @see @ref Utility-FileWatcherSet-wait
+         */
+        Containers::ArrayView<const std::pair<std::string, Change>> wait(std::size_t timeout);
+
+    private:
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+CORRADE_ENUMSET_OPERATORS(DirectoryWatcher::Flags)
+
+/** @debugoperatorclassenum{DirectoryWatcher,DirectoryWatcher::Change} */
+CORRADE_UTILITY_EXPORT Debug& operator<<(Debug& debug, DirectoryWatcher::Change value);
 #else
 #error this header is available only on Unix, non-RT Windows and Emscripten
 #endif
@@ -27,25 +27,12 @@
 
 #include <cstring>
 
-#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/Containers/Array.h"
 #include "Corrade/Utility/Assert.h"
+#include "Corrade/Utility/Implementation/numberConversion.h"
 
 namespace Corrade { namespace Utility { namespace Implementation {
 
-enum class FormatType: unsigned char {
-    Unspecified,
-    Octal,
-    Decimal,
-    Hexadecimal,
-    HexadecimalUppercase,
-    Float,
-    FloatUppercase,
-    FloatExponent,
-    FloatExponentUppercase,
-    FloatFixed,
-    FloatFixedUppercase
-};
-
 template<class> char formatTypeChar(FormatType type);
 
 template<> char formatTypeChar<int>(FormatType type) {
@@ -114,46 +101,83 @@ template<> char formatTypeChar<float>(FormatType type) {
     CORRADE_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
-std::size_t Formatter<int>::format(const Containers::ArrayView<char>& buffer, const int value, int precision, const FormatType type) {
+namespace {
+
+/* Writes a sign, zero padding up to given precision and the digits, the same
+   as printf() with %.*i / %.*u / %.*o / %.*x / %.*X. Unlike std::snprintf(),
+   writes nothing if the buffer is too small, but also returns the full
+   size. */
+std::size_t formatIntegerInto(const Containers::ArrayView<char>& buffer, const unsigned long long magnitude, const bool negative, int precision, const char type) {
     if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', formatTypeChar<int>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, value);
-    return {};
+    const unsigned base = type == 'o' ? 8 : type == 'x' || type == 'X' ? 16 : 10;
+
+    /* Like printf(), a zero with zero precision is printed as nothing */
+    char digits[22];
+    const std::size_t digitCount = !precision && !magnitude ? 0 :
+        formatInteger(digits, magnitude, base, type == 'X');
+    const std::size_t padding = std::size_t(precision) > digitCount ? precision - digitCount : 0;
+    const std::size_t size = (negative ? 1 : 0) + padding + digitCount;
+
+    if(buffer && size <= buffer.size()) {
+        char* out = buffer;
+        if(negative) *out++ = '-';
+        std::memset(out, '0', padding);
+        std::memcpy(out + padding, digits, digitCount);
+    }
+
+    return size;
 }
-void Formatter<int>::format(std::FILE* const file, const int value, int precision, FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', formatTypeChar<int>(type), 0 };
-    std::fprintf(file, format, precision, value);
+
+/* Like printf(), octal and hexadecimal prints the two's complement of
+   negative values, so the value is converted to an unsigned type of the same
+   size */
+template<class T, class U> std::size_t formatSignedInto(const Containers::ArrayView<char>& buffer, const T value, const int precision, const FormatType type) {
+    const char typeChar = formatTypeChar<int>(type);
+    if(typeChar != 'i')
+        return formatIntegerInto(buffer, static_cast<U>(value), false, precision, typeChar);
+    return formatIntegerInto(buffer, value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value), value < 0, precision, typeChar);
 }
-std::size_t Formatter<unsigned int>::format(const Containers::ArrayView<char>& buffer, const unsigned int value, int precision, const FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', formatTypeChar<unsigned int>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, value);
+
+/* Formats into a stack buffer and writes that to the file. Only values that
+   don't fit (large precision or huge values with %f) need an allocation. */
+template<class T> void formatIntoFile(std::FILE* const file, const T value, const int precision, const FormatType type) {
+    char buffer[128];
+    const std::size_t size = Formatter<T>::format(buffer, value, precision, type);
+    if(size <= sizeof(buffer)) {
+        std::fwrite(buffer, size, 1, file);
+        return;
+    }
+
+    Containers::Array<char> data{Containers::NoInit, size};
+    Formatter<T>::format(data, value, precision, type);
+    std::fwrite(data, size, 1, file);
 }
-void Formatter<unsigned int>::format(std::FILE* const file, const unsigned int value, int precision, const FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', formatTypeChar<unsigned int>(type), 0 };
-    std::fprintf(file, format, precision, value);
+
 }
-std::size_t Formatter<long long>::format(const Containers::ArrayView<char>& buffer, const long long value, int precision, const FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', 'l', 'l', formatTypeChar<int>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, value);
+
+std::size_t Formatter<int>::format(const Containers::ArrayView<char>& buffer, const int value, const int precision, const FormatType type) {
+    return formatSignedInto<int, unsigned int>(buffer, value, precision, type);
 }
-void Formatter<long long>::format(std::FILE* const file, const long long value, int precision, const FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', 'l', 'l', formatTypeChar<int>(type), 0 };
-    std::fprintf(file, format, precision, value);
+void Formatter<int>::format(std::FILE* const file, const int value, const int precision, const FormatType type) {
+    formatIntoFile<int>(file, value, precision, type);
 }
-std::size_t Formatter<unsigned long long>::format(const Containers::ArrayView<char>& buffer, const unsigned long long value, int precision, const FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', 'l', 'l', formatTypeChar<unsigned int>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, value);
+std::size_t Formatter<unsigned int>::format(const Containers::ArrayView<char>& buffer, const unsigned int value, const int precision, const FormatType type) {
+    return formatIntegerInto(buffer, value, false, precision, formatTypeChar<unsigned int>(type));
 }
-void Formatter<unsigned long long>::format(std::FILE* const file, const unsigned long long value, int precision, const FormatType type) {
-    if(precision == -1) precision = 1;
-    const char format[]{ '%', '.', '*', 'l', 'l', formatTypeChar<unsigned int>(type), 0 };
-    std::fprintf(file, format, precision, value);
+void Formatter<unsigned int>::format(std::FILE* const file, const unsigned int value, const int precision, const FormatType type) {
+    formatIntoFile<unsigned int>(file, value, precision, type);
+}
+std::size_t Formatter<long long>::format(const Containers::ArrayView<char>& buffer, const long long value, const int precision, const FormatType type) {
+    return formatSignedInto<long long, unsigned long long>(buffer, value, precision, type);
+}
+void Formatter<long long>::format(std::FILE* const file, const long long value, const int precision, const FormatType type) {
+    formatIntoFile<long long>(file, value, precision, type);
+}
+std::size_t Formatter<unsigned long long>::format(const Containers::ArrayView<char>& buffer, const unsigned long long value, const int precision, const FormatType type) {
+    return formatIntegerInto(buffer, value, false, precision, formatTypeChar<unsigned int>(type));
+}
+void Formatter<unsigned long long>::format(std::FILE* const file, const unsigned long long value, const int precision, const FormatType type) {
+    formatIntoFile<unsigned long long>(file, value, precision, type);
 }
 
 /* The default. Source: http://en.cppreference.com/w/cpp/io/ios_base/precision,
@@ -162,13 +186,10 @@ void Formatter<unsigned long long>::format(std::FILE* const file, const unsigned
    Kept in sync with Debug. */
 std::size_t Formatter<float>::format(const Containers::ArrayView<char>& buffer, const float value, int precision, const FormatType type) {
     if(precision == -1) precision = 6;
-    const char format[]{ '%', '.', '*', formatTypeChar<float>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, double(value));
+    return formatFloatingPoint(buffer, buffer.size(), value, formatTypeChar<float>(type), precision);
 }
-void Formatter<float>::format(std::FILE* const file, const float value, int precision, const FormatType type) {
-    if(precision == -1) precision = 6;
-    const char format[]{ '%', '.', '*', formatTypeChar<float>(type), 0 };
-    std::fprintf(file, format, precision, double(value));
+void Formatter<float>::format(std::FILE* const file, const float value, const int precision, const FormatType type) {
+    formatIntoFile<float>(file, value, precision, type);
 }
 
 /* Wikipedia says 15-digit number can be converted back and forth without loss:
@@ -176,13 +197,10 @@ void Formatter<float>::format(std::FILE* const file, const float value, int prec
    Kept in sync with Debug. */
 std::size_t Formatter<double>::format(const Containers::ArrayView<char>& buffer, const double value, int precision, const FormatType type) {
     if(precision == -1) precision = 15;
-    const char format[]{ '%', '.', '*', formatTypeChar<float>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, value);
+    return formatFloatingPoint(buffer, buffer.size(), value, formatTypeChar<float>(type), precision);
 }
-void Formatter<double>::format(std::FILE* const file, const double value, int precision, const FormatType type) {
-    if(precision == -1) precision = 15;
-    const char format[]{ '%', '.', '*', formatTypeChar<float>(type), 0 };
-    std::fprintf(file, format, precision, value);
+void Formatter<double>::format(std::FILE* const file, const double value, const int precision, const FormatType type) {
+    formatIntoFile<double>(file, value, precision, type);
 }
 
 #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -191,13 +209,10 @@ void Formatter<double>::format(std::FILE* const file, const double value, int pr
    Kept in sync with Debug. */
 std::size_t Formatter<long double>::format(const Containers::ArrayView<char>& buffer, const long double value, int precision, const FormatType type) {
     if(precision == -1) precision = 18;
-    const char format[]{ '%', '.', '*', 'L', formatTypeChar<float>(type), 0 };
-    return std::snprintf(buffer, buffer.size(), format, precision, value);
+    return formatFloatingPoint(buffer, buffer.size(), value, formatTypeChar<float>(type), precision);
 }
-void Formatter<long double>::format(std::FILE* const file, const long double value, int precision, const FormatType type) {
-    if(precision == -1) precision = 18;
-    const char format[]{ '%', '.', '*', 'L', formatTypeChar<float>(type), 0 };
-    std::fprintf(file, format, precision, value);
+void Formatter<long double>::format(std::FILE* const file, const long double value, const int precision, const FormatType type) {
+    formatIntoFile<long double>(file, value, precision, type);
 }
 #endif
 
@@ -206,8 +221,9 @@ std::size_t Formatter<Containers::ArrayView<const char>>::format(const Container
     if(std::size_t(precision) < size) size = precision;
     CORRADE_ASSERT(type == FormatType::Unspecified,
         "Utility::format(): type specifier can't be used for a string value", {});
-    /* strncpy() would stop on \0 characters */
-    if(buffer) std::memcpy(buffer, value, size);
+    /* strncpy() would stop on \0 characters. If the buffer is too small,
+       only the size is returned, same as with std::snprintf(). */
+    if(buffer && size <= buffer.size()) std::memcpy(buffer, value, size);
     return size;
 }
 void Formatter<Containers::ArrayView<const char>>::format(std::FILE* const file, const Containers::ArrayView<const char> value, const int precision, const FormatType type) {
@@ -421,6 +437,104 @@ void formatInto(std::FILE* const file,  const char* format, FileFormatter* const
     }, {format, std::strlen(format)}, Containers::arrayView(formatters, formatterCount));
 }
 
+std::size_t formatInto(const Containers::ArrayView<char>& buffer, const char* const format, const FormatChunk* const chunks, const std::size_t chunkCount, BufferFormatter* const formatters, const std::size_t formatterCount) {
+    std::size_t bufferOffset = 0;
+    for(std::size_t i = 0; i != chunkCount; ++i) {
+        const FormatChunk& chunk = chunks[i];
+
+        /* Literal, or the whole placeholder verbatim if there's no argument
+           for it */
+        const std::size_t literalSize = chunk.placeholder && std::size_t(chunk.argument) >= formatterCount ? chunk.end - chunk.offset : chunk.literalSize;
+        if(buffer) {
+            CORRADE_ASSERT(bufferOffset + literalSize <= buffer.size(),
+                "Utility::formatInto(): buffer too small, expected at least" << bufferOffset + literalSize << "but got" << buffer.size(), {});
+            /* strncpy() would stop on \0 characters */
+            std::memcpy(buffer + bufferOffset, format + chunk.offset, literalSize);
+        }
+        bufferOffset += literalSize;
+
+        if(!chunk.placeholder || std::size_t(chunk.argument) >= formatterCount)
+            continue;
+
+        BufferFormatter& formatter = formatters[chunk.argument];
+        if(buffer) {
+            formatter.size = formatter(buffer.suffix(bufferOffset), chunk.precision, chunk.type);
+            CORRADE_ASSERT(bufferOffset + formatter.size <= buffer.size(),
+                "Utility::formatInto(): buffer too small, expected at least" << bufferOffset + formatter.size << "but got" << buffer.size(), {});
+        } else if(formatter.size == ~std::size_t{})
+            formatter.size = formatter(nullptr, chunk.precision, chunk.type);
+        bufferOffset += formatter.size;
+    }
+
+    return bufferOffset;
+}
+
+namespace {
+
+void formatAppend(std::string& buffer, std::size_t& offset, const char* const data, const std::size_t size) {
+    if(buffer.size() < offset + size) buffer.resize(offset + size);
+    /* strncpy() would stop on \0 characters */
+    std::memcpy(&buffer[offset], data, size);
+    offset += size;
+}
+
+}
+
+std::size_t formatInto(std::string& buffer, std::size_t offset, const char* const format, const FormatChunk* const chunks, const std::size_t chunkCount, BufferFormatter* const formatters, const std::size_t formatterCount) {
+    /* The values are formatted into a stack buffer first and then copied, as
+       std::snprintf() always writes the null terminator and would overwrite
+       existing string contents when inserting in the middle. Only values
+       that don't fit are formatted directly into the string. */
+    char scratch[64];
+    for(std::size_t i = 0; i != chunkCount; ++i) {
+        const FormatChunk& chunk = chunks[i];
+
+        /* Literal, or the whole placeholder verbatim if there's no argument
+           for it */
+        if(chunk.placeholder && std::size_t(chunk.argument) >= formatterCount) {
+            formatAppend(buffer, offset, format + chunk.offset, chunk.end - chunk.offset);
+            continue;
+        }
+        formatAppend(buffer, offset, format + chunk.offset, chunk.literalSize);
+        if(!chunk.placeholder) continue;
+
+        const BufferFormatter& formatter = formatters[chunk.argument];
+        const std::size_t size = formatter(scratch, chunk.precision, chunk.type);
+        if(size < sizeof(scratch)) {
+            formatAppend(buffer, offset, scratch, size);
+            continue;
+        }
+
+        /* Under C++11, the character storage always includes the null
+           terminator, so allow printf() to write there. If writing in the
+           middle, preserve the character it'd overwrite. */
+        if(buffer.size() < offset + size) buffer.resize(offset + size);
+        const char overwritten = buffer[offset + size];
+        formatter({&buffer[offset], size + 1}, chunk.precision, chunk.type);
+        buffer[offset + size] = overwritten;
+        offset += size;
+    }
+
+    return offset;
+}
+
+void formatInto(std::FILE* const file, const char* const format, const FormatChunk* const chunks, const std::size_t chunkCount, FileFormatter* const formatters, const std::size_t formatterCount) {
+    for(std::size_t i = 0; i != chunkCount; ++i) {
+        const FormatChunk& chunk = chunks[i];
+
+        /* Literal, or the whole placeholder verbatim if there's no argument
+           for it */
+        if(chunk.placeholder && std::size_t(chunk.argument) >= formatterCount) {
+            std::fwrite(format + chunk.offset, chunk.end - chunk.offset, 1, file);
+            continue;
+        }
+        if(chunk.literalSize)
+            std::fwrite(format + chunk.offset, chunk.literalSize, 1, file);
+        if(chunk.placeholder)
+            formatters[chunk.argument](file, chunk.precision, chunk.type);
+    }
+}
+
 }
 
 }}
@@ -26,17 +26,22 @@
 */
 
 /** @file
- * @brief Function @ref Corrade::Utility::formatString(), @ref Corrade::Utility::formatInto(), @ref Corrade::Utility::print(), @ref Corrade::Utility::printError()
+ * @brief Function @ref Corrade::Utility::formatString(), @ref Corrade::Utility::formatInto(), @ref Corrade::Utility::print(), @ref Corrade::Utility::printError(), macro @ref CORRADE_FORMAT()
  * @experimental
  */
 
 #include <string>
 
 #include "Corrade/Containers/Containers.h"
+#include "Corrade/Utility/TypeTraits.h"
 #include "Corrade/Utility/visibility.h"
 
 namespace Corrade { namespace Utility {
 
+namespace Implementation {
+    template<class> struct FormatLiteral;
+}
+
 /**
 @brief Format a string
 
@@ -136,6 +141,18 @@ for a completely zero-allocation alternative. There is also
 @ref formatInto(std::FILE*, const char*, const Args&... args) for writing to
 files or standard output.
 
+The format string is parsed again on every call. If it's known at compile
+time, wrap it in @ref CORRADE_FORMAT() --- the string is then parsed and
+validated already during compilation and the formatting is done in a single
+pass directly into the destination:
+
+@snippet Utility.cpp formatString-compiled
+
+A malformed format string (such as a mismatched @cpp '}' @ce or an unknown
+type specifier) or a type specifier that doesn't match type of the
+corresponding argument (such as @cpp "{:x}" @ce used for a floating-point
+value) is then reported as a compilation error instead of a runtime assertion.
+
 # Comparison to Debug
 
 @ref Debug class desired usage is for easy printing of complex nested types,
@@ -225,9 +242,91 @@ template<class ...Args> inline void printError(const char* format, const Args&..
     return formatInto(stderr, format, args...);
 }
 
+/**
+@brief Format a string using a compile-time parsed format string
+
+Equivalent to @ref formatString(const char*, const Args&... args), but with
+the @p format parsed and validated at compile time. Use @ref CORRADE_FORMAT()
+to create the @p format object.
+
+@experimental
+*/
+template<class Literal, class ...Args> std::string formatString(Implementation::FormatLiteral<Literal> format, const Args&... args);
+
+/**
+@brief Format a string into an existing string using a compile-time parsed format string
+
+Equivalent to @ref formatInto(std::string&, std::size_t, const char*, const Args&... args),
+but with the @p format parsed and validated at compile time. Unlike the runtime
+variant, the formatting is done in a single pass directly into @p string,
+growing it as needed. Use @ref CORRADE_FORMAT() to create the @p format
+object.
+
+@experimental
+*/
+template<class Literal, class ...Args> std::size_t formatInto(std::string& string, std::size_t offset, Implementation::FormatLiteral<Literal> format, const Args&... args);
+
+/**
+@brief Format a string into an existing buffer using a compile-time parsed format string
+
+Equivalent to @ref formatInto(const Containers::ArrayView<char>&, const char*, const Args&... args),
+but with the @p format parsed and validated at compile time. Use
+@ref CORRADE_FORMAT() to create the @p format object.
+
+@experimental
+*/
+template<class Literal, class ...Args> std::size_t formatInto(const Containers::ArrayView<char>& buffer, Implementation::FormatLiteral<Literal> format, const Args&... args);
+
+/**
+@brief Format a string into a file using a compile-time parsed format string
+
+Equivalent to @ref formatInto(std::FILE*, const char*, const Args&... args),
+but with the @p format parsed and validated at compile time. Use
+@ref CORRADE_FORMAT() to create the @p format object.
+
+@experimental
+*/
+template<class Literal, class ...Args> void formatInto(std::FILE* file, Implementation::FormatLiteral<Literal> format, const Args&... args);
+
+/**
+@brief Print a string to the standard output using a compile-time parsed format string
+
+Equivalent to calling @ref formatInto(std::FILE*, Implementation::FormatLiteral<Literal>, const Args&... args)
+with @cpp stdout @ce as a first parameter.
+
+@experimental
+*/
+template<class Literal, class ...Args> inline void print(Implementation::FormatLiteral<Literal> format, const Args&... args) {
+    return formatInto(stdout, format, args...);
+}
+
+/**
+@brief Print a string to the standard error output using a compile-time parsed format string
+
+Equivalent to calling @ref formatInto(std::FILE*, Implementation::FormatLiteral<Literal>, const Args&... args)
+with @cpp stderr @ce as a first parameter.
+
+@experimental
+*/
+template<class Literal, class ...Args> inline void printError(Implementation::FormatLiteral<Literal> format, const Args&... args) {
+    return formatInto(stderr, format, args...);
+}
+
 namespace Implementation {
 
-enum class FormatType: unsigned char;
+enum class FormatType: unsigned char {
+    Unspecified,
+    Octal,
+    Decimal,
+    Hexadecimal,
+    HexadecimalUppercase,
+    Float,
+    FloatUppercase,
+    FloatExponent,
+    FloatExponentUppercase,
+    FloatFixed,
+    FloatFixedUppercase
+};
 
 template<class T> struct Formatter;
 
@@ -328,6 +427,232 @@ CORRADE_UTILITY_EXPORT std::size_t formatInto(const Containers::ArrayView<char>&
 CORRADE_UTILITY_EXPORT std::size_t formatInto(std::string& buffer, std::size_t offset, const char* format, BufferFormatter* formatters, std::size_t formattersCount);
 CORRADE_UTILITY_EXPORT void formatInto(std::FILE* file, const char* format, FileFormatter* formatters, std::size_t formattersCount);
 
+/* Compile-time parsed format strings. Everything below has to be C++11
+   constexpr, so it's all single-expression functions, recursion instead of
+   loops and values passed around instead of being modified. */
+
+enum class FormatError: unsigned char {
+    None,
+    MismatchedDelimiter,
+    UnexpectedEnd,
+    UnknownPlaceholderContent,
+    InvalidPrecision,
+    InvalidType
+};
+
+/* Literal text at [offset, offset + literalSize) optionally followed by a
+   placeholder at [offset + literalSize, end) */
+struct FormatChunk {
+    std::size_t offset;
+    std::size_t literalSize;
+    std::size_t end;
+    /* Explicit placeholder number while parsing, resolved argument index
+       after */
+    int argument;
+    int precision;
+    FormatType type;
+    FormatError error;
+    bool placeholder;
+};
+
+struct FormatNumber {
+    std::size_t end;
+    int value;
+};
+
+/* Returns position of the first { or } in [begin, end), or end if there's
+   none. Bisecting instead of going character by character to not hit the
+   constexpr recursion depth limit on long literals. */
+constexpr std::size_t formatFindDelimiterIn(const char* data, std::size_t middle, std::size_t end, std::size_t left);
+constexpr std::size_t formatFindDelimiter(const char* data, std::size_t begin, std::size_t end) {
+    return end - begin == 0 ? end :
+        end - begin == 1 ? (data[begin] == '{' || data[begin] == '}' ? begin : end) :
+        formatFindDelimiterIn(data, begin + (end - begin)/2, end, formatFindDelimiter(data, begin, begin + (end - begin)/2));
+}
+constexpr std::size_t formatFindDelimiterIn(const char* data, std::size_t middle, std::size_t end, std::size_t left) {
+    return left != middle ? left : formatFindDelimiter(data, middle, end);
+}
+
+constexpr FormatNumber formatParseNumber(const char* data, std::size_t size, std::size_t i, int value) {
+    return i < size && data[i] >= '0' && data[i] <= '9' ?
+        formatParseNumber(data, size, i + 1, (value == -1 ? 0 : value*10) + (data[i] - '0')) :
+        FormatNumber{i, value};
+}
+
+constexpr FormatType formatTypeFromCharacter(char c) {
+    return
+        c == 'o' ? FormatType::Octal :
+        c == 'd' ? FormatType::Decimal :
+        c == 'x' ? FormatType::Hexadecimal :
+        c == 'X' ? FormatType::HexadecimalUppercase :
+        c == 'g' ? FormatType::Float :
+        c == 'G' ? FormatType::FloatUppercase :
+        c == 'e' ? FormatType::FloatExponent :
+        c == 'E' ? FormatType::FloatExponentUppercase :
+        c == 'f' ? FormatType::FloatFixed :
+        c == 'F' ? FormatType::FloatFixedUppercase :
+                   FormatType::Unspecified;
+}
+
+constexpr FormatChunk formatChunkError(const FormatChunk& chunk, std::size_t size, FormatError error) {
+    /* Parsing stops at the first error */
+    return {chunk.offset, chunk.literalSize, size, chunk.argument, chunk.precision, chunk.type, error, chunk.placeholder};
+}
+
+/* {[number][:[.precision][type]]}, parsed in the same way as the runtime
+   variant in Format.cpp does */
+constexpr FormatChunk formatParsePlaceholderEnd(const char* data, std::size_t size, const FormatChunk& chunk, std::size_t i) {
+    return i == size ? formatChunkError(chunk, size, FormatError::UnexpectedEnd) :
+        data[i] != '}' ? formatChunkError(chunk, size, FormatError::UnknownPlaceholderContent) :
+        FormatChunk{chunk.offset, chunk.literalSize, i + 1, chunk.argument, chunk.precision, chunk.type, FormatError::None, true};
+}
+constexpr FormatChunk formatParsePlaceholderType(const char* data, std::size_t size, const FormatChunk& chunk, std::size_t i) {
+    return i == size || data[i] == '}' ? formatParsePlaceholderEnd(data, size, chunk, i) :
+        formatTypeFromCharacter(data[i]) == FormatType::Unspecified ? formatChunkError(chunk, size, FormatError::InvalidType) :
+        formatParsePlaceholderEnd(data, size, FormatChunk{chunk.offset, chunk.literalSize, chunk.end, chunk.argument, chunk.precision, formatTypeFromCharacter(data[i]), FormatError::None, true}, i + 1);
+}
+constexpr FormatChunk formatParsePlaceholderPrecision(const char* data, std::size_t size, const FormatChunk& chunk, const FormatNumber& precision) {
+    return precision.value == -1 ? formatChunkError(chunk, size, FormatError::InvalidPrecision) :
+        formatParsePlaceholderType(data, size, FormatChunk{chunk.offset, chunk.literalSize, chunk.end, chunk.argument, precision.value, chunk.type, FormatError::None, true}, precision.end);
+}
+constexpr FormatChunk formatParsePlaceholderOptions(const char* data, std::size_t size, const FormatChunk& chunk, std::size_t i) {
+    return i + 1 < size && data[i] == '.' ?
+        formatParsePlaceholderPrecision(data, size, chunk, formatParseNumber(data, size, i + 1, -1)) :
+        formatParsePlaceholderType(data, size, chunk, i);
+}
+constexpr FormatChunk formatParsePlaceholder(const char* data, std::size_t size, const FormatChunk& chunk, const FormatNumber& number) {
+    return number.end < size && data[number.end] == ':' ?
+        formatParsePlaceholderOptions(data, size, FormatChunk{chunk.offset, chunk.literalSize, chunk.end, number.value, -1, FormatType::Unspecified, FormatError::None, true}, number.end + 1) :
+        formatParsePlaceholderEnd(data, size, FormatChunk{chunk.offset, chunk.literalSize, chunk.end, number.value, -1, FormatType::Unspecified, FormatError::None, true}, number.end);
+}
+
+constexpr FormatChunk formatParseChunk(const char* data, std::size_t size, std::size_t offset, std::size_t delimiter) {
+    return
+        /* Only a literal until the end */
+        delimiter == size ? FormatChunk{offset, size - offset, size, -1, -1, FormatType::Unspecified, FormatError::None, false} :
+        /* Escaped { or }, include one of the two in the literal */
+        delimiter + 1 < size && data[delimiter + 1] == data[delimiter] ? FormatChunk{offset, delimiter - offset + 1, delimiter + 2, -1, -1, FormatType::Unspecified, FormatError::None, false} :
+        data[delimiter] == '}' ? FormatChunk{offset, delimiter - offset, size, -1, -1, FormatType::Unspecified, FormatError::MismatchedDelimiter, false} :
+        formatParsePlaceholder(data, size, FormatChunk{offset, delimiter - offset, delimiter + 1, -1, -1, FormatType::Unspecified, FormatError::None, true}, formatParseNumber(data, size, delimiter + 1, -1));
+}
+constexpr FormatChunk formatParseChunk(const char* data, std::size_t size, std::size_t offset) {
+    return formatParseChunk(data, size, offset, formatFindDelimiter(data, offset, size));
+}
+
+constexpr FormatError formatErrorOf(const char* data, std::size_t size, const FormatChunk& chunk);
+constexpr FormatError formatError(const char* data, std::size_t size, std::size_t offset) {
+    return offset >= size ? FormatError::None :
+        formatErrorOf(data, size, formatParseChunk(data, size, offset));
+}
+constexpr FormatError formatErrorOf(const char* data, std::size_t size, const FormatChunk& chunk) {
+    return chunk.error != FormatError::None ? chunk.error :
+        formatError(data, size, chunk.end);
+}
+
+constexpr std::size_t formatChunkCount(const char* data, std::size_t size, std::size_t offset) {
+    return offset >= size ? 0 :
+        1 + formatChunkCount(data, size, formatParseChunk(data, size, offset).end);
+}
+
+/* Resolves the argument index of a placeholder. Implicit placeholders take
+   the argument after the previous placeholder, the same as in the runtime
+   variant. */
+constexpr int formatChunkArgument(const FormatChunk& chunk, int next) {
+    return !chunk.placeholder ? -1 :
+        chunk.argument != -1 ? chunk.argument : next;
+}
+constexpr int formatNextArgument(const FormatChunk& chunk, int next) {
+    return !chunk.placeholder ? next : formatChunkArgument(chunk, next) + 1;
+}
+constexpr FormatChunk formatChunk(const char* data, std::size_t size, std::size_t i, const FormatChunk& chunk, int next) {
+    return i ? formatChunk(data, size, i - 1, formatParseChunk(data, size, chunk.end), formatNextArgument(chunk, next)) :
+        FormatChunk{chunk.offset, chunk.literalSize, chunk.end, formatChunkArgument(chunk, next), chunk.precision, chunk.type, chunk.error, chunk.placeholder};
+}
+constexpr FormatChunk formatChunk(const char* data, std::size_t size, std::size_t i) {
+    return formatChunk(data, size, i, formatParseChunk(data, size, 0), 0);
+}
+
+template<class Literal, class> struct FormatChunks;
+template<class Literal, std::size_t ...sequence> struct FormatChunks<Literal, Sequence<sequence...>> {
+    /* One more for a sentinel (C arrays can't have zero size) */
+    static constexpr FormatChunk Data[sizeof...(sequence) + 1]{
+        formatChunk(Literal::data(), Literal::size(), sequence)...,
+        FormatChunk{}
+    };
+};
+template<class Literal, std::size_t ...sequence> constexpr FormatChunk FormatChunks<Literal, Sequence<sequence...>>::Data[];
+
+/* Passed to the public API. Deliberately empty as it gets instantiated
+   during overload resolution also for calls with explicitly specified
+   template arguments such as formatString<char>(). */
+template<class Literal> struct FormatLiteral {};
+
+template<class Literal> struct FormatCompiled {
+    static constexpr FormatError Error = formatError(Literal::data(), Literal::size(), 0);
+    static_assert(Error != FormatError::MismatchedDelimiter,
+        "Utility::format(): mismatched }");
+    static_assert(Error != FormatError::UnexpectedEnd,
+        "Utility::format(): unexpected end of format string");
+    static_assert(Error != FormatError::UnknownPlaceholderContent,
+        "Utility::format(): unknown placeholder content");
+    static_assert(Error != FormatError::InvalidPrecision,
+        "Utility::format(): invalid character in precision specifier");
+    static_assert(Error != FormatError::InvalidType,
+        "Utility::format(): invalid type specifier");
+
+    enum: std::size_t {
+        ChunkCount = formatChunkCount(Literal::data(), Literal::size(), 0)
+    };
+
+    typedef FormatChunks<Literal, typename GenerateSequence<ChunkCount>::Type> Chunks;
+};
+
+template<class Literal> constexpr FormatLiteral<Literal> formatLiteral(Literal) { return {}; }
+
+/* Validation of type specifiers against argument types */
+enum class FormatKind: unsigned char { Integer, Float, String };
+
+template<class T> constexpr FormatKind formatKind() {
+    return std::is_integral<T>::value ? FormatKind::Integer :
+        std::is_floating_point<T>::value ? FormatKind::Float :
+        FormatKind::String;
+}
+
+constexpr bool formatTypeMatches(FormatType type, FormatKind kind) {
+    return type == FormatType::Unspecified ||
+        (kind == FormatKind::Integer &&
+            (type == FormatType::Octal ||
+             type == FormatType::Decimal ||
+             type == FormatType::Hexadecimal ||
+             type == FormatType::HexadecimalUppercase)) ||
+        (kind == FormatKind::Float &&
+            (type == FormatType::Float ||
+             type == FormatType::FloatUppercase ||
+             type == FormatType::FloatExponent ||
+             type == FormatType::FloatExponentUppercase ||
+             type == FormatType::FloatFixed ||
+             type == FormatType::FloatFixedUppercase));
+}
+
+template<class ...Args> struct FormatKinds {
+    /* One more for a sentinel (C arrays can't have zero size) */
+    static constexpr FormatKind Data[sizeof...(Args) + 1]{
+        formatKind<Args>()..., FormatKind::String
+    };
+};
+template<class ...Args> constexpr FormatKind FormatKinds<Args...>::Data[];
+
+/* Placeholders without a matching argument are copied verbatim, so those
+   aren't checked */
+constexpr bool formatTypesMatch(const FormatChunk* chunks, std::size_t chunkCount, const FormatKind* kinds, std::size_t kindCount) {
+    return !chunkCount || ((!chunks->placeholder || std::size_t(chunks->argument) >= kindCount || formatTypeMatches(chunks->type, kinds[chunks->argument])) &&
+        formatTypesMatch(chunks + 1, chunkCount - 1, kinds, kindCount));
+}
+
+CORRADE_UTILITY_EXPORT std::size_t formatInto(const Containers::ArrayView<char>& buffer, const char* format, const FormatChunk* chunks, std::size_t chunkCount, BufferFormatter* formatters, std::size_t formattersCount);
+CORRADE_UTILITY_EXPORT std::size_t formatInto(std::string& buffer, std::size_t offset, const char* format, const FormatChunk* chunks, std::size_t chunkCount, BufferFormatter* formatters, std::size_t formattersCount);
+CORRADE_UTILITY_EXPORT void formatInto(std::FILE* file, const char* format, const FormatChunk* chunks, std::size_t chunkCount, FileFormatter* formatters, std::size_t formattersCount);
+
 }
 
 template<class ...Args> std::string formatString(const char* format, const Args&... args) {
@@ -351,6 +676,63 @@ template<class ...Args> void formatInto(std::FILE* file, const char* format, con
     Implementation::formatInto(file, format, formatters, sizeof...(args));
 }
 
+template<class Literal, class ...Args> std::string formatString(Implementation::FormatLiteral<Literal> format, const Args&... args) {
+    std::string buffer;
+    formatInto(buffer, 0, format, args...);
+    return buffer;
+}
+
+template<class Literal, class ...Args> std::size_t formatInto(const Containers::ArrayView<char>& buffer, Implementation::FormatLiteral<Literal>, const Args&... args) {
+    typedef Implementation::FormatCompiled<Literal> Format;
+    static_assert(Implementation::formatTypesMatch(Format::Chunks::Data, Format::ChunkCount, Implementation::FormatKinds<typename std::decay<Args>::type...>::Data, sizeof...(args)),
+        "Utility::format(): type specifier doesn't match the argument type");
+    Implementation::BufferFormatter formatters[sizeof...(args) + 1] { Implementation::BufferFormatter{args}..., {} };
+    return Implementation::formatInto(buffer, Literal::data(), Format::Chunks::Data, Format::ChunkCount, formatters, sizeof...(args));
+}
+
+template<class Literal, class ...Args> std::size_t formatInto(std::string& buffer, std::size_t offset, Implementation::FormatLiteral<Literal>, const Args&... args) {
+    typedef Implementation::FormatCompiled<Literal> Format;
+    static_assert(Implementation::formatTypesMatch(Format::Chunks::Data, Format::ChunkCount, Implementation::FormatKinds<typename std::decay<Args>::type...>::Data, sizeof...(args)),
+        "Utility::format(): type specifier doesn't match the argument type");
+    Implementation::BufferFormatter formatters[sizeof...(args) + 1] { Implementation::BufferFormatter{args}..., {} };
+    return Implementation::formatInto(buffer, offset, Literal::data(), Format::Chunks::Data, Format::ChunkCount, formatters, sizeof...(args));
+}
+
+template<class Literal, class ...Args> void formatInto(std::FILE* file, Implementation::FormatLiteral<Literal>, const Args&... args) {
+    typedef Implementation::FormatCompiled<Literal> Format;
+    static_assert(Implementation::formatTypesMatch(Format::Chunks::Data, Format::ChunkCount, Implementation::FormatKinds<typename std::decay<Args>::type...>::Data, sizeof...(args)),
+        "Utility::format(): type specifier doesn't match the argument type");
+    Implementation::FileFormatter formatters[sizeof...(args) + 1] { Implementation::FileFormatter{args}..., {} };
+    Implementation::formatInto(file, Literal::data(), Format::Chunks::Data, Format::ChunkCount, formatters, sizeof...(args));
+}
+
 }}
 
+/** @hideinitializer
+@brief Compile-time parsed format string
+@param format    Format string literal
+
+Parses and validates @p format at compile time, producing an object that can
+be passed to @ref Corrade::Utility::formatString(), @ref Corrade::Utility::formatInto(),
+@ref Corrade::Utility::print() and @ref Corrade::Utility::printError() in place
+of the format string. The @p format has to be a string literal. Example usage:
+
+@snippet Utility.cpp formatString-compiled
+
+See @ref Corrade::Utility::formatString() for more information about the
+templating language.
+
+@experimental
+*/
+/* The literal is wrapped in a local class to make it a part of a type, which
+   is the only way to get it into a constant expression in C++11 */
+#define CORRADE_FORMAT(format)                                              \
+    ::Corrade::Utility::Implementation::formatLiteral([] {                  \
+        struct Literal {                                                    \
+            static constexpr const char* data() { return format; }          \
+            static constexpr std::size_t size() { return sizeof(format) - 1; } \
+        };                                                                  \
+        return Literal{};                                                   \
+    }())
+
 #endif
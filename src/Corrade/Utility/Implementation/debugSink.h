@@ -0,0 +1,55 @@
+#ifndef Corrade_Utility_Implementation_debugSink_h
+#define Corrade_Utility_Implementation_debugSink_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <iosfwd>
+
+#include "Corrade/Utility/visibility.h"
+
+namespace Corrade { namespace Utility { namespace Implementation {
+
+/* DebugSink is in a separate library so Utility and its users don't need to
+   link to the threading library. Debug reaches the sink only through these
+   hooks, which the sink installs for as long as it's active. */
+struct DebugSinkHooks {
+    /* Returns a thread-local line buffer stream if output is the active sink
+       output or nullptr otherwise */
+    std::ostream*(*lineOutput)(std::ostream* output);
+    /* Publishes contents of the thread-local line buffer */
+    void(*publishLine)();
+    /* Returns the active sink destination if output is the active sink
+       output or output otherwise */
+    std::ostream*(*destination)(std::ostream* output);
+    /* Flushes the active sink */
+    void(*flush)();
+};
+
+/* Passing nullptr uninstalls the hooks */
+CORRADE_UTILITY_EXPORT void setDebugSinkHooks(const DebugSinkHooks* hooks);
+
+}}}
+
+#endif
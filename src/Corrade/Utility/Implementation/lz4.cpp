@@ -0,0 +1,166 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "lz4.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Corrade { namespace Utility { namespace Implementation {
+
+namespace {
+
+/* Constraints of the format -- the last five bytes are always literals and
+   the last match has to start at least twelve bytes before the end */
+enum: std::size_t {
+    MinMatch = 4,
+    LastLiterals = 5,
+    MatchFindLimit = 12,
+    MaxOffset = 65535,
+    HashBits = 16
+};
+
+inline std::uint32_t read32(const char* const data) {
+    /* Explicitly little-endian so the output is the same everywhere */
+    const unsigned char* const d = reinterpret_cast<const unsigned char*>(data);
+    return std::uint32_t(d[0])|(std::uint32_t(d[1]) << 8)|(std::uint32_t(d[2]) << 16)|(std::uint32_t(d[3]) << 24);
+}
+
+inline std::size_t hash(const std::uint32_t sequence) {
+    return (sequence*2654435761u) >> (32 - HashBits);
+}
+
+void writeLength(std::string& out, std::size_t length) {
+    for(; length >= 255; length -= 255) out += char(255);
+    out += char(length);
+}
+
+void writeSequence(std::string& out, const char* const literals, const std::size_t literalCount, const std::size_t offset, const std::size_t matchLength) {
+    const std::size_t matchCode = matchLength - MinMatch;
+    out += char(((literalCount < 15 ? literalCount : 15) << 4)|(matchCode < 15 ? matchCode : 15));
+    if(literalCount >= 15) writeLength(out, literalCount - 15);
+    out.append(literals, literalCount);
+    out += char(offset & 0xff);
+    out += char(offset >> 8);
+    if(matchCode >= 15) writeLength(out, matchCode - 15);
+}
+
+}
+
+std::string lz4Compress(const char* const data, const std::size_t size) {
+    std::string out;
+    out.reserve(size + size/255 + 16);
+
+    /* Positions of last occurences of four-byte sequences, offset by one so
+       zero means "none" */
+    std::vector<std::size_t> table(std::size_t{1} << HashBits);
+
+    std::size_t anchor = 0;
+    if(size > MatchFindLimit) {
+        const std::size_t matchFindEnd = size - MatchFindLimit;
+        const std::size_t matchEnd = size - LastLiterals;
+        for(std::size_t i = 0; i < matchFindEnd; ) {
+            const std::uint32_t sequence = read32(data + i);
+            std::size_t& entry = table[hash(sequence)];
+            const std::size_t candidate = entry;
+            entry = i + 1;
+
+            if(!candidate || i - (candidate - 1) > MaxOffset || read32(data + candidate - 1) != sequence) {
+                ++i;
+                continue;
+            }
+
+            /* Extend the match as far as possible */
+            const std::size_t match = candidate - 1;
+            std::size_t end = i + MinMatch;
+            while(end < matchEnd && data[end] == data[match + end - i]) ++end;
+
+            writeSequence(out, data + anchor, i - anchor, i - match, end - i);
+            i = anchor = end;
+        }
+    }
+
+    /* The rest is literals */
+    const std::size_t literalCount = size - anchor;
+    out += char((literalCount < 15 ? literalCount : 15) << 4);
+    if(literalCount >= 15) writeLength(out, literalCount - 15);
+    out.append(data + anchor, literalCount);
+
+    return out;
+}
+
+bool lz4Decompress(const char* const data, const std::size_t size, char* const output, const std::size_t outputSize) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* const inEnd = in + size;
+    char* out = output;
+    char* const outEnd = output + outputSize;
+
+    /* Reads a length extension, returns false on truncated input */
+    auto readLength = [&](std::size_t& length) {
+        unsigned char byte;
+        do {
+            if(in == inEnd) return false;
+            byte = *in++;
+            length += byte;
+        } while(byte == 255);
+        return true;
+    };
+
+    while(in != inEnd) {
+        const unsigned char token = *in++;
+
+        /* Literals */
+        std::size_t literalCount = token >> 4;
+        if(literalCount == 15 && !readLength(literalCount)) return false;
+        if(literalCount > std::size_t(inEnd - in) || literalCount > std::size_t(outEnd - out))
+            return false;
+        std::memcpy(out, in, literalCount);
+        in += literalCount;
+        out += literalCount;
+
+        /* The last sequence has only literals */
+        if(in == inEnd) break;
+
+        /* Match */
+        if(inEnd - in < 2) return false;
+        const std::size_t offset = in[0]|(std::size_t(in[1]) << 8);
+        in += 2;
+        if(!offset || offset > std::size_t(out - output)) return false;
+        std::size_t matchLength = token & 0x0f;
+        if(matchLength == 15 && !readLength(matchLength)) return false;
+        matchLength += MinMatch;
+        if(matchLength > std::size_t(outEnd - out)) return false;
+
+        /* The match can overlap the output, so it has to be copied byte by
+           byte */
+        const char* match = out - offset;
+        for(char* const end = out + matchLength; out != end; ) *out++ = *match++;
+    }
+
+    return out == outEnd;
+}
+
+}}}
@@ -0,0 +1,880 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "numberConversion.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#if LDBL_MANT_DIG > 64
+#include <locale>
+#include <sstream>
+#endif
+
+#include "Corrade/Containers/Array.h"
+#include "Corrade/Utility/Assert.h"
+
+namespace Corrade { namespace Utility { namespace Implementation {
+
+namespace {
+
+constexpr const char DigitsLowercase[] = "0123456789abcdef";
+constexpr const char DigitsUppercase[] = "0123456789ABCDEF";
+
+/* Same set as std::isspace() in the C locale */
+inline bool isWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+inline bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline const char* skipWhitespace(const char* it, const char* const end) {
+    while(it != end && isWhitespace(*it)) ++it;
+    return it;
+}
+
+inline unsigned digitValue(const char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 0xff;
+}
+
+template<unsigned base> std::size_t formatIntegerBase(char* const out, unsigned long long value, const char* const digits) {
+    /* Write the digits from the end of a temporary buffer, then copy */
+    char buffer[22];
+    char* it = buffer + sizeof(buffer);
+    do {
+        *--it = digits[value % base];
+        value /= base;
+    } while(value);
+
+    const std::size_t size = buffer + sizeof(buffer) - it;
+    std::memcpy(out, it, size);
+    return size;
+}
+
+/* Arbitrary-precision unsigned integer with a fixed capacity that's enough
+   for exact conversions of all supported floating-point types. The largest
+   numbers are needed for long double denormals, which have about 16500
+   bits after the binary point. */
+struct BigInt {
+    enum: std::size_t { Capacity = 640 };
+
+    std::uint32_t words[Capacity];
+    std::size_t size; /* The top word is always nonzero, zero has no words */
+};
+
+void set(BigInt& a, unsigned long long value) {
+    a.size = 0;
+    while(value) {
+        a.words[a.size++] = std::uint32_t(value);
+        value >>= 32;
+    }
+}
+
+void copy(BigInt& to, const BigInt& from) {
+    std::memcpy(to.words, from.words, from.size*sizeof(std::uint32_t));
+    to.size = from.size;
+}
+
+void multiply(BigInt& a, const std::uint32_t factor) {
+    std::uint64_t carry = 0;
+    for(std::size_t i = 0; i != a.size; ++i) {
+        const std::uint64_t product = std::uint64_t(a.words[i])*factor + carry;
+        a.words[i] = std::uint32_t(product);
+        carry = product >> 32;
+    }
+
+    if(carry) {
+        CORRADE_INTERNAL_ASSERT(a.size < BigInt::Capacity);
+        a.words[a.size++] = std::uint32_t(carry);
+    }
+}
+
+void add(BigInt& a, std::uint32_t value) {
+    for(std::size_t i = 0; value && i != a.size; ++i) {
+        const std::uint64_t sum = std::uint64_t(a.words[i]) + value;
+        a.words[i] = std::uint32_t(sum);
+        value = std::uint32_t(sum >> 32);
+    }
+
+    if(value) {
+        CORRADE_INTERNAL_ASSERT(a.size < BigInt::Capacity);
+        a.words[a.size++] = value;
+    }
+}
+
+constexpr std::uint32_t Powers10[]{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+void multiplyPow10(BigInt& a, unsigned exponent) {
+    for(; exponent >= 9; exponent -= 9) multiply(a, Powers10[9]);
+    if(exponent) multiply(a, Powers10[exponent]);
+}
+
+void shiftLeft(BigInt& a, const unsigned bits) {
+    if(!a.size || !bits) return;
+
+    const std::size_t words = bits/32;
+    const unsigned shift = bits%32;
+    CORRADE_INTERNAL_ASSERT(a.size + words + 1 <= BigInt::Capacity);
+
+    if(shift) {
+        a.words[a.size + words] = 0;
+        for(std::size_t i = a.size; i != 0; --i) {
+            a.words[i + words] |= a.words[i - 1] >> (32 - shift);
+            a.words[i + words - 1] = a.words[i - 1] << shift;
+        }
+    } else for(std::size_t i = a.size; i != 0; --i)
+        a.words[i + words - 1] = a.words[i - 1];
+
+    for(std::size_t i = 0; i != words; ++i) a.words[i] = 0;
+
+    a.size += words + (shift && a.words[a.size + words] ? 1 : 0);
+}
+
+void shiftRightOne(BigInt& a) {
+    for(std::size_t i = 0; i + 1 < a.size; ++i)
+        a.words[i] = (a.words[i] >> 1)|(a.words[i + 1] << 31);
+    if(a.size) {
+        a.words[a.size - 1] >>= 1;
+        if(!a.words[a.size - 1]) --a.size;
+    }
+}
+
+int compare(const BigInt& a, const BigInt& b) {
+    if(a.size != b.size) return a.size < b.size ? -1 : 1;
+    for(std::size_t i = a.size; i != 0; --i)
+        if(a.words[i - 1] != b.words[i - 1])
+            return a.words[i - 1] < b.words[i - 1] ? -1 : 1;
+    return 0;
+}
+
+/* Expects a >= b */
+void subtract(BigInt& a, const BigInt& b) {
+    std::uint32_t borrow = 0;
+    for(std::size_t i = 0; i != a.size; ++i) {
+        const std::uint64_t subtrahend = std::uint64_t(i < b.size ? b.words[i] : 0) + borrow;
+        borrow = a.words[i] < subtrahend ? 1 : 0;
+        a.words[i] = std::uint32_t(a.words[i] - subtrahend);
+    }
+    while(a.size && !a.words[a.size - 1]) --a.size;
+}
+
+int bitLength(const unsigned long long value) {
+    int bits = 0;
+    for(unsigned long long v = value; v; v >>= 1) ++bits;
+    return bits;
+}
+
+int bitLength(const BigInt& a) {
+    return a.size ? int(a.size - 1)*32 + bitLength(a.words[a.size - 1]) : 0;
+}
+
+inline bool bit(const BigInt& a, const int i) {
+    return std::size_t(i/32) < a.size && (a.words[i/32] >> (i%32)) & 1;
+}
+
+/* Whether any of bits [0, count) is set */
+bool anyBitBelow(const BigInt& a, const int count) {
+    const std::size_t words = count/32;
+    for(std::size_t i = 0; i != words && i != a.size; ++i)
+        if(a.words[i]) return true;
+    return words < a.size && count % 32 && a.words[words] & ((1u << (count % 32)) - 1);
+}
+
+/* Bits [begin, begin + count) of a, count being at most 64 */
+unsigned long long bits(const BigInt& a, const int begin, const int count) {
+    unsigned long long out = 0;
+    for(int i = count; i != 0; --i) out = (out << 1)|(bit(a, begin + i - 1) ? 1 : 0);
+    return out;
+}
+
+/* Divides a by b, with the quotient expected to be small. The remainder is
+   left in a, b is modified. */
+void divide(BigInt& a, BigInt& b, BigInt& quotient) {
+    quotient.size = 0;
+    const int shift = bitLength(a) - bitLength(b);
+    if(shift < 0) return;
+
+    quotient.size = shift/32 + 1;
+    CORRADE_INTERNAL_ASSERT(quotient.size <= BigInt::Capacity);
+    std::memset(quotient.words, 0, quotient.size*sizeof(std::uint32_t));
+
+    shiftLeft(b, shift);
+    for(int i = shift; i >= 0; --i) {
+        if(compare(a, b) >= 0) {
+            subtract(a, b);
+            quotient.words[i/32] |= 1u << (i%32);
+        }
+        if(i) shiftRightOne(b);
+    }
+
+    while(quotient.size && !quotient.words[quotient.size - 1]) --quotient.size;
+}
+
+/* Fraction used by the fast path in DecimalDigits, with four bits spare for
+   the multiplication by ten */
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 FastFraction;
+#else
+typedef unsigned long long FastFraction;
+#endif
+enum: int { FastFractionBits = sizeof(FastFraction)*8 - 4 };
+
+/* Rounds `count` digits up, returns the decimal exponent of the first digit,
+   which is one larger if all digits were nines */
+int roundUp(char* const digits, const int count, const int exponent) {
+    int i = count - 1;
+    for(; i >= 0 && digits[i] == '9'; --i) digits[i] = '0';
+    if(i >= 0) {
+        ++digits[i];
+        return exponent;
+    }
+
+    digits[0] = '1';
+    return exponent + 1;
+}
+
+/* Exact decimal digit generation for a value of m·2^e */
+struct DecimalDigits {
+    /* Scales the value so numerator/denominator is in [1, 10) and returns
+       the decimal exponent of the first digit */
+    int scale(unsigned long long m, int e) {
+        /* If the integer part fits into 64 bits and the fractional part
+           into FastFraction, the digits can be calculated without any
+           arbitrary-precision arithmetic. That's the case for the vast
+           majority of values printed in practice. */
+        fast = e >= 0 ? bitLength(m) + e <= 64 : -e <= FastFractionBits;
+        if(fast) return scaleFast(m, e);
+
+        set(numerator, m);
+        set(denominator, 1);
+        if(e > 0) shiftLeft(numerator, e);
+        else if(e < 0) shiftLeft(denominator, -e);
+
+        /* The value is in [2^(bits - 1), 2^bits), so this estimate is either
+           exact or one less than the real exponent */
+        int exponent = int(std::floor((bitLength(m) + e - 1)*0.30102999566398119521));
+        if(exponent > 0) multiplyPow10(denominator, exponent);
+        else if(exponent < 0) multiplyPow10(numerator, -exponent);
+
+        copy(scratch, denominator);
+        multiply(scratch, 10);
+        if(compare(numerator, scratch) >= 0) {
+            copy(denominator, scratch);
+            ++exponent;
+        }
+
+        return exponent;
+    }
+
+    /* Generates `count` digits rounded with ties to even and returns the
+       decimal exponent of the first digit, which is one larger than the
+       scaled exponent if all digits were rounded up. If `count` is zero,
+       the value is rounded to a single digit one position above the first
+       digit, in which case `count` is set to either zero or one. */
+    int generate(char* const digits, int& count, int exponent) {
+        if(count < 0) {
+            count = 0;
+            return exponent;
+        }
+
+        if(fast) return generateFast(digits, count, exponent);
+
+        /* Rounding to a position above the first digit, the result is
+           either zero or one at that position */
+        if(count == 0) {
+            copy(scratch, denominator);
+            multiply(scratch, 5);
+            if(compare(numerator, scratch) > 0) {
+                digits[0] = '1';
+                count = 1;
+                return exponent + 1;
+            }
+            return exponent;
+        }
+
+        for(int i = 0; i != count; ++i) {
+            if(!numerator.size) {
+                /* Exact value, the rest is zeros and there's no rounding */
+                std::memset(digits + i, '0', count - i);
+                return exponent;
+            }
+
+            if(i) multiply(numerator, 10);
+            char digit = '0';
+            while(compare(numerator, denominator) >= 0) {
+                subtract(numerator, denominator);
+                ++digit;
+            }
+            digits[i] = digit;
+        }
+
+        /* Round the remainder with ties to even */
+        shiftLeft(numerator, 1);
+        const int result = compare(numerator, denominator);
+        if(result > 0 || (result == 0 && (digits[count - 1] - '0') % 2))
+            return roundUp(digits, count, exponent);
+
+        return exponent;
+    }
+
+    /* The value is split into an integer part, whose digits are calculated
+       upfront into `pending`, and a fraction with `fractionBits` bits,
+       producing the subsequent digits one by one by multiplying by ten */
+    int scaleFast(const unsigned long long m, const int e) {
+        unsigned long long integer;
+        if(e >= 0) {
+            integer = m << e;
+            fraction = 0;
+            fractionBits = 0;
+        } else {
+            fractionBits = -e;
+            integer = fractionBits < 64 ? m >> fractionBits : 0;
+            fraction = FastFraction(m) & ((FastFraction(1) << fractionBits) - 1);
+        }
+
+        pendingIndex = 0;
+        if(integer) {
+            pendingCount = int(formatIntegerBase<10>(pending, integer, DigitsLowercase));
+            return pendingCount - 1;
+        }
+
+        /* Skip leading zeros of the fraction, keeping the first significant
+           digit. The value is nonzero, so this terminates. */
+        for(int exponent = -1; ; --exponent) {
+            const char digit = nextFractionDigit();
+            if(digit != '0') {
+                pending[0] = digit;
+                pendingCount = 1;
+                return exponent;
+            }
+        }
+    }
+
+    int generateFast(char* const digits, int& count, const int exponent) {
+        /* Rounding to a position above the first digit, same as above */
+        if(count == 0) {
+            const char first = nextDigit();
+            if(first > '5' || (first == '5' && hasRemainder())) {
+                digits[0] = '1';
+                count = 1;
+                return exponent + 1;
+            }
+            return exponent;
+        }
+
+        for(int i = 0; i != count; ++i) digits[i] = nextDigit();
+
+        /* Round the remainder with ties to even */
+        const char next = nextDigit();
+        if(next > '5' || (next == '5' && (hasRemainder() || (digits[count - 1] - '0') % 2)))
+            return roundUp(digits, count, exponent);
+
+        return exponent;
+    }
+
+    char nextFractionDigit() {
+        fraction *= 10;
+        const char digit = char('0' + int(fraction >> fractionBits));
+        fraction &= (FastFraction(1) << fractionBits) - 1;
+        return digit;
+    }
+
+    char nextDigit() {
+        return pendingIndex < pendingCount ? pending[pendingIndex++] : nextFractionDigit();
+    }
+
+    /* Whether there's anything nonzero after the digits consumed so far */
+    bool hasRemainder() const {
+        for(int i = pendingIndex; i < pendingCount; ++i)
+            if(pending[i] != '0') return true;
+        return fraction != 0;
+    }
+
+    BigInt numerator, denominator, scratch;
+
+    bool fast;
+    int fractionBits;
+    int pendingCount, pendingIndex;
+    char pending[22];
+    FastFraction fraction;
+};
+
+struct Writer {
+    void put(const char c) {
+        if(written < size) data[written] = c;
+        ++written;
+    }
+
+    void put(const char* string) {
+        for(; *string; ++string) put(*string);
+    }
+
+    char* data;
+    std::size_t size;
+    std::size_t written;
+};
+
+/* Decomposes a finite positive value to m·2^e with m odd */
+template<class T> void decompose(const T value, unsigned long long& m, int& e) {
+    static_assert(std::numeric_limits<T>::digits <= 64, "mantissa too large");
+
+    int exponent;
+    const T fraction = std::frexp(value, &exponent);
+    m = static_cast<unsigned long long>(std::ldexp(fraction, std::numeric_limits<T>::digits));
+    e = exponent - std::numeric_limits<T>::digits;
+
+    /* Strip trailing zero bits to keep the numbers small */
+    while(!(m & 1)) {
+        m >>= 1;
+        ++e;
+    }
+}
+
+template<class T> std::size_t formatFloatingPointInternal(char* const out, const std::size_t size, T value, const char type, int precision) {
+    Writer writer{out, size, 0};
+    const bool uppercase = type == 'E' || type == 'F' || type == 'G';
+    const char lowercaseType = char(type|0x20);
+    CORRADE_INTERNAL_ASSERT(lowercaseType == 'e' || lowercaseType == 'f' || lowercaseType == 'g');
+    if(precision < 0) precision = 6;
+
+    /* Like printf(), print the sign also for negative zero and NaN */
+    if(std::signbit(value)) {
+        writer.put('-');
+        value = -value;
+    }
+
+    if(std::isnan(value)) {
+        writer.put(uppercase ? "NAN" : "nan");
+        return writer.written;
+    }
+
+    if(std::isinf(value)) {
+        writer.put(uppercase ? "INF" : "inf");
+        return writer.written;
+    }
+
+    /* Calculate the digits. Zero is all zero digits with a zero exponent. */
+    unsigned long long m = 0;
+    int e = 0;
+    if(value != T(0)) decompose(value, m, e);
+
+    DecimalDigits generator;
+    const int scaledExponent = m ? generator.scale(m, e) : 0;
+    int count;
+    if(lowercaseType == 'f') count = scaledExponent + 1 + precision;
+    else if(lowercaseType == 'e') count = precision + 1;
+    else count = precision ? precision : 1;
+
+    char stackDigits[64];
+    Containers::Array<char> heapDigits;
+    char* digits = stackDigits;
+    if(count > int(sizeof(stackDigits))) {
+        heapDigits = Containers::Array<char>{Containers::NoInit, std::size_t(count)};
+        digits = heapDigits;
+    }
+
+    int exponent;
+    if(m) exponent = generator.generate(digits, count, scaledExponent);
+    else {
+        exponent = 0;
+        if(count > 0) std::memset(digits, '0', count);
+    }
+
+    /* Digit at given decimal position, zero outside of the generated range */
+    auto digitAt = [&](const int position) {
+        const int index = exponent - position;
+        return index >= 0 && index < count ? digits[index] : '0';
+    };
+
+    /* For %g, pick the style based on the exponent and drop trailing zeros */
+    char style = lowercaseType;
+    bool stripZeros = false;
+    if(lowercaseType == 'g') {
+        const int significant = precision ? precision : 1;
+        stripZeros = true;
+        if(exponent < -4 || exponent >= significant) {
+            style = 'e';
+            precision = significant - 1;
+        } else {
+            style = 'f';
+            precision = significant - 1 - exponent;
+        }
+    }
+
+    if(style == 'e') {
+        int fractionDigits = precision;
+        if(stripZeros) while(fractionDigits && digitAt(exponent - fractionDigits) == '0')
+            --fractionDigits;
+
+        writer.put(digitAt(exponent));
+        if(fractionDigits) writer.put('.');
+        for(int i = 1; i <= fractionDigits; ++i)
+            writer.put(digitAt(exponent - i));
+
+        writer.put(uppercase ? 'E' : 'e');
+        writer.put(exponent < 0 ? '-' : '+');
+        char exponentDigits[22];
+        const std::size_t exponentSize = formatIntegerBase<10>(exponentDigits, exponent < 0 ? -exponent : exponent, DigitsLowercase);
+        if(exponentSize < 2) writer.put('0');
+        for(std::size_t i = 0; i != exponentSize; ++i)
+            writer.put(exponentDigits[i]);
+
+    } else {
+        int fractionDigits = precision;
+        if(stripZeros) while(fractionDigits && digitAt(-fractionDigits) == '0')
+            --fractionDigits;
+
+        if(exponent >= 0 && count) for(int i = exponent; i >= 0; --i)
+            writer.put(digitAt(i));
+        else writer.put('0');
+        if(fractionDigits) writer.put('.');
+        for(int i = 1; i <= fractionDigits; ++i)
+            writer.put(digitAt(-i));
+    }
+
+    return writer.written;
+}
+
+/* Matches a lowercase string case-insensitively, returns pointer after it
+   or nullptr */
+const char* matchIgnoreCase(const char* it, const char* const end, const char* string) {
+    for(; *string; ++string, ++it)
+        if(it == end || (*it|0x20) != *string) return nullptr;
+    return it;
+}
+
+constexpr long double ExactPowers10[]{
+    1.0e0l, 1.0e1l, 1.0e2l, 1.0e3l, 1.0e4l, 1.0e5l, 1.0e6l, 1.0e7l, 1.0e8l,
+    1.0e9l, 1.0e10l, 1.0e11l, 1.0e12l, 1.0e13l, 1.0e14l, 1.0e15l, 1.0e16l,
+    1.0e17l, 1.0e18l, 1.0e19l, 1.0e20l, 1.0e21l, 1.0e22l, 1.0e23l, 1.0e24l,
+    1.0e25l, 1.0e26l, 1.0e27l
+};
+
+/* Largest power of ten that's exactly representable in given type, i.e.
+   5^n fits into the mantissa */
+constexpr int maxExactPower10(int digits) {
+    return digits >= 64 ? 27 : digits >= 53 ? 22 : digits >= 24 ? 10 : 0;
+}
+
+template<class T> const char* parseFloatingPointInternal(const char* const begin, const char* const end, T& value) {
+    /* With 800 significant digits the rounding is always correct for floats
+       and doubles. Longer inputs are truncated, remembering whether any of
+       the truncated digits was nonzero. */
+    enum: std::size_t { MaxDigits = 800 };
+    typedef std::numeric_limits<T> Limits;
+
+    value = T(0);
+    const char* it = skipWhitespace(begin, end);
+    bool negative = false;
+    if(it != end && (*it == '+' || *it == '-')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    /* Infinity and NaN */
+    if(const char* const inf = matchIgnoreCase(it, end, "inf")) {
+        value = negative ? -Limits::infinity() : Limits::infinity();
+        const char* const infinity = matchIgnoreCase(inf, end, "inity");
+        return infinity ? infinity : inf;
+    }
+    if(const char* const nan = matchIgnoreCase(it, end, "nan")) {
+        value = negative ? -Limits::quiet_NaN() : Limits::quiet_NaN();
+        return nan;
+    }
+
+    /* Significant digits, the value is digits·10^exponent */
+    char digits[MaxDigits + 1];
+    std::size_t digitCount = 0;
+    long exponent = 0;
+    bool hasDigits = false, truncated = false;
+    for(; it != end && isDigit(*it); ++it) {
+        hasDigits = true;
+        if(!digitCount && *it == '0') continue;
+        if(digitCount < MaxDigits) digits[digitCount++] = *it;
+        else {
+            ++exponent;
+            if(*it != '0') truncated = true;
+        }
+    }
+    if(it != end && *it == '.') {
+        const char* fraction = it + 1;
+        for(; fraction != end && isDigit(*fraction); ++fraction) {
+            hasDigits = true;
+            if(!digitCount && *fraction == '0') --exponent;
+            else if(digitCount < MaxDigits) {
+                digits[digitCount++] = *fraction;
+                --exponent;
+            } else if(*fraction != '0') truncated = true;
+        }
+        if(hasDigits) it = fraction;
+    }
+    if(!hasDigits) return nullptr;
+
+    /* Exponent, consumed only if there are digits after the e */
+    if(it != end && (*it == 'e' || *it == 'E')) {
+        const char* e = it + 1;
+        bool exponentNegative = false;
+        if(e != end && (*e == '+' || *e == '-')) {
+            exponentNegative = *e == '-';
+            ++e;
+        }
+        if(e != end && isDigit(*e)) {
+            long explicitExponent = 0;
+            for(; e != end && isDigit(*e); ++e)
+                if(explicitExponent < 100000)
+                    explicitExponent = explicitExponent*10 + (*e - '0');
+            exponent += exponentNegative ? -explicitExponent : explicitExponent;
+            it = e;
+        }
+    }
+
+    /* Drop trailing zeros, add a nonzero digit at the end if something
+       nonzero got truncated */
+    while(digitCount && digits[digitCount - 1] == '0') {
+        --digitCount;
+        ++exponent;
+    }
+    if(truncated) {
+        digits[digitCount++] = '1';
+        --exponent;
+    }
+
+    if(!digitCount) {
+        value = negative ? -T(0) : T(0);
+        return it;
+    }
+
+    /* Values clearly out of range */
+    const long leadingExponent = exponent + long(digitCount) - 1;
+    if(leadingExponent > Limits::max_exponent10) {
+        value = negative ? -Limits::infinity() : Limits::infinity();
+        return it;
+    }
+    if(leadingExponent < Limits::min_exponent10 - Limits::max_digits10 - 2) {
+        value = negative ? -T(0) : T(0);
+        return it;
+    }
+
+    /* Fast path if both the digits and the power of ten are exactly
+       representable, then a single multiplication or division is correctly
+       rounded. Not done on platforms that evaluate in a larger precision, as
+       there it would round twice. */
+    constexpr int maxExactPower = maxExactPower10(Limits::digits);
+    #if FLT_EVAL_METHOD == 0
+    constexpr bool fastPathAllowed = true;
+    #else
+    constexpr bool fastPathAllowed = std::is_same<T, long double>::value;
+    #endif
+    if(fastPathAllowed && digitCount <= 19 && exponent >= -maxExactPower && exponent <= maxExactPower) {
+        unsigned long long integer = 0;
+        for(std::size_t i = 0; i != digitCount; ++i)
+            integer = integer*10 + (digits[i] - '0');
+        if(Limits::digits >= 64 || integer <= (1ull << (Limits::digits % 64))) {
+            value = T(integer);
+            if(exponent >= 0) value *= T(ExactPowers10[exponent]);
+            else value /= T(ExactPowers10[-exponent]);
+            if(negative) value = -value;
+            return it;
+        }
+    }
+
+    /* Otherwise calculate the exact value as a big integer or a quotient of
+       two big integers and round that */
+    BigInt a;
+    set(a, 0);
+    for(std::size_t i = 0; i < digitCount; i += 9) {
+        const std::size_t chunk = digitCount - i < 9 ? digitCount - i : 9;
+        std::uint32_t chunkValue = 0;
+        for(std::size_t j = 0; j != chunk; ++j)
+            chunkValue = chunkValue*10 + (digits[i + j] - '0');
+        multiply(a, Powers10[chunk]);
+        add(a, chunkValue);
+    }
+
+    BigInt quotient;
+    int lsbExponent = 0;
+    bool sticky = false;
+    if(exponent >= 0) {
+        multiplyPow10(a, exponent);
+        copy(quotient, a);
+    } else {
+        BigInt b;
+        set(b, 1);
+        multiplyPow10(b, -exponent);
+
+        /* Shift so the quotient has a few more bits than the mantissa */
+        const int shift = Limits::digits + 3 + bitLength(b) - bitLength(a);
+        if(shift > 0) shiftLeft(a, shift);
+        else if(shift < 0) shiftLeft(b, -shift);
+        lsbExponent = -shift;
+
+        divide(a, b, quotient);
+        sticky = a.size != 0;
+    }
+
+    /* Round to the mantissa size with ties to even, with denormals having
+       less bits */
+    constexpr int digitsBits = Limits::digits;
+    constexpr int minExponent = Limits::min_exponent - Limits::digits;
+    const int quotientBits = bitLength(quotient);
+    int binaryExponent = lsbExponent + quotientBits - digitsBits;
+    if(binaryExponent < minExponent) binaryExponent = minExponent;
+    const int shift = binaryExponent - lsbExponent;
+    unsigned long long mantissa;
+    if(shift <= 0) mantissa = bits(quotient, 0, quotientBits) << -shift;
+    else {
+        mantissa = quotientBits > shift ? bits(quotient, shift, quotientBits - shift) : 0;
+        if(bit(quotient, shift - 1) && (sticky || anyBitBelow(quotient, shift - 1) || mantissa & 1)) {
+            ++mantissa;
+            if(digitsBits >= 64 ? mantissa == 0 : mantissa == 1ull << (digitsBits%64)) {
+                mantissa = 1ull << (digitsBits - 1);
+                ++binaryExponent;
+            }
+        }
+    }
+
+    if(binaryExponent > Limits::max_exponent - digitsBits)
+        value = Limits::infinity();
+    else value = std::ldexp(T(mantissa), binaryExponent);
+    if(negative) value = -value;
+    return it;
+}
+
+}
+
+std::size_t formatInteger(char* const out, const unsigned long long value, const unsigned base, const bool uppercase) {
+    const char* const digits = uppercase ? DigitsUppercase : DigitsLowercase;
+    switch(base) {
+        case 8: return formatIntegerBase<8>(out, value, digits);
+        case 10: return formatIntegerBase<10>(out, value, digits);
+        case 16: return formatIntegerBase<16>(out, value, digits);
+    }
+
+    CORRADE_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+const char* parseInteger(const char* const begin, const char* const end, const unsigned base, unsigned long long& magnitude, bool& negative, bool& overflow) {
+    magnitude = 0;
+    negative = false;
+    overflow = false;
+
+    const char* it = skipWhitespace(begin, end);
+    if(it != end && (*it == '+' || *it == '-')) {
+        negative = *it == '-';
+        ++it;
+    }
+
+    /* Like std::num_get, a 0x prefix alone is parsed as a zero */
+    bool hasDigits = false;
+    if(base == 16 && it != end && *it == '0' && it + 1 != end && (it[1] == 'x' || it[1] == 'X')) {
+        it += 2;
+        hasDigits = true;
+    }
+
+    for(; it != end; ++it) {
+        const unsigned digit = digitValue(*it);
+        if(digit >= base) break;
+
+        hasDigits = true;
+        if(overflow) continue;
+        if(magnitude > (~0ull - digit)/base) {
+            overflow = true;
+            magnitude = ~0ull;
+        } else magnitude = magnitude*base + digit;
+    }
+
+    if(!hasDigits) {
+        negative = false;
+        return nullptr;
+    }
+
+    return it;
+}
+
+std::size_t formatFloatingPoint(char* const out, const std::size_t size, const float value, const char type, const int precision) {
+    return formatFloatingPointInternal(out, size, value, type, precision);
+}
+
+std::size_t formatFloatingPoint(char* const out, const std::size_t size, const double value, const char type, const int precision) {
+    return formatFloatingPointInternal(out, size, value, type, precision);
+}
+
+const char* parseFloatingPoint(const char* const begin, const char* const end, float& value) {
+    return parseFloatingPointInternal(begin, end, value);
+}
+
+const char* parseFloatingPoint(const char* const begin, const char* const end, double& value) {
+    return parseFloatingPointInternal(begin, end, value);
+}
+
+#if LDBL_MANT_DIG <= 64
+std::size_t formatFloatingPoint(char* const out, const std::size_t size, const long double value, const char type, const int precision) {
+    return formatFloatingPointInternal(out, size, value, type, precision);
+}
+
+const char* parseFloatingPoint(const char* const begin, const char* const end, long double& value) {
+    return parseFloatingPointInternal(begin, end, value);
+}
+#else
+/* The exact algorithms work with mantissas of at most 64 bits, use streams
+   with the classic locale for quad-precision long doubles instead */
+std::size_t formatFloatingPoint(char* const out, const std::size_t size, const long double value, const char type, const int precision) {
+    std::ostringstream stream;
+    stream.imbue(std::locale::classic());
+    if((type|0x20) == 'e') stream.setf(std::ios::scientific, std::ios::floatfield);
+    else if((type|0x20) == 'f') stream.setf(std::ios::fixed, std::ios::floatfield);
+    if(type == 'E' || type == 'F' || type == 'G') stream.setf(std::ios::uppercase);
+    stream.precision(precision < 0 ? 6 : precision);
+    stream << value;
+
+    const std::string string = stream.str();
+    std::memcpy(out, string.data(), string.size() < size ? string.size() : size);
+    return string.size();
+}
+
+const char* parseFloatingPoint(const char* const begin, const char* const end, long double& value) {
+    const std::string string{begin, end};
+    std::istringstream stream{string};
+    stream.imbue(std::locale::classic());
+    value = 0.0l;
+    if(!(stream >> value)) {
+        value = 0.0l;
+        return nullptr;
+    }
+    return stream.eof() ? end : begin + std::size_t(stream.tellg());
+}
+#endif
+
+}}}
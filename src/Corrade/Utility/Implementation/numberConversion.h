@@ -0,0 +1,71 @@
+#ifndef Corrade_Utility_Implementation_numberConversion_h
+#define Corrade_Utility_Implementation_numberConversion_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstddef>
+
+#include "Corrade/Utility/visibility.h"
+
+namespace Corrade { namespace Utility { namespace Implementation {
+
+/* Locale-independent number conversion that doesn't allocate, used by
+   ConfigurationValue and Formatter. Exposed like this so we can test it. */
+
+/* Writes digits of an unsigned integer in base 8, 10 or 16 to out, which has
+   to have space for at least 22 characters. Returns the number of characters
+   written. */
+CORRADE_UTILITY_EXPORT std::size_t formatInteger(char* out, unsigned long long value, unsigned base, bool uppercase);
+
+/* Parses an integer in base 8, 10 or 16 the same way as std::num_get does:
+   leading whitespace is skipped, an optional sign follows and in base 16 an
+   optional 0x / 0X prefix. Returns pointer after the last consumed
+   character and fills the magnitude and sign, or returns nullptr if there
+   are no digits. The overflow flag is set if the magnitude doesn't fit into
+   64 bits, in which case the magnitude is saturated. */
+CORRADE_UTILITY_EXPORT const char* parseInteger(const char* begin, const char* end, unsigned base, unsigned long long& magnitude, bool& negative, bool& overflow);
+
+/* Formats a floating-point value the same way as printf() does with the %e,
+   %E, %f, %F, %g or %G conversion specifier (given in type) and given
+   precision, exactly rounded with ties to even. Writes at most size
+   characters (and no null terminator) to out and returns the total number
+   of characters the output would have. */
+CORRADE_UTILITY_EXPORT std::size_t formatFloatingPoint(char* out, std::size_t size, float value, char type, int precision);
+CORRADE_UTILITY_EXPORT std::size_t formatFloatingPoint(char* out, std::size_t size, double value, char type, int precision);
+CORRADE_UTILITY_EXPORT std::size_t formatFloatingPoint(char* out, std::size_t size, long double value, char type, int precision);
+
+/* Parses a decimal floating-point value with correct rounding to given type.
+   Leading whitespace is skipped, accepts an optional sign, digits with an
+   optional decimal point, an optional exponent and also `inf`, `infinity`
+   and `nan` in any case. Values too large for the type are parsed as an
+   infinity. Returns pointer after the last consumed character, or nullptr
+   if there's no number, in which case value is set to zero. */
+CORRADE_UTILITY_EXPORT const char* parseFloatingPoint(const char* begin, const char* end, float& value);
+CORRADE_UTILITY_EXPORT const char* parseFloatingPoint(const char* begin, const char* end, double& value);
+CORRADE_UTILITY_EXPORT const char* parseFloatingPoint(const char* begin, const char* end, long double& value);
+
+}}}
+
+#endif
@@ -27,7 +27,7 @@
 
 namespace Corrade { namespace Utility { namespace Implementation {
 
-unsigned int MurmurHash2<4>::operator()(const unsigned int seed, const char* const signedData, unsigned int size) const {
+unsigned int MurmurHash2<4>::runtime(const unsigned int seed, const char* const signedData, unsigned int size) {
     const unsigned char* const data = reinterpret_cast<const unsigned char*>(signedData);
 
     /* m and r are mixing constants generated offline. They're not really
@@ -72,7 +72,7 @@ unsigned int MurmurHash2<4>::operator()(const unsigned int seed, const char* con
     return h;
 }
 
-unsigned long long MurmurHash2<8>::operator()(const unsigned long long seed, const char* const signedData, unsigned long long size) const {
+unsigned long long MurmurHash2<8>::runtime(const unsigned long long seed, const char* const signedData, unsigned long long size) {
     const unsigned char* const data = reinterpret_cast<const unsigned char*>(signedData);
 
     /* m and r are mixing constants generated offline. They're not really
@@ -32,19 +32,129 @@
 #include <cstddef>
 #include <string>
 
+#include "Corrade/configure.h"
 #include "Corrade/Utility/AbstractHash.h"
 #include "Corrade/Utility/visibility.h"
 
 namespace Corrade { namespace Utility {
 
 namespace Implementation {
+    /* The hash is calculated with recursive C++11 constexpr functions for
+       inputs up to MurmurHash2ConstexprSizeLimit bytes so digests of string
+       literals fold into constants, the recursion depth stays well below the
+       compiler limits. Longer inputs are hashed with a loop in the
+       non-constexpr runtime() function, which is also used directly for all
+       data that aren't string literals. */
+    enum: std::size_t { MurmurHash2ConstexprSizeLimit = 1024 };
+
+    constexpr unsigned int murmurHash2Byte(char data) {
+        return static_cast<unsigned char>(data);
+    }
+
     template<std::size_t> struct MurmurHash2;
-    template<> struct CORRADE_UTILITY_EXPORT MurmurHash2<4> {
-        unsigned int operator()(unsigned int seed, const char* data, unsigned int size) const;
+    template<> struct MurmurHash2<4> {
+        enum: unsigned int { M = 0x5bd1e995u };
+        enum: int { R = 24 };
+
+        constexpr unsigned int operator()(unsigned int seed, const char* data, unsigned int size) const {
+            return size <= MurmurHash2ConstexprSizeLimit ?
+                finalize(body(seed^size, data, size)) :
+                runtime(seed, data, size);
+        }
+
+        CORRADE_UTILITY_EXPORT static unsigned int runtime(unsigned int seed, const char* data, unsigned int size);
+
+        private:
+            constexpr static unsigned int mix(unsigned int k) {
+                return (k ^ (k >> R))*M;
+            }
+            constexpr static unsigned int read(const char* data) {
+                return murmurHash2Byte(data[0]) |
+                       murmurHash2Byte(data[1]) << 8 |
+                       murmurHash2Byte(data[2]) << 16 |
+                       murmurHash2Byte(data[3]) << 24;
+            }
+            constexpr static unsigned int tail(unsigned int h, const char* data, unsigned int size) {
+                return size ? (h ^
+                    (size > 2 ? murmurHash2Byte(data[2]) << 16 : 0) ^
+                    (size > 1 ? murmurHash2Byte(data[1]) << 8 : 0) ^
+                    murmurHash2Byte(data[0]))*M : h;
+            }
+            constexpr static unsigned int body(unsigned int h, const char* data, unsigned int size) {
+                return size >= 4 ?
+                    body((h*M) ^ mix(read(data)*M), data + 4, size - 4) :
+                    tail(h, data, size);
+            }
+            constexpr static unsigned int finalizeMultiplied(unsigned int h) {
+                return h ^ (h >> 15);
+            }
+            constexpr static unsigned int finalize(unsigned int h) {
+                return finalizeMultiplied((h ^ (h >> 13))*M);
+            }
     };
-    template<> struct CORRADE_UTILITY_EXPORT MurmurHash2<8> {
-        unsigned long long operator()(unsigned long long seed, const char* data, unsigned long long size) const;
+    template<> struct MurmurHash2<8> {
+        enum: unsigned long long { M = 0xc6a4a7935bd1e995ull };
+        enum: int { R = 47 };
+
+        constexpr unsigned long long operator()(unsigned long long seed, const char* data, unsigned long long size) const {
+            return size <= MurmurHash2ConstexprSizeLimit ?
+                finalize(body(seed^(size*M), data, size)) :
+                runtime(seed, data, size);
+        }
+
+        CORRADE_UTILITY_EXPORT static unsigned long long runtime(unsigned long long seed, const char* data, unsigned long long size);
+
+        private:
+            constexpr static unsigned long long mix(unsigned long long k) {
+                return (k ^ (k >> R))*M;
+            }
+            constexpr static unsigned long long read(const char* data) {
+                return static_cast<unsigned long long>(murmurHash2Byte(data[0]) |
+                       murmurHash2Byte(data[1]) << 8 |
+                       murmurHash2Byte(data[2]) << 16 |
+                       murmurHash2Byte(data[3]) << 24) |
+                       static_cast<unsigned long long>(murmurHash2Byte(data[4]) |
+                       murmurHash2Byte(data[5]) << 8 |
+                       murmurHash2Byte(data[6]) << 16 |
+                       murmurHash2Byte(data[7]) << 24) << 32;
+            }
+            constexpr static unsigned long long tailBytes(const char* data, unsigned long long size) {
+                return size ? static_cast<unsigned long long>(murmurHash2Byte(data[size - 1])) << 8*(size - 1) ^
+                    tailBytes(data, size - 1) : 0;
+            }
+            constexpr static unsigned long long tail(unsigned long long h, const char* data, unsigned long long size) {
+                return size ? (h ^ tailBytes(data, size))*M : h;
+            }
+            constexpr static unsigned long long body(unsigned long long h, const char* data, unsigned long long size) {
+                return size >= 8 ?
+                    body((h ^ mix(read(data)*M))*M, data + 8, size - 8) :
+                    tail(h, data, size);
+            }
+            constexpr static unsigned long long finalizeMultiplied(unsigned long long h) {
+                return h ^ (h >> R);
+            }
+            constexpr static unsigned long long finalize(unsigned long long h) {
+                return finalizeMultiplied((h ^ (h >> R))*M);
+            }
     };
+
+    /* Digest bytes are the hash value in native endianness */
+    constexpr HashDigest<4> murmurHash2Digest(unsigned int hash) {
+        #ifndef CORRADE_BIG_ENDIAN
+        return HashDigest<4>{hash, hash >> 8, hash >> 16, hash >> 24};
+        #else
+        return HashDigest<4>{hash >> 24, hash >> 16, hash >> 8, hash};
+        #endif
+    }
+    constexpr HashDigest<8> murmurHash2Digest(unsigned long long hash) {
+        #ifndef CORRADE_BIG_ENDIAN
+        return HashDigest<8>{hash, hash >> 8, hash >> 16, hash >> 24,
+                             hash >> 32, hash >> 40, hash >> 48, hash >> 56};
+        #else
+        return HashDigest<8>{hash >> 56, hash >> 48, hash >> 40, hash >> 32,
+                             hash >> 24, hash >> 16, hash >> 8, hash};
+        #endif
+    }
 }
 
 /**
@@ -54,7 +164,12 @@ Based on algorithm copyright Austin Appleby, http://code.google.com/p/smhasher/
 The digest is 32bit or 64bit, depending on @cpp sizeof(std::size_t) @ce and
 thus usable for hashing in e.g. @ref std::unordered_map.
 
-@todo constexpr algorithm
+Digests of string literals up to 1 kB are calculated at compile time, which
+makes it possible to use them as constant keys:
+
+@code{.cpp}
+constexpr Utility::MurmurHash2::Digest digest = Utility::MurmurHash2{}("plugin");
+@endcode
 */
 class CORRADE_UTILITY_EXPORT MurmurHash2: public AbstractHash<sizeof(std::size_t)> {
     public:
@@ -79,16 +194,21 @@ class CORRADE_UTILITY_EXPORT MurmurHash2: public AbstractHash<sizeof(std::size_t
             return operator()(data.data(), data.size());
         }
 
-        /** @copydoc operator()(const std::string&) const */
-        template<std::size_t size> Digest operator()(const char(&data)[size]) const {
-            std::size_t d = Implementation::MurmurHash2<sizeof(std::size_t)>{}(_seed, data, size-1);
-            return Digest::fromByteArray(reinterpret_cast<const char*>(&d));
+        /**
+         * @copydoc operator()(const std::string&) const
+         *
+         * The trailing null terminator is not included in the digest. For
+         * literals up to 1 kB the function is @cpp constexpr @ce.
+         */
+        template<std::size_t size> constexpr Digest operator()(const char(&data)[size]) const {
+            return Implementation::murmurHash2Digest(Implementation::MurmurHash2<sizeof(std::size_t)>{}(_seed, data, size - 1));
         }
 
         /** @copydoc operator()(const std::string&) const */
         Digest operator()(const char* data, std::size_t size) const {
-            std::size_t d = Implementation::MurmurHash2<sizeof(std::size_t)>{}(_seed, data, size);
-            return Digest::fromByteArray(reinterpret_cast<const char*>(&d));
+            /* The recursive constexpr variant is slow at runtime especially
+               in debug builds, use it only for literals */
+            return Implementation::murmurHash2Digest(Implementation::MurmurHash2<sizeof(std::size_t)>::runtime(_seed, data, size));
         }
 
     private:
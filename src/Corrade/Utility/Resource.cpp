@@ -25,12 +25,13 @@
 
 #include "Resource.h"
 
-#ifdef _MSC_VER
-#include <algorithm> /* std::max() */
-#endif
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "Corrade/Containers/Array.h"
@@ -39,6 +40,7 @@
 #include "Corrade/Utility/ConfigurationGroup.h"
 #include "Corrade/Utility/Debug.h"
 #include "Corrade/Utility/Directory.h"
+#include "Corrade/Utility/Implementation/lz4.h"
 
 namespace Corrade { namespace Utility {
 
@@ -49,8 +51,140 @@ struct Resource::OverrideData {
     explicit OverrideData(const std::string& filename): conf(filename) {}
 };
 
-Resource::GroupData::GroupData() = default;
-Resource::GroupData::~GroupData() = default;
+namespace {
+
+/* Binary resource pack layout, see the class documentation for details. All
+   values are in native endianness, offsets are from the start of the pack. */
+struct PackHeader {
+    char magic[4];
+    unsigned char version;
+    unsigned char flags;
+    unsigned short reserved;
+    unsigned int fileCount;
+    unsigned int groupSize;
+};
+
+struct PackFile {
+    unsigned int filenameOffset;
+    unsigned int filenameSize;
+    unsigned int dataOffset;
+    unsigned int dataSize;
+};
+
+static_assert(sizeof(PackHeader) == 16 && sizeof(PackFile) == 16, "unexpected pack structure size");
+
+constexpr const char PackMagic[4]{'C', 'R', 'P', 'K'};
+constexpr unsigned char PackVersion = 1;
+enum: unsigned char { PackFlagBigEndian = 1 << 0 };
+enum: std::size_t { PackDataAlignment = 16 };
+
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+typedef Containers::Array<const char, Directory::MapDeleter> PackFileData;
+PackFileData readPackFile(const std::string& filename) {
+    return Directory::mapRead(filename);
+}
+#else
+typedef Containers::Array<char> PackFileData;
+PackFileData readPackFile(const std::string& filename) {
+    return Directory::read(filename);
+}
+#endif
+
+/* Packs registered from a file are owned by the resource manager until the
+   group is unregistered */
+std::map<std::string, PackFileData>& packFiles() {
+    static std::map<std::string, PackFileData> packFiles;
+    return packFiles;
+}
+
+}
+
+namespace {
+
+bool lessThan(const Containers::ArrayView<const char> a, const Containers::ArrayView<const char> b) {
+    const std::size_t size = std::min(a.size(), b.size());
+    const int result = size ? std::memcmp(a.data(), b.data(), size) : 0;
+    return result < 0 || (result == 0 && a.size() < b.size());
+}
+
+bool equal(const Containers::ArrayView<const char> a, const Containers::ArrayView<const char> b) {
+    return a.size() == b.size() && (!a.size() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+struct FileView {
+    Containers::ArrayView<const char> filename;
+    Containers::ArrayView<const char> data;
+    /* Zero if the file is not compressed */
+    unsigned int uncompressedSize;
+};
+
+/* Sorts the files by filename so they can be binary-searched in getRaw()
+   without allocating. If there are duplicates, the first one wins. Returns
+   whether any of the files is compressed. */
+bool sortFiles(std::vector<FileView>& files, std::vector<Containers::ArrayView<const char>>& filenames, std::vector<Containers::ArrayView<const char>>& data, std::vector<unsigned int>& uncompressedSizes) {
+    std::stable_sort(files.begin(), files.end(), [](const FileView& a, const FileView& b) {
+        return lessThan(a.filename, b.filename);
+    });
+    files.erase(std::unique(files.begin(), files.end(), [](const FileView& a, const FileView& b) {
+        return equal(a.filename, b.filename);
+    }), files.end());
+
+    bool compressed = false;
+    filenames.reserve(files.size());
+    data.reserve(files.size());
+    uncompressedSizes.reserve(files.size());
+    for(const FileView& file: files) {
+        filenames.push_back(file.filename);
+        data.push_back(file.data);
+        uncompressedSizes.push_back(file.uncompressedSize);
+        if(file.uncompressedSize) compressed = true;
+    }
+
+    return compressed;
+}
+
+}
+
+struct Resource::GroupData::CompressedData {
+    explicit CompressedData(std::vector<unsigned int>&& uncompressedSizes): uncompressedSizes{std::move(uncompressedSizes)}, decompressed{new std::atomic<char*>[this->uncompressedSizes.size()]()} {}
+
+    ~CompressedData() {
+        for(std::size_t i = 0; i != uncompressedSizes.size(); ++i)
+            delete[] decompressed[i].load();
+    }
+
+    Containers::ArrayView<const char> decompress(std::size_t i, Containers::ArrayView<const char> data);
+
+    std::vector<unsigned int> uncompressedSizes;
+    std::unique_ptr<std::atomic<char*>[]> decompressed;
+};
+
+Containers::ArrayView<const char> Resource::GroupData::CompressedData::decompress(const std::size_t i, const Containers::ArrayView<const char> data) {
+    const std::size_t size = uncompressedSizes[i];
+
+    /* Decompress on first access and cache the result for the lifetime of
+       the group. If more threads race on the first access, the first result
+       wins and the others are discarded. */
+    char* out = decompressed[i].load(std::memory_order_acquire);
+    if(!out) {
+        std::unique_ptr<char[]> buffer{new char[size]};
+        CORRADE_INTERNAL_ASSERT_OUTPUT(Implementation::lz4Decompress(data, data.size(), buffer.get(), size));
+        if(decompressed[i].compare_exchange_strong(out, buffer.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+            out = buffer.release();
+    }
+
+    return {out, size};
+}
+
+Resource::GroupData::GroupData(): compressed{} {}
+
+Resource::GroupData::GroupData(GroupData&& other) noexcept: overrideGroup{std::move(other.overrideGroup)}, filenames{std::move(other.filenames)}, data{std::move(other.data)}, compressed{other.compressed} {
+    other.compressed = nullptr;
+}
+
+Resource::GroupData::~GroupData() {
+    delete compressed;
+}
 
 auto Resource::resources() -> std::map<std::string, GroupData>& {
     static std::map<std::string, GroupData> resources;
@@ -58,32 +192,45 @@ auto Resource::resources() -> std::map<std::string, GroupData>& {
 }
 
 void Resource::registerData(const char* group, unsigned int count, const unsigned char* positions, const unsigned char* filenames, const unsigned char* data) {
+    registerData(group, count, positions, filenames, data, nullptr);
+}
+
+void Resource::registerData(const char* group, unsigned int count, const unsigned char* positions, const unsigned char* filenames, const unsigned char* data, const unsigned char* uncompressedSizes) {
     /* Already registered */
     /** @todo Fix and assert that this doesn't happen */
     if(resources().find(group) != resources().end()) return;
 
     CORRADE_INTERNAL_ASSERT(reinterpret_cast<std::uintptr_t>(positions) % 4 == 0);
+    CORRADE_INTERNAL_ASSERT(reinterpret_cast<std::uintptr_t>(uncompressedSizes) % 4 == 0);
 
-    const auto groupData = resources().emplace(group, GroupData()).first;
+    GroupData& groupData = resources().emplace(group, GroupData()).first->second;
 
-    /* Cast to type which can be eaten by std::string constructor */
     const char* _positions = reinterpret_cast<const char*>(positions);
     const char* _filenames = reinterpret_cast<const char*>(filenames);
 
     const unsigned int size = sizeof(unsigned int);
     unsigned int oldFilenamePosition = 0, oldDataPosition = 0;
 
-    /* Every 2*sizeof(unsigned int) is one data */
+    /* Every 2*sizeof(unsigned int) is one data. The views point directly
+       into the static data, nothing is copied. */
+    std::vector<FileView> files;
+    files.reserve(count);
     for(unsigned int i = 0; i != count*2*size; i += 2*size) {
         unsigned int filenamePosition = *reinterpret_cast<const unsigned int*>(_positions+i);
         unsigned int dataPosition = *reinterpret_cast<const unsigned int*>(_positions+i+size);
 
-        Containers::ArrayView<const char> res(reinterpret_cast<const char*>(data)+oldDataPosition, dataPosition-oldDataPosition);
-        groupData->second.resources.emplace(std::string(_filenames+oldFilenamePosition, filenamePosition-oldFilenamePosition), res);
+        files.push_back({
+            {_filenames+oldFilenamePosition, filenamePosition-oldFilenamePosition},
+            {reinterpret_cast<const char*>(data)+oldDataPosition, dataPosition-oldDataPosition},
+            uncompressedSizes ? reinterpret_cast<const unsigned int*>(uncompressedSizes)[i/(2*size)] : 0});
 
         oldFilenamePosition = filenamePosition;
         oldDataPosition = dataPosition;
     }
+
+    std::vector<unsigned int> sortedUncompressedSizes;
+    if(sortFiles(files, groupData.filenames, groupData.data, sortedUncompressedSizes))
+        groupData.compressed = new GroupData::CompressedData{std::move(sortedUncompressedSizes)};
 }
 
 void Resource::unregisterData(const char* group) {
@@ -93,6 +240,98 @@ void Resource::unregisterData(const char* group) {
         "Utility::Resource: resource group" << group << "is not registered", );
 
     resources().erase(it);
+    packFiles().erase(group);
+}
+
+bool Resource::registerPack(const Containers::ArrayView<const char> data) {
+    if(data.size() < sizeof(PackHeader) || std::memcmp(data.data(), PackMagic, sizeof(PackMagic)) != 0) {
+        Error() << "Utility::Resource::registerPack(): invalid pack signature";
+        return false;
+    }
+
+    if(reinterpret_cast<std::uintptr_t>(data.data()) % 4 != 0) {
+        Error() << "Utility::Resource::registerPack(): pack data not aligned to four bytes";
+        return false;
+    }
+
+    const PackHeader& header = *reinterpret_cast<const PackHeader*>(data.data());
+    if(header.version != PackVersion) {
+        Error() << "Utility::Resource::registerPack(): unsupported pack version" << header.version;
+        return false;
+    }
+
+    #ifndef CORRADE_BIG_ENDIAN
+    if(header.flags & PackFlagBigEndian)
+    #else
+    if(!(header.flags & PackFlagBigEndian))
+    #endif
+    {
+        Error() << "Utility::Resource::registerPack(): pack endianness doesn't match the platform";
+        return false;
+    }
+
+    /* Verify that the group name, the index and all files are in bounds.
+       The group size is checked first so the alignment can't overflow. */
+    if(std::size_t(header.groupSize) > data.size() - sizeof(PackHeader)) {
+        Error() << "Utility::Resource::registerPack(): group name out of bounds";
+        return false;
+    }
+    const std::size_t indexOffset = sizeof(PackHeader) + ((std::size_t(header.groupSize) + 3) & ~std::size_t(3));
+    if(indexOffset > data.size() || std::size_t(header.fileCount) > (data.size() - indexOffset)/sizeof(PackFile)) {
+        Error() << "Utility::Resource::registerPack(): pack index out of bounds";
+        return false;
+    }
+    const PackFile* const files = reinterpret_cast<const PackFile*>(data.data() + indexOffset);
+    for(std::size_t i = 0; i != header.fileCount; ++i) {
+        if(std::size_t(files[i].filenameOffset) + files[i].filenameSize > data.size() ||
+           std::size_t(files[i].dataOffset) + files[i].dataSize > data.size()) {
+            Error() << "Utility::Resource::registerPack(): file" << i << "out of bounds";
+            return false;
+        }
+    }
+
+    const std::string group{data.data() + sizeof(PackHeader), header.groupSize};
+    if(resources().find(group) != resources().end()) {
+        Error() << "Utility::Resource::registerPack(): group" << '\'' + group + '\'' << "is already registered";
+        return false;
+    }
+
+    /* The views point directly into the pack memory, empty files are null */
+    std::vector<FileView> fileViews;
+    fileViews.reserve(header.fileCount);
+    for(std::size_t i = 0; i != header.fileCount; ++i)
+        fileViews.push_back({
+            {data.data() + files[i].filenameOffset, files[i].filenameSize},
+            files[i].dataSize ? Containers::ArrayView<const char>{data.data() + files[i].dataOffset, files[i].dataSize} : nullptr,
+            0});
+
+    /* The index is sorted already if the pack was made by compileBinary(),
+       but it's not guaranteed for packs made by other tools. Packs don't
+       support compression. */
+    GroupData& groupData = resources().emplace(group, GroupData()).first->second;
+    std::vector<unsigned int> uncompressedSizes;
+    sortFiles(fileViews, groupData.filenames, groupData.data, uncompressedSizes);
+
+    return true;
+}
+
+bool Resource::registerPackFile(const std::string& filename) {
+    PackFileData data = readPackFile(filename);
+    if(!data) {
+        Error() << "Utility::Resource::registerPackFile(): cannot read" << filename;
+        return false;
+    }
+
+    if(!registerPack(data)) return false;
+
+    /* Group name is validated by registerPack() already */
+    const PackHeader& header = *reinterpret_cast<const PackHeader*>(data.data());
+    packFiles().emplace(std::string{data.data() + sizeof(PackHeader), header.groupSize}, std::move(data));
+    return true;
+}
+
+void Resource::unregisterPack(const std::string& group) {
+    unregisterData(group.data());
 }
 
 namespace {
@@ -102,42 +341,129 @@ std::pair<bool, Containers::Array<char>> fileContents(const std::string& filenam
     return {true, Directory::read(filename)};
 }
 
-std::string comment(const std::string& comment) {
-    return "\n    /* " + comment + " */";
+/* Upper bounds for sizes of the output generated by the functions below.
+   Everything is written through a pointer into a single preallocated string
+   instead of concatenating many small strings. */
+constexpr std::size_t commentSize(const std::size_t size) {
+    return size + 11;
+}
+
+constexpr std::size_t hexcodeSize(const std::size_t size) {
+    return (size + 14)/15*5 + size*5;
+}
+
+constexpr std::size_t stringLiteralSize(const std::size_t size) {
+    return (size + 63)/64*7 + size*4;
+}
+
+char* copy(char* out, const char* data, const std::size_t size) {
+    std::memcpy(out, data, size);
+    return out + size;
+}
+
+char* copy(char* out, const std::string& data) {
+    return copy(out, data.data(), data.size());
+}
+
+template<std::size_t size> char* copy(char* out, const char(&data)[size]) {
+    return copy(out, data, size - 1);
+}
+
+char* comment(char* out, const std::string& comment) {
+    out = copy(out, "\n    /* ");
+    out = copy(out, comment);
+    return copy(out, " */");
 }
 
-std::string hexcode(const std::string& data) {
-    std::ostringstream out;
-    out << std::hex;
+constexpr const char HexDigits[]{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
 
+char* hexcode(char* out, const char* const data, const std::size_t size) {
     /* Each row is indented by four spaces and has newline at the end */
-    for(std::size_t row = 0; row < data.size(); row += 15) {
-        out << "\n    ";
+    for(std::size_t row = 0; row < size; row += 15) {
+        out = copy(out, "\n    ");
 
         /* Convert all characters on a row to hex "0xab,0x01,..." */
-        for(std::size_t end = std::min(row + 15, data.size()), i = row; i != end; ++i) {
-            out << "0x" << std::setw(2) << std::setfill('0')
-                << static_cast<unsigned int>(static_cast<unsigned char>(data[i]))
-                << ",";
+        for(std::size_t end = std::min(row + 15, size), i = row; i != end; ++i) {
+            const unsigned char c = data[i];
+            out[0] = '0';
+            out[1] = 'x';
+            out[2] = HexDigits[c >> 4];
+            out[3] = HexDigits[c & 0xf];
+            out[4] = ',';
+            out += 5;
         }
     }
 
-    return out.str();
+    return out;
+}
+
+/* Printable characters are written as-is, the rest as three-digit octal
+   escapes, which (unlike hex escapes) can't swallow the following character.
+   Question marks are escaped to avoid accidental trigraphs. To avoid
+   branching on every byte, all four characters are always copied and the
+   output pointer is then advanced only by the actual escape length. */
+struct StringLiteralTable {
+    explicit StringLiteralTable() {
+        for(std::size_t i = 0; i != 256; ++i) {
+            if(i >= ' ' && i <= '~' && i != '"' && i != '\\' && i != '?') {
+                escape[i][0] = char(i);
+                size[i] = 1;
+            } else {
+                escape[i][0] = '\\';
+                escape[i][1] = char('0' + (i >> 6));
+                escape[i][2] = char('0' + ((i >> 3) & 7));
+                escape[i][3] = char('0' + (i & 7));
+                size[i] = 4;
+            }
+        }
+    }
+
+    char escape[256][4]{};
+    unsigned char size[256];
+};
+
+char* stringLiteral(char* out, const char* const data, const std::size_t size) {
+    static const StringLiteralTable table;
+
+    /* Each row is indented by four spaces and has newline at the end */
+    for(std::size_t row = 0; row < size; row += 64) {
+        out = copy(out, "\n    \"");
+
+        for(std::size_t end = std::min(row + 64, size), i = row; i != end; ++i) {
+            const unsigned char c = data[i];
+            std::memcpy(out, table.escape[c], 4);
+            out += table.size[c];
+        }
+
+        *out++ = '"';
+    }
+
+    return out;
 }
 
-#ifndef DOXYGEN_GENERATING_OUTPUT
-template<class T> std::string numberToString(const T& number) {
-    return std::string(reinterpret_cast<const char*>(&number), sizeof(T));
 }
-#endif
 
+namespace {
+
+/* Calls f(i) for all i in [0, count) using given executor or serially if
+   it's null */
+template<class F> void forEach(const Resource::ParallelFor parallelFor, const std::size_t count, F&& f) {
+    if(!parallelFor) {
+        for(std::size_t i = 0; i != count; ++i) f(i);
+        return;
+    }
+
+    parallelFor(count, [](void* const state, const std::size_t i) {
+        (*static_cast<typename std::remove_reference<F>::type*>(state))(i);
+    }, &f);
 }
 
-std::string Resource::compileFrom(const std::string& name, const std::string& configurationFile) {
+/* If uncompressedSizes is null, the compress option is ignored */
+bool loadFiles(const std::string& configurationFile, std::string& group, std::vector<std::pair<std::string, std::string>>& fileData, std::vector<unsigned int>* const uncompressedSizes, const Resource::ParallelFor parallelFor) {
     /* Resource file existence */
     if(!Directory::exists(configurationFile)) {
         Error() << "    Error: file" << configurationFile << "does not exist";
-        return {};
+        return false;
     }
 
     const std::string path = Directory::path(configurationFile);
@@ -146,36 +472,72 @@ std::string Resource::compileFrom(const std::string& name, const std::string& co
     /* Group name */
     if(!conf.hasValue("group")) {
         Error() << "    Error: group name is not specified";
-        return {};
+        return false;
     }
-    const std::string group = conf.value("group");
+    group = conf.value("group");
 
-    /* Load all files */
+    /* Gather the file list */
     std::vector<const ConfigurationGroup*> files = conf.groups("file");
-    std::vector<std::pair<std::string, std::string>> fileData;
+    std::vector<std::string> filenames;
+    std::vector<char> compress;
+    filenames.reserve(files.size());
+    compress.reserve(files.size());
     fileData.reserve(files.size());
     for(const auto file: files) {
-        const std::string filename = file->value("filename");
-        const std::string alias = file->hasValue("alias") ? file->value("alias") : filename;
+        std::string filename = file->value("filename");
+        std::string alias = file->hasValue("alias") ? file->value("alias") : filename;
         if(filename.empty() || alias.empty()) {
             Error() << "    Error: filename or alias of file" << fileData.size()+1 << "in group" << group << "is empty";
-            return {};
+            return false;
         }
 
+        compress.push_back(uncompressedSizes && file->value<bool>("compress"));
+        filenames.push_back(std::move(filename));
+        fileData.emplace_back(std::move(alias), std::string{});
+    }
+    if(uncompressedSizes) uncompressedSizes->assign(files.size(), 0);
+
+    /* Load and compress all files, possibly in parallel. Each file is
+       written only to its own slot, so the result doesn't depend on the
+       executor. On failure, files after the first failed one may be
+       skipped, all files before it are still processed so the same error as
+       with a serial load is reported. */
+    std::atomic<std::size_t> firstFailed{files.size()};
+    forEach(parallelFor, files.size(), [&](const std::size_t i) {
+        if(i > firstFailed) return;
+
         bool success;
         Containers::Array<char> contents;
-        std::tie(success, contents) = fileContents(Directory::join(path, filename));
+        std::tie(success, contents) = fileContents(Directory::join(path, filenames[i]));
         if(!success) {
-            Error() << "    Error: cannot open file" << filename << "of file" << fileData.size()+1 << "in group" << group;
-            return {};
+            std::size_t failed = firstFailed;
+            while(i < failed && !firstFailed.compare_exchange_weak(failed, i));
+            return;
         }
-        fileData.emplace_back(alias, std::string{contents, contents.size()});
+
+        /* Compress the file if requested, but only if it makes it smaller */
+        if(compress[i] && !contents.empty()) {
+            std::string compressed = Implementation::lz4Compress(contents, contents.size());
+            if(compressed.size() < contents.size()) {
+                fileData[i].second = std::move(compressed);
+                (*uncompressedSizes)[i] = contents.size();
+                return;
+            }
+        }
+
+        fileData[i].second.assign(contents, contents.size());
+    });
+
+    if(firstFailed != files.size()) {
+        Error() << "    Error: cannot open file" << filenames[firstFailed] << "of file" << firstFailed+1 << "in group" << group;
+        return false;
     }
 
-    return compile(name, group, fileData);
+    return true;
 }
 
-std::string Resource::compile(const std::string& name, const std::string& group, const std::vector<std::pair<std::string, std::string>>& files) {
+/* If uncompressedSizes is empty, none of the files is compressed */
+std::string compileImplementation(const std::string& name, const std::string& group, const std::vector<std::pair<std::string, std::string>>& files, const std::vector<unsigned int>& uncompressedSizes, const Resource::CompileFlags flags, const Resource::ParallelFor parallelFor) {
     /* Special case for empty file list */
     if(files.empty()) {
         return "/* Compiled resource file. DO NOT EDIT! */\n\n"
@@ -194,63 +556,228 @@ std::string Resource::compile(const std::string& name, const std::string& group,
             "} CORRADE_AUTOMATIC_FINALIZER(resourceFinalizer_" + name + ")\n";
     }
 
-    std::string positions, filenames, data;
-    unsigned int filenamesLen = 0, dataLen = 0;
+    const bool stringLiterals = !!(flags & Resource::CompileFlag::StringLiterals);
 
-    /* Convert data to hexacodes */
-    for(auto it = files.cbegin(); it != files.cend(); ++it) {
-        filenamesLen += it->first.size();
-        dataLen += it->second.size();
+    /* Calculate upper bound of the output size. The fixed parts (header,
+       declarations, initializer and finalizer) are well under 1 kB. */
+    std::size_t filenamesLen = 0, dataLen = 0, size = 1024 + 6*name.size() + 2*group.size();
+    for(const auto& file: files) {
+        filenamesLen += file.first.size();
+        dataLen += file.second.size();
+        size += 3*hexcodeSize(4) + 2*commentSize(file.first.size()) + 2 +
+            (stringLiterals ? stringLiteralSize(file.first.size()) + stringLiteralSize(file.second.size()) : hexcodeSize(file.first.size()) + hexcodeSize(file.second.size()));
+    }
 
-        if(it != files.begin()) {
-            filenames += '\n';
-            data += '\n';
-        }
+    /* If we don't have any data, we don't create the resourceData array, as
+       zero-length arrays are not allowed */
+    const bool dataStringLiterals = stringLiterals && dataLen;
+
+    std::string out;
+    out.resize(size);
+    char* const begin = &out[0];
+    char* o = begin;
 
-        positions += hexcode(numberToString(filenamesLen));
-        positions += hexcode(numberToString(dataLen));
+    o = copy(o, "/* Compiled resource file. DO NOT EDIT! */\n\n"
+        "#include \"Corrade/Corrade.h\"\n"
+        "#include \"Corrade/Utility/Macros.h\"\n"
+        "#include \"Corrade/Utility/Resource.h\"\n\n"
+        "CORRADE_ALIGNAS(4) static const unsigned char resourcePositions[] = {");
+
+    /* Positions are always in hex, removing the last comma */
+    unsigned int filenamesPosition = 0, dataPosition = 0;
+    for(const auto& file: files) {
+        filenamesPosition += file.first.size();
+        dataPosition += file.second.size();
+        o = hexcode(o, reinterpret_cast<const char*>(&filenamesPosition), 4);
+        o = hexcode(o, reinterpret_cast<const char*>(&dataPosition), 4);
+    }
+    --o;
 
-        filenames += comment(it->first);
-        filenames += hexcode(it->first);
+    o = copy(o, "\n};\n\n");
 
-        data += comment(it->first);
-        data += hexcode(it->second);
+    /* Uncompressed sizes, if any file is compressed */
+    if(!uncompressedSizes.empty()) {
+        o = copy(o, "CORRADE_ALIGNAS(4) static const unsigned char resourceUncompressedSizes[] = {");
+        for(const unsigned int uncompressedSize: uncompressedSizes)
+            o = hexcode(o, reinterpret_cast<const char*>(&uncompressedSize), 4);
+        o = copy(--o, "\n};\n\n");
     }
 
-    /* Remove last comma from positions and filenames array */
-    positions.resize(positions.size()-1);
-    filenames.resize(filenames.size()-1);
+    o = copy(o, "static const unsigned char resourceFilenames[] =");
+    if(!stringLiterals) o = copy(o, " {");
+    for(auto it = files.cbegin(); it != files.cend(); ++it) {
+        if(it != files.begin()) *o++ = '\n';
+        o = comment(o, it->first);
+        o = stringLiterals ?
+            stringLiteral(o, it->first.data(), it->first.size()) :
+            hexcode(o, it->first.data(), it->first.size());
+    }
+
+    /* Remove last comma from the filenames array */
+    if(stringLiterals) o = copy(o, ";\n\n");
+    else o = copy(--o, "\n};\n\n");
+
+    auto encodeData = [&](char* o, const std::pair<std::string, std::string>& file) {
+        o = comment(o, file.first);
+        return dataStringLiterals ?
+            stringLiteral(o, file.second.data(), file.second.size()) :
+            hexcode(o, file.second.data(), file.second.size());
+    };
+
+    /* With an executor, each file is encoded into a separate buffer in
+       parallel and then copied to the output, otherwise it's written there
+       directly */
+    std::vector<std::string> encodedData;
+    if(parallelFor) {
+        encodedData.resize(files.size());
+        forEach(parallelFor, files.size(), [&](const std::size_t i) {
+            const std::pair<std::string, std::string>& file = files[i];
+            std::string& encoded = encodedData[i];
+            encoded.resize(commentSize(file.first.size()) + (dataStringLiterals ? stringLiteralSize(file.second.size()) : hexcodeSize(file.second.size())));
+            encoded.resize(encodeData(&encoded[0], file) - &encoded[0]);
+        });
+    }
+
+    if(!dataLen) o = copy(o, "// ");
+    o = copy(o, "static const unsigned char resourceData[] =");
+    if(!dataStringLiterals) o = copy(o, " {");
+    for(std::size_t i = 0; i != files.size(); ++i) {
+        if(i) *o++ = '\n';
+        o = encodedData.empty() ? encodeData(o, files[i]) : copy(o, encodedData[i]);
+    }
 
     /* Remove last comma from data array only if the last file is not empty */
-    if(!files.back().second.empty())
-        data.resize(data.size()-1);
-
-    /* Return C++ file. The functions have forward declarations to avoid warning
-       about functions which don't have corresponding declarations (enabled by
-       -Wmissing-declarations in GCC). If we don't have any data, we don't
-       create the resourceData array, as zero-length arrays are not allowed. */
-    return "/* Compiled resource file. DO NOT EDIT! */\n\n"
-        "#include \"Corrade/Corrade.h\"\n"
-        "#include \"Corrade/Utility/Macros.h\"\n"
-        "#include \"Corrade/Utility/Resource.h\"\n\n"
-        "CORRADE_ALIGNAS(4) static const unsigned char resourcePositions[] = {" +
-        positions + "\n};\n\n"
-        "static const unsigned char resourceFilenames[] = {" +
-        filenames + "\n};\n\n" +
-        (dataLen ? "" : "// ") + "static const unsigned char resourceData[] = {" +
-        data + '\n' + (dataLen ? "" : "// ") + "};\n\n" +
-        "int resourceInitializer_" + name + "();\n"
-        "int resourceInitializer_" + name + "() {\n"
-        "    Corrade::Utility::Resource::registerData(\"" + group + "\", " +
-            std::to_string(files.size()) +
-        ", resourcePositions, resourceFilenames, " + (dataLen ? "resourceData" : "nullptr") + ");\n"
+    if(dataStringLiterals) o = copy(o, ";\n\n");
+    else {
+        if(!files.back().second.empty()) --o;
+        *o++ = '\n';
+        if(!dataLen) o = copy(o, "// ");
+        o = copy(o, "};\n\n");
+    }
+
+    /* The functions have forward declarations to avoid warning about
+       functions which don't have corresponding declarations (enabled by
+       -Wmissing-declarations in GCC). */
+    o = copy(o, "int resourceInitializer_");
+    o = copy(o, name);
+    o = copy(o, "();\n"
+        "int resourceInitializer_");
+    o = copy(o, name);
+    o = copy(o, "() {\n"
+        "    Corrade::Utility::Resource::registerData(\"");
+    o = copy(o, group);
+    o = copy(o, "\", ");
+    o = copy(o, std::to_string(files.size()));
+    o = copy(o, ", resourcePositions, resourceFilenames, ");
+    o = dataLen ? copy(o, "resourceData") : copy(o, "nullptr");
+    if(!uncompressedSizes.empty()) o = copy(o, ", resourceUncompressedSizes");
+    o = copy(o, ");\n"
         "    return 1;\n"
-        "} CORRADE_AUTOMATIC_INITIALIZER(resourceInitializer_" + name + ")\n\n"
-        "int resourceFinalizer_" + name + "();\n"
-        "int resourceFinalizer_" + name + "() {\n"
-        "    Corrade::Utility::Resource::unregisterData(\"" + group + "\");\n"
+        "} CORRADE_AUTOMATIC_INITIALIZER(resourceInitializer_");
+    o = copy(o, name);
+    o = copy(o, ")\n\n"
+        "int resourceFinalizer_");
+    o = copy(o, name);
+    o = copy(o, "();\n"
+        "int resourceFinalizer_");
+    o = copy(o, name);
+    o = copy(o, "() {\n"
+        "    Corrade::Utility::Resource::unregisterData(\"");
+    o = copy(o, group);
+    o = copy(o, "\");\n"
         "    return 1;\n"
-        "} CORRADE_AUTOMATIC_FINALIZER(resourceFinalizer_" + name + ")\n";
+        "} CORRADE_AUTOMATIC_FINALIZER(resourceFinalizer_");
+    o = copy(o, name);
+    o = copy(o, ")\n");
+
+    CORRADE_INTERNAL_ASSERT(std::size_t(o - begin) <= size);
+    out.resize(o - begin);
+    return out;
+}
+
+}
+
+std::string Resource::compileFrom(const std::string& name, const std::string& configurationFile, const CompileFlags flags, const ParallelFor parallelFor) {
+    std::string group;
+    std::vector<std::pair<std::string, std::string>> fileData;
+    std::vector<unsigned int> uncompressedSizes;
+    if(!loadFiles(configurationFile, group, fileData, &uncompressedSizes, parallelFor)) return {};
+
+    /* If nothing ended up compressed, the output is the same as without the
+       compression */
+    if(std::find_if(uncompressedSizes.begin(), uncompressedSizes.end(), [](unsigned int size) { return size != 0; }) == uncompressedSizes.end())
+        uncompressedSizes.clear();
+
+    return compileImplementation(name, group, fileData, uncompressedSizes, flags, parallelFor);
+}
+
+std::string Resource::compileBinaryFrom(const std::string& configurationFile, const ParallelFor parallelFor) {
+    std::string group;
+    std::vector<std::pair<std::string, std::string>> fileData;
+    if(!loadFiles(configurationFile, group, fileData, nullptr, parallelFor)) return {};
+
+    return compileBinary(group, fileData);
+}
+
+std::string Resource::compile(const std::string& name, const std::string& group, const std::vector<std::pair<std::string, std::string>>& files, const CompileFlags flags, const ParallelFor parallelFor) {
+    return compileImplementation(name, group, files, {}, flags, parallelFor);
+}
+
+std::string Resource::compileBinary(const std::string& group, const std::vector<std::pair<std::string, std::string>>& files) {
+    /* Sort the files by name. If there are duplicates, the first one wins,
+       consistently with the compiled-in resources. */
+    std::vector<const std::pair<std::string, std::string>*> sorted;
+    sorted.reserve(files.size());
+    for(const auto& file: files) sorted.push_back(&file);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, std::string>* a, const std::pair<std::string, std::string>* b) {
+        return a->first < b->first;
+    });
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const std::pair<std::string, std::string>* a, const std::pair<std::string, std::string>* b) {
+        return a->first == b->first;
+    }), sorted.end());
+
+    /* Calculate the layout -- header, group name, index, filenames and then
+       the data, each file aligned */
+    const std::size_t indexOffset = sizeof(PackHeader) + ((group.size() + 3) & ~std::size_t{3});
+    std::size_t filenameOffset = indexOffset + sorted.size()*sizeof(PackFile);
+    std::size_t size = filenameOffset;
+    for(const auto* file: sorted) size += file->first.size();
+    std::vector<PackFile> index;
+    index.reserve(sorted.size());
+    for(const auto* file: sorted) {
+        size = (size + PackDataAlignment - 1) & ~(PackDataAlignment - 1);
+        index.push_back({static_cast<unsigned int>(filenameOffset), static_cast<unsigned int>(file->first.size()),
+                         static_cast<unsigned int>(size), static_cast<unsigned int>(file->second.size())});
+        filenameOffset += file->first.size();
+        size += file->second.size();
+    }
+
+    /* All offsets and sizes are stored as 32-bit values and none of them is
+       larger than the total size, so checking just that is enough. The
+       offsets in the index above got truncated in that case, but the index
+       is discarded. */
+    if(std::uint64_t(size) > 0xffffffffull) {
+        Error() << "Utility::Resource::compileBinary(): the pack would be" << size << "bytes, which is more than the 4 GB limit";
+        return {};
+    }
+
+    /* Fill the output, the padding is zero-filled */
+    std::string out(size, '\0');
+    PackHeader header{{}, PackVersion, 0, 0, static_cast<unsigned int>(sorted.size()), static_cast<unsigned int>(group.size())};
+    std::memcpy(header.magic, PackMagic, sizeof(PackMagic));
+    #ifdef CORRADE_BIG_ENDIAN
+    header.flags |= PackFlagBigEndian;
+    #endif
+    std::memcpy(&out[0], &header, sizeof(PackHeader));
+    std::copy(group.begin(), group.end(), out.begin() + sizeof(PackHeader));
+    if(!index.empty())
+        std::memcpy(&out[indexOffset], index.data(), index.size()*sizeof(PackFile));
+    for(std::size_t i = 0; i != sorted.size(); ++i) {
+        std::copy(sorted[i]->first.begin(), sorted[i]->first.end(), out.begin() + index[i].filenameOffset);
+        std::copy(sorted[i]->second.begin(), sorted[i]->second.end(), out.begin() + index[i].dataOffset);
+    }
+
+    return out;
 }
 
 void Resource::overrideGroup(const std::string& group, const std::string& configurationFile) {
@@ -285,22 +812,30 @@ Resource::~Resource() {
     delete _overrideGroup;
 }
 
-std::vector<std::string> Resource::list() const {
+Containers::ArrayView<const Containers::ArrayView<const char>> Resource::list() const {
     CORRADE_INTERNAL_ASSERT(_group != resources().end());
 
-    std::vector<std::string> result;
-    result.reserve(_group->second.resources.size());
-    for(const auto& filename: _group->second.resources)
-        result.push_back(filename.first);
-
-    return result;
+    return {_group->second.filenames.data(), _group->second.filenames.size()};
 }
 
 Containers::ArrayView<const char> Resource::getRaw(const std::string& filename) const {
+    return getRaw(Containers::ArrayView<const char>{filename.data(), filename.size()});
+}
+
+Containers::ArrayView<const char> Resource::getRaw(const char* const filename) const {
+    CORRADE_ASSERT(filename,
+        "Utility::Resource::getRaw(): filename can't be null", nullptr);
+    return getRaw(Containers::ArrayView<const char>{filename, std::strlen(filename)});
+}
+
+Containers::ArrayView<const char> Resource::getRaw(const Containers::ArrayView<const char> filenameView) const {
     CORRADE_INTERNAL_ASSERT(_group != resources().end());
 
-    /* The group is overriden with live data */
+    /* The group is overriden with live data. This is not meant to be used in
+       production code, so the allocations are not an issue. */
     if(_overrideGroup) {
+        const std::string filename{filenameView, filenameView.size()};
+
         /* The file is already loaded */
         auto it = _overrideGroup->data.find(filename);
         if(it != _overrideGroup->data.end())
@@ -332,14 +867,26 @@ Containers::ArrayView<const char> Resource::getRaw(const std::string& filename)
                   << "was not found in overriden group, fallback to compiled-in resources";
     }
 
-    const auto it = _group->second.resources.find(filename);
-    CORRADE_ASSERT(it != _group->second.resources.end(),
-        "Utility::Resource::get(): file" << '\'' + filename + '\'' << "was not found in group" << '\'' + _group->first + '\'', nullptr);
+    const std::vector<Containers::ArrayView<const char>>& filenames = _group->second.filenames;
+    const auto found = std::lower_bound(filenames.begin(), filenames.end(), filenameView, lessThan);
+    CORRADE_ASSERT(found != filenames.end() && equal(*found, filenameView),
+        "Utility::Resource::get(): file" << '\'' + std::string(filenameView, filenameView.size()) + '\'' << "was not found in group" << '\'' + _group->first + '\'', nullptr);
 
-    return it->second;
+    const std::size_t i = found - filenames.begin();
+    if(_group->second.compressed && _group->second.compressed->uncompressedSizes[i])
+        return _group->second.compressed->decompress(i, _group->second.data[i]);
+    return _group->second.data[i];
 }
 
 std::string Resource::get(const std::string& filename) const {
+    return get(Containers::ArrayView<const char>{filename.data(), filename.size()});
+}
+
+std::string Resource::get(const char* const filename) const {
+    return get(Containers::ArrayView<const char>{filename, std::strlen(filename)});
+}
+
+std::string Resource::get(const Containers::ArrayView<const char> filename) const {
     Containers::ArrayView<const char> data = getRaw(filename);
     return data ? std::string{data, data.size()} : std::string{};
 }
@@ -29,12 +29,14 @@
  * @brief Class @ref Corrade::Utility::Resource
  */
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "Corrade/Containers/ArrayView.h"
+#include "Corrade/Containers/EnumSet.h"
 #include "Corrade/Utility/visibility.h"
 
 namespace Corrade { namespace Utility {
@@ -69,37 +71,199 @@ alias=intro.ogg
 
 [file]
 filename=license.txt
+compress=true
 
 [file]
 filename=levels-insane.conf
 alias=levels-easy.conf
 @endcode
 
+@subsection Utility-Resource-conf-compression Compressed resources
+
+Files with the `compress` option enabled are compressed at build time using
+the LZ4 block format, which is useful for text-heavy resources to reduce the
+executable size. Files that wouldn't get smaller are stored uncompressed. The
+data are decompressed on first access to given file in @ref getRaw() or
+@ref get() and cached for the lifetime of the group, so later accesses return
+the same memory without any copy. Decompression on first access is
+thread-safe. The option is ignored by @ref compileBinaryFrom(), as binary
+packs are meant to be memory-mapped directly.
+
+@section Utility-Resource-pack Binary resource packs
+
+As an alternative to compiling the data into a C++ source file, which can get
+very slow and memory-hungry for large amounts of data, the resources can be
+compiled into a binary pack using @ref compileBinary(),
+@ref compileBinaryFrom() or the `--binary` option of
+@ref corrade-rc "corrade-rc". The pack can be then registered at runtime by
+memory-mapping the file with @ref registerPackFile():
+
+@code{.cpp}
+Utility::Resource::registerPackFile("resources.pack");
+Utility::Resource rs{"myGroup"};
+@endcode
+
+Or it can be embedded into the executable by the linker, for example with the
+`.incbin` assembler directive or by converting it to an object file with
+`objcopy`, and registered with @ref registerPack(). The pack start has to be
+aligned to at least four bytes:
+
+@code{.cpp}
+__asm__(".section .rodata\n"
+        ".balign 16\n"
+        ".global resourcePack, resourcePackEnd\n"
+        "resourcePack:\n"
+        ".incbin \"resources.pack\"\n"
+        "resourcePackEnd:\n"
+        ".previous\n");
+extern "C" const char resourcePack[], resourcePackEnd[];
+
+Utility::Resource::registerPack({resourcePack, std::size_t(resourcePackEnd - resourcePack)});
+@endcode
+
+In both cases @ref getRaw() returns views directly into the pack memory.
+
+The pack starts with a 16-byte header consisting of a `CRPK` signature, a
+one-byte version (currently @cpp 1 @ce), a one-byte flags field with the
+lowest bit set for big-endian packs, two reserved bytes, a 32-bit file count
+and a 32-bit group name size. The group name follows, padded to four bytes,
+then the file index sorted by filename, with each entry being four 32-bit
+values --- filename offset, filename size, data offset and data size, with
+offsets being from the pack start. Then the filenames follow and after them
+the file data, each file aligned to 16 bytes. All values are in the native
+endianness of the platform that created the pack.
+
 @todo Ad-hoc resources
 @todo Test data unregistering
  */
 class CORRADE_UTILITY_EXPORT Resource {
     public:
+        /**
+         * @brief Compilation flag
+         *
+         * @see @ref CompileFlags, @ref compile(), @ref compileFrom()
+         */
+        enum class CompileFlag: std::uint32_t {
+            /**
+             * Emit the filenames and data as C string literals instead of
+             * comma-separated hexadecimal values. The output is several times
+             * smaller and much faster to parse for the compiler. Note that
+             * MSVC limits the total length of a string literal to 64 kB, so
+             * this is usable only with GCC, Clang and other compilers that
+             * don't have such limit.
+             */
+            StringLiterals = 1 << 0
+        };
+
+        /**
+         * @brief Compilation flags
+         *
+         * @see @ref compile(), @ref compileFrom()
+         */
+        typedef Containers::EnumSet<CompileFlag> CompileFlags;
+
+        /**
+         * @brief Parallel executor
+         *
+         * Used by @ref compile(), @ref compileFrom() and
+         * @ref compileBinaryFrom() to process the files in parallel. Expected
+         * to call @p function with @p state and each index in the range
+         * @cpp [0, count) @ce exactly once, in any order and from any thread,
+         * and return after all calls are finished. The library itself
+         * doesn't create any threads, the @ref corrade-rc "corrade-rc"
+         * utility provides a thread-based executor for its `-j` option.
+         */
+        typedef void(*ParallelFor)(std::size_t count, void(*function)(void*, std::size_t), void* state);
+
         /**
          * @brief Compile data resource file
          * @param name          Resource name (see @ref CORRADE_RESOURCE_INITIALIZE())
          * @param group         Group name
          * @param files         Files (pairs of filename, file data)
+         * @param flags         Compilation flags
+         * @param parallelFor   Executor used for encoding the data. If
+         *      @cpp nullptr @ce, the files are encoded serially.
          *
-         * Produces C++ file with hexadecimal data representation.
+         * Produces C++ file with hexadecimal data representation or with C
+         * string literals if @ref CompileFlag::StringLiterals is set. The
+         * output is the same regardless of @p parallelFor.
          */
-        static std::string compile(const std::string& name, const std::string& group, const std::vector<std::pair<std::string, std::string>>& files);
+        static std::string compile(const std::string& name, const std::string& group, const std::vector<std::pair<std::string, std::string>>& files, CompileFlags flags = {}, ParallelFor parallelFor = nullptr);
 
         /**
          * @brief Compile data resource file using configuration file
          * @param name          Resource name (see @ref CORRADE_RESOURCE_INITIALIZE())
          * @param configurationFile Filename of configuration file
+         * @param flags         Compilation flags
+         * @param parallelFor   Executor used for reading, compressing and
+         *      encoding the files. If @cpp nullptr @ce, the files are
+         *      processed serially.
          *
-         * Produces C++ file with hexadecimal data representation. See class
-         * documentation for configuration file syntax overview. The filenames
-         * are taken relative to configuration file path.
+         * Produces C++ file with hexadecimal data representation or with C
+         * string literals if @ref CompileFlag::StringLiterals is set. See
+         * class documentation for configuration file syntax overview. The
+         * filenames are taken relative to configuration file path. The
+         * output is the same regardless of @p parallelFor.
          */
-        static std::string compileFrom(const std::string& name, const std::string& configurationFile);
+        static std::string compileFrom(const std::string& name, const std::string& configurationFile, CompileFlags flags = {}, ParallelFor parallelFor = nullptr);
+
+        /**
+         * @brief Compile a binary resource pack
+         * @param group         Group name
+         * @param files         Files (pairs of filename, file data)
+         *
+         * Produces a binary pack that can be registered with
+         * @ref registerPack() or @ref registerPackFile(). See
+         * @ref Utility-Resource-pack for details. As offsets in the pack are
+         * 32-bit, the pack can't be larger than 4 GB. If it would be, prints
+         * a message to @ref Error and returns an empty string.
+         */
+        static std::string compileBinary(const std::string& group, const std::vector<std::pair<std::string, std::string>>& files);
+
+        /**
+         * @brief Compile a binary resource pack using configuration file
+         * @param configurationFile Filename of configuration file
+         * @param parallelFor   Executor used for reading the files. If
+         *      @cpp nullptr @ce, the files are read serially.
+         *
+         * Like @ref compileBinary(), but takes the group name and file list
+         * from a configuration file, same as @ref compileFrom().
+         */
+        static std::string compileBinaryFrom(const std::string& configurationFile, ParallelFor parallelFor = nullptr);
+
+        /**
+         * @brief Register a binary resource pack
+         * @param data          Pack data
+         *
+         * The data are not copied, the caller is responsible for keeping them
+         * in scope until the group is unregistered with
+         * @ref unregisterPack(), which makes this suitable for packs embedded
+         * into the executable by the linker. The data has to be aligned to at
+         * least four bytes. If the pack is invalid or its group is already
+         * registered, prints a message to @ref Error and returns
+         * @cpp false @ce.
+         * @see @ref Utility-Resource-pack
+         */
+        static bool registerPack(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Register a binary resource pack from a file
+         * @param filename      Pack filename in UTF-8
+         *
+         * Memory-maps the file using @ref Directory::mapRead() on platforms
+         * that support it, reads it into memory otherwise, and registers it
+         * with @ref registerPack(). The mapping is kept until the group is
+         * unregistered with @ref unregisterPack().
+         */
+        static bool registerPackFile(const std::string& filename);
+
+        /**
+         * @brief Unregister a binary resource pack
+         * @param group         Group name
+         *
+         * The group must exist.
+         */
+        static void unregisterPack(const std::string& group);
 
         /**
          * @brief Override group
@@ -132,42 +296,73 @@ class CORRADE_UTILITY_EXPORT Resource {
         /**
          * @brief List of all resources in the group
          *
-         * Note that the list contains only list of compiled-in files, no
-         * additional filenames from overriden group are incluuded.
+         * The filenames are sorted and point directly to the compiled-in
+         * data, so this function doesn't allocate. Note that the list
+         * contains only list of compiled-in files, no additional filenames
+         * from overriden group are included.
          */
-        std::vector<std::string> list() const;
+        Containers::ArrayView<const Containers::ArrayView<const char>> list() const;
 
         /**
          * @brief Get pointer to raw resource data
          * @param filename      Filename in UTF-8
          *
          * Returns reference to data of given file in the group. The file must
-         * exist. If the file is empty, returns @cpp nullptr @ce.
+         * exist. If the file is empty, returns @cpp nullptr @ce. The lookup
+         * is done using a binary search over the sorted filenames and
+         * doesn't allocate unless the group is overriden using
+         * @ref overrideGroup().
          */
+        Containers::ArrayView<const char> getRaw(Containers::ArrayView<const char> filename) const;
+
+        /** @overload */
         Containers::ArrayView<const char> getRaw(const std::string& filename) const;
 
+        /** @overload */
+        Containers::ArrayView<const char> getRaw(const char* filename) const;
+
         /**
          * @brief Get data resource
          * @param filename      Filename in UTF-8
          *
          * Returns data of given file in the group. The file must exist.
          */
+        std::string get(Containers::ArrayView<const char> filename) const;
+
+        /** @overload */
         std::string get(const std::string& filename) const;
 
+        /** @overload */
+        std::string get(const char* filename) const;
+
     #ifdef DOXYGEN_GENERATING_OUTPUT
     private:
     #endif
         /* Internal use only. */
         static void registerData(const char* group, unsigned int count, const unsigned char* positions, const unsigned char* filenames, const unsigned char* data);
+        static void registerData(const char* group, unsigned int count, const unsigned char* positions, const unsigned char* filenames, const unsigned char* data, const unsigned char* uncompressedSizes);
         static void unregisterData(const char* group);
 
     private:
         struct CORRADE_UTILITY_LOCAL GroupData {
             explicit GroupData();
+            GroupData(const GroupData&) = delete;
+            GroupData(GroupData&& other) noexcept;
             ~GroupData();
+            GroupData& operator=(const GroupData&) = delete;
+            GroupData& operator=(GroupData&&) = delete;
 
             std::string overrideGroup;
-            std::map<std::string, Containers::ArrayView<const char>> resources;
+
+            /* Sorted filenames and corresponding data, both pointing to
+               the compiled-in data or to the pack memory */
+            std::vector<Containers::ArrayView<const char>> filenames;
+            std::vector<Containers::ArrayView<const char>> data;
+
+            /* Uncompressed sizes and lazily decompressed data, null if no
+               file in the group is compressed */
+            struct CompressedData;
+            CompressedData* compressed;
         };
 
         struct OverrideData;
@@ -180,6 +375,8 @@ class CORRADE_UTILITY_EXPORT Resource {
         OverrideData* _overrideGroup;
 };
 
+CORRADE_ENUMSET_OPERATORS(Resource::CompileFlags)
+
 /**
 @brief Initialize resource
 
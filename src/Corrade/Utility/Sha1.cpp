@@ -25,10 +25,54 @@
 
 #include "Sha1.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 #include "Corrade/Utility/Endianness.h"
 
+/* SHA-NI and AVX2 are available on GCC, Clang and MSVC. On GCC and Clang the
+   kernels are compiled with a target attribute and picked only after a
+   runtime check, so the rest of the library doesn't need to be built with
+   -msha or -mavx2. */
+#if defined(CORRADE_TARGET_X86) && (defined(__GNUC__) || defined(_MSC_VER))
+#define CORRADE_UTILITY_SHA1_SHANI
+#define CORRADE_UTILITY_SHA1_AVX2
+#ifdef __GNUC__
+#include <cpuid.h>
+#include <immintrin.h>
+#define CORRADE_UTILITY_SHA1_SHANI_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+#define CORRADE_UTILITY_SHA1_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#include <intrin.h>
+#include <immintrin.h>
+#define CORRADE_UTILITY_SHA1_SHANI_TARGET
+#define CORRADE_UTILITY_SHA1_AVX2_TARGET
+#endif
+#endif
+
+/* ARMv8 crypto extensions. If the compiler is told they're available, use
+   them directly, otherwise GCC 9+ can enable them per-function with a target
+   attribute. Runtime detection is done through getauxval() on Linux and
+   Android, Apple ARM64 devices have the extensions always. */
+#if defined(CORRADE_TARGET_ARM) && defined(__aarch64__)
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2)
+#define CORRADE_UTILITY_SHA1_ARM_CRYPTO
+#define CORRADE_UTILITY_SHA1_ARM_CRYPTO_TARGET
+#elif defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9 && defined(__linux__)
+#define CORRADE_UTILITY_SHA1_ARM_CRYPTO
+#define CORRADE_UTILITY_SHA1_ARM_CRYPTO_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+#ifdef CORRADE_UTILITY_SHA1_ARM_CRYPTO
+#include <cstdint>
+#include <arm_neon.h>
+#ifdef __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
 namespace Corrade { namespace Utility {
 
 namespace {
@@ -44,38 +88,540 @@ constexpr const unsigned int Constants[4] = { 0x5A827999,
                                               0x8F1BBCDC,
                                               0xCA62C1D6 };
 
-unsigned int leftrotate(unsigned int data, unsigned int shift) {
+inline unsigned int leftrotate(unsigned int data, unsigned int shift) {
     return data << shift | data >> (32 - shift);
 }
 
+inline void round(unsigned int(&d)[5], unsigned int f, unsigned int constant, unsigned int extended) {
+    const unsigned int temp = leftrotate(d[0], 5) + f + d[4] + constant + extended;
+    d[4] = d[3];
+    d[3] = d[2];
+    d[2] = leftrotate(d[1], 30);
+    d[1] = d[0];
+    d[0] = temp;
+}
+
+/* Appends the '1' bit and the data size in bits to the last incomplete chunk
+   of data. Returns size of the padded output, which is either 64 or 128
+   bytes. */
+std::size_t pad(char(&out)[128], const Containers::ArrayView<const char> leftovers, const unsigned long long dataSize) {
+    /* Add '1' bit to the leftovers, pad to (n*64)+56 bytes */
+    const std::size_t paddedSize = leftovers.size() + 1 > 56 ? 120 : 56;
+    if(!leftovers.empty()) std::memcpy(out, leftovers.data(), leftovers.size());
+    out[leftovers.size()] = '\x80';
+    std::memset(out + leftovers.size() + 1, 0, paddedSize - leftovers.size() - 1);
+
+    /* Add size of data in bits in big endian */
+    const unsigned long long dataSizeBigEndian = Endianness::bigEndian<unsigned long long>(dataSize*8);
+    std::memcpy(out + paddedSize, &dataSizeBigEndian, 8);
+    return paddedSize + 8;
+}
+
+void processChunksScalar(unsigned int* const digest, const char* data, std::size_t chunkCount) {
+    for(; chunkCount; --chunkCount, data += 64) {
+        /* Extend the data to 80 words. Assembling the big endian words byte
+           by byte avoids both unaligned reads on platforms that don't like
+           them (Emscripten) and a separate byte swap. */
+        const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(data);
+        unsigned int extended[80];
+        for(int i = 0; i != 16; ++i)
+            extended[i] =
+                static_cast<unsigned int>(bytes[i*4 + 0]) << 24 |
+                static_cast<unsigned int>(bytes[i*4 + 1]) << 16 |
+                static_cast<unsigned int>(bytes[i*4 + 2]) <<  8 |
+                static_cast<unsigned int>(bytes[i*4 + 3]) <<  0;
+        for(int i = 16; i != 80; ++i)
+            extended[i] = leftrotate((extended[i-3] ^ extended[i-8] ^ extended[i-14] ^ extended[i-16]), 1);
+
+        /* Initialize value for this chunk */
+        unsigned int d[5];
+        std::copy(digest, digest + 5, d);
+
+        /* Main loop, split into the four stages so there's no branching
+           inside */
+        for(int i = 0; i != 20; ++i)
+            round(d, d[3] ^ (d[1] & (d[2] ^ d[3])), Constants[0], extended[i]);
+        for(int i = 20; i != 40; ++i)
+            round(d, d[1] ^ d[2] ^ d[3], Constants[1], extended[i]);
+        for(int i = 40; i != 60; ++i)
+            round(d, (d[1] & d[2]) | (d[3] & (d[1] | d[2])), Constants[2], extended[i]);
+        for(int i = 60; i != 80; ++i)
+            round(d, d[1] ^ d[2] ^ d[3], Constants[3], extended[i]);
+
+        /* Add the values to digest */
+        for(int i = 0; i != 5; ++i)
+            digest[i] += d[i];
+    }
+}
+
+#if defined(CORRADE_UTILITY_SHA1_SHANI) || defined(CORRADE_UTILITY_SHA1_AVX2)
+struct CpuidLeaf {
+    unsigned int eax, ebx, ecx, edx;
+};
+
+CpuidLeaf cpuid(const unsigned int leaf) {
+    CpuidLeaf out{};
+    #ifdef __GNUC__
+    if(__get_cpuid_max(0, nullptr) < leaf) return out;
+    __cpuid_count(leaf, 0, out.eax, out.ebx, out.ecx, out.edx);
+    #else
+    int info[4];
+    __cpuid(info, 0);
+    if(unsigned(info[0]) < leaf) return out;
+    __cpuidex(info, leaf, 0);
+    out.eax = info[0];
+    out.ebx = info[1];
+    out.ecx = info[2];
+    out.edx = info[3];
+    #endif
+    return out;
+}
+#endif
+
+#ifdef CORRADE_UTILITY_SHA1_SHANI
+bool hasShaNi() {
+    /* SSSE3 is bit 9 and SSE4.1 bit 19 of leaf 1 ECX, SHA is bit 29 of leaf
+       7 EBX */
+    const unsigned int ecx1 = cpuid(1).ecx;
+    return (ecx1 & (1 << 9)) && (ecx1 & (1 << 19)) && (cpuid(7).ebx & (1 << 29));
+}
+
+/* One group of four rounds. The E values alternate between two registers and
+   the message schedule rotates through four, all indices are compile-time
+   constants so everything stays in registers. */
+template<int group> CORRADE_UTILITY_SHA1_SHANI_TARGET inline void shaNiGroup(__m128i& abcd, __m128i(&e)[2], __m128i(&message)[4]) {
+    if(group == 0)
+        e[0] = _mm_add_epi32(e[0], message[0]);
+    else
+        e[group%2] = _mm_sha1nexte_epu32(e[group%2], message[group%4]);
+    e[(group + 1)%2] = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e[group%2], group/5);
+
+    if(group >= 3 && group <= 18)
+        message[(group + 1)%4] = _mm_sha1msg2_epu32(message[(group + 1)%4], message[group%4]);
+    if(group >= 2 && group <= 17)
+        message[(group + 2)%4] = _mm_xor_si128(message[(group + 2)%4], message[group%4]);
+    if(group >= 1 && group <= 16)
+        message[(group + 3)%4] = _mm_sha1msg1_epu32(message[(group + 3)%4], message[group%4]);
+}
+
+CORRADE_UTILITY_SHA1_SHANI_TARGET void processChunksShaNi(unsigned int* const digest, const char* data, std::size_t chunkCount) {
+    /* Reverses bytes in the whole 128-bit value -- converts big endian input
+       words to native and at the same time puts the first word into the
+       highest lane, which is what the instructions expect */
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digest)), 0x1b);
+    __m128i e[2]{_mm_set_epi32(digest[4], 0, 0, 0), _mm_setzero_si128()};
+
+    for(; chunkCount; --chunkCount, data += 64) {
+        const __m128i abcdSaved = abcd;
+        const __m128i eSaved = e[0];
+
+        __m128i message[4];
+        for(int i = 0; i != 4; ++i)
+            message[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i*16)), mask);
+
+        shaNiGroup< 0>(abcd, e, message); shaNiGroup< 1>(abcd, e, message);
+        shaNiGroup< 2>(abcd, e, message); shaNiGroup< 3>(abcd, e, message);
+        shaNiGroup< 4>(abcd, e, message); shaNiGroup< 5>(abcd, e, message);
+        shaNiGroup< 6>(abcd, e, message); shaNiGroup< 7>(abcd, e, message);
+        shaNiGroup< 8>(abcd, e, message); shaNiGroup< 9>(abcd, e, message);
+        shaNiGroup<10>(abcd, e, message); shaNiGroup<11>(abcd, e, message);
+        shaNiGroup<12>(abcd, e, message); shaNiGroup<13>(abcd, e, message);
+        shaNiGroup<14>(abcd, e, message); shaNiGroup<15>(abcd, e, message);
+        shaNiGroup<16>(abcd, e, message); shaNiGroup<17>(abcd, e, message);
+        shaNiGroup<18>(abcd, e, message); shaNiGroup<19>(abcd, e, message);
+
+        /* Add the values to digest */
+        e[0] = _mm_sha1nexte_epu32(e[0], eSaved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(digest), _mm_shuffle_epi32(abcd, 0x1b));
+    digest[4] = _mm_extract_epi32(e[0], 3);
+}
+#endif
+
+#ifdef CORRADE_UTILITY_SHA1_AVX2
+bool hasAvx2() {
+    /* OSXSAVE is bit 27 and AVX bit 28 of leaf 1 ECX, additionally the OS
+       has to enable saving of both XMM and YMM registers in XCR0. AVX2 is bit
+       5 of leaf 7 EBX. */
+    const unsigned int ecx1 = cpuid(1).ecx;
+    if(!(ecx1 & (1 << 27)) || !(ecx1 & (1 << 28))) return false;
+    #ifdef __GNUC__
+    unsigned int xcr0, edx;
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+    static_cast<void>(edx);
+    #else
+    const unsigned long long xcr0 = _xgetbv(0);
+    #endif
+    return (xcr0 & 0x06) == 0x06 && (cpuid(7).ebx & (1 << 5));
+}
+
+template<int shift> CORRADE_UTILITY_SHA1_AVX2_TARGET inline __m256i leftrotateAvx2(const __m256i data) {
+    return _mm256_or_si256(_mm256_slli_epi32(data, shift), _mm256_srli_epi32(data, 32 - shift));
+}
+
+CORRADE_UTILITY_SHA1_AVX2_TARGET inline void roundAvx2(__m256i(&d)[5], const __m256i f, const __m256i constant, const __m256i extended) {
+    const __m256i temp = _mm256_add_epi32(
+        _mm256_add_epi32(leftrotateAvx2<5>(d[0]), f),
+        _mm256_add_epi32(_mm256_add_epi32(d[4], constant), extended));
+    d[4] = d[3];
+    d[3] = d[2];
+    d[2] = leftrotateAvx2<30>(d[1]);
+    d[1] = d[0];
+    d[0] = temp;
+}
+
+/* Processes one 64-byte chunk from each of the eight independent messages,
+   the digest is updated only in lanes that are marked as active */
+CORRADE_UTILITY_SHA1_AVX2_TARGET void processChunkAvx2(__m256i(&digest)[5], const char* const(&data)[8], const __m256i active) {
+    /* Converts big endian words to native */
+    const __m256i byteSwap = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    /* Load eight words of each message at a time and transpose them so each
+       register contains the same word from all messages */
+    __m256i extended[80];
+    for(int half = 0; half != 2; ++half) {
+        __m256i r[8];
+        for(int i = 0; i != 8; ++i)
+            r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data[i] + half*32));
+
+        const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+        const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+        const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+        const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+        const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+        const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+        const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+        const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+        const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+        const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+        const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+        const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+        const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+        const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+        const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+        const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+        __m256i* const words = extended + half*8;
+        words[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), byteSwap);
+        words[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), byteSwap);
+        words[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), byteSwap);
+        words[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), byteSwap);
+        words[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), byteSwap);
+        words[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), byteSwap);
+        words[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), byteSwap);
+        words[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), byteSwap);
+    }
+    for(int i = 16; i != 80; ++i)
+        extended[i] = leftrotateAvx2<1>(_mm256_xor_si256(
+            _mm256_xor_si256(extended[i-3], extended[i-8]),
+            _mm256_xor_si256(extended[i-14], extended[i-16])));
+
+    /* Initialize value for this chunk */
+    __m256i d[5];
+    std::copy(digest, digest + 5, d);
+
+    /* Main loop, the same as in the scalar variant */
+    const __m256i constant0 = _mm256_set1_epi32(Constants[0]);
+    for(int i = 0; i != 20; ++i)
+        roundAvx2(d, _mm256_xor_si256(d[3], _mm256_and_si256(d[1], _mm256_xor_si256(d[2], d[3]))), constant0, extended[i]);
+    const __m256i constant1 = _mm256_set1_epi32(Constants[1]);
+    for(int i = 20; i != 40; ++i)
+        roundAvx2(d, _mm256_xor_si256(_mm256_xor_si256(d[1], d[2]), d[3]), constant1, extended[i]);
+    const __m256i constant2 = _mm256_set1_epi32(Constants[2]);
+    for(int i = 40; i != 60; ++i)
+        roundAvx2(d, _mm256_or_si256(_mm256_and_si256(d[1], d[2]), _mm256_and_si256(d[3], _mm256_or_si256(d[1], d[2]))), constant2, extended[i]);
+    const __m256i constant3 = _mm256_set1_epi32(Constants[3]);
+    for(int i = 60; i != 80; ++i)
+        roundAvx2(d, _mm256_xor_si256(_mm256_xor_si256(d[1], d[2]), d[3]), constant3, extended[i]);
+
+    /* Add the values to digest in active lanes */
+    for(int i = 0; i != 5; ++i)
+        digest[i] = _mm256_blendv_epi8(digest[i], _mm256_add_epi32(digest[i], d[i]), active);
+}
+
+CORRADE_UTILITY_SHA1_AVX2_TARGET void digestMultiBufferAvx2(const Containers::ArrayView<const Containers::ArrayView<const char>> data, char* const digests) {
+    /* Process messages sorted by size so messages of similar length end up
+       next to each other and the lanes are kept busy most of the time */
+    Containers::Array<std::size_t> order{Containers::NoInit, data.size()};
+    for(std::size_t i = 0; i != data.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&data](std::size_t a, std::size_t b) {
+        return data[a].size() < data[b].size();
+    });
+
+    /* Padding of the message tails, inactive lanes read zeros */
+    char tails[8][128];
+    const char zeros[64]{};
+
+    for(std::size_t group = 0; group < data.size(); group += 8) {
+        const std::size_t laneCount = std::min(std::size_t{8}, data.size() - group);
+
+        std::size_t fullChunkCount[8]{};
+        std::size_t chunkCount[8]{};
+        std::size_t maxChunkCount = 0;
+        for(std::size_t lane = 0; lane != laneCount; ++lane) {
+            const Containers::ArrayView<const char> message = data[order[group + lane]];
+            fullChunkCount[lane] = message.size()/64;
+            chunkCount[lane] = fullChunkCount[lane] + pad(tails[lane], message.suffix(fullChunkCount[lane]*64), message.size())/64;
+            maxChunkCount = std::max(maxChunkCount, chunkCount[lane]);
+        }
+
+        __m256i digest[5];
+        for(int i = 0; i != 5; ++i)
+            digest[i] = _mm256_set1_epi32(InitialDigest[i]);
+
+        for(std::size_t chunk = 0; chunk != maxChunkCount; ++chunk) {
+            const char* pointers[8];
+            int active[8];
+            for(std::size_t lane = 0; lane != 8; ++lane) {
+                if(chunk < fullChunkCount[lane])
+                    pointers[lane] = data[order[group + lane]].data() + chunk*64;
+                else if(chunk < chunkCount[lane])
+                    pointers[lane] = tails[lane] + (chunk - fullChunkCount[lane])*64;
+                else pointers[lane] = zeros;
+                active[lane] = chunk < chunkCount[lane] ? -1 : 0;
+            }
+
+            processChunkAvx2(digest, pointers, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(active)));
+        }
+
+        /* Extract the digests, converting them to big endian */
+        unsigned int words[5][8];
+        for(int i = 0; i != 5; ++i)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(words[i]), digest[i]);
+        for(std::size_t lane = 0; lane != laneCount; ++lane) {
+            char* const out = digests + order[group + lane]*20;
+            for(int i = 0; i != 5; ++i) {
+                out[i*4 + 0] = char(words[i][lane] >> 24);
+                out[i*4 + 1] = char(words[i][lane] >> 16);
+                out[i*4 + 2] = char(words[i][lane] >>  8);
+                out[i*4 + 3] = char(words[i][lane] >>  0);
+            }
+        }
+    }
+}
+#endif
+
+#ifdef CORRADE_UTILITY_SHA1_ARM_CRYPTO
+bool hasArmCrypto() {
+    #if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2) || defined(CORRADE_TARGET_APPLE)
+    return true;
+    #else
+    return getauxval(AT_HWCAP) & HWCAP_SHA1;
+    #endif
+}
+
+/* One group of four rounds, similarly to the SHA-NI variant above. The
+   constants are added to the message words two groups ahead. */
+template<int group> CORRADE_UTILITY_SHA1_ARM_CRYPTO_TARGET inline void armCryptoGroup(uint32x4_t& abcd, std::uint32_t(&e)[2], uint32x4_t(&message)[4], uint32x4_t(&messageWithConstant)[2]) {
+    e[(group + 1)%2] = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+    if(group/5 == 0)
+        abcd = vsha1cq_u32(abcd, e[group%2], messageWithConstant[group%2]);
+    else if(group/5 == 2)
+        abcd = vsha1mq_u32(abcd, e[group%2], messageWithConstant[group%2]);
+    else
+        abcd = vsha1pq_u32(abcd, e[group%2], messageWithConstant[group%2]);
+
+    if(group <= 17)
+        messageWithConstant[group%2] = vaddq_u32(message[(group + 2)%4], vdupq_n_u32(Constants[(group + 2)/5]));
+    if(group >= 1 && group <= 16)
+        message[(group + 3)%4] = vsha1su1q_u32(message[(group + 3)%4], message[(group + 2)%4]);
+    if(group <= 15)
+        message[group%4] = vsha1su0q_u32(message[group%4], message[(group + 1)%4], message[(group + 2)%4]);
+}
+
+CORRADE_UTILITY_SHA1_ARM_CRYPTO_TARGET void processChunksArmCrypto(unsigned int* const digest, const char* data, std::size_t chunkCount) {
+    uint32x4_t abcd = vld1q_u32(digest);
+    std::uint32_t e[2]{digest[4], 0};
+
+    for(; chunkCount; --chunkCount, data += 64) {
+        const uint32x4_t abcdSaved = abcd;
+        const std::uint32_t eSaved = e[0];
+
+        uint32x4_t message[4];
+        for(int i = 0; i != 4; ++i) {
+            const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i*16));
+            #ifndef CORRADE_BIG_ENDIAN
+            message[i] = vreinterpretq_u32_u8(vrev32q_u8(bytes));
+            #else
+            message[i] = vreinterpretq_u32_u8(bytes);
+            #endif
+        }
+        uint32x4_t messageWithConstant[2]{
+            vaddq_u32(message[0], vdupq_n_u32(Constants[0])),
+            vaddq_u32(message[1], vdupq_n_u32(Constants[0]))};
+
+        armCryptoGroup< 0>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 1>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 2>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 3>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 4>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 5>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 6>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 7>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 8>(abcd, e, message, messageWithConstant);
+        armCryptoGroup< 9>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<10>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<11>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<12>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<13>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<14>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<15>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<16>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<17>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<18>(abcd, e, message, messageWithConstant);
+        armCryptoGroup<19>(abcd, e, message, messageWithConstant);
+
+        /* Add the values to digest */
+        e[0] += eSaved;
+        abcd = vaddq_u32(abcd, abcdSaved);
+    }
+
+    vst1q_u32(digest, abcd);
+    digest[4] = e[0];
+}
+#endif
+
+typedef void(*ProcessChunksFunction)(unsigned int*, const char*, std::size_t);
+
+ProcessChunksFunction processChunksFunction(const Implementation::Sha1Kernel kernel) {
+    switch(kernel) {
+        case Implementation::Sha1Kernel::Scalar:
+            return processChunksScalar;
+        #ifdef CORRADE_UTILITY_SHA1_SHANI
+        case Implementation::Sha1Kernel::ShaNi:
+            return processChunksShaNi;
+        #endif
+        #ifdef CORRADE_UTILITY_SHA1_ARM_CRYPTO
+        case Implementation::Sha1Kernel::ArmCrypto:
+            return processChunksArmCrypto;
+        #endif
+        default: return nullptr;
+    }
+}
+
+ProcessChunksFunction defaultProcessChunksFunction() {
+    /* Picked just once, the static initialization is thread-safe */
+    static const ProcessChunksFunction function = processChunksFunction(Implementation::sha1DefaultKernel());
+    return function;
+}
+
+}
+
+namespace Implementation {
+
+bool sha1KernelSupported(const Sha1Kernel kernel) {
+    switch(kernel) {
+        case Sha1Kernel::Scalar:
+            return true;
+        case Sha1Kernel::ShaNi:
+            #ifdef CORRADE_UTILITY_SHA1_SHANI
+            return hasShaNi();
+            #else
+            return false;
+            #endif
+        case Sha1Kernel::ArmCrypto:
+            #ifdef CORRADE_UTILITY_SHA1_ARM_CRYPTO
+            return hasArmCrypto();
+            #else
+            return false;
+            #endif
+    }
+
+    return false; /* LCOV_EXCL_LINE */
+}
+
+Sha1Kernel sha1DefaultKernel() {
+    if(sha1KernelSupported(Sha1Kernel::ShaNi)) return Sha1Kernel::ShaNi;
+    if(sha1KernelSupported(Sha1Kernel::ArmCrypto)) return Sha1Kernel::ArmCrypto;
+    return Sha1Kernel::Scalar;
+}
+
+void sha1ProcessChunks(const Sha1Kernel kernel, unsigned int* const digest, const char* const data, const std::size_t chunkCount) {
+    processChunksFunction(kernel)(digest, data, chunkCount);
+}
+
+bool sha1MultiBufferKernelSupported(const Sha1MultiBufferKernel kernel) {
+    switch(kernel) {
+        case Sha1MultiBufferKernel::Serial:
+            return true;
+        case Sha1MultiBufferKernel::Avx2:
+            #ifdef CORRADE_UTILITY_SHA1_AVX2
+            return hasAvx2();
+            #else
+            return false;
+            #endif
+    }
+
+    return false; /* LCOV_EXCL_LINE */
+}
+
+Sha1MultiBufferKernel sha1DefaultMultiBufferKernel() {
+    /* Picked just once, the static initialization is thread-safe. The
+       single-stream SHA-NI kernel is slightly faster than eight AVX2 lanes,
+       so the multi-buffer variant is used only if SHA-NI isn't there. */
+    static const Sha1MultiBufferKernel kernel =
+        !sha1KernelSupported(Sha1Kernel::ShaNi) && sha1MultiBufferKernelSupported(Sha1MultiBufferKernel::Avx2) ?
+            Sha1MultiBufferKernel::Avx2 : Sha1MultiBufferKernel::Serial;
+    return kernel;
+}
+
+void sha1DigestMultiBuffer(const Sha1MultiBufferKernel kernel, const Containers::ArrayView<const Containers::ArrayView<const char>> data, char* const digests) {
+    #ifdef CORRADE_UTILITY_SHA1_AVX2
+    if(kernel == Sha1MultiBufferKernel::Avx2) {
+        digestMultiBufferAvx2(data, digests);
+        return;
+    }
+    #else
+    static_cast<void>(kernel);
+    #endif
+
+    for(std::size_t i = 0; i != data.size(); ++i)
+        std::memcpy(digests + i*20, Sha1::digest(data[i]).byteArray(), 20);
+}
+
+}
+
+Containers::Array<Sha1::Digest> Sha1::digest(const Containers::ArrayView<const Containers::ArrayView<const char>> data) {
+    Containers::Array<Digest> out{Containers::NoInit, data.size()};
+    Implementation::sha1DigestMultiBuffer(Implementation::sha1DefaultMultiBufferKernel(), data, reinterpret_cast<char*>(out.data()));
+    return out;
 }
 
 Sha1::Sha1(): _dataSize(0), _digest{InitialDigest[0], InitialDigest[1], InitialDigest[2], InitialDigest[3], InitialDigest[4]} {}
 
-Sha1& Sha1::operator<<(const std::string& data) {
-    const std::size_t dataOffset = _buffer.empty() ? 0 : 64 - _buffer.size();
+Sha1& Sha1::operator<<(Containers::ArrayView<const char> data) {
+    /* The leftover byte count is implicitly given by the total size */
+    const std::size_t bufferSize = _dataSize % 64;
+    _dataSize += data.size();
 
     /* Process leftovers */
-    if(!_buffer.empty()) {
-        /* Not large enough, try it next time */
-        if(data.size() + _buffer.size() < 64) {
-            _buffer.append(data);
-            _dataSize += data.size();
-            return *this;
-        }
+    if(bufferSize) {
+        /* Append few last bytes to have the buffer at 64 bytes, if not large
+           enough, try it next time */
+        const std::size_t count = std::min(64 - bufferSize, data.size());
+        if(count) std::memcpy(_buffer + bufferSize, data.data(), count);
+        if(bufferSize + count != 64) return *this;
 
-        /* Append few last bytes to have the buffer at 64 bytes */
-        _buffer.append(data.substr(0, dataOffset));
-        processChunk(_buffer.data());
+        processChunks(_buffer, 1);
+        data = data.suffix(count);
     }
 
-    for(std::size_t i = dataOffset; i + 64 <= data.size(); i += 64)
-        processChunk(data.data() + i);
+    /* Process all full chunks at once */
+    const std::size_t chunkCount = data.size()/64;
+    processChunks(data.data(), chunkCount);
 
     /* Save last unfinished 512-bit chunk of data */
-    _buffer = data.substr(dataOffset + ((data.size() - dataOffset)/64)*64);
+    if(const std::size_t remaining = data.size() - chunkCount*64)
+        std::memcpy(_buffer, data.data() + chunkCount*64, remaining);
 
-    _dataSize += data.size();
     return *this;
 }
 
@@ -92,17 +638,9 @@ Sha1& Sha1::operator<<(const std::string& data) {
 #pragma GCC optimize ("O2")
 #endif
 Sha1::Digest Sha1::digest() {
-    /* Add '1' bit to the leftovers, pad to (n*64)+56 bytes */
-    _buffer.append(1, '\x80');
-    _buffer.append((_buffer.size() > 56 ? 120 : 56) - _buffer.size(), 0);
-
-    /* Add size of data in bits in big endian */
-    unsigned long long dataSizeBigEndian = Endianness::bigEndian<unsigned long long>(_dataSize*8);
-    _buffer.append(reinterpret_cast<const char*>(&dataSizeBigEndian), 8);
-
-    /* Process remaining chunks */
-    for(std::size_t i = 0; i != _buffer.size()/64; ++i)
-        processChunk(_buffer.data()+i*64);
+    /* Pad the leftovers and process remaining chunks */
+    char padded[128];
+    processChunks(padded, pad(padded, {_buffer, std::size_t(_dataSize % 64)}, _dataSize)/64);
 
     /* Convert digest from big endian */
     unsigned int digest[5];
@@ -112,7 +650,6 @@ Sha1::Digest Sha1::digest() {
 
     /* Clear data and return */
     std::copy(InitialDigest, InitialDigest+5, _digest);
-    _buffer.clear();
     _dataSize = 0;
     return d;
 }
@@ -120,53 +657,8 @@ Sha1::Digest Sha1::digest() {
 #pragma GCC pop_options
 #endif
 
-void Sha1::processChunk(const char* data) {
-    /* Extend the data to 80 bytes, make it big endian */
-    unsigned int extended[80];
-    /* Some memory juggling to avoid unaligned reads on platforms that don't
-       like it (Emscripten) */
-    for(int i = 0; i != 16; ++i)
-        extended[i] = Endianness::bigEndian<unsigned int>(
-            (static_cast<unsigned int>(static_cast<unsigned char>(data[i*4 + 3])) << 24) |
-            (static_cast<unsigned int>(static_cast<unsigned char>(data[i*4 + 2])) << 16) |
-            (static_cast<unsigned int>(static_cast<unsigned char>(data[i*4 + 1])) <<  8) |
-            (static_cast<unsigned int>(static_cast<unsigned char>(data[i*4 + 0])) <<  0));
-    for(int i = 16; i != 80; ++i)
-        extended[i] = leftrotate((extended[i-3] ^ extended[i-8] ^ extended[i-14] ^ extended[i-16]), 1);
-
-    /* Initialize value for this chunk */
-    unsigned int d[5];
-    unsigned int f, constant, temp;
-    std::copy(_digest, _digest+5, d);
-
-    /* Main loop */
-    for(int i = 0; i != 80; ++i) {
-        if(i < 20) {
-            f = d[3] ^ (d[1] & (d[2] ^ d[3]));
-            constant = Constants[0];
-        } else if(i < 40) {
-            f = d[1] ^ d[2] ^ d[3];
-            constant = Constants[1];
-        } else if(i < 60) {
-            f = (d[1] & d[2]) | (d[3] & (d[1] | d[2]));
-            constant = Constants[2];
-        } else {
-            f = d[1] ^ d[2] ^ d[3];
-            constant = Constants[3];
-        }
-
-        temp =
-            leftrotate(d[0], 5) + f + d[4] + constant + extended[i];
-        d[4] = d[3];
-        d[3] = d[2];
-        d[2] = leftrotate(d[1], 30);
-        d[1] = d[0];
-        d[0] = temp;
-    }
-
-    /* Add the values to digest */
-    for(int i = 0; i != 5; ++i)
-        _digest[i] += d[i];
+void Sha1::processChunks(const char* const data, const std::size_t chunkCount) {
+    if(chunkCount) defaultProcessChunksFunction()(_digest, data, chunkCount);
 }
 
 }}
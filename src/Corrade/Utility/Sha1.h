@@ -29,14 +29,45 @@
  * @brief Class @ref Corrade::Utility::Sha1
  */
 
+#include <cstddef>
 #include <string>
 
+#include "Corrade/Containers/Array.h"
 #include "Corrade/Utility/AbstractHash.h"
 #include "Corrade/Utility/visibility.h"
 
 namespace Corrade { namespace Utility {
 
-/** @brief SHA-1 */
+namespace Implementation {
+    /* Exposed only for testing and benchmarking */
+    enum class Sha1Kernel: unsigned char {
+        Scalar,
+        ShaNi,
+        ArmCrypto
+    };
+
+    CORRADE_UTILITY_EXPORT bool sha1KernelSupported(Sha1Kernel kernel);
+    CORRADE_UTILITY_EXPORT Sha1Kernel sha1DefaultKernel();
+    CORRADE_UTILITY_EXPORT void sha1ProcessChunks(Sha1Kernel kernel, unsigned int* digest, const char* data, std::size_t chunkCount);
+
+    enum class Sha1MultiBufferKernel: unsigned char {
+        Serial,
+        Avx2
+    };
+
+    CORRADE_UTILITY_EXPORT bool sha1MultiBufferKernelSupported(Sha1MultiBufferKernel kernel);
+    CORRADE_UTILITY_EXPORT Sha1MultiBufferKernel sha1DefaultMultiBufferKernel();
+    CORRADE_UTILITY_EXPORT void sha1DigestMultiBuffer(Sha1MultiBufferKernel kernel, Containers::ArrayView<const Containers::ArrayView<const char>> data, char* digests);
+}
+
+/**
+@brief SHA-1
+
+The implementation picks the fastest available code path at runtime --- on x86
+it's using the SHA instruction set extensions if the CPU supports them, on
+ARM64 the ARMv8 cryptography extensions. Otherwise a portable scalar
+implementation is used.
+*/
 class CORRADE_UTILITY_EXPORT Sha1: public AbstractHash<20> {
     public:
         /**
@@ -44,22 +75,69 @@ class CORRADE_UTILITY_EXPORT Sha1: public AbstractHash<20> {
          *
          * Convenience function for @cpp (Utility::Sha1{} << data).digest() @ce.
          */
+        static Digest digest(Containers::ArrayView<const char> data) {
+            return (Sha1() << data).digest();
+        }
+
+        /** @overload */
         static Digest digest(const std::string& data) {
             return (Sha1() << data).digest();
         }
 
+        /**
+         * @overload
+         *
+         * The trailing null terminator is not included in the digest.
+         */
+        template<std::size_t size> static Digest digest(const char(&data)[size]) {
+            return (Sha1() << data).digest();
+        }
+
+        /**
+         * @brief Digests of multiple independent inputs
+         *
+         * Returns the same as calling @ref digest(Containers::ArrayView<const char>)
+         * on each item of @p data. On x86 CPUs with AVX2 but without the SHA
+         * instruction set extensions the inputs are hashed eight at a time in
+         * parallel SIMD lanes, which is considerably faster for large amounts
+         * of small inputs.
+         */
+        static Containers::Array<Digest> digest(Containers::ArrayView<const Containers::ArrayView<const char>> data);
+
         explicit Sha1();
 
-        /** @brief Add data for digesting */
-        Sha1& operator<<(const std::string& data);
+        /**
+         * @brief Add data for digesting
+         *
+         * The data are processed directly from the view, only the trailing
+         * incomplete 64-byte block is copied to an internal fixed-size
+         * buffer. Adding data doesn't allocate, which makes it possible to
+         * incrementally digest for example a memory-mapped file.
+         * @see @ref Directory::mapRead()
+         */
+        Sha1& operator<<(Containers::ArrayView<const char> data);
+
+        /** @overload */
+        Sha1& operator<<(const std::string& data) {
+            return operator<<(Containers::ArrayView<const char>{data.data(), data.size()});
+        }
+
+        /**
+         * @overload
+         *
+         * The trailing null terminator is not included in the digest.
+         */
+        template<std::size_t size> Sha1& operator<<(const char(&data)[size]) {
+            return operator<<(Containers::ArrayView<const char>{data, size - 1});
+        }
 
         /** @brief Digest of all added data */
         Digest digest();
 
     private:
-        CORRADE_UTILITY_LOCAL void processChunk(const char* data);
+        CORRADE_UTILITY_LOCAL void processChunks(const char* data, std::size_t chunkCount);
 
-        std::string _buffer;
+        char _buffer[64];
         unsigned long long _dataSize;
         unsigned int _digest[5];
 };
@@ -0,0 +1,353 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+
+#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/TestSuite/Tester.h"
+#include "Corrade/TestSuite/Compare/Container.h"
+#include "Corrade/Utility/Configuration.h"
+#include "Corrade/Utility/ConfigurationParser.h"
+
+namespace Corrade { namespace Utility { namespace Test { namespace {
+
+struct ConfigurationParserTest: TestSuite::Tester {
+    explicit ConfigurationParserTest();
+
+    void empty();
+    void events();
+    void nestedShorthand();
+    void nestedShorthandTrailingSlash();
+    void multiLine();
+    void multiLineWindowsEol();
+    void bom();
+    void windowsEol();
+    void reuse();
+    void defaultImplementation();
+
+    void errorMissingEquals();
+    void errorMissingQuote();
+    void errorMissingMultiLineQuote();
+    void errorMissingBracket();
+    void errorEmptyGroup();
+    void errorEmptySubgroup();
+
+    void benchmarkParse();
+};
+
+/* Records all events into a string */
+struct Recorder: ConfigurationParser {
+    void doGroupBegin(Containers::ArrayView<const char> name) override {
+        out << "begin " << std::string{name, name.size()} << "\n";
+    }
+    void doGroupEnd() override {
+        out << "end\n";
+    }
+    void doValue(Containers::ArrayView<const char> key, Containers::ArrayView<const char> value) override {
+        out << "value " << std::string{key, key.size()} << "=" << std::string{value, value.size()} << "\n";
+    }
+    void doComment(Containers::ArrayView<const char> line) override {
+        out << "comment " << std::string{line, line.size()} << "\n";
+    }
+    void doError(const char* message) override {
+        out << "error " << message << "\n";
+    }
+
+    std::ostringstream out;
+};
+
+Containers::ArrayView<const char> view(const std::string& string) {
+    return {string.data(), string.size()};
+}
+
+constexpr const char* BenchmarkData[]{"Configuration", "ConfigurationParser"};
+
+ConfigurationParserTest::ConfigurationParserTest() {
+    addTests({&ConfigurationParserTest::empty,
+              &ConfigurationParserTest::events,
+              &ConfigurationParserTest::nestedShorthand,
+              &ConfigurationParserTest::nestedShorthandTrailingSlash,
+              &ConfigurationParserTest::multiLine,
+              &ConfigurationParserTest::multiLineWindowsEol,
+              &ConfigurationParserTest::bom,
+              &ConfigurationParserTest::windowsEol,
+              &ConfigurationParserTest::reuse,
+              &ConfigurationParserTest::defaultImplementation,
+
+              &ConfigurationParserTest::errorMissingEquals,
+              &ConfigurationParserTest::errorMissingQuote,
+              &ConfigurationParserTest::errorMissingMultiLineQuote,
+              &ConfigurationParserTest::errorMissingBracket,
+              &ConfigurationParserTest::errorEmptyGroup,
+              &ConfigurationParserTest::errorEmptySubgroup});
+
+    addInstancedBenchmarks({&ConfigurationParserTest::benchmarkParse}, 10,
+        Containers::arraySize(BenchmarkData));
+}
+
+void ConfigurationParserTest::empty() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(nullptr));
+    CORRADE_COMPARE(parser.out.str(), "");
+    CORRADE_VERIFY(!parser.hasBom());
+    CORRADE_VERIFY(!parser.hasWindowsEol());
+}
+
+void ConfigurationParserTest::events() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view(
+        "# A comment\n"
+        "\n"
+        "  key = value  \n"
+        "quoted=\"  spaces  \"\n"
+        "[group]\n"
+        "; another comment\n"
+        "empty=\n"
+        "[group]\n"
+        "\n")));
+    CORRADE_COMPARE(parser.out.str(),
+        "comment # A comment\n"
+        "comment \n"
+        "value key=value\n"
+        "value quoted=  spaces  \n"
+        "begin group\n"
+        "comment ; another comment\n"
+        "value empty=\n"
+        "end\n"
+        "begin group\n"
+        "comment \n"
+        "end\n");
+}
+
+void ConfigurationParserTest::nestedShorthand() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view(
+        "[a/b/c]\n"
+        "x=1\n"
+        "[a/b/c/d]\n"
+        "[a/e]\n"
+        "y=2\n"
+        "[ f ]\n"
+        "z=3")));
+    CORRADE_COMPARE(parser.out.str(),
+        "begin a\n"
+        "begin b\n"
+        "begin c\n"
+        "value x=1\n"
+        "begin d\n"
+        "end\n"
+        "end\n"
+        "end\n"
+        "begin e\n"
+        "value y=2\n"
+        "end\n"
+        "end\n"
+        "begin f\n"
+        "value z=3\n"
+        "end\n");
+}
+
+void ConfigurationParserTest::nestedShorthandTrailingSlash() {
+    /* Matches what Configuration did before, creating a group with an empty
+       name */
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view("[a/]\nx=1\n")));
+    CORRADE_COMPARE(parser.out.str(),
+        "begin a\n"
+        "begin \n"
+        "value x=1\n"
+        "end\n"
+        "end\n");
+}
+
+void ConfigurationParserTest::multiLine() {
+    const std::string data =
+        "value=\"\"\"\n"
+        "  Here is the value.\n"
+        "\n"
+        "[not a group]\n"
+        "  \"\"\"  \n"
+        "empty=\"\"\"\n"
+        "\"\"\"\n";
+
+    struct: ConfigurationParser {
+        void doValue(Containers::ArrayView<const char> key, Containers::ArrayView<const char> value) override {
+            keys.emplace_back(key, key.size());
+            values.emplace_back(value, value.size());
+            /* Not Windows EOL, so the value points into the input */
+            inInput = inInput && value.begin() >= data.begin() && value.end() <= data.end();
+        }
+
+        Containers::ArrayView<const char> data;
+        std::vector<std::string> keys, values;
+        bool inInput = true;
+    } parser;
+    parser.data = view(data);
+    CORRADE_VERIFY(parser.parse(parser.data));
+    CORRADE_COMPARE_AS(parser.keys, (std::vector<std::string>{"value", "empty"}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(parser.values, (std::vector<std::string>{
+        "  Here is the value.\n\n[not a group]", ""}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(parser.inInput);
+}
+
+void ConfigurationParserTest::multiLineWindowsEol() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view(
+        "value=\"\"\"\r\n"
+        "first\r\n"
+        "second\r\n"
+        "\"\"\"\r\n")));
+    CORRADE_COMPARE(parser.out.str(), "value value=first\nsecond\n");
+    CORRADE_VERIFY(parser.hasWindowsEol());
+}
+
+void ConfigurationParserTest::bom() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view("\xEF\xBB\xBFkey=value\n")));
+    CORRADE_COMPARE(parser.out.str(), "value key=value\n");
+    CORRADE_VERIFY(parser.hasBom());
+    CORRADE_VERIFY(!parser.hasWindowsEol());
+}
+
+void ConfigurationParserTest::windowsEol() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view("[group]\r\nkey=value\r\n")));
+    CORRADE_COMPARE(parser.out.str(),
+        "begin group\n"
+        "value key=value\n"
+        "end\n");
+    CORRADE_VERIFY(!parser.hasBom());
+    CORRADE_VERIFY(parser.hasWindowsEol());
+}
+
+void ConfigurationParserTest::reuse() {
+    Recorder parser;
+    CORRADE_VERIFY(parser.parse(view("\xEF\xBB\xBF[a]\r\n")));
+    CORRADE_VERIFY(parser.hasBom());
+    CORRADE_VERIFY(parser.hasWindowsEol());
+
+    /* Open groups from the previous run don't leak into the next one */
+    parser.out.str({});
+    CORRADE_VERIFY(parser.parse(view("[b]\n")));
+    CORRADE_COMPARE(parser.out.str(),
+        "begin b\n"
+        "end\n");
+    CORRADE_VERIFY(!parser.hasBom());
+    CORRADE_VERIFY(!parser.hasWindowsEol());
+}
+
+void ConfigurationParserTest::defaultImplementation() {
+    ConfigurationParser parser;
+    CORRADE_VERIFY(parser.parse(view("# comment\n[a/b]\nkey=value\n")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!parser.parse(view("[a")));
+    CORRADE_COMPARE(out.str(), "Utility::ConfigurationParser::parse(): missing closing bracket for a group header\n");
+}
+
+void ConfigurationParserTest::errorMissingEquals() {
+    Recorder parser;
+    CORRADE_VERIFY(!parser.parse(view("[a]\nkey\n[b]\n")));
+    /* Events before the error are reported, the groups are not closed */
+    CORRADE_COMPARE(parser.out.str(),
+        "begin a\n"
+        "error missing equals for a value\n");
+}
+
+void ConfigurationParserTest::errorMissingQuote() {
+    Recorder parser;
+    CORRADE_VERIFY(!parser.parse(view("key=\"value\n")));
+    CORRADE_COMPARE(parser.out.str(), "error missing closing quote for a value\n");
+}
+
+void ConfigurationParserTest::errorMissingMultiLineQuote() {
+    Recorder parser;
+    CORRADE_VERIFY(!parser.parse(view("key=\"\"\"\nvalue\n\"\"\n")));
+    CORRADE_COMPARE(parser.out.str(), "error missing closing quotes for a multi-line value\n");
+}
+
+void ConfigurationParserTest::errorMissingBracket() {
+    Recorder parser;
+    CORRADE_VERIFY(!parser.parse(view("[group\n")));
+    CORRADE_COMPARE(parser.out.str(), "error missing closing bracket for a group header\n");
+}
+
+void ConfigurationParserTest::errorEmptyGroup() {
+    Recorder parser;
+    CORRADE_VERIFY(!parser.parse(view("[  ]\n")));
+    CORRADE_COMPARE(parser.out.str(), "error empty group name\n");
+}
+
+void ConfigurationParserTest::errorEmptySubgroup() {
+    Recorder parser;
+    CORRADE_VERIFY(!parser.parse(view("[a//b]\n")));
+    CORRADE_COMPARE(parser.out.str(),
+        "begin a\n"
+        "error empty subgroup name\n");
+}
+
+void ConfigurationParserTest::benchmarkParse() {
+    setTestCaseDescription(BenchmarkData[testCaseInstanceId()]);
+
+    /* A generated file with lots of groups, only one of which is wanted */
+    std::string data;
+    for(std::size_t i = 0; i != 1000; ++i) {
+        data += "[entry]\nname=entry" + std::to_string(i) + "\n";
+        for(std::size_t j = 0; j != 10; ++j)
+            data += "value" + std::to_string(j) + "=" + std::to_string(i*j) + "\n";
+    }
+
+    std::string found;
+    CORRADE_BENCHMARK(1) {
+        if(testCaseInstanceId() == 0) {
+            std::istringstream in{data};
+            Configuration conf{in, Configuration::Flag::ReadOnly};
+            for(const ConfigurationGroup* group: conf.groups("entry"))
+                if(group->value("name") == "entry500") found = group->value("value7");
+        } else {
+            struct: ConfigurationParser {
+                void doValue(Containers::ArrayView<const char> key, Containers::ArrayView<const char> value) override {
+                    const std::string k{key, key.size()};
+                    if(k == "name") wanted = std::string{value, value.size()} == "entry500";
+                    else if(wanted && k == "value7") found = std::string{value, value.size()};
+                }
+
+                bool wanted{};
+                std::string found;
+            } parser;
+            parser.parse(view(data));
+            found = parser.found;
+        }
+    }
+
+    CORRADE_COMPARE(found, "3500");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Corrade::Utility::Test::ConfigurationParserTest)
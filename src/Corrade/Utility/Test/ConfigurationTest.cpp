@@ -23,6 +23,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <memory>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -32,13 +33,24 @@
 #include "Corrade/TestSuite/Compare/Container.h"
 #include "Corrade/TestSuite/Compare/File.h"
 #include "Corrade/TestSuite/Compare/FileToString.h"
+#include "Corrade/TestSuite/Compare/Numeric.h"
 #include "Corrade/Utility/Configuration.h"
 #include "Corrade/Utility/Directory.h"
+#include "Corrade/Utility/String.h"
 
 #include "configure.h"
 
+#ifdef CORRADE_TARGET_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Corrade { namespace Utility { namespace Test { namespace {
 
+struct Vec2 {
+    float x, y;
+};
+
 struct ConfigurationTest: TestSuite::Tester {
     explicit ConfigurationTest();
 
@@ -55,14 +67,41 @@ struct ConfigurationTest: TestSuite::Tester {
 
     void groupIndex();
     void valueIndex();
+    void groupLookupLarge();
+    void valueLookupLarge();
+
+    void valuesIntoArray();
+    void valuesIntoArrayIndexed();
+    void valuesIntoArrayCustomType();
+    void valueComponents();
+    void valueComponentsNonexistent();
 
     void names();
 
     void readonly();
+    void readonlySameAsReadWrite();
+    void readonlyStream();
+    void readonlyEmptyFile();
+    void readonlyModify();
+    void readonlyGroupOutlivesConfiguration();
+    void readonlyMove();
     void nonexistentFile();
     void truncate();
 
+    void saveReplacesFile();
+    void saveSymlinkPermissions();
+    void saveReadonlyOverSameFile();
+    void saveFailed();
+
+    void cache();
+    void cacheSameAsParsed();
+    void cacheUsed();
+    void cacheSourceModified();
+    void cacheCorrupted();
+    void cacheSkipComments();
+
     void whitespaces();
+    void trailingEmptyLine();
     void bom();
     void eol();
     void stripComments();
@@ -73,8 +112,55 @@ struct ConfigurationTest: TestSuite::Tester {
     void standaloneGroup();
     void copy();
     void move();
+
+    void benchmarkValueLookup();
+    void benchmarkSetValue();
+    void benchmarkParse();
+    void benchmarkSave();
+    void benchmarkValuesTyped();
+    void benchmarkValueComponents();
 };
 
+namespace {
+    enum: std::size_t { BenchmarkKeyCount = 10000 };
+
+    constexpr const char* ReadonlyData[]{
+        "parse.conf",
+        "hierarchic.conf",
+        "hierarchic-shortcuts.conf",
+        "whitespaces.conf",
+        "comments.conf",
+        "bom.conf",
+        "eol-windows.conf",
+        "eol-mixed.conf",
+        "multiLine.conf",
+        "multiLine-crlf.conf"
+    };
+
+    constexpr struct {
+        const char* name;
+        Configuration::Flags flags;
+    } BenchmarkParseData[]{
+        {"", {}},
+        {"read-only", Configuration::Flag::ReadOnly},
+        {"cached", Configuration::Flag::Cache},
+        {"cached, read-only", Configuration::Flag::Cache|Configuration::Flag::ReadOnly}
+    };
+
+    constexpr struct {
+        const char* name;
+        Configuration::Flags flags;
+    } CacheData[]{
+        {"", {}},
+        {"read-only", Configuration::Flag::ReadOnly}
+    };
+
+    constexpr const char* BenchmarkSaveData[]{"file", "std::ostream"};
+
+    constexpr const char* BenchmarkValuesTypedData[]{"std::vector", "Containers::Array"};
+    constexpr const char* BenchmarkValueComponentsData[]{"String::splitWithoutEmptyParts()", "valueComponents()"};
+}
+
 ConfigurationTest::ConfigurationTest() {
     addTests({&ConfigurationTest::parse,
               &ConfigurationTest::parseMissingEquals,
@@ -89,14 +175,49 @@ ConfigurationTest::ConfigurationTest() {
 
               &ConfigurationTest::groupIndex,
               &ConfigurationTest::valueIndex,
+              &ConfigurationTest::groupLookupLarge,
+              &ConfigurationTest::valueLookupLarge,
+
+              &ConfigurationTest::valuesIntoArray,
+              &ConfigurationTest::valuesIntoArrayIndexed,
+              &ConfigurationTest::valuesIntoArrayCustomType,
+              &ConfigurationTest::valueComponents,
+              &ConfigurationTest::valueComponentsNonexistent,
 
               &ConfigurationTest::names,
 
-              &ConfigurationTest::readonly,
+              &ConfigurationTest::readonly});
+
+    addInstancedTests({&ConfigurationTest::readonlySameAsReadWrite},
+        Containers::arraySize(ReadonlyData));
+
+    addTests({&ConfigurationTest::readonlyStream,
+              &ConfigurationTest::readonlyEmptyFile,
+              &ConfigurationTest::readonlyModify,
+              &ConfigurationTest::readonlyGroupOutlivesConfiguration,
+              &ConfigurationTest::readonlyMove,
               &ConfigurationTest::nonexistentFile,
               &ConfigurationTest::truncate,
 
+              &ConfigurationTest::saveReplacesFile,
+              &ConfigurationTest::saveSymlinkPermissions,
+              &ConfigurationTest::saveReadonlyOverSameFile,
+              &ConfigurationTest::saveFailed,
+
+              &ConfigurationTest::cache});
+
+    addInstancedTests({&ConfigurationTest::cacheSameAsParsed},
+        Containers::arraySize(ReadonlyData));
+
+    addInstancedTests({&ConfigurationTest::cacheUsed,
+                       &ConfigurationTest::cacheSourceModified},
+        Containers::arraySize(CacheData));
+
+    addTests({&ConfigurationTest::cacheCorrupted,
+              &ConfigurationTest::cacheSkipComments,
+
               &ConfigurationTest::whitespaces,
+              &ConfigurationTest::trailingEmptyLine,
               &ConfigurationTest::bom,
               &ConfigurationTest::eol,
               &ConfigurationTest::stripComments,
@@ -108,6 +229,21 @@ ConfigurationTest::ConfigurationTest() {
               &ConfigurationTest::copy,
               &ConfigurationTest::move});
 
+    addBenchmarks({&ConfigurationTest::benchmarkValueLookup,
+                   &ConfigurationTest::benchmarkSetValue}, 10);
+
+    addInstancedBenchmarks({&ConfigurationTest::benchmarkParse}, 10,
+        Containers::arraySize(BenchmarkParseData));
+
+    addInstancedBenchmarks({&ConfigurationTest::benchmarkSave}, 10,
+        Containers::arraySize(BenchmarkSaveData));
+
+    addInstancedBenchmarks({&ConfigurationTest::benchmarkValuesTyped}, 10,
+        Containers::arraySize(BenchmarkValuesTypedData));
+
+    addInstancedBenchmarks({&ConfigurationTest::benchmarkValueComponents}, 10,
+        Containers::arraySize(BenchmarkValueComponentsData));
+
     /* Create testing dir */
     Directory::mkpath(CONFIGURATION_WRITE_TEST_DIR);
 
@@ -341,6 +477,229 @@ void ConfigurationTest::valueIndex() {
     CORRADE_VERIFY(conf.setValue("a", "foo", 2));
 }
 
+void ConfigurationTest::groupLookupLarge() {
+    /* Enough groups to make the lookup go through the index */
+    Configuration conf;
+    for(std::size_t i = 0; i != 100; ++i) conf.addGroup(std::to_string(i%50));
+    ConfigurationGroup* const last = conf.addGroup("last");
+
+    CORRADE_COMPARE(conf.groupCount(), 101);
+    CORRADE_COMPARE(conf.groupCount("17"), 2);
+    CORRADE_COMPARE(conf.groupCount("nonexistent"), 0);
+    CORRADE_VERIFY(conf.hasGroup("17", 1));
+    CORRADE_VERIFY(!conf.hasGroup("17", 2));
+    CORRADE_VERIFY(conf.group("last") == last);
+    CORRADE_COMPARE(conf.groups("17").size(), 2);
+    CORRADE_VERIFY(conf.groups("nonexistent").empty());
+
+    /* Adding after the index was built picks the new group up */
+    ConfigurationGroup* const another = conf.addGroup("17");
+    CORRADE_COMPARE(conf.groupCount("17"), 3);
+    CORRADE_VERIFY(conf.group("17", 2) == another);
+
+    /* Removing updates positions of the groups after it */
+    CORRADE_VERIFY(conf.removeGroup("17", 0));
+    CORRADE_COMPARE(conf.groupCount("17"), 2);
+    CORRADE_VERIFY(conf.group("17", 1) == another);
+    CORRADE_VERIFY(conf.group("last") == last);
+    CORRADE_VERIFY(conf.removeGroup(last));
+    CORRADE_VERIFY(!conf.hasGroup("last"));
+
+    conf.removeAllGroups("17");
+    CORRADE_VERIFY(!conf.hasGroup("17"));
+    CORRADE_VERIFY(conf.hasGroup("18", 1));
+}
+
+void ConfigurationTest::valueLookupLarge() {
+    /* Enough values to make the lookup go through the index, with comments
+       in between */
+    std::ostringstream data;
+    for(std::size_t i = 0; i != 100; ++i)
+        data << "# comment\n" << "key" << i%50 << "=" << i << "\n";
+    std::istringstream in(data.str());
+    Configuration conf(in);
+    CORRADE_VERIFY(conf.isValid());
+
+    CORRADE_COMPARE(conf.valueCount(), 100);
+    CORRADE_COMPARE(conf.valueCount("key17"), 2);
+    CORRADE_COMPARE(conf.valueCount("nonexistent"), 0);
+    CORRADE_COMPARE(conf.value("key17", 0), "17");
+    CORRADE_COMPARE(conf.value("key17", 1), "67");
+    CORRADE_VERIFY(!conf.hasValue("key17", 2));
+    CORRADE_COMPARE_AS(conf.values("key17"),
+        (std::vector<std::string>{"17", "67"}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(conf.values("nonexistent").empty());
+
+    /* Setting existing and a new value, adding another */
+    CORRADE_VERIFY(conf.setValue("key17", "changed", 1));
+    CORRADE_VERIFY(!conf.setValue("key17", "foo", 3));
+    CORRADE_VERIFY(conf.setValue("key17", "new", 2));
+    conf.addValue("key17", "added");
+    conf.addValue("another", "yes");
+    CORRADE_COMPARE_AS(conf.values("key17"),
+        (std::vector<std::string>{"17", "changed", "new", "added"}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(conf.value("another"), "yes");
+
+    /* Removing updates positions of the values after it */
+    CORRADE_VERIFY(conf.removeValue("key17", 0));
+    CORRADE_COMPARE(conf.value("key17", 0), "changed");
+    CORRADE_COMPARE(conf.value("key49", 1), "99");
+    CORRADE_COMPARE(conf.value("another"), "yes");
+    conf.removeAllValues("key17");
+    CORRADE_VERIFY(!conf.hasValue("key17"));
+    CORRADE_COMPARE(conf.value("key18", 1), "68");
+
+    /* Insertion order is preserved on save */
+    std::ostringstream out;
+    conf.save(out);
+    const std::string saved = out.str();
+    CORRADE_VERIFY(saved.find("key16=66\n# comment\n# comment\nkey18=68\n") != std::string::npos);
+    CORRADE_VERIFY(String::endsWith(saved, "key49=99\nanother=yes\n"));
+}
+
+void ConfigurationTest::valuesIntoArray() {
+    std::istringstream in{
+        "value=1.5\n"
+        "# comment\n"
+        "value=-2\n"
+        "other=3\n"
+        "value=\n"
+        "value=  4e2  \n"};
+    Configuration conf{in, Configuration::Flag::ReadOnly};
+    CORRADE_VERIFY(conf.isValid());
+
+    Containers::Array<float> out{Containers::ValueInit, 4};
+    CORRADE_COMPARE(conf.values("value", Containers::arrayView(out)), 4);
+    CORRADE_COMPARE_AS(out,
+        (Containers::Array<float>{Containers::InPlaceInit, {1.5f, -2.0f, 0.0f, 400.0f}}),
+        TestSuite::Compare::Container);
+
+    /* Less space than values, the rest is not written but counted */
+    Containers::Array<int> smaller{Containers::ValueInit, 2};
+    CORRADE_COMPARE(conf.values("value", Containers::arrayView(smaller)), 4);
+    CORRADE_COMPARE_AS(smaller,
+        (Containers::Array<int>{Containers::InPlaceInit, {1, -2}}),
+        TestSuite::Compare::Container);
+
+    /* More space than values */
+    Containers::Array<int> larger{Containers::DirectInit, 3, 7};
+    CORRADE_COMPARE(conf.values("other", Containers::arrayView(larger)), 1);
+    CORRADE_COMPARE_AS(larger,
+        (Containers::Array<int>{Containers::InPlaceInit, {3, 7, 7}}),
+        TestSuite::Compare::Container);
+
+    /* Allocated */
+    CORRADE_COMPARE_AS(conf.valueArray<double>("value"),
+        (Containers::Array<double>{Containers::InPlaceInit, {1.5, -2.0, 0.0, 400.0}}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(conf.valueArray<double>("nonexistent").empty());
+
+    /* Flags are passed through, strings are taken verbatim like with
+       values() */
+    conf.addValue("hex", "ff");
+    conf.addValue("hex", "7f");
+    CORRADE_COMPARE_AS(conf.valueArray<int>("hex", ConfigurationValueFlag::Hex),
+        (Containers::Array<int>{Containers::InPlaceInit, {255, 127}}),
+        TestSuite::Compare::Container);
+    conf.addValue("text", "hello world");
+    CORRADE_COMPARE_AS(conf.valueArray<std::string>("text"),
+        (Containers::Array<std::string>{Containers::InPlaceInit, {"hello world"}}),
+        TestSuite::Compare::Container);
+}
+
+void ConfigurationTest::valuesIntoArrayIndexed() {
+    /* Enough values to make the lookup go through the index */
+    ConfigurationGroup group;
+    for(std::size_t i = 0; i != 100; ++i) {
+        group.addValue("key", i);
+        group.addValue("other", 1000 + i);
+    }
+
+    Containers::Array<unsigned int> out = group.valueArray<unsigned int>("key");
+    CORRADE_COMPARE(out.size(), 100);
+    for(std::size_t i = 0; i != out.size(); ++i)
+        CORRADE_COMPARE(out[i], i);
+
+    Containers::Array<unsigned int> three{Containers::ValueInit, 3};
+    CORRADE_COMPARE(group.values("other", Containers::arrayView(three)), 100);
+    CORRADE_COMPARE_AS(three,
+        (Containers::Array<unsigned int>{Containers::InPlaceInit, {1000, 1001, 1002}}),
+        TestSuite::Compare::Container);
+}
+
+}}
+
+template<> struct ConfigurationValue<Test::Vec2> {
+    ConfigurationValue() = delete;
+
+    static Test::Vec2 fromString(const std::string& value, ConfigurationValueFlags) {
+        const std::vector<std::string> parts = String::splitWithoutEmptyParts(value);
+        return {parts.size() > 0 ? std::stof(parts[0]) : 0.0f,
+                parts.size() > 1 ? std::stof(parts[1]) : 0.0f};
+    }
+};
+
+namespace Test { namespace {
+
+void ConfigurationTest::valuesIntoArrayCustomType() {
+    ConfigurationGroup group;
+    group.addValue("position", "1 2");
+    group.addValue("position", "3.5 -4");
+
+    Vec2 out[2];
+    CORRADE_COMPARE(group.values("position", Containers::arrayView(out)), 2);
+    CORRADE_COMPARE(out[0].x, 1.0f);
+    CORRADE_COMPARE(out[0].y, 2.0f);
+    CORRADE_COMPARE(out[1].x, 3.5f);
+    CORRADE_COMPARE(out[1].y, -4.0f);
+
+    Containers::Array<Vec2> array = group.valueArray<Vec2>("position");
+    CORRADE_COMPARE(array.size(), 2);
+    CORRADE_COMPARE(array[1].x, 3.5f);
+}
+
+void ConfigurationTest::valueComponents() {
+    ConfigurationGroup group;
+    group.addValue("weights", "  0.25\t0.5   0.25 ");
+    group.addValue("weights", "1");
+    group.addValue("flags", "yes no true 0");
+
+    Containers::Array<float> out{Containers::ValueInit, 3};
+    CORRADE_COMPARE(group.valueComponents("weights", Containers::arrayView(out)), 3);
+    CORRADE_COMPARE_AS(out,
+        (Containers::Array<float>{Containers::InPlaceInit, {0.25f, 0.5f, 0.25f}}),
+        TestSuite::Compare::Container);
+
+    /* Second value, less space than components */
+    float one[1];
+    CORRADE_COMPARE(group.valueComponents("weights", Containers::arrayView(one), 1), 1);
+    CORRADE_COMPARE(one[0], 1.0f);
+    CORRADE_COMPARE(group.valueComponents("weights", Containers::ArrayView<float>{}), 3);
+
+    CORRADE_COMPARE_AS(group.valueComponentsArray<bool>("flags"),
+        (Containers::Array<bool>{Containers::InPlaceInit, {true, false, true, false}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(group.valueComponentsArray<std::string>("flags"),
+        (Containers::Array<std::string>{Containers::InPlaceInit, {"yes", "no", "true", "0"}}),
+        TestSuite::Compare::Container);
+}
+
+void ConfigurationTest::valueComponentsNonexistent() {
+    ConfigurationGroup group;
+    group.addValue("empty", "");
+
+    Containers::Array<int> out{Containers::DirectInit, 2, 3};
+    CORRADE_COMPARE(group.valueComponents("nonexistent", Containers::arrayView(out)), 0);
+    CORRADE_COMPARE(group.valueComponents("empty", Containers::arrayView(out)), 0);
+    CORRADE_COMPARE(group.valueComponents("empty", Containers::arrayView(out), 1), 0);
+    CORRADE_COMPARE_AS(out,
+        (Containers::Array<int>{Containers::InPlaceInit, {3, 3}}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(group.valueComponentsArray<int>("nonexistent").empty());
+}
+
 void ConfigurationTest::names() {
     std::ostringstream out;
     Error redirectError{&out};
@@ -379,6 +738,92 @@ void ConfigurationTest::readonly() {
     CORRADE_VERIFY(conf.filename().empty());
 }
 
+void ConfigurationTest::readonlySameAsReadWrite() {
+    const std::string filename = Directory::join(CONFIGURATION_TEST_DIR, ReadonlyData[testCaseInstanceId()]);
+    setTestCaseDescription(ReadonlyData[testCaseInstanceId()]);
+
+    /* The values are views into the file in the read-only case, everything
+       should be the same as when parsing to owned strings */
+    Configuration conf(filename, Configuration::Flag::PreserveBom);
+    Configuration readonly(filename, Configuration::Flag::ReadOnly|Configuration::Flag::PreserveBom);
+    CORRADE_VERIFY(conf.isValid());
+    CORRADE_VERIFY(readonly.isValid());
+
+    std::ostringstream out, readonlyOut;
+    conf.save(out);
+    readonly.save(readonlyOut);
+    CORRADE_COMPARE(readonlyOut.str(), out.str());
+}
+
+void ConfigurationTest::readonlyStream() {
+    std::string data = "a=\"  quoted  \"\nb=42\nvalue=\"\"\"\nmulti\nline\n\"\"\"\n";
+    std::istringstream in(data);
+    Configuration conf(in, Configuration::Flag::ReadOnly);
+    CORRADE_VERIFY(conf.isValid());
+
+    /* The stream data got copied, so changing the original has no effect */
+    data.assign(data.size(), 'x');
+    CORRADE_COMPARE(conf.value("a"), "  quoted  ");
+    CORRADE_COMPARE(conf.value<int>("b"), 42);
+    CORRADE_COMPARE(conf.value("value"), "multi\nline");
+}
+
+void ConfigurationTest::readonlyEmptyFile() {
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "empty.conf");
+    CORRADE_VERIFY(Directory::write(filename, nullptr));
+
+    /* Memory-mapping an empty file fails, which should be handled silently */
+    std::ostringstream out;
+    Error redirectError{&out};
+    Configuration conf(filename, Configuration::Flag::ReadOnly);
+    CORRADE_VERIFY(conf.isValid());
+    CORRADE_VERIFY(conf.isEmpty());
+    CORRADE_COMPARE(out.str(), "");
+}
+
+void ConfigurationTest::readonlyModify() {
+    Configuration conf(Directory::join(CONFIGURATION_TEST_DIR, "parse.conf"), Configuration::Flag::ReadOnly);
+    CORRADE_VERIFY(conf.isValid());
+
+    CORRADE_VERIFY(conf.setValue("key", "newValue"));
+    conf.addValue("another", 1337);
+    CORRADE_VERIFY(conf.group("group", 1)->setValue("c", "value6", 1));
+    CORRADE_COMPARE(conf.value("key"), "newValue");
+    CORRADE_COMPARE(conf.value<int>("another"), 1337);
+    CORRADE_COMPARE_AS(conf.group("group", 1)->values("c"),
+        (std::vector<std::string>{"value4", "value6"}),
+        TestSuite::Compare::Container);
+}
+
+void ConfigurationTest::readonlyGroupOutlivesConfiguration() {
+    std::unique_ptr<ConfigurationGroup> copied, moved;
+    {
+        Configuration conf(Directory::join(CONFIGURATION_TEST_DIR, "hierarchic.conf"), Configuration::Flag::ReadOnly);
+        CORRADE_VERIFY(conf.isValid());
+
+        /* Both copies and groups moved out have to own their data, as the
+           original data get unmapped with the configuration */
+        copied.reset(new ConfigurationGroup{*conf.group("z")});
+        moved.reset(new ConfigurationGroup{std::move(*conf.group("z"))});
+    }
+
+    CORRADE_COMPARE(copied->group("x")->group("c")->group("v")->value("key1"), "val1");
+    CORRADE_COMPARE(moved->group("x")->group("c")->group("v")->value("key1"), "val1");
+}
+
+void ConfigurationTest::readonlyMove() {
+    Configuration conf(Directory::join(CONFIGURATION_TEST_DIR, "parse.conf"), Configuration::Flag::ReadOnly);
+    CORRADE_VERIFY(conf.isValid());
+
+    /* The data are moved along with the values */
+    Configuration moved{std::move(conf)};
+    CORRADE_COMPARE(moved.value("key"), "value");
+
+    Configuration assigned;
+    assigned = std::move(moved);
+    CORRADE_COMPARE(assigned.group("group")->value("b"), "value2");
+}
+
 void ConfigurationTest::nonexistentFile() {
     Directory::rm(Directory::join(CONFIGURATION_WRITE_TEST_DIR, "nonexistent.conf"));
     Configuration conf(Directory::join(CONFIGURATION_WRITE_TEST_DIR, "nonexistent.conf"));
@@ -405,6 +850,262 @@ void ConfigurationTest::truncate() {
                        "", TestSuite::Compare::FileToString);
 }
 
+void ConfigurationTest::saveReplacesFile() {
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "replaced.conf");
+    CORRADE_VERIFY(Directory::writeString(filename, "a much longer original content that should be completely gone\n"));
+
+    Configuration conf;
+    conf.setValue("key", "value");
+    CORRADE_VERIFY(conf.save(filename));
+    CORRADE_COMPARE_AS(filename, "key=value\n", TestSuite::Compare::FileToString);
+
+    /* The temporary file is not left behind */
+    for(const std::string& file: Directory::list(CONFIGURATION_WRITE_TEST_DIR))
+        CORRADE_VERIFY(!String::beginsWith(file, "replaced.conf.tmp"));
+}
+
+void ConfigurationTest::saveSymlinkPermissions() {
+    #ifndef CORRADE_TARGET_UNIX
+    CORRADE_SKIP("Symlinks and file modes are tested only on Unix.");
+    #else
+    const std::string target = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "symlink-target.conf");
+    const std::string link = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "symlink.conf");
+    Directory::rm(link);
+    CORRADE_VERIFY(Directory::writeString(target, "key=original\n"));
+    CORRADE_COMPARE(chmod(target.data(), 0640), 0);
+    /* Relative link, which has to be resolved against its directory */
+    CORRADE_COMPARE(symlink("symlink-target.conf", link.data()), 0);
+
+    Configuration conf{link};
+    conf.setValue("key", "saved");
+    CORRADE_VERIFY(conf.save());
+
+    /* The link is kept and the target is updated with its mode preserved */
+    struct stat st;
+    CORRADE_COMPARE(lstat(link.data(), &st), 0);
+    CORRADE_VERIFY(S_ISLNK(st.st_mode));
+    CORRADE_COMPARE(stat(target.data(), &st), 0);
+    CORRADE_COMPARE(st.st_mode & 0777, 0640);
+    CORRADE_COMPARE_AS(target, "key=saved\n", TestSuite::Compare::FileToString);
+    #endif
+}
+
+void ConfigurationTest::saveReadonlyOverSameFile() {
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "readonly-resave.conf");
+    CORRADE_VERIFY(Directory::copy(Directory::join(CONFIGURATION_TEST_DIR, "parse.conf"), filename));
+
+    /* The values reference the mapped file, which is not overwritten in
+       place by saving, so they stay intact */
+    Configuration conf{filename, Configuration::Flag::ReadOnly};
+    CORRADE_VERIFY(conf.isValid());
+    conf.group("thirdGroup")->setValue("key", "a new value that's quite a lot longer");
+    CORRADE_VERIFY(conf.save(filename));
+    CORRADE_COMPARE(conf.value("key"), "value");
+    CORRADE_COMPARE(conf.group("group")->value("b"), "value2");
+
+    Configuration saved{filename};
+    CORRADE_COMPARE(saved.group("thirdGroup")->value("key"), "a new value that's quite a lot longer");
+    CORRADE_COMPARE(saved.group("group")->value("b"), "value2");
+}
+
+void ConfigurationTest::saveFailed() {
+    const std::string filename = Directory::join(Directory::join(CONFIGURATION_WRITE_TEST_DIR, "nonexistent"), "file.conf");
+
+    Configuration conf;
+    conf.setValue("key", "value");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!conf.save(filename));
+    CORRADE_COMPARE(out.str(),
+        "Utility::Configuration::save(): cannot open file " + filename + "\n");
+    CORRADE_VERIFY(!Directory::exists(filename));
+}
+
+void ConfigurationTest::cache() {
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "cache.conf");
+    CORRADE_VERIFY(Directory::copy(Directory::join(CONFIGURATION_TEST_DIR, "parse.conf"), filename));
+    Directory::rm(filename + ".cache");
+
+    /* The cache is created next to the file, without a temporary file left
+       behind */
+    Configuration conf{filename, Configuration::Flag::Cache};
+    CORRADE_VERIFY(conf.isValid());
+    CORRADE_COMPARE(conf.value("key"), "value");
+    CORRADE_VERIFY(Directory::exists(filename + ".cache"));
+    CORRADE_VERIFY(!Directory::exists(filename + ".cache.tmp"));
+
+    /* Saving still writes the text format and doesn't touch the cache */
+    const Containers::Array<char> cache = Directory::read(filename + ".cache");
+    CORRADE_VERIFY(conf.save());
+    CORRADE_COMPARE_AS(filename,
+        Directory::join(CONFIGURATION_TEST_DIR, "parse.conf"),
+        TestSuite::Compare::File);
+    CORRADE_COMPARE_AS(Directory::read(filename + ".cache"), cache,
+        TestSuite::Compare::Container);
+}
+
+void ConfigurationTest::cacheSameAsParsed() {
+    const std::string source = Directory::join(CONFIGURATION_TEST_DIR, ReadonlyData[testCaseInstanceId()]);
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, std::string{"cache-"} + ReadonlyData[testCaseInstanceId()]);
+    setTestCaseDescription(ReadonlyData[testCaseInstanceId()]);
+    CORRADE_VERIFY(Directory::copy(source, filename));
+    Directory::rm(filename + ".cache");
+
+    Configuration conf{filename, Configuration::Flag::PreserveBom};
+    CORRADE_VERIFY(conf.isValid());
+    std::ostringstream out;
+    conf.save(out);
+
+    /* First creates the cache, the others load it */
+    for(Configuration::Flags flags: {Configuration::Flags{}, Configuration::Flags{}, Configuration::Flags{Configuration::Flag::ReadOnly}}) {
+        Configuration cached{filename, flags|Configuration::Flag::Cache|Configuration::Flag::PreserveBom};
+        CORRADE_VERIFY(cached.isValid());
+
+        std::ostringstream cachedOut;
+        cached.save(cachedOut);
+        CORRADE_COMPARE(cachedOut.str(), out.str());
+    }
+}
+
+void ConfigurationTest::cacheUsed() {
+    auto&& data = CacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "cache-used.conf");
+    CORRADE_VERIFY(Directory::copy(Directory::join(CONFIGURATION_TEST_DIR, "parse.conf"), filename));
+    Directory::rm(filename + ".cache");
+    CORRADE_VERIFY(Configuration(filename, Configuration::Flag::Cache).isValid());
+
+    /* Patch a value in the cache to verify it's really used instead of the
+       source file */
+    std::string cache = Directory::readString(filename + ".cache");
+    const std::size_t position = cache.find("value2");
+    CORRADE_VERIFY(position != std::string::npos);
+    cache.replace(position, 6, "VALUE2");
+    CORRADE_VERIFY(Directory::writeString(filename + ".cache", cache));
+
+    Configuration conf{filename, data.flags|Configuration::Flag::Cache};
+    CORRADE_VERIFY(conf.isValid());
+    CORRADE_COMPARE(conf.group("group")->value("b"), "VALUE2");
+    CORRADE_COMPARE(conf.value("key"), "value");
+
+    /* The values stay valid after a move */
+    Configuration moved{std::move(conf)};
+    CORRADE_COMPARE(moved.group("group")->value("b"), "VALUE2");
+}
+
+void ConfigurationTest::cacheSourceModified() {
+    auto&& data = CacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "cache-modified.conf");
+    CORRADE_VERIFY(Directory::writeString(filename, "key=value\n"));
+    Directory::rm(filename + ".cache");
+    CORRADE_VERIFY(Configuration(filename, Configuration::Flag::Cache).isValid());
+
+    /* Same size, different contents, so the hash has to catch it */
+    CORRADE_VERIFY(Directory::writeString(filename, "key=VALUE\n"));
+    {
+        Configuration conf{filename, data.flags|Configuration::Flag::Cache};
+        CORRADE_VERIFY(conf.isValid());
+        CORRADE_COMPARE(conf.value("key"), "VALUE");
+    }
+
+    /* Different size, and the cache is updated */
+    CORRADE_VERIFY(Directory::writeString(filename, "key=another value\n"));
+    {
+        Configuration conf{filename, data.flags|Configuration::Flag::Cache};
+        CORRADE_VERIFY(conf.isValid());
+        CORRADE_COMPARE(conf.value("key"), "another value");
+    }
+    const std::string cache = Directory::readString(filename + ".cache");
+    CORRADE_VERIFY(cache.find("another value") != std::string::npos);
+}
+
+void ConfigurationTest::cacheCorrupted() {
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "cache-corrupted.conf");
+    CORRADE_VERIFY(Directory::copy(Directory::join(CONFIGURATION_TEST_DIR, "hierarchic.conf"), filename));
+    Directory::rm(filename + ".cache");
+    CORRADE_VERIFY(Configuration(filename, Configuration::Flag::Cache).isValid());
+
+    Configuration expected{filename};
+    std::ostringstream expectedOut;
+    expected.save(expectedOut);
+
+    const std::string cache = Directory::readString(filename + ".cache");
+    for(std::size_t size: {std::size_t{0}, std::size_t{10}, std::size_t{24}, std::size_t{40}, cache.size() - 1}) {
+        /* A truncated cache silently falls back to parsing the file, which
+           then updates the cache again */
+        CORRADE_VERIFY(Directory::writeString(filename + ".cache", cache.substr(0, size)));
+        std::ostringstream out;
+        Error redirectError{&out};
+        Configuration conf{filename, Configuration::Flag::Cache|Configuration::Flag::ReadOnly};
+        CORRADE_VERIFY(conf.isValid());
+        CORRADE_COMPARE(out.str(), "");
+
+        std::ostringstream confOut;
+        conf.save(confOut);
+        CORRADE_COMPARE(confOut.str(), expectedOut.str());
+        CORRADE_COMPARE(Directory::readString(filename + ".cache"), cache);
+    }
+
+    /* Garbage counts after a valid header */
+    {
+        std::string corrupted = cache.substr(0, 24);
+        corrupted.append(4, '\xff');
+        corrupted.append(cache.size() - corrupted.size(), 'x');
+        CORRADE_VERIFY(Directory::writeString(filename + ".cache", corrupted));
+        Configuration conf{filename, Configuration::Flag::Cache};
+        CORRADE_VERIFY(conf.isValid());
+        std::ostringstream confOut;
+        conf.save(confOut);
+        CORRADE_COMPARE(confOut.str(), expectedOut.str());
+    }
+
+    /* A valid header followed by a long chain of nested groups, each with no
+       values, one unnamed subgroup. Shouldn't overflow the stack. */
+    {
+        std::string corrupted = cache.substr(0, 24);
+        const char level[12]{0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0};
+        for(std::size_t i = 0; i != 1000000; ++i)
+            corrupted.append(level, sizeof(level));
+        corrupted.append(8, '\0');
+        CORRADE_VERIFY(Directory::writeString(filename + ".cache", corrupted));
+        Configuration conf{filename, Configuration::Flag::Cache};
+        CORRADE_VERIFY(conf.isValid());
+        std::ostringstream confOut;
+        conf.save(confOut);
+        CORRADE_COMPARE(confOut.str(), expectedOut.str());
+    }
+}
+
+void ConfigurationTest::cacheSkipComments() {
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "cache-comments.conf");
+    CORRADE_VERIFY(Directory::copy(Directory::join(CONFIGURATION_TEST_DIR, "comments.conf"), filename));
+    Directory::rm(filename + ".cache");
+
+    std::ostringstream expected, expectedSkipComments;
+    Configuration{filename}.save(expected);
+    Configuration{filename, Configuration::Flag::SkipComments}.save(expectedSkipComments);
+    CORRADE_VERIFY(expected.str() != expectedSkipComments.str());
+
+    /* A cache with comments is not used when comments should be skipped and
+       vice versa */
+    CORRADE_VERIFY(Configuration(filename, Configuration::Flag::Cache).isValid());
+    {
+        Configuration conf{filename, Configuration::Flag::Cache|Configuration::Flag::SkipComments};
+        std::ostringstream out;
+        conf.save(out);
+        CORRADE_COMPARE(out.str(), expectedSkipComments.str());
+    } {
+        Configuration conf{filename, Configuration::Flag::Cache};
+        std::ostringstream out;
+        conf.save(out);
+        CORRADE_COMPARE(out.str(), expected.str());
+    }
+}
+
 void ConfigurationTest::whitespaces() {
     Configuration conf(Directory::join(CONFIGURATION_TEST_DIR, "whitespaces.conf"));
     conf.setFilename(Directory::join(CONFIGURATION_WRITE_TEST_DIR, "whitespaces.conf"));
@@ -415,6 +1116,30 @@ void ConfigurationTest::whitespaces() {
                        TestSuite::Compare::File);
 }
 
+void ConfigurationTest::trailingEmptyLine() {
+    /* An empty line at the end of the file is kept, same as in the original
+       parser, both for the root and a subgroup */
+    const std::string data = "a=1\n\n[g]\nb=2\n\n";
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "trailing-empty-line.conf");
+    CORRADE_VERIFY(Directory::writeString(filename, data));
+
+    for(const Configuration::Flags flags: {Configuration::Flags{}, Configuration::Flags{Configuration::Flag::ReadOnly}}) {
+        Configuration conf{filename, flags};
+        CORRADE_VERIFY(conf.isValid());
+        CORRADE_COMPARE(conf.group("g")->value("b"), "2");
+
+        std::ostringstream out;
+        conf.save(out);
+        CORRADE_COMPARE(out.str(), data);
+    }
+
+    /* Comments are skipped including empty lines */
+    Configuration conf{filename, Configuration::Flag::SkipComments};
+    std::ostringstream out;
+    conf.save(out);
+    CORRADE_COMPARE(out.str(), "a=1\n[g]\nb=2\n");
+}
+
 void ConfigurationTest::bom() {
     {
         /* Stripped by default */
@@ -612,6 +1337,143 @@ void ConfigurationTest::move() {
     CORRADE_VERIFY(confAssignedMove.group("group")->configuration() == &confAssignedMove);
 }
 
+void ConfigurationTest::benchmarkValueLookup() {
+    ConfigurationGroup group;
+    for(std::size_t i = 0; i != BenchmarkKeyCount; ++i)
+        group.addValue("key" + std::to_string(i), i);
+
+    std::vector<std::string> keys;
+    for(std::size_t i = 0; i != BenchmarkKeyCount; ++i)
+        keys.push_back("key" + std::to_string(i));
+
+    std::size_t sum = 0;
+    CORRADE_BENCHMARK(1)
+        for(const std::string& key: keys)
+            sum += group.value<std::size_t>(key);
+
+    CORRADE_COMPARE(sum, BenchmarkKeyCount*(BenchmarkKeyCount - 1)/2);
+}
+
+void ConfigurationTest::benchmarkSetValue() {
+    std::vector<std::string> keys;
+    for(std::size_t i = 0; i != BenchmarkKeyCount; ++i)
+        keys.push_back("key" + std::to_string(i));
+
+    ConfigurationGroup group;
+    CORRADE_BENCHMARK(1) {
+        group.clear();
+        for(const std::string& key: keys)
+            group.setValue(key, "value");
+    }
+
+    CORRADE_COMPARE(group.valueCount(), BenchmarkKeyCount);
+}
+
+void ConfigurationTest::benchmarkParse() {
+    const auto& data = BenchmarkParseData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Keys and values long enough to not fit into small string storage */
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "benchmark.conf");
+    {
+        std::string file;
+        for(std::size_t i = 0; i != BenchmarkKeyCount; ++i) {
+            if(i % 100 == 0) file += "[group]\n";
+            file += "a.pretty.long.key" + std::to_string(i) + " = and a value that is long as well\n";
+        }
+        CORRADE_VERIFY(Directory::writeString(filename, file));
+    }
+
+    /* Create the cache upfront so the benchmark measures just loading it */
+    Directory::rm(filename + ".cache");
+    if(data.flags & Configuration::Flag::Cache)
+        CORRADE_VERIFY(Configuration(filename, data.flags).isValid());
+
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(1) {
+        Configuration conf{filename, data.flags};
+        count += conf.groupCount("group");
+    }
+
+    CORRADE_COMPARE(count, BenchmarkKeyCount/100);
+}
+
+void ConfigurationTest::benchmarkSave() {
+    const bool stream = testCaseInstanceId() == 1;
+    setTestCaseDescription(BenchmarkSaveData[testCaseInstanceId()]);
+
+    /* 50k values in nested groups */
+    Configuration conf;
+    for(std::size_t i = 0; i != 500; ++i) {
+        ConfigurationGroup* group = conf.addGroup("group")->addGroup("subgroup");
+        for(std::size_t j = 0; j != 100; ++j)
+            group->addValue("a.pretty.long.key" + std::to_string(j), i*j);
+    }
+
+    const std::string filename = Directory::join(CONFIGURATION_WRITE_TEST_DIR, "benchmark-save.conf");
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        if(stream) {
+            std::ostringstream out;
+            conf.save(out);
+            size = out.str().size();
+        } else conf.save(filename);
+    }
+
+    if(!stream) size = Directory::read(filename).size();
+
+    CORRADE_COMPARE_AS(size, 1000000, TestSuite::Compare::Greater);
+}
+
+void ConfigurationTest::benchmarkValuesTyped() {
+    const bool array = testCaseInstanceId() == 1;
+    setTestCaseDescription(BenchmarkValuesTypedData[testCaseInstanceId()]);
+
+    /* A per-vertex tuning table */
+    std::ostringstream data;
+    for(std::size_t i = 0; i != BenchmarkKeyCount; ++i)
+        data << "weight=" << float(i)*0.25f << "\n";
+    std::istringstream in{data.str()};
+    Configuration conf{in, Configuration::Flag::ReadOnly};
+
+    float sum = 0.0f;
+    CORRADE_BENCHMARK(1) {
+        if(array) {
+            for(float weight: conf.valueArray<float>("weight")) sum += weight;
+        } else {
+            for(float weight: conf.values<float>("weight")) sum += weight;
+        }
+    }
+
+    CORRADE_VERIFY(sum > 0.0f);
+}
+
+void ConfigurationTest::benchmarkValueComponents() {
+    const bool components = testCaseInstanceId() == 1;
+    setTestCaseDescription(BenchmarkValueComponentsData[testCaseInstanceId()]);
+
+    /* A per-bone tuning table with a few components in each value */
+    ConfigurationGroup group;
+    for(std::size_t i = 0; i != BenchmarkKeyCount/10; ++i)
+        group.addValue("bone", "0.5 1.25 -3 " + std::to_string(i));
+
+    std::size_t sum = 0;
+    CORRADE_BENCHMARK(1) {
+        for(unsigned int i = 0; i != BenchmarkKeyCount/10; ++i) {
+            if(components) {
+                float out[4];
+                group.valueComponents("bone", Containers::arrayView(out), i);
+                sum += std::size_t(out[3]);
+            } else {
+                const std::vector<std::string> parts = String::splitWithoutEmptyParts(group.value("bone", i));
+                sum += std::size_t(ConfigurationValue<float>::fromString(parts[3], {}));
+            }
+        }
+    }
+
+    CORRADE_COMPARE(sum % (BenchmarkKeyCount/10*(BenchmarkKeyCount/10 - 1)/2), 0);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::ConfigurationTest)
@@ -23,6 +23,9 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <limits>
+#include <sstream>
+
 #include "Corrade/TestSuite/Tester.h"
 #include "Corrade/Utility/Configuration.h"
 
@@ -57,25 +60,44 @@ struct ConfigurationValueTest: TestSuite::Tester {
     void unsignedInteger();
     void signedInteger();
     void integerFlags();
+    void integerParsing();
     void floatingPoint();
     void floatingPointScientific();
+    void floatingPointRoundtrip();
+    void floatingPointSpecial();
     void unicodeCharLiteral();
     void boolean();
 
     void custom();
+
+    void benchmarkIntegerFromString();
+    void benchmarkFloatFromString();
+    void benchmarkFloatToString();
 };
 
+enum: std::size_t { BenchmarkValueCount = 10000 };
+
+constexpr const char* BenchmarkData[]{"", "std::stringstream"};
+
 ConfigurationValueTest::ConfigurationValueTest() {
     addTests({&ConfigurationValueTest::string,
               &ConfigurationValueTest::unsignedInteger,
               &ConfigurationValueTest::signedInteger,
               &ConfigurationValueTest::integerFlags,
+              &ConfigurationValueTest::integerParsing,
               &ConfigurationValueTest::floatingPoint,
               &ConfigurationValueTest::floatingPointScientific,
+              &ConfigurationValueTest::floatingPointRoundtrip,
+              &ConfigurationValueTest::floatingPointSpecial,
               &ConfigurationValueTest::unicodeCharLiteral,
               &ConfigurationValueTest::boolean,
 
               &ConfigurationValueTest::custom});
+
+    addInstancedBenchmarks({&ConfigurationValueTest::benchmarkIntegerFromString,
+                            &ConfigurationValueTest::benchmarkFloatFromString,
+                            &ConfigurationValueTest::benchmarkFloatToString}, 10,
+        Containers::arraySize(BenchmarkData));
 }
 
 void ConfigurationValueTest::string() {
@@ -161,6 +183,30 @@ void ConfigurationValueTest::integerFlags() {
     }
 }
 
+void ConfigurationValueTest::integerParsing() {
+    /* Leading whitespace and a sign is accepted, parsing stops at the first
+       non-digit character */
+    CORRADE_COMPARE(ConfigurationValue<int>::fromString("  +17 apples", {}), 17);
+    CORRADE_COMPARE(ConfigurationValue<int>::fromString("-0x1f", ConfigurationValueFlag::Hex), -0x1f);
+    CORRADE_COMPARE(ConfigurationValue<int>::fromString("1f", ConfigurationValueFlag::Hex), 0x1f);
+    CORRADE_COMPARE(ConfigurationValue<int>::fromString("0x1f", {}), 0);
+    CORRADE_COMPARE(ConfigurationValue<int>::fromString("0778", ConfigurationValueFlag::Oct), 077);
+    CORRADE_COMPARE(ConfigurationValue<int>::fromString("nope", {}), 0);
+
+    /* Out-of-range values saturate, negative values wrap around for unsigned
+       types */
+    CORRADE_COMPARE(ConfigurationValue<short>::fromString("40000", {}), 32767);
+    CORRADE_COMPARE(ConfigurationValue<short>::fromString("-32768", {}), -32768);
+    CORRADE_COMPARE(ConfigurationValue<short>::fromString("-40000", {}), -32768);
+    CORRADE_COMPARE(ConfigurationValue<unsigned long long>::fromString("99999999999999999999", {}), 18446744073709551615ull);
+    CORRADE_COMPARE(ConfigurationValue<unsigned int>::fromString("-1", {}), 4294967295u);
+
+    /* Hexadecimal and octal output is unsigned */
+    CORRADE_COMPARE(ConfigurationValue<short>::toString(-1, ConfigurationValueFlag::Hex), "ffff");
+    CORRADE_COMPARE(ConfigurationValue<long long>::toString(-9223372036854775807ll - 1, {}), "-9223372036854775808");
+    CORRADE_COMPARE(ConfigurationValue<int>::toString(-8, ConfigurationValueFlag::Oct), "37777777770");
+}
+
 void ConfigurationValueTest::floatingPoint() {
     Configuration c;
 
@@ -305,6 +351,58 @@ void ConfigurationValueTest::floatingPointScientific() {
     }
 }
 
+void ConfigurationValueTest::floatingPointRoundtrip() {
+    /* Values that need more than the default six digits get the precision
+       raised so they survive a round trip */
+    {
+        const float a = 1.0f/3.0f;
+        const std::string value = ConfigurationValue<float>::toString(a, {});
+        CORRADE_COMPARE(value, "0.33333334");
+        CORRADE_COMPARE(ConfigurationValue<float>::fromString(value, {}), a);
+    } {
+        const double a = 3.14159265358979323846;
+        const std::string value = ConfigurationValue<double>::toString(a, {});
+        CORRADE_COMPARE(value, "3.141592653589793");
+        CORRADE_COMPARE(ConfigurationValue<double>::fromString(value, {}), a);
+    } {
+        const double a = 1.0/3.0;
+        const std::string value = ConfigurationValue<double>::toString(a, ConfigurationValueFlag::Scientific);
+        CORRADE_COMPARE(value, "3.333333333333333e-01");
+        CORRADE_COMPARE(ConfigurationValue<double>::fromString(value, {}), a);
+    } {
+        const double a = 123456789.0;
+        const std::string value = ConfigurationValue<double>::toString(a, {});
+        CORRADE_COMPARE(value, "123456789");
+        CORRADE_COMPARE(ConfigurationValue<double>::fromString(value, {}), a);
+    }
+
+    /* Correctly rounded parsing, including halfway cases and denormals */
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("9007199254740993", {}), 9007199254740992.0);
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("9007199254740993.0000000000000000001", {}), 9007199254740994.0);
+    CORRADE_COMPARE(ConfigurationValue<float>::fromString("1.000000059604644775390625", {}), 1.0f);
+    CORRADE_COMPARE(ConfigurationValue<float>::fromString("1.000000059604644775390626", {}), 1.00000011920928955078125f);
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("4.9406564584124654e-324", {}), std::numeric_limits<double>::denorm_min());
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("2.4703282292062327e-324", {}), 0.0);
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("1.7976931348623157e308", {}), std::numeric_limits<double>::max());
+}
+
+void ConfigurationValueTest::floatingPointSpecial() {
+    const double inf = std::numeric_limits<double>::infinity();
+    CORRADE_COMPARE(ConfigurationValue<double>::toString(-inf, {}), "-inf");
+    CORRADE_COMPARE(ConfigurationValue<double>::toString(inf, ConfigurationValueFlag::Uppercase), "INF");
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("-inf", {}), -inf);
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("Infinity", {}), inf);
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("1e400", {}), inf);
+
+    const std::string nan = ConfigurationValue<float>::toString(std::numeric_limits<float>::quiet_NaN(), {});
+    CORRADE_COMPARE(nan, "nan");
+    CORRADE_VERIFY(ConfigurationValue<float>::fromString(nan, {}) != ConfigurationValue<float>::fromString(nan, {}));
+
+    CORRADE_COMPARE(ConfigurationValue<double>::toString(-0.0, {}), "-0");
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString("  -1.5e+1xyz", {}), -15.0);
+    CORRADE_COMPARE(ConfigurationValue<double>::fromString(".", {}), 0.0);
+}
+
 void ConfigurationValueTest::unicodeCharLiteral() {
     Configuration c;
 
@@ -364,6 +462,78 @@ void ConfigurationValueTest::custom() {
     CORRADE_COMPARE(values[3].a, 7);
 }
 
+void ConfigurationValueTest::benchmarkIntegerFromString() {
+    const bool stream = testCaseInstanceId() == 1;
+    setTestCaseDescription(BenchmarkData[testCaseInstanceId()]);
+
+    std::vector<std::string> strings;
+    for(std::size_t i = 0; i != BenchmarkValueCount; ++i)
+        strings.push_back(std::to_string(int(i*7919) - 4000000));
+
+    std::vector<int> values(BenchmarkValueCount);
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t i = 0; i != BenchmarkValueCount; ++i) {
+            if(stream) {
+                std::istringstream in{strings[i]};
+                in >> values[i];
+            } else values[i] = ConfigurationValue<int>::fromString(strings[i], {});
+        }
+    }
+
+    for(std::size_t i = 0; i != BenchmarkValueCount; ++i)
+        CORRADE_COMPARE(values[i], int(i*7919) - 4000000);
+}
+
+void ConfigurationValueTest::benchmarkFloatFromString() {
+    const bool stream = testCaseInstanceId() == 1;
+    setTestCaseDescription(BenchmarkData[testCaseInstanceId()]);
+
+    /* Short values with a few decimal places, as in usual tuning tables */
+    std::vector<std::string> strings;
+    for(std::size_t i = 0; i != BenchmarkValueCount; ++i) {
+        std::ostringstream out;
+        out << (float(i) - 5000.0f)*0.25f;
+        strings.push_back(out.str());
+    }
+
+    std::vector<float> values(BenchmarkValueCount);
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t i = 0; i != BenchmarkValueCount; ++i) {
+            if(stream) {
+                std::istringstream in{strings[i]};
+                in >> values[i];
+            } else values[i] = ConfigurationValue<float>::fromString(strings[i], {});
+        }
+    }
+
+    for(std::size_t i = 0; i != BenchmarkValueCount; ++i)
+        CORRADE_COMPARE(values[i], (float(i) - 5000.0f)*0.25f);
+}
+
+void ConfigurationValueTest::benchmarkFloatToString() {
+    const bool stream = testCaseInstanceId() == 1;
+    setTestCaseDescription(BenchmarkData[testCaseInstanceId()]);
+
+    std::vector<std::string> strings(BenchmarkValueCount);
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t i = 0; i != BenchmarkValueCount; ++i) {
+            const float value = (float(i) - 5000.0f)*0.25f;
+            if(stream) {
+                std::ostringstream out;
+                out << value;
+                strings[i] = out.str();
+            } else strings[i] = ConfigurationValue<float>::toString(value, {});
+        }
+    }
+
+    /* The values fit into six digits, so the output is the same */
+    for(std::size_t i = 0; i != BenchmarkValueCount; ++i) {
+        std::ostringstream out;
+        out << (float(i) - 5000.0f)*0.25f;
+        CORRADE_COMPARE(strings[i], out.str());
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::ConfigurationValueTest)
@@ -0,0 +1,276 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/* Compiling out the Verbose level to test that */
+#define CORRADE_LOG_MINIMUM_LEVEL 1
+
+#include "Corrade/TestSuite/Tester.h"
+#include "Corrade/Utility/DebugCategory.h"
+
+namespace Corrade { namespace Utility { namespace Test { namespace {
+
+struct DebugCategoryTest: TestSuite::Tester {
+    explicit DebugCategoryTest();
+
+    void construct();
+    void constructGlobal();
+    void setLevel();
+
+    void log();
+    void logFiltered();
+    void logCompiledOut();
+    void logModifiers();
+    void logDanglingElse();
+
+    void everyN();
+    void everyNFiltered();
+    void everyNMultipleThreads();
+    void everyNZero();
+
+    void benchmarkNullOutput();
+    void benchmarkFiltered();
+};
+
+DebugCategoryTest::DebugCategoryTest() {
+    addTests({&DebugCategoryTest::construct,
+              &DebugCategoryTest::constructGlobal,
+              &DebugCategoryTest::setLevel,
+
+              &DebugCategoryTest::log,
+              &DebugCategoryTest::logFiltered,
+              &DebugCategoryTest::logCompiledOut,
+              &DebugCategoryTest::logModifiers,
+              &DebugCategoryTest::logDanglingElse,
+
+              &DebugCategoryTest::everyN,
+              &DebugCategoryTest::everyNFiltered,
+              &DebugCategoryTest::everyNMultipleThreads,
+              &DebugCategoryTest::everyNZero});
+
+    addBenchmarks({&DebugCategoryTest::benchmarkNullOutput,
+                   &DebugCategoryTest::benchmarkFiltered}, 10);
+}
+
+constexpr const char GlobalName[] = "global";
+DebugCategory globalCategory{GlobalName, DebugCategory::Level::Warning};
+
+void DebugCategoryTest::construct() {
+    DebugCategory a{"a"};
+    CORRADE_COMPARE(a.name(), std::string{"a"});
+    CORRADE_VERIFY(a.level() == DebugCategory::Level::Debug);
+
+    DebugCategory b{"b", DebugCategory::Level::Error};
+    CORRADE_VERIFY(b.level() == DebugCategory::Level::Error);
+}
+
+void DebugCategoryTest::constructGlobal() {
+    const char* name = globalCategory.name();
+    CORRADE_VERIFY(name == GlobalName);
+    CORRADE_VERIFY(globalCategory.level() == DebugCategory::Level::Warning);
+}
+
+void DebugCategoryTest::setLevel() {
+    DebugCategory a{"a"};
+    CORRADE_VERIFY(!a.isEnabled(DebugCategory::Level::Verbose));
+    CORRADE_VERIFY(a.isEnabled(DebugCategory::Level::Debug));
+    CORRADE_VERIFY(a.isEnabled(DebugCategory::Level::Error));
+
+    a.setLevel(DebugCategory::Level::Error);
+    CORRADE_VERIFY(a.level() == DebugCategory::Level::Error);
+    CORRADE_VERIFY(!a.isEnabled(DebugCategory::Level::Warning));
+    CORRADE_VERIFY(a.isEnabled(DebugCategory::Level::Error));
+
+    a.setLevel(DebugCategory::Level::Off);
+    CORRADE_VERIFY(!a.isEnabled(DebugCategory::Level::Error));
+
+    a.setLevel(DebugCategory::Level::Verbose);
+    CORRADE_VERIFY(a.isEnabled(DebugCategory::Level::Verbose));
+}
+
+void DebugCategoryTest::log() {
+    std::ostringstream debug, warning, error;
+    Debug redirectDebug{&debug};
+    Warning redirectWarning{&warning};
+    Error redirectError{&error};
+
+    DebugCategory category{"category"};
+    CORRADE_LOG(category, Debug) << "debug" << 42;
+    CORRADE_LOG(category, Warning) << "warning" << 1.5f;
+    CORRADE_LOG(category, Error) << "error";
+
+    CORRADE_COMPARE(debug.str(), "debug 42\n");
+    CORRADE_COMPARE(warning.str(), "warning 1.5\n");
+    CORRADE_COMPARE(error.str(), "error\n");
+}
+
+int evaluated = 0;
+int sideEffect() {
+    ++evaluated;
+    return 42;
+}
+
+void DebugCategoryTest::logFiltered() {
+    std::ostringstream debug, warning;
+    Debug redirectDebug{&debug};
+    Warning redirectWarning{&warning};
+
+    DebugCategory category{"category", DebugCategory::Level::Warning};
+    evaluated = 0;
+    CORRADE_LOG(category, Debug) << "debug" << sideEffect();
+    CORRADE_LOG(category, Warning) << "warning" << sideEffect();
+    CORRADE_COMPARE(evaluated, 1);
+    CORRADE_COMPARE(debug.str(), "");
+    CORRADE_COMPARE(warning.str(), "warning 42\n");
+
+    category.setLevel(DebugCategory::Level::Off);
+    CORRADE_LOG(category, Warning) << "warning" << sideEffect();
+    CORRADE_COMPARE(evaluated, 1);
+    CORRADE_COMPARE(warning.str(), "warning 42\n");
+}
+
+void DebugCategoryTest::logCompiledOut() {
+    std::ostringstream debug;
+    Debug redirectDebug{&debug};
+
+    /* Enabled at runtime, but compiled out */
+    DebugCategory category{"category", DebugCategory::Level::Verbose};
+    evaluated = 0;
+    CORRADE_LOG(category, Verbose) << "verbose" << sideEffect();
+    CORRADE_LOG_EVERY_N(category, Verbose, 1) << "verbose" << sideEffect();
+    CORRADE_COMPARE(evaluated, 0);
+    CORRADE_COMPARE(debug.str(), "");
+}
+
+void DebugCategoryTest::logModifiers() {
+    std::ostringstream debug;
+    Debug redirectDebug{&debug};
+
+    DebugCategory category{"category"};
+    CORRADE_LOG(category, Debug) << "a" << Debug::nospace << "b" << Debug::newline << "c";
+
+    CORRADE_COMPARE(debug.str(), "ab\nc\n");
+}
+
+void DebugCategoryTest::logDanglingElse() {
+    std::ostringstream debug;
+    Debug redirectDebug{&debug};
+
+    DebugCategory category{"category"};
+    bool elseTaken = false;
+    if(false)
+        CORRADE_LOG(category, Debug) << "not printed";
+    else elseTaken = true;
+
+    CORRADE_VERIFY(elseTaken);
+    CORRADE_COMPARE(debug.str(), "");
+}
+
+void DebugCategoryTest::everyN() {
+    std::ostringstream debug;
+    Debug redirectDebug{&debug};
+
+    DebugCategory category{"category"};
+    evaluated = 0;
+    for(int i = 0; i != 10; ++i)
+        CORRADE_LOG_EVERY_N(category, Debug, 3) << i << Debug::nospace << sideEffect();
+
+    CORRADE_COMPARE(evaluated, 4);
+    CORRADE_COMPARE(debug.str(), "042\n342\n642\n942\n");
+}
+
+void DebugCategoryTest::everyNFiltered() {
+    std::ostringstream debug;
+    Debug redirectDebug{&debug};
+
+    DebugCategory category{"category"};
+    for(int i = 0; i != 10; ++i) {
+        /* Executions filtered by the category level are not counted */
+        category.setLevel(i < 5 ? DebugCategory::Level::Error : DebugCategory::Level::Debug);
+        CORRADE_LOG_EVERY_N(category, Debug, 2) << i;
+    }
+
+    CORRADE_COMPARE(debug.str(), "5\n7\n9\n");
+}
+
+std::atomic<std::size_t> evaluatedAtomic{0};
+int sideEffectAtomic() {
+    ++evaluatedAtomic;
+    return 42;
+}
+
+void DebugCategoryTest::everyNMultipleThreads() {
+    Debug redirectDebug{nullptr};
+
+    constexpr std::size_t ThreadCount = 4;
+    constexpr std::size_t Count = 1000;
+    DebugCategory category{"category"};
+    evaluatedAtomic = 0;
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i != ThreadCount; ++i) threads.emplace_back([&category]{
+        for(std::size_t j = 0; j != Count; ++j)
+            CORRADE_LOG_EVERY_N(category, Debug, 10) << sideEffectAtomic();
+    });
+    for(std::thread& thread: threads) thread.join();
+
+    CORRADE_COMPARE(evaluatedAtomic, ThreadCount*Count/10);
+}
+
+void DebugCategoryTest::everyNZero() {
+    std::ostringstream debug, out;
+    Debug redirectDebug{&debug};
+    Error redirectError{&out};
+
+    DebugCategory category{"category"};
+    CORRADE_LOG_EVERY_N(category, Debug, 0) << "not printed";
+    CORRADE_COMPARE(debug.str(), "");
+    CORRADE_COMPARE(out.str(), "CORRADE_LOG_EVERY_N(): sampling period has to be positive\n");
+}
+
+void DebugCategoryTest::benchmarkNullOutput() {
+    Debug redirectOutput{nullptr};
+
+    float value = 3.5f;
+    CORRADE_BENCHMARK(1000)
+        Debug{} << "hello" << 42 << "world" << std::string{"string"} << value;
+}
+
+void DebugCategoryTest::benchmarkFiltered() {
+    Debug redirectOutput{nullptr};
+
+    DebugCategory category{"category", DebugCategory::Level::Error};
+    float value = 3.5f;
+    CORRADE_BENCHMARK(1000)
+        CORRADE_LOG(category, Debug) << "hello" << 42 << "world" << std::string{"string"} << value;
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Corrade::Utility::Test::DebugCategoryTest)
@@ -0,0 +1,297 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Corrade/TestSuite/Tester.h"
+#include "Corrade/Utility/DebugSink.h"
+#include "Corrade/Utility/Debug.h"
+#include "Corrade/Utility/String.h"
+
+namespace Corrade { namespace Utility { namespace Test { namespace {
+
+struct DebugSinkTest: TestSuite::Tester {
+    explicit DebugSinkTest();
+
+    void construct();
+    void capacity();
+
+    void debug();
+    void warningError();
+    void noNewlineAtTheEnd();
+    void nested();
+    void longLine();
+    void directWrite();
+    void flushOnDestruction();
+    void isTty();
+
+    void multipleThreads();
+
+    void benchmarkDirect();
+    void benchmarkSink();
+};
+
+DebugSinkTest::DebugSinkTest() {
+    addTests({&DebugSinkTest::construct,
+              &DebugSinkTest::capacity,
+
+              &DebugSinkTest::debug,
+              &DebugSinkTest::warningError,
+              &DebugSinkTest::noNewlineAtTheEnd,
+              &DebugSinkTest::nested,
+              &DebugSinkTest::longLine,
+              &DebugSinkTest::directWrite,
+              &DebugSinkTest::flushOnDestruction,
+              &DebugSinkTest::isTty,
+
+              &DebugSinkTest::multipleThreads});
+
+    addBenchmarks({&DebugSinkTest::benchmarkDirect,
+                   &DebugSinkTest::benchmarkSink}, 10);
+}
+
+void DebugSinkTest::construct() {
+    std::ostringstream out;
+    DebugSink sink{out};
+
+    CORRADE_VERIFY(&sink.destination() == &out);
+    CORRADE_VERIFY(sink.output());
+    CORRADE_VERIFY(sink.output() != &out);
+    CORRADE_COMPARE(sink.capacity(), 256*1024);
+}
+
+void DebugSinkTest::capacity() {
+    std::ostringstream out;
+
+    {
+        DebugSink sink{out, 0};
+        CORRADE_COMPARE(sink.capacity(), 1024);
+    } {
+        DebugSink sink{out, 1025};
+        CORRADE_COMPARE(sink.capacity(), 2048);
+    } {
+        DebugSink sink{out, 4096};
+        CORRADE_COMPARE(sink.capacity(), 4096);
+    }
+}
+
+void DebugSinkTest::debug() {
+    std::ostringstream out;
+    DebugSink sink{out};
+
+    {
+        Debug redirectOutput{sink.output()};
+        CORRADE_VERIFY(Debug::output() == sink.output());
+
+        Debug{} << "hello" << 42 << 3.5f;
+        Debug{} << "world";
+    }
+
+    /* Not written through the sink anymore */
+    std::ostringstream other;
+    Debug{&other} << "direct";
+    CORRADE_COMPARE(other.str(), "direct\n");
+
+    sink.flush();
+    CORRADE_COMPARE(out.str(), "hello 42 3.5\nworld\n");
+}
+
+void DebugSinkTest::warningError() {
+    std::ostringstream out;
+    DebugSink sink{out};
+
+    {
+        Debug redirectDebug{sink.output()};
+        Warning redirectWarning{sink.output()};
+        Error redirectError{sink.output()};
+
+        Debug{} << "debug";
+        Warning{} << "warning";
+        Error{} << "error";
+    }
+
+    sink.flush();
+    CORRADE_COMPARE(out.str(), "debug\nwarning\nerror\n");
+}
+
+void DebugSinkTest::noNewlineAtTheEnd() {
+    std::ostringstream out;
+    DebugSink sink{out};
+
+    {
+        Debug redirectOutput{sink.output()};
+
+        Debug{Debug::Flag::NoNewlineAtTheEnd} << "hello";
+        Debug{} << "" << "world";
+    }
+
+    sink.flush();
+    CORRADE_COMPARE(out.str(), "hello world\n");
+}
+
+void DebugSinkTest::nested() {
+    std::ostringstream out;
+    DebugSink sink{out};
+
+    {
+        Debug redirectOutput{sink.output()};
+
+        /* An inner instance created while the outer one is still alive
+           publishes the line buffer contents written so far, the same as it
+           would be interleaved with direct output */
+        Debug outer;
+        outer << "outer";
+        Debug{} << "inner";
+        outer << "end";
+    }
+
+    sink.flush();
+    CORRADE_COMPARE(out.str(), "outerinner\n end\n");
+}
+
+void DebugSinkTest::longLine() {
+    std::ostringstream out;
+
+    /* Bigger than the internal line buffer and much bigger than half of the
+       ring, so it gets split */
+    const std::string line(5000, 'a');
+    {
+        DebugSink sink{out, 1024};
+        Debug redirectOutput{sink.output()};
+
+        Debug{} << "hello";
+        Debug{} << line;
+        Debug{} << "world";
+    }
+
+    CORRADE_COMPARE(out.str(), "hello\n" + line + "\nworld\n");
+}
+
+void DebugSinkTest::directWrite() {
+    std::ostringstream out;
+    DebugSink sink{out};
+
+    *sink.output() << "hello " << 42 << std::endl;
+    sink.flush();
+    CORRADE_COMPARE(out.str(), "hello 42\n");
+
+    /* Gets published also on explicit flush() */
+    *sink.output() << "world";
+    sink.flush();
+    CORRADE_COMPARE(out.str(), "hello 42\nworld");
+}
+
+void DebugSinkTest::flushOnDestruction() {
+    std::ostringstream out;
+
+    {
+        DebugSink sink{out};
+        Debug redirectOutput{sink.output()};
+
+        Debug{} << "hello";
+        *sink.output() << "world";
+    }
+
+    CORRADE_COMPARE(out.str(), "hello\nworld");
+}
+
+void DebugSinkTest::isTty() {
+    {
+        DebugSink sink{std::cout};
+        CORRADE_COMPARE(Debug::isTty(sink.output()), Debug::isTty(&std::cout));
+    } {
+        std::ostringstream out;
+        DebugSink sink{out};
+        CORRADE_VERIFY(!Debug::isTty(sink.output()));
+    }
+}
+
+void DebugSinkTest::multipleThreads() {
+    std::ostringstream out;
+
+    /* Using the smallest possible capacity to test waiting on a full ring */
+    constexpr std::size_t ThreadCount = 8;
+    constexpr std::size_t LineCount = 2000;
+    {
+        DebugSink sink{out, 1024};
+        Debug redirectOutput{sink.output()};
+
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i != ThreadCount; ++i) threads.emplace_back([i]{
+            for(std::size_t j = 0; j != LineCount; ++j)
+                Debug{} << "thread" << i << "line" << j << "of" << LineCount;
+        });
+        for(std::thread& thread: threads) thread.join();
+    }
+
+    /* All lines should be complete and in order for given thread */
+    std::vector<std::string> lines = String::splitWithoutEmptyParts(out.str(), '\n');
+    CORRADE_COMPARE(lines.size(), ThreadCount*LineCount);
+    std::size_t next[ThreadCount]{};
+    for(const std::string& line: lines) {
+        std::istringstream in{line};
+        std::string thread, lineWord, of;
+        std::size_t i = ThreadCount, j = LineCount, count = 0;
+        in >> thread >> i >> lineWord >> j >> of >> count;
+        CORRADE_COMPARE(thread, "thread");
+        CORRADE_VERIFY(i < ThreadCount);
+        CORRADE_COMPARE(lineWord, "line");
+        CORRADE_COMPARE(j, next[i]);
+        CORRADE_COMPARE(of, "of");
+        CORRADE_COMPARE(count, LineCount);
+        CORRADE_VERIFY(in.eof());
+        ++next[i];
+    }
+}
+
+void DebugSinkTest::benchmarkDirect() {
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+
+    CORRADE_BENCHMARK(1000)
+        Debug{} << "hello" << 42 << "world" << 3.5f;
+
+    CORRADE_COMPARE(out.str().size(), 1000*19);
+}
+
+void DebugSinkTest::benchmarkSink() {
+    std::ostringstream out;
+    {
+        DebugSink sink{out};
+        Debug redirectOutput{sink.output()};
+
+        CORRADE_BENCHMARK(1000)
+            Debug{} << "hello" << 42 << "world" << 3.5f;
+    }
+
+    CORRADE_COMPARE(out.str().size(), 1000*19);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Corrade::Utility::Test::DebugSinkTest)
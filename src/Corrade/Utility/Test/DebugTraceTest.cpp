@@ -0,0 +1,362 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/TestSuite/Tester.h"
+#include "Corrade/Utility/DebugTrace.h"
+#include "Corrade/Utility/Debug.h"
+#include "Corrade/Utility/String.h"
+
+namespace Corrade { namespace Utility { namespace Test { namespace {
+
+struct DebugTraceTest: TestSuite::Tester {
+    explicit DebugTraceTest();
+
+    void construct();
+
+    void values();
+    void colors();
+    void whitespace();
+    void noNewlineAtTheEnd();
+    void warningError();
+    void compact();
+    void directWrite();
+    void scoped();
+
+    void multipleThreads();
+
+    void decodeInvalidHeader();
+    void decodeTruncated();
+    void decodeUnknownEntry();
+
+    void benchmarkText();
+    void benchmarkTrace();
+};
+
+DebugTraceTest::DebugTraceTest() {
+    addTests({&DebugTraceTest::construct,
+
+              &DebugTraceTest::values,
+              &DebugTraceTest::colors,
+              &DebugTraceTest::whitespace,
+              &DebugTraceTest::noNewlineAtTheEnd,
+              &DebugTraceTest::warningError,
+              &DebugTraceTest::compact,
+              &DebugTraceTest::directWrite,
+              &DebugTraceTest::scoped,
+
+              &DebugTraceTest::multipleThreads,
+
+              &DebugTraceTest::decodeInvalidHeader,
+              &DebugTraceTest::decodeTruncated,
+              &DebugTraceTest::decodeUnknownEntry});
+
+    addBenchmarks({&DebugTraceTest::benchmarkText,
+                   &DebugTraceTest::benchmarkTrace}, 10);
+}
+
+std::string decode(const std::string& trace) {
+    std::ostringstream out;
+    if(!DebugTrace::decode({trace.data(), trace.size()}, out))
+        return "<invalid>";
+    return out.str();
+}
+
+/* Returns the output of given function written directly to a stream and the
+   same output recorded to a trace and decoded */
+std::pair<std::string, std::string> directAndDecoded(void(*f)()) {
+    std::ostringstream direct;
+    {
+        Debug redirectOutput{&direct};
+        f();
+    }
+
+    std::ostringstream trace;
+    {
+        DebugTrace debugTrace{trace};
+        Debug redirectOutput{debugTrace.output()};
+        f();
+    }
+
+    return {direct.str(), decode(trace.str())};
+}
+
+struct Foo {
+    int value;
+};
+
+std::ostream& operator<<(std::ostream& o, const Foo& foo) {
+    return o << "Foo(" << foo.value << ")";
+}
+
+void DebugTraceTest::construct() {
+    std::ostringstream out;
+    {
+        DebugTrace trace{out};
+        CORRADE_VERIFY(&trace.destination() == &out);
+        CORRADE_VERIFY(trace.output());
+        CORRADE_VERIFY(trace.output() != &out);
+        CORRADE_VERIFY(!Debug::isTty(trace.output()));
+    }
+
+    /* Just the header */
+    CORRADE_COMPARE(out.str().size(), 8);
+    CORRADE_COMPARE(decode(out.str()), "");
+}
+
+void DebugTraceTest::values() {
+    auto out = directAndDecoded([]{
+        Debug{} << "string" << std::string{"std::string"} << std::string{};
+        Debug{} << 0 << -1 << 42 << -2147483647 - 1 << 4294967295u;
+        Debug{} << -9223372036854775807ll - 1 << 18446744073709551615ull << 123456789l << 123456789ul;
+        Debug{} << static_cast<unsigned char>(224) << static_cast<short>(-32768);
+        Debug{} << 3.1415926535f << -1.0e-20f << 1.0e30f << 0.0f;
+        Debug{} << 3.141592653589793 << -1.0e-300 << 12345678.9;
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        Debug{} << 3.14159265358979323846l;
+        #endif
+        Debug{} << true << false << nullptr;
+        Debug{} << reinterpret_cast<const void*>(0xdeadbeef) << static_cast<const void*>(nullptr);
+        Debug{} << U'\xfe' << 'a';
+        Debug{} << std::vector<int>{1, 2, 3} << std::make_tuple(1.5f, "a", 3u);
+        Debug{} << Foo{3} << Debug::Color::Cyan;
+    });
+
+    CORRADE_COMPARE(out.second, out.first);
+    /* Verify the direct output isn't empty by accident */
+    CORRADE_VERIFY(out.first.find("std::string") != std::string::npos);
+}
+
+void DebugTraceTest::colors() {
+    auto out = directAndDecoded([]{
+        Debug{} << Debug::color(Debug::Color::Red) << "red" << Debug::boldColor(Debug::Color::Blue) << "bold blue";
+        Debug{} << Debug::boldColor(Debug::Color::Green) << "green" << Debug::resetColor << "default";
+        Debug{Debug::Flag::DisableColors} << Debug::color(Debug::Color::Yellow) << "no color";
+
+        Debug d;
+        d << Debug::color(Debug::Color::Cyan) << "cyan";
+        Debug{} << "scoped" << Debug::color(Debug::Color::Magenta) << "magenta";
+    });
+
+    #if defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_UTILITY_USE_ANSI_COLORS)
+    /* The trace records ANSI colors, the direct output uses WINAPI */
+    CORRADE_COMPARE(out.second.find("\033[0;31mred"), 0);
+    #else
+    CORRADE_COMPARE(out.second, out.first);
+    CORRADE_VERIFY(out.first.find("\033[1;34m") != std::string::npos);
+    #endif
+}
+
+void DebugTraceTest::whitespace() {
+    auto out = directAndDecoded([]{
+        Debug{} << "a" << Debug::nospace << 1 << Debug::nospace << 2.5f << Debug::nospace << "b";
+        Debug{} << "Value:" << Debug::newline << 16 << Debug::newline << Debug::nospace << "x";
+        Debug{} << Debug::nospace << 3 << "" << "";
+        Debug{};
+    });
+
+    CORRADE_COMPARE(out.second, out.first);
+    CORRADE_COMPARE(out.first, "a12.5b\nValue:\n16\nx\n3  \n");
+}
+
+void DebugTraceTest::noNewlineAtTheEnd() {
+    auto out = directAndDecoded([]{
+        Debug{Debug::Flag::NoNewlineAtTheEnd} << "hello";
+        Debug{} << "world";
+    });
+
+    CORRADE_COMPARE(out.second, out.first);
+    CORRADE_COMPARE(out.first, "helloworld\n");
+}
+
+void DebugTraceTest::warningError() {
+    std::ostringstream out;
+    {
+        DebugTrace trace{out};
+        Debug redirectDebug{trace.output()};
+        Warning redirectWarning{trace.output()};
+        Error redirectError{trace.output()};
+
+        Debug{} << "debug";
+        Warning{} << "warning";
+        Error{} << "error";
+    }
+
+    CORRADE_COMPARE(decode(out.str()), "debug\nwarning\nerror\n");
+}
+
+void DebugTraceTest::compact() {
+    std::ostringstream out;
+    {
+        DebugTrace trace{out};
+        Debug redirectOutput{trace.output()};
+        Debug{} << 1 << -1 << 1.5f;
+    }
+
+    /* 8 bytes header, 2 bytes for each integer, 5 bytes for the float and 3
+       bytes for the newline */
+    CORRADE_COMPARE(out.str().size(), 8 + 2 + 2 + 5 + 3);
+    CORRADE_COMPARE(decode(out.str()), "1 -1 1.5\n");
+}
+
+void DebugTraceTest::directWrite() {
+    std::ostringstream out;
+    DebugTrace trace{out};
+
+    *trace.output() << "hello " << 42 << std::endl;
+    CORRADE_COMPARE(decode(out.str()), "hello 42\n");
+
+    /* Gets recorded also on explicit flush() */
+    *trace.output() << "world";
+    trace.flush();
+    CORRADE_COMPARE(decode(out.str()), "hello 42\nworld");
+}
+
+void DebugTraceTest::scoped() {
+    std::ostringstream out, other;
+    {
+        DebugTrace trace{out};
+        {
+            Debug redirectOutput{trace.output()};
+            CORRADE_VERIFY(Debug::output() == trace.output());
+            Debug{} << "traced";
+
+            /* Not recorded */
+            Debug{&other} << "direct" << 1.5f;
+        }
+
+        /* Not recorded anymore */
+        Debug{&other} << "direct";
+    }
+
+    CORRADE_COMPARE(decode(out.str()), "traced\n");
+    CORRADE_COMPARE(other.str(), "direct 1.5\ndirect\n");
+}
+
+void DebugTraceTest::multipleThreads() {
+    std::ostringstream out;
+
+    constexpr std::size_t ThreadCount = 8;
+    constexpr std::size_t LineCount = 1000;
+    {
+        DebugTrace trace{out};
+        Debug redirectOutput{trace.output()};
+
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i != ThreadCount; ++i) threads.emplace_back([i]{
+            for(std::size_t j = 0; j != LineCount; ++j)
+                Debug{} << "thread" << i << "line" << j << "of" << LineCount;
+        });
+        for(std::thread& thread: threads) thread.join();
+    }
+
+    /* All lines should be complete and in order for given thread */
+    std::vector<std::string> lines = String::splitWithoutEmptyParts(decode(out.str()), '\n');
+    CORRADE_COMPARE(lines.size(), ThreadCount*LineCount);
+    std::size_t next[ThreadCount]{};
+    for(const std::string& line: lines) {
+        std::istringstream in{line};
+        std::string thread, lineWord, of;
+        std::size_t i = ThreadCount, j = LineCount, count = 0;
+        in >> thread >> i >> lineWord >> j >> of >> count;
+        CORRADE_COMPARE(thread, "thread");
+        CORRADE_VERIFY(i < ThreadCount);
+        CORRADE_COMPARE(lineWord, "line");
+        CORRADE_COMPARE(j, next[i]);
+        CORRADE_COMPARE(of, "of");
+        CORRADE_COMPARE(count, LineCount);
+        CORRADE_VERIFY(in.eof());
+        ++next[i];
+    }
+}
+
+void DebugTraceTest::decodeInvalidHeader() {
+    std::ostringstream out;
+    std::ostringstream error;
+    Error redirectError{&error};
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE", 7}, out));
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE\x02", 8}, out));
+    CORRADE_COMPARE(error.str(),
+        "Utility::DebugTrace::decode(): invalid header\n"
+        "Utility::DebugTrace::decode(): invalid header\n");
+}
+
+void DebugTraceTest::decodeTruncated() {
+    std::ostringstream out;
+    std::ostringstream error;
+    Error redirectError{&error};
+    /* Text of size 3 with just two bytes, a float with three bytes, an
+       unterminated integer and a color without the value */
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE\x01\x00\x03He", 12}, out));
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE\x01\x01\x01H\x04\x00\x00\x00", 14}, out));
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE\x01\x02\xff", 10}, out));
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE\x01\x07", 9}, out));
+    CORRADE_COMPARE(error.str(),
+        "Utility::DebugTrace::decode(): entry at offset 8 is truncated\n"
+        "Utility::DebugTrace::decode(): entry at offset 11 is truncated\n"
+        "Utility::DebugTrace::decode(): entry at offset 8 is truncated\n"
+        "Utility::DebugTrace::decode(): entry at offset 8 is truncated\n");
+}
+
+void DebugTraceTest::decodeUnknownEntry() {
+    std::ostringstream out;
+    std::ostringstream error;
+    Error redirectError{&error};
+    CORRADE_VERIFY(!DebugTrace::decode({"CRTRACE\x01\x01\x01H\x8f", 12}, out));
+    CORRADE_COMPARE(error.str(), "Utility::DebugTrace::decode(): unknown entry 15 at offset 11\n");
+}
+
+void DebugTraceTest::benchmarkText() {
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+
+    CORRADE_BENCHMARK(1000)
+        Debug{} << "hello" << 42 << "world" << 3.5f << 1.0e-5;
+
+    CORRADE_COMPARE(out.str().size(), 1000*25);
+}
+
+void DebugTraceTest::benchmarkTrace() {
+    std::ostringstream out;
+    {
+        DebugTrace trace{out};
+        Debug redirectOutput{trace.output()};
+
+        CORRADE_BENCHMARK(1000)
+            Debug{} << "hello" << 42 << "world" << 3.5f << 1.0e-5;
+    }
+
+    CORRADE_COMPARE(decode(out.str()).size(), 1000*25);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Corrade::Utility::Test::DebugTraceTest)
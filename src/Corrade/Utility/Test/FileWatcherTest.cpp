@@ -23,9 +23,15 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <chrono>
 #include <sstream>
+#include <thread>
+#include <vector>
 
+#include "Corrade/Containers/Array.h"
 #include "Corrade/TestSuite/Tester.h"
+#include "Corrade/TestSuite/Compare/Container.h"
+#include "Corrade/TestSuite/Compare/Numeric.h"
 #include "Corrade/Utility/Directory.h"
 #include "Corrade/Utility/FileWatcher.h"
 #include "Corrade/Utility/System.h"
@@ -48,11 +54,149 @@ struct FileWatcherTest: TestSuite::Tester {
     void changedDeleted();
     void changedRecreatedImmediately();
     void changedRecreatedLate();
+    void wait();
+    void waitInvalid();
+
+    void set();
+    void setAddTwice();
+    void setRead();
+    void setWrite();
+    void setWriteMultiple();
+    void setReplaced();
+    void setDeletedRecreated();
+    void setNonexistentDirectory();
+    void setMove();
+    void setWaitTimeout();
+    void setWaitPending();
+    void setWait();
+    void setWaitAny();
+    void setWaitDebounce();
+
+    void setupTree();
+    void teardownTree();
+
+    void directory();
+    void directoryNotDirectory();
+    void directoryModified();
+    void directoryCreatedDeleted();
+    void directorySubdirectoryCreated();
+    void directorySubdirectoryDeleted();
+    void directorySubdirectoryMoved();
+    void directoryCompareContents();
+    void directoryWait();
+    void directoryMove();
+
+    void benchmarkNoChange();
+    void benchmarkWaitLatency();
+    void benchmarkDirectoryNoChange();
+    void benchmarkDirectoryScan();
+
+    void latencyBegin();
+    std::uint64_t latencyEnd();
 
     private:
-        std::string _filename;
+        std::string _filename, _tree;
+        std::chrono::steady_clock::time_point _written;
+        std::uint64_t _latency;
 };
 
+namespace {
+    constexpr struct {
+        const char* name;
+        FileWatcherSet::Flags flags;
+    } SetData[]{
+        {"", {}},
+        {"polling", FileWatcherSet::Flag::Polling}
+    };
+
+    enum: std::size_t { BenchmarkFileCount = 500 };
+
+    constexpr struct {
+        const char* name;
+        DirectoryWatcher::Flags flags;
+    } DirectoryData[]{
+        {"", {}},
+        {"polling", DirectoryWatcher::Flag::Polling},
+        {"compare contents", DirectoryWatcher::Flag::CompareContents},
+        {"polling, compare contents", DirectoryWatcher::Flag::Polling|DirectoryWatcher::Flag::CompareContents}
+    };
+
+    /* Directories and files in each of them for the directory benchmarks. The
+       tree gets recreated for every repeat, keep it small enough to not make
+       the test run for too long. */
+    enum: std::size_t {
+        BenchmarkDirectoryCount = 20,
+        BenchmarkDirectoryFileCount = 50
+    };
+
+    constexpr struct {
+        const char* name;
+        DirectoryWatcher::Flags flags;
+    } BenchmarkDirectoryData[]{
+        {"", {}},
+        {"polling", DirectoryWatcher::Flag::Polling},
+        {"compare contents", DirectoryWatcher::Flag::CompareContents}
+    };
+
+    constexpr const char* BenchmarkNoChangeData[]{
+        "FileWatcher",
+        "FileWatcherSet",
+        "FileWatcherSet, polling"
+    };
+
+    /* So we don't write at the same nanosecond when polling, see
+       FileWatcherTest::changedRead() for details. System notifications don't
+       have this problem. */
+    void sleepIfPolling(FileWatcherSet::Flags flags) {
+        if(!(flags & FileWatcherSet::Flag::Polling)) return;
+        #if defined(CORRADE_TARGET_APPLE) || defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_EMSCRIPTEN)
+        System::sleep(1100);
+        #else
+        System::sleep(10);
+        #endif
+    }
+
+    void sleepIfPolling(DirectoryWatcher::Flags flags) {
+        sleepIfPolling(flags & DirectoryWatcher::Flag::Polling ? FileWatcherSet::Flag::Polling : FileWatcherSet::Flags{});
+    }
+
+    /* Directory::rm() can delete only empty directories */
+    void removeRecursive(const std::string& path) {
+        if(!Directory::exists(path)) return;
+        for(const std::string& name: Directory::list(path, Directory::Flag::SkipDotAndDotDot|Directory::Flag::SkipFiles))
+            removeRecursive(Directory::join(path, name));
+        for(const std::string& name: Directory::list(path, Directory::Flag::SkipDotAndDotDot|Directory::Flag::SkipDirectories))
+            Directory::rm(Directory::join(path, name));
+        Directory::rm(path);
+    }
+
+    /* Changes in a compact form for easier comparison, + for created, ~ for
+       modified, - for deleted */
+    std::string formatChanges(Containers::ArrayView<const std::pair<std::string, DirectoryWatcher::Change>> changes) {
+        std::string out;
+        for(const std::pair<std::string, DirectoryWatcher::Change>& change: changes) {
+            if(!out.empty()) out += ' ';
+            switch(change.second) {
+                case DirectoryWatcher::Change::Created: out += '+'; break;
+                case DirectoryWatcher::Change::Modified: out += '~'; break;
+                case DirectoryWatcher::Change::Deleted: out += '-'; break;
+            }
+            out += change.first;
+        }
+        return out;
+    }
+
+    /* Writes the file from another thread after a delay, optionally
+       remembering when it happened */
+    std::thread writeLater(const std::string& filename, std::size_t delay, std::chrono::steady_clock::time_point* written = nullptr) {
+        return std::thread{[filename, delay, written]() {
+            System::sleep(delay);
+            if(written) *written = std::chrono::steady_clock::now();
+            Directory::writeString(filename, "ahoy");
+        }};
+    }
+}
+
 FileWatcherTest::FileWatcherTest() {
     addTests({&FileWatcherTest::nonexistent});
 
@@ -64,11 +208,62 @@ FileWatcherTest::FileWatcherTest() {
 
     addTests({&FileWatcherTest::changedDeleted,
               &FileWatcherTest::changedRecreatedImmediately,
-              &FileWatcherTest::changedRecreatedLate},
+              &FileWatcherTest::changedRecreatedLate,
+              &FileWatcherTest::wait,
+              &FileWatcherTest::waitInvalid},
              &FileWatcherTest::setup, &FileWatcherTest::teardown);
 
+    addInstancedTests({&FileWatcherTest::set,
+                       &FileWatcherTest::setAddTwice,
+                       &FileWatcherTest::setRead,
+                       &FileWatcherTest::setWrite,
+                       &FileWatcherTest::setWriteMultiple,
+                       &FileWatcherTest::setReplaced,
+                       &FileWatcherTest::setDeletedRecreated,
+                       &FileWatcherTest::setNonexistentDirectory,
+                       &FileWatcherTest::setWaitTimeout,
+                       &FileWatcherTest::setWaitPending,
+                       &FileWatcherTest::setWait,
+                       &FileWatcherTest::setWaitAny,
+                       &FileWatcherTest::setWaitDebounce},
+        Containers::arraySize(SetData),
+        &FileWatcherTest::setup, &FileWatcherTest::teardown);
+
+    addTests({&FileWatcherTest::setMove},
+             &FileWatcherTest::setup, &FileWatcherTest::teardown);
+
+    addInstancedTests({&FileWatcherTest::directory,
+                       &FileWatcherTest::directoryModified,
+                       &FileWatcherTest::directoryCreatedDeleted,
+                       &FileWatcherTest::directorySubdirectoryCreated,
+                       &FileWatcherTest::directorySubdirectoryDeleted,
+                       &FileWatcherTest::directorySubdirectoryMoved,
+                       &FileWatcherTest::directoryCompareContents,
+                       &FileWatcherTest::directoryWait},
+        Containers::arraySize(DirectoryData),
+        &FileWatcherTest::setupTree, &FileWatcherTest::teardownTree);
+
+    addTests({&FileWatcherTest::directoryNotDirectory,
+              &FileWatcherTest::directoryMove},
+             &FileWatcherTest::setupTree, &FileWatcherTest::teardownTree);
+
+    addInstancedBenchmarks({&FileWatcherTest::benchmarkNoChange}, 10,
+        Containers::arraySize(BenchmarkNoChangeData));
+
+    addCustomInstancedBenchmarks({&FileWatcherTest::benchmarkWaitLatency}, 10,
+        Containers::arraySize(SetData),
+        &FileWatcherTest::setup, &FileWatcherTest::teardown,
+        &FileWatcherTest::latencyBegin, &FileWatcherTest::latencyEnd,
+        BenchmarkUnits::Nanoseconds);
+
+    addInstancedBenchmarks({&FileWatcherTest::benchmarkDirectoryNoChange,
+                            &FileWatcherTest::benchmarkDirectoryScan}, 3,
+        Containers::arraySize(BenchmarkDirectoryData),
+        &FileWatcherTest::setupTree, &FileWatcherTest::teardownTree);
+
     Directory::mkpath(FILEWATCHER_WRITE_TEST_DIR);
     _filename = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "file.txt");
+    _tree = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "tree");
 }
 
 void FileWatcherTest::nonexistent() {
@@ -94,6 +289,18 @@ void FileWatcherTest::teardown() {
     Directory::rm(_filename);
 }
 
+void FileWatcherTest::setupTree() {
+    removeRecursive(_tree);
+    Directory::mkpath(Directory::join(_tree, "sub/deep"));
+    Directory::writeString(Directory::join(_tree, "a.txt"), "a");
+    Directory::writeString(Directory::join(_tree, "sub/b.txt"), "b");
+    Directory::writeString(Directory::join(_tree, "sub/deep/c.txt"), "c");
+}
+
+void FileWatcherTest::teardownTree() {
+    removeRecursive(_tree);
+}
+
 void FileWatcherTest::changedRead() {
     CORRADE_VERIFY(Directory::exists(_filename));
 
@@ -221,6 +428,623 @@ void FileWatcherTest::changedRecreatedLate() {
     CORRADE_VERIFY(!watcher.isValid());
 }
 
+void FileWatcherTest::wait() {
+    FileWatcher watcher{_filename};
+    CORRADE_VERIFY(!watcher.wait(20));
+
+    /* See changedRead() for details */
+    #if defined(CORRADE_TARGET_APPLE) || defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    std::thread thread = writeLater(_filename, 1100);
+    #else
+    std::thread thread = writeLater(_filename, 10);
+    #endif
+    CORRADE_VERIFY(watcher.wait(5000));
+    thread.join();
+    CORRADE_VERIFY(watcher.isValid());
+    CORRADE_VERIFY(!watcher.hasChanged());
+}
+
+void FileWatcherTest::waitInvalid() {
+    FileWatcher watcher{_filename};
+    CORRADE_VERIFY(Directory::rm(_filename));
+
+    /* The deletion is not a change, and the file is checked at the end */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!watcher.wait(20));
+    CORRADE_VERIFY(!watcher.isValid());
+    CORRADE_VERIFY(!out.str().empty());
+
+    /* And then it doesn't block anymore */
+    CORRADE_VERIFY(!watcher.wait(1000000));
+}
+
+void FileWatcherTest::set() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    #ifdef __linux__
+    CORRADE_VERIFY(watchers.flags() == data.flags);
+    #else
+    CORRADE_VERIFY(watchers.flags() == FileWatcherSet::Flag::Polling);
+    #endif
+    CORRADE_COMPARE(watchers.size(), 0);
+    CORRADE_VERIFY(watchers.changed().empty());
+
+    const std::string nonexistent = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "nonexistent.txt");
+    Directory::rm(nonexistent);
+    CORRADE_COMPARE(watchers.add(_filename), 0);
+    CORRADE_COMPARE(watchers.add(nonexistent), 1);
+    CORRADE_COMPARE(watchers.size(), 2);
+    CORRADE_COMPARE(watchers.filename(0), _filename);
+    CORRADE_COMPARE(watchers.filename(1), nonexistent);
+    CORRADE_VERIFY(watchers.isValid(0));
+    CORRADE_VERIFY(!watchers.isValid(1));
+    CORRADE_VERIFY(watchers.changed().empty());
+}
+
+void FileWatcherTest::setAddTwice() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    CORRADE_COMPARE(watchers.add(_filename), 0);
+    CORRADE_COMPARE(watchers.add(_filename), 0);
+    CORRADE_COMPARE(watchers.size(), 1);
+
+    /* The change is reported just once */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(_filename, "ahoy"));
+    CORRADE_COMPARE_AS(watchers.changed(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+}
+
+void FileWatcherTest::setRead() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    sleepIfPolling(data.flags);
+    CORRADE_COMPARE(Directory::readString(_filename), "hello");
+    CORRADE_VERIFY(watchers.changed().empty());
+}
+
+void FileWatcherTest::setWrite() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string another = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "another.txt");
+    CORRADE_VERIFY(Directory::writeString(another, "hey"));
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(another);
+    watchers.add(_filename);
+
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(_filename, "ahoy"));
+    CORRADE_COMPARE_AS(watchers.changed(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {1}}),
+        TestSuite::Compare::Container);
+
+    /* Nothing changed second time */
+    CORRADE_VERIFY(watchers.changed().empty());
+
+    CORRADE_VERIFY(Directory::rm(another));
+}
+
+void FileWatcherTest::setWriteMultiple() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Files in a subdirectory, which is watched separately */
+    const std::string subdirectory = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "subdir");
+    CORRADE_VERIFY(Directory::mkpath(subdirectory));
+    std::vector<std::string> files;
+    for(const char* name: {"a.txt", "b.txt", "c.txt"}) {
+        files.push_back(Directory::join(subdirectory, name));
+        CORRADE_VERIFY(Directory::writeString(files.back(), name));
+    }
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(files[0]);
+    watchers.add(_filename);
+    watchers.add(files[1]);
+    watchers.add(files[2]);
+
+    /* All changes are reported at once, sorted */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(files[2], "C"));
+    CORRADE_VERIFY(Directory::writeString(_filename, "ahoy"));
+    CORRADE_VERIFY(Directory::writeString(files[0], "A"));
+    CORRADE_VERIFY(Directory::writeString(files[2], "CC"));
+    CORRADE_COMPARE_AS(watchers.changed(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0, 1, 3}}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(watchers.changed().empty());
+
+    for(const std::string& file: files) CORRADE_VERIFY(Directory::rm(file));
+}
+
+void FileWatcherTest::setReplaced() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    /* Editors usually save into a temporary file and then rename it over
+       the original */
+    const std::string temporary = _filename + ".tmp";
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(temporary, "ahoy"));
+    CORRADE_VERIFY(Directory::move(temporary, _filename));
+    CORRADE_COMPARE_AS(watchers.changed(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(watchers.isValid(0));
+}
+
+void FileWatcherTest::setDeletedRecreated() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    /* Deletion is not a change */
+    CORRADE_VERIFY(Directory::rm(_filename));
+    CORRADE_VERIFY(watchers.changed().empty());
+    CORRADE_VERIFY(!watchers.isValid(0));
+
+    /* But recreation is, unlike with FileWatcher */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(_filename, "hello again"));
+    CORRADE_COMPARE_AS(watchers.changed(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(watchers.isValid(0));
+}
+
+void FileWatcherTest::setNonexistentDirectory() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string filename = Directory::join(Directory::join(FILEWATCHER_WRITE_TEST_DIR, "nonexistent"), "file.txt");
+
+    FileWatcherSet watchers{data.flags};
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_COMPARE(watchers.add(filename), 0);
+    }
+    CORRADE_VERIFY(!watchers.isValid(0));
+    CORRADE_VERIFY(watchers.changed().empty());
+
+    if(watchers.flags() & FileWatcherSet::Flag::Polling)
+        CORRADE_COMPARE(out.str(), "");
+    else CORRADE_COMPARE(out.str(), "Utility::FileWatcherSet::add(): can't watch " + Directory::path(filename) + ": No such file or directory\n");
+}
+
+void FileWatcherTest::setMove() {
+    FileWatcherSet a;
+    a.add(_filename);
+
+    FileWatcherSet b{std::move(a)};
+    CORRADE_COMPARE(b.size(), 1);
+
+    FileWatcherSet c{FileWatcherSet::Flag::Polling};
+    c = std::move(b);
+    CORRADE_COMPARE(c.size(), 1);
+
+    sleepIfPolling(c.flags());
+    CORRADE_VERIFY(Directory::writeString(_filename, "ahoy"));
+    CORRADE_COMPARE_AS(c.changed(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+}
+
+void FileWatcherTest::setWaitTimeout() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CORRADE_VERIFY(watchers.wait(50).empty());
+    CORRADE_COMPARE_AS(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), 49,
+        TestSuite::Compare::GreaterOrEqual);
+
+    /* Zero timeout is just like changed() */
+    CORRADE_VERIFY(watchers.wait(0).empty());
+}
+
+void FileWatcherTest::setWaitPending() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    /* A change that happened before the call is returned right away */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(_filename, "ahoy"));
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CORRADE_COMPARE_AS(watchers.wait(100000),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), 1000,
+        TestSuite::Compare::Less);
+}
+
+void FileWatcherTest::setWait() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string another = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "another.txt");
+    CORRADE_VERIFY(Directory::writeString(another, "hey"));
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(another);
+    watchers.add(_filename);
+
+    #if defined(CORRADE_TARGET_APPLE) || defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    std::thread thread = writeLater(_filename, 1100);
+    #else
+    std::thread thread = writeLater(_filename, 20);
+    #endif
+    CORRADE_COMPARE_AS(watchers.wait(5000),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {1}}),
+        TestSuite::Compare::Container);
+    thread.join();
+
+    CORRADE_VERIFY(Directory::rm(another));
+}
+
+void FileWatcherTest::setWaitAny() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    #if defined(CORRADE_TARGET_APPLE) || defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    std::thread thread = writeLater(_filename, 1100);
+    #else
+    std::thread thread = writeLater(_filename, 20);
+    #endif
+    CORRADE_COMPARE_AS(watchers.waitAny(),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+    thread.join();
+}
+
+void FileWatcherTest::setWaitDebounce() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.setDebounceTime(200);
+    CORRADE_COMPARE(watchers.debounceTime(), 200);
+    watchers.add(_filename);
+
+    /* Simulate an editor that first truncates the file, then writes
+       it in two steps. The writes are far enough apart so the modification
+       time changes each time even on Linux with polling, but within the
+       debounce time. */
+    std::thread thread{[&]() {
+        System::sleep(20);
+        Directory::writeString(_filename, "");
+        System::sleep(30);
+        Directory::writeString(_filename, "ah");
+        System::sleep(30);
+        Directory::writeString(_filename, "ahoy");
+    }};
+
+    /* Everything is reported in a single call, when the file is complete */
+    CORRADE_COMPARE_AS(watchers.wait(5000),
+        (Containers::Array<std::size_t>{Containers::InPlaceInit, {0}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(Directory::readString(_filename), "ahoy");
+    thread.join();
+    CORRADE_VERIFY(watchers.changed().empty());
+}
+
+void FileWatcherTest::directory() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+    CORRADE_VERIFY(watcher.isValid());
+    CORRADE_COMPARE(watcher.path(), _tree);
+    CORRADE_COMPARE(watcher.fileCount(), 3);
+    #ifdef __linux__
+    CORRADE_VERIFY(watcher.flags() == data.flags);
+    #else
+    CORRADE_VERIFY(watcher.flags() == (data.flags|DirectoryWatcher::Flag::Polling));
+    #endif
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "");
+
+    /* Reading doesn't change anything */
+    sleepIfPolling(data.flags);
+    CORRADE_COMPARE(Directory::readString(Directory::join(_tree, "sub/b.txt")), "b");
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "");
+}
+
+void FileWatcherTest::directoryNotDirectory() {
+    std::ostringstream out;
+    Error redirectError{&out};
+    DirectoryWatcher watcher{Directory::join(_tree, "a.txt")};
+    CORRADE_VERIFY(!watcher.isValid());
+    CORRADE_COMPARE(watcher.fileCount(), 0);
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "");
+    CORRADE_COMPARE(formatChanges(watcher.wait(10)), "");
+    CORRADE_COMPARE(out.str(), "Utility::DirectoryWatcher: " + Directory::join(_tree, "a.txt") + " is not a directory\n");
+}
+
+void FileWatcherTest::directoryModified() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "sub/deep/c.txt"), "cc"));
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "a.txt"), "aa"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "~a.txt ~sub/deep/c.txt");
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "");
+}
+
+void FileWatcherTest::directoryCreatedDeleted() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "sub/new.txt"), "new"));
+    CORRADE_VERIFY(Directory::rm(Directory::join(_tree, "a.txt")));
+
+    /* Created and deleted before querying, not reported at all */
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "temporary.txt"), "tmp"));
+    CORRADE_VERIFY(Directory::rm(Directory::join(_tree, "temporary.txt")));
+
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "-a.txt +sub/new.txt");
+    CORRADE_COMPARE(watcher.fileCount(), 3);
+
+    /* Deleted and created again is a modification */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::rm(Directory::join(_tree, "sub/b.txt")));
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "sub/b.txt"), "bb"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "~sub/b.txt");
+}
+
+void FileWatcherTest::directorySubdirectoryCreated() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+
+    CORRADE_VERIFY(Directory::mkpath(Directory::join(_tree, "new/deeper")));
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "new/deeper/x.txt"), "x"));
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "new/y.txt"), "y"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "+new/deeper/x.txt +new/y.txt");
+    CORRADE_COMPARE(watcher.fileCount(), 5);
+
+    /* The new directories are watched as well */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "new/deeper/x.txt"), "xx"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "~new/deeper/x.txt");
+}
+
+void FileWatcherTest::directorySubdirectoryDeleted() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+
+    removeRecursive(Directory::join(_tree, "sub"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "-sub/b.txt -sub/deep/c.txt");
+    CORRADE_COMPARE(watcher.fileCount(), 1);
+    CORRADE_VERIFY(watcher.isValid());
+
+    /* Deleting the root invalidates the watcher */
+    removeRecursive(_tree);
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "-a.txt");
+    CORRADE_VERIFY(!watcher.isValid());
+    CORRADE_COMPARE(watcher.fileCount(), 0);
+}
+
+void FileWatcherTest::directorySubdirectoryMoved() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+
+    CORRADE_VERIFY(Directory::move(Directory::join(_tree, "sub/deep"), Directory::join(_tree, "moved")));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "+moved/c.txt -sub/deep/c.txt");
+
+    /* The moved directory is still watched under the new name */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "moved/c.txt"), "cc"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "~moved/c.txt");
+
+    /* Moving out of the tree is a deletion */
+    const std::string outside = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "moved-outside");
+    removeRecursive(outside);
+    CORRADE_VERIFY(Directory::move(Directory::join(_tree, "moved"), outside));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "-moved/c.txt");
+
+    /* And it's not watched anymore */
+    CORRADE_VERIFY(Directory::writeString(Directory::join(outside, "c.txt"), "ccc"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "");
+    removeRecursive(outside);
+}
+
+void FileWatcherTest::directoryCompareContents() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+
+    /* Writing the same contents updates the modification time, which is a
+       change only if contents are not compared */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "sub/b.txt"), "b"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()),
+        data.flags & DirectoryWatcher::Flag::CompareContents ? "" : "~sub/b.txt");
+
+    /* Writing different contents is always a change */
+    sleepIfPolling(data.flags);
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "sub/b.txt"), "B"));
+    CORRADE_COMPARE(formatChanges(watcher.changes()), "~sub/b.txt");
+}
+
+void FileWatcherTest::directoryWait() {
+    auto&& data = DirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    DirectoryWatcher watcher{_tree, data.flags};
+    watcher.setDebounceTime(50);
+    CORRADE_COMPARE(watcher.debounceTime(), 50);
+    CORRADE_COMPARE(formatChanges(watcher.wait(20)), "");
+
+    #if defined(CORRADE_TARGET_APPLE) || defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_EMSCRIPTEN)
+    std::thread thread = writeLater(Directory::join(_tree, "sub/deep/c.txt"), 1100);
+    #else
+    std::thread thread = writeLater(Directory::join(_tree, "sub/deep/c.txt"), 20);
+    #endif
+    CORRADE_COMPARE(formatChanges(watcher.wait(5000)), "~sub/deep/c.txt");
+    thread.join();
+}
+
+void FileWatcherTest::directoryMove() {
+    DirectoryWatcher a{_tree};
+    DirectoryWatcher b{std::move(a)};
+    CORRADE_COMPARE(b.fileCount(), 3);
+
+    DirectoryWatcher c{FILEWATCHER_WRITE_TEST_DIR, DirectoryWatcher::Flag::Polling};
+    c = std::move(b);
+    CORRADE_COMPARE(c.path(), _tree);
+
+    sleepIfPolling(c.flags());
+    CORRADE_VERIFY(Directory::writeString(Directory::join(_tree, "a.txt"), "aa"));
+    CORRADE_COMPARE(formatChanges(c.changes()), "~a.txt");
+}
+
+void FileWatcherTest::benchmarkNoChange() {
+    setTestCaseDescription(BenchmarkNoChangeData[testCaseInstanceId()]);
+
+    const std::string directory = Directory::join(FILEWATCHER_WRITE_TEST_DIR, "benchmark");
+    CORRADE_VERIFY(Directory::mkpath(directory));
+    std::vector<std::string> files;
+    for(std::size_t i = 0; i != BenchmarkFileCount; ++i) {
+        files.push_back(Directory::join(directory, std::to_string(i) + ".txt"));
+        CORRADE_VERIFY(Directory::writeString(files.back(), "hello"));
+    }
+
+    /* What Tweakable::update() did originally with each watched source
+       file, compared to a single set */
+    std::size_t changed = 0;
+    if(testCaseInstanceId() == 0) {
+        std::vector<FileWatcher> watchers;
+        for(const std::string& file: files) watchers.emplace_back(file);
+
+        CORRADE_BENCHMARK(10)
+            for(FileWatcher& watcher: watchers)
+                changed += watcher.hasChanged();
+
+    } else {
+        FileWatcherSet watchers{testCaseInstanceId() == 2 ? FileWatcherSet::Flag::Polling : FileWatcherSet::Flags{}};
+        for(const std::string& file: files) watchers.add(file);
+
+        CORRADE_BENCHMARK(10)
+            changed += watchers.changed().size();
+    }
+
+    CORRADE_COMPARE(changed, 0);
+}
+
+void FileWatcherTest::benchmarkDirectoryNoChange() {
+    auto&& data = BenchmarkDirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* 1000 files in 20 directories */
+    for(std::size_t i = 0; i != BenchmarkDirectoryCount; ++i) {
+        const std::string directory = Directory::join(_tree, std::to_string(i));
+        Directory::mkpath(directory);
+        for(std::size_t j = 0; j != BenchmarkDirectoryFileCount; ++j)
+            Directory::writeString(Directory::join(directory, std::to_string(j) + ".txt"), "hello");
+    }
+
+    DirectoryWatcher watcher{_tree, data.flags};
+    CORRADE_COMPARE(watcher.fileCount(), BenchmarkDirectoryCount*BenchmarkDirectoryFileCount + 3);
+
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(1)
+        count += watcher.changes().size();
+
+    CORRADE_COMPARE(count, 0);
+}
+
+void FileWatcherTest::benchmarkDirectoryScan() {
+    auto&& data = BenchmarkDirectoryData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for(std::size_t i = 0; i != BenchmarkDirectoryCount; ++i) {
+        const std::string directory = Directory::join(_tree, std::to_string(i));
+        Directory::mkpath(directory);
+        for(std::size_t j = 0; j != BenchmarkDirectoryFileCount; ++j)
+            Directory::writeString(Directory::join(directory, std::to_string(j) + ".txt"), "hello");
+    }
+
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(1) {
+        DirectoryWatcher watcher{_tree, data.flags};
+        count += watcher.fileCount();
+    }
+
+    CORRADE_COMPARE(count, BenchmarkDirectoryCount*BenchmarkDirectoryFileCount + 3);
+}
+
+void FileWatcherTest::latencyBegin() {
+    setBenchmarkName("write to notification");
+    _latency = 0;
+}
+
+std::uint64_t FileWatcherTest::latencyEnd() {
+    return _latency;
+}
+
+void FileWatcherTest::benchmarkWaitLatency() {
+    auto&& data = SetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    FileWatcherSet watchers{data.flags};
+    watchers.add(_filename);
+
+    /* Wait for the file to be written from another thread, measuring the
+       time from the write to the wakeup. The delay has to be long enough
+       for the modification time to change when polling. */
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(1) {
+        /* Discard events that might be left over from the previous write so
+           the wait doesn't return early */
+        watchers.changed();
+
+        std::thread thread = writeLater(_filename, 15, &_written);
+        count += watchers.wait(5000).size();
+        const std::chrono::steady_clock::time_point woken = std::chrono::steady_clock::now();
+        thread.join();
+        _latency += std::chrono::duration_cast<std::chrono::nanoseconds>(woken - _written).count();
+    }
+
+    CORRADE_COMPARE(count, 1);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::FileWatcherTest)
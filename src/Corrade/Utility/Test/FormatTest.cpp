@@ -57,6 +57,7 @@ struct FormatTest: TestSuite::Tester {
     void integerFloat();
 
     void integerPrecision();
+    void integerSnprintfEquivalence();
 
     void floatingFloat();
     void floatingDouble();
@@ -72,6 +73,7 @@ struct FormatTest: TestSuite::Tester {
     void floatFixed();
     void floatFixedUppercase();
     void floatBase();
+    template<class T> void floatSnprintfEquivalence();
 
     void charArray();
     void charArrayView();
@@ -105,7 +107,20 @@ struct FormatTest: TestSuite::Tester {
     void typeForString();
     void invalidType();
 
+    void compiled();
+    void compiledToBuffer();
+    void compiledAppendToString();
+    void compiledInsertToString();
+    void compiledLongValue();
+    void compiledFile();
+    void compiledTooLittlePlaceholders();
+    void compiledTooManyPlaceholders();
+    void compiledParseError();
+
     void benchmarkFormat();
+    void benchmarkFormatCompiled();
+    void benchmarkFormatString();
+    void benchmarkFormatStringCompiled();
     void benchmarkSnprintf();
     void benchmarkSstream();
     void benchmarkDebug();
@@ -114,6 +129,11 @@ struct FormatTest: TestSuite::Tester {
     void benchmarkFloatSnprintf();
     void benchmarkFloatSstream();
     void benchmarkFloatDebug();
+
+    void benchmarkFormatterInteger();
+    void benchmarkFormatterIntegerSnprintf();
+    void benchmarkFormatterFloat();
+    void benchmarkFormatterFloatSnprintf();
 };
 
 FormatTest::FormatTest() {
@@ -134,6 +154,7 @@ FormatTest::FormatTest() {
               &FormatTest::integerFloat,
 
               &FormatTest::integerPrecision,
+              &FormatTest::integerSnprintfEquivalence,
 
               &FormatTest::floatingFloat,
               &FormatTest::floatingDouble,
@@ -153,6 +174,11 @@ FormatTest::FormatTest() {
               &FormatTest::floatFixed,
               &FormatTest::floatFixedUppercase,
               &FormatTest::floatBase,
+              &FormatTest::floatSnprintfEquivalence<float>,
+              &FormatTest::floatSnprintfEquivalence<double>,
+              #ifndef CORRADE_TARGET_EMSCRIPTEN
+              &FormatTest::floatSnprintfEquivalence<long double>,
+              #endif
 
               &FormatTest::charArray,
               &FormatTest::charArrayView,
@@ -184,9 +210,22 @@ FormatTest::FormatTest() {
               &FormatTest::unknownPlaceholderContent,
               &FormatTest::invalidPrecision,
               &FormatTest::typeForString,
-              &FormatTest::invalidType});
+              &FormatTest::invalidType,
+
+              &FormatTest::compiled,
+              &FormatTest::compiledToBuffer,
+              &FormatTest::compiledAppendToString,
+              &FormatTest::compiledInsertToString,
+              &FormatTest::compiledLongValue,
+              &FormatTest::compiledFile,
+              &FormatTest::compiledTooLittlePlaceholders,
+              &FormatTest::compiledTooManyPlaceholders,
+              &FormatTest::compiledParseError});
 
     addBenchmarks({&FormatTest::benchmarkFormat,
+                   &FormatTest::benchmarkFormatCompiled,
+                   &FormatTest::benchmarkFormatString,
+                   &FormatTest::benchmarkFormatStringCompiled,
                    &FormatTest::benchmarkSnprintf,
                    &FormatTest::benchmarkSstream,
                    &FormatTest::benchmarkDebug,
@@ -194,7 +233,12 @@ FormatTest::FormatTest() {
                    &FormatTest::benchmarkFloatFormat,
                    &FormatTest::benchmarkFloatSnprintf,
                    &FormatTest::benchmarkFloatSstream,
-                   &FormatTest::benchmarkFloatDebug}, 50);
+                   &FormatTest::benchmarkFloatDebug,
+
+                   &FormatTest::benchmarkFormatterInteger,
+                   &FormatTest::benchmarkFormatterIntegerSnprintf,
+                   &FormatTest::benchmarkFormatterFloat,
+                   &FormatTest::benchmarkFormatterFloatSnprintf}, 50);
 }
 
 void FormatTest::empty() {
@@ -300,22 +344,46 @@ void FormatTest::integerPrecision() {
     CORRADE_COMPARE(formatString("{:.15}", 1536ull), "000000000001536");
 }
 
+void FormatTest::integerSnprintfEquivalence() {
+    /* The output should be the same as with printf() for all types,
+       precisions and values including the edge cases */
+    const long long values[]{
+        0, 1, -1, 7, -8, 255, 1337, -1337, 2147483647ll, -2147483647ll - 1,
+        4294967295ll, 9223372036854775807ll, -9223372036854775807ll - 1
+    };
+    for(const char type: {'d', 'o', 'x', 'X'}) for(const int precision: {-1, 0, 1, 5, 25}) {
+        const std::string format = precision == -1 ?
+            formatString("{{:{}}}", Containers::arrayView(&type, 1)) :
+            formatString("{{:.{}{}}}", precision, Containers::arrayView(&type, 1));
+        const int printfPrecision = precision == -1 ? 1 : precision;
+        const char printfFormat[]{'%', '.', '*', 'l', 'l', type == 'd' ? 'i' : type, 0};
+        const char printfFormatInt[]{'%', '.', '*', type == 'd' ? 'i' : type, 0};
+        const char printfFormatUnsigned[]{'%', '.', '*', 'l', 'l', type == 'd' ? 'u' : type, 0};
+
+        for(const long long value: values) {
+            char expected[64];
+
+            std::snprintf(expected, sizeof(expected), printfFormat, printfPrecision, value);
+            CORRADE_COMPARE(formatString(format.data(), value), expected);
+
+            std::snprintf(expected, sizeof(expected), printfFormatUnsigned, printfPrecision, static_cast<unsigned long long>(value));
+            CORRADE_COMPARE(formatString(format.data(), static_cast<unsigned long long>(value)), expected);
+
+            const int intValue = int(value);
+            std::snprintf(expected, sizeof(expected), printfFormatInt, printfPrecision, intValue);
+            CORRADE_COMPARE(formatString(format.data(), intValue), expected);
+        }
+    }
+}
+
 void FormatTest::floatingFloat() {
     CORRADE_COMPARE(formatString("{}", 12.34f), "12.34");
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{}", -1.32e+07f), "-1.32e+07");
-    #else
-    CORRADE_COMPARE(formatString("{}", -1.32e+07f), "-1.32e+007");
-    #endif
 }
 
 void FormatTest::floatingDouble() {
     CORRADE_COMPARE(formatString("{}", 12.3404), "12.3404");
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{}", -1.32e+37), "-1.32e+37");
-    #else
-    CORRADE_COMPARE(formatString("{}", -1.32e+37), "-1.32e+037");
-    #endif
 }
 
 #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -330,11 +398,7 @@ void FormatTest::floatingLongDouble() {
         "Android has precision problems with long double on 32bit.");
     #endif
     CORRADE_COMPARE(formatString("{}", 12.3404l), "12.3404");
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{}", -1.32e+67l), "-1.32e+67");
-    #else
-    CORRADE_COMPARE(formatString("{}", -1.32e+67l), "-1.32e+067");
-    #endif
 }
 #endif
 
@@ -342,32 +406,20 @@ template<class> struct FloatingPrecisionData;
 template<> struct FloatingPrecisionData<float> {
     static const char* name() { return "floatingPrecision<float>"; }
     static const char* expected() {
-        #ifndef __MINGW32__
         return "3.14159 -12345.7 1.23457e-12 3.14159";
-        #else
-        return "3.14159 -12345.7 1.23457e-012 3.14159";
-        #endif
     }
 };
 template<> struct FloatingPrecisionData<double> {
     static const char* name() { return "floatingPrecision<double>"; }
     static const char* expected() {
-        #ifndef __MINGW32__
         return "3.14159265358979 -12345.6789012346 1.23456789012346e-12 3.14159";
-        #else
-        return "3.14159265358979 -12345.6789012346 1.23456789012346e-012 3.14159";
-        #endif
     }
 };
 #ifndef CORRADE_TARGET_EMSCRIPTEN
 template<> struct FloatingPrecisionData<long double> {
     static const char* name() { return "floatingPrecision<long double>"; }
     static const char* expected() {
-        #ifndef __MINGW32__
         return "3.14159265358979324 -12345.6789012345679 1.23456789012345679e-12 3.14159";
-        #else
-        return "3.14159265358979324 -12345.6789012345679 1.23456789012345679e-012 3.14159";
-        #endif
     }
 };
 #endif
@@ -397,21 +449,13 @@ template<class T> void FormatTest::floatingPrecision() {
 }
 
 void FormatTest::floatGeneric() {
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{}", 1234.0e5f), "1.234e+08");
-    #else
-    CORRADE_COMPARE(formatString("{}", 1234.0e5f), "1.234e+008");
-    #endif
     CORRADE_COMPARE(formatString("{}", 1234.0e5), "123400000");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{}", 1234.0e5l), "123400000");
     #endif
 
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{:g}", 1234.0e5f), "1.234e+08");
-    #else
-    CORRADE_COMPARE(formatString("{:g}", 1234.0e5f), "1.234e+008");
-    #endif
     CORRADE_COMPARE(formatString("{:g}", 1234.0e5), "123400000");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{:g}", 1234.0e5l), "123400000");
@@ -441,11 +485,7 @@ void FormatTest::floatGeneric() {
 }
 
 void FormatTest::floatGenericUppercase() {
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{:G}", 1234.0e5f), "1.234E+08");
-    #else
-    CORRADE_COMPARE(formatString("{:G}", 1234.0e5f), "1.234E+008");
-    #endif
     CORRADE_COMPARE(formatString("{:G}", 1234.0e5), "123400000");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{:G}", 1234.0e5l), "123400000");
@@ -464,19 +504,12 @@ void FormatTest::floatGenericUppercase() {
 }
 
 void FormatTest::floatExponent() {
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{:e}", 1234.0e5f), "1.234000e+08");
     CORRADE_COMPARE(formatString("{:e}", 1234.0e5), "1.234000000000000e+08");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{:e}", 1234.0e5l), "1.234000000000000000e+08");
     #endif
-    #else
-    CORRADE_COMPARE(formatString("{:e}", 1234.0e5f), "1.234000e+008");
-    CORRADE_COMPARE(formatString("{:e}", 1234.0e5), "1.234000000000000e+008");
-    CORRADE_COMPARE(formatString("{:e}", 1234.0e5l), "1.234000000000000000e+008");
-    #endif
 
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{:.3e}", 1.0f), "1.000e+00");
     CORRADE_COMPARE(formatString("{:.3e}", 1.0), "1.000e+00");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -487,30 +520,15 @@ void FormatTest::floatExponent() {
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{:.3e}", 12.34567l), "1.235e+01");
     #endif
-    #else
-    CORRADE_COMPARE(formatString("{:.3e}", 1.0f), "1.000e+000");
-    CORRADE_COMPARE(formatString("{:.3e}", 1.0), "1.000e+000");
-    CORRADE_COMPARE(formatString("{:.3e}", 1.0l), "1.000e+000");
-    CORRADE_COMPARE(formatString("{:.3e}", 12.34567f), "1.235e+001");
-    CORRADE_COMPARE(formatString("{:.3e}", 12.34567), "1.235e+001");
-    CORRADE_COMPARE(formatString("{:.3e}", 12.34567l), "1.235e+001");
-    #endif
 }
 
 void FormatTest::floatExponentUppercase() {
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{:E}", 1234.0e5f), "1.234000E+08");
     CORRADE_COMPARE(formatString("{:E}", 1234.0e5), "1.234000000000000E+08");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{:E}", 1234.0e5l), "1.234000000000000000E+08");
     #endif
-    #else
-    CORRADE_COMPARE(formatString("{:E}", 1234.0e5f), "1.234000E+008");
-    CORRADE_COMPARE(formatString("{:E}", 1234.0e5), "1.234000000000000E+008");
-    CORRADE_COMPARE(formatString("{:E}", 1234.0e5l), "1.234000000000000000E+008");
-    #endif
 
-    #ifndef __MINGW32__
     CORRADE_COMPARE(formatString("{:.3E}", 1.0f), "1.000E+00");
     CORRADE_COMPARE(formatString("{:.3E}", 1.0), "1.000E+00");
     #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -521,14 +539,6 @@ void FormatTest::floatExponentUppercase() {
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     CORRADE_COMPARE(formatString("{:.3E}", 12.34567l), "1.235E+01");
     #endif
-    #else
-    CORRADE_COMPARE(formatString("{:.3E}", 1.0f), "1.000E+000");
-    CORRADE_COMPARE(formatString("{:.3E}", 1.0), "1.000E+000");
-    CORRADE_COMPARE(formatString("{:.3E}", 1.0l), "1.000E+000");
-    CORRADE_COMPARE(formatString("{:.3E}", 12.34567f), "1.235E+001");
-    CORRADE_COMPARE(formatString("{:.3E}", 12.34567), "1.235E+001");
-    CORRADE_COMPARE(formatString("{:.3E}", 12.34567l), "1.235E+001");
-    #endif
 }
 
 void FormatTest::floatFixed() {
@@ -591,6 +601,59 @@ void FormatTest::floatBase() {
     #endif
 }
 
+template<class> struct FloatSnprintfEquivalenceData;
+template<> struct FloatSnprintfEquivalenceData<float> {
+    static const char* name() { return "floatSnprintfEquivalence<float>"; }
+    static const char* length() { return ""; }
+    static double printfValue(float value) { return double(value); }
+};
+template<> struct FloatSnprintfEquivalenceData<double> {
+    static const char* name() { return "floatSnprintfEquivalence<double>"; }
+    static const char* length() { return ""; }
+    static double printfValue(double value) { return value; }
+};
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+template<> struct FloatSnprintfEquivalenceData<long double> {
+    static const char* name() { return "floatSnprintfEquivalence<long double>"; }
+    static const char* length() { return "L"; }
+    static long double printfValue(long double value) { return value; }
+};
+#endif
+
+template<class T> void FormatTest::floatSnprintfEquivalence() {
+    setTestCaseName(FloatSnprintfEquivalenceData<T>::name());
+
+    /* The output should be the same as with printf() for all types,
+       precisions and values including the edge cases, rounding ties and
+       values that need arbitrary-precision arithmetic */
+    const T values[]{
+        T(0.0), -T(0.0), T(1.0), T(0.1), T(4.2), T(-13.37), T(0.5), T(2.5),
+        T(0.125), T(999999.5), T(1234.5678), T(1.0e-5), T(9.9999999e-5),
+        T(1.0e-7), T(3.0e-30), T(1.5e30), T(1.0e21), T(123456789012345678.0),
+        std::numeric_limits<T>::min(), std::numeric_limits<T>::denorm_min(),
+        std::numeric_limits<T>::max(), std::numeric_limits<T>::epsilon(),
+        std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+        std::numeric_limits<T>::quiet_NaN()
+    };
+    const int defaultPrecision = std::is_same<T, float>::value ? 6 :
+        std::is_same<T, double>::value ? 15 : 18;
+    for(const char type: {'g', 'G', 'e', 'E', 'f', 'F'}) for(const int precision: {-1, 0, 1, 3, 6, 17}) {
+        const std::string format = precision == -1 ?
+            formatString("{{:{}}}", Containers::arrayView(&type, 1)) :
+            formatString("{{:.{}{}}}", precision, Containers::arrayView(&type, 1));
+        const std::string printfFormat = formatString("%.*{}{}",
+            FloatSnprintfEquivalenceData<T>::length(), Containers::arrayView(&type, 1));
+
+        for(const T value: values) {
+            /* Large values with %f are long, size the output first */
+            const int printfPrecision = precision == -1 ? defaultPrecision : precision;
+            std::string expected(std::snprintf(nullptr, 0, printfFormat.data(), printfPrecision, FloatSnprintfEquivalenceData<T>::printfValue(value)), '\0');
+            std::snprintf(&expected[0], expected.size() + 1, printfFormat.data(), printfPrecision, FloatSnprintfEquivalenceData<T>::printfValue(value));
+            CORRADE_COMPARE(formatString(format.data(), value), expected);
+        }
+    }
+}
+
 void FormatTest::charArray() {
     /* Decays from const char[n] to char* (?), stuff after \0 ignored due to
        strlen */
@@ -657,13 +720,13 @@ void FormatTest::toBuffer() {
 }
 
 void FormatTest::toBufferNullTerminatorFromSnprintfAtTheEnd() {
+    /* Numbers used to be printed with snprintf(), which always wants to print
+       a null terminator and so the last character got cut off */
     char buffer[8];
     CORRADE_COMPARE(formatInto(buffer, "hello {}", 42), 8);
-    {
-        CORRADE_EXPECT_FAIL("snprintf() really wants to print a null terminator so the last character gets cut off. Need a better solution.");
-        CORRADE_COMPARE((std::string{buffer, 8}), "hello 42");
-    }
-    CORRADE_COMPARE(std::string{buffer}, "hello 4");
+    CORRADE_COMPARE((std::string{buffer, 8}), "hello 42");
+    CORRADE_COMPARE(formatInto(buffer, "{} {}", 4.5, 0.25f), 8);
+    CORRADE_COMPARE((std::string{buffer, 8}), "4.5 0.25");
 }
 
 void FormatTest::appendToString() {
@@ -843,8 +906,140 @@ void FormatTest::invalidType() {
         "Utility::format(): invalid type specifier: H\n");
 }
 
+void FormatTest::compiled() {
+    /* Same as the runtime-parsed variants above */
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("")), "");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("hello world!")), "hello world!");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("typedef struct {{ int a; }} Type;")),
+        "typedef struct { int a; } Type;");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("}}{{}}{{")), "}{}{");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("so I got {} {}, {} and {} and all that for {}€!"),
+        2, "beers", std::string{"a goulash"}, Containers::arrayView("a soup", 6), 8.70f),
+        "so I got 2 beers, a goulash and a soup and all that for 8.7€!");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("<{0}>HTML, <{1}>amirite</{1}>?</{0}>"), "p", "strong"),
+        "<p>HTML, <strong>amirite</strong>?</p>");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("{0:.1X}{:.6x}{0:.1X}"), 0xb, 0),
+        "B000000B");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("this {1} {} {0}, {}"), "wrong", "is", "certainly"),
+        "this is certainly wrong, is");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("{:.3e} {:F} {:o} {:.4}"), 1234.5, 1.5f, 8u, "hello world"),
+        "1.234e+03 1.500000 10 hell");
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("{0:}*9 = {:}"), 6, 42), "6*9 = 42");
+}
+
+void FormatTest::compiledToBuffer() {
+    char buffer[15]{};
+    buffer[13] = '?'; /* to verify that a null terminator wasn't printed */
+    CORRADE_COMPARE(formatInto(buffer, CORRADE_FORMAT("hello, {}!"), "world"), 13);
+    CORRADE_COMPARE(std::string{buffer}, "hello, world!?");
+
+    /* Size query */
+    CORRADE_COMPARE(formatInto(Containers::ArrayView<char>{}, CORRADE_FORMAT("hello, {}! {:.4}"), "world", 3), 18);
+}
+
+void FormatTest::compiledAppendToString() {
+    /* Returned size should be including start offset */
+    std::string hello = "hello";
+    CORRADE_COMPARE(formatInto(hello, hello.size(), CORRADE_FORMAT(", {}! {}"), "world", 1337), 18);
+    CORRADE_COMPARE(hello, "hello, world! 1337");
+}
+
+void FormatTest::compiledInsertToString() {
+    /* Returned size should be including start offset but be less than string
+       size, and the rest of the string shouldn't get overwritten by a null
+       terminator printed by snprintf() */
+    std::string hello = "hello, __________! Happy to see you!";
+    CORRADE_COMPARE(formatInto(hello, 8, CORRADE_FORMAT("{}{}"), "Frank", 42), 15);
+    CORRADE_COMPARE(hello, "hello, _Frank42__! Happy to see you!");
+    CORRADE_COMPARE(hello.size(), 36);
+}
+
+void FormatTest::compiledLongValue() {
+    /* Values that don't fit into the internal stack buffer are formatted
+       directly into the string */
+    const std::string value(100, 'a');
+    std::string out = "<" + std::string(200, '_') + ">";
+    CORRADE_COMPARE(formatInto(out, 1, CORRADE_FORMAT("{} {:.80}"), value, 1), 182);
+    CORRADE_COMPARE(out, "<" + value + " " + std::string(79, '0') + "1" + std::string(19, '_') + ">");
+
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("[{}] [{:.70f}]"), value, 0.5),
+        formatString("[{}] [{:.70f}]", value, 0.5));
+}
+
+void FormatTest::compiledFile() {
+    const std::string filename = Directory::join(FORMAT_WRITE_TEST_DIR, "format-compiled.txt");
+    if(!Directory::exists(FORMAT_WRITE_TEST_DIR))
+        CORRADE_VERIFY(Directory::mkpath(FORMAT_WRITE_TEST_DIR));
+    if(Directory::exists(filename))
+        CORRADE_VERIFY(Directory::rm(filename));
+
+    {
+        FILE* f = std::fopen(filename.data(), "w");
+        CORRADE_VERIFY(f);
+        Containers::ScopeGuard e{f, fclose};
+        formatInto(f, CORRADE_FORMAT("A {} {} {} {} {} {} + ({}) {} {{{5}}}"),
+            "string", std::string{"file"}, -2000123, 4025136u, -12345678901234ll, 24568780984912ull, 12.3404f, 1.52);
+    }
+    CORRADE_COMPARE_AS(filename,
+        "A string file -2000123 4025136 -12345678901234 24568780984912 + (12.3404) 1.52 {24568780984912}",
+        TestSuite::Compare::FileToString);
+}
+
+void FormatTest::compiledTooLittlePlaceholders() {
+    /* Not a problem */
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("{}!"), 42, "but this is", "not visible", 1337), "42!");
+}
+
+void FormatTest::compiledTooManyPlaceholders() {
+    /* Not a problem, copied verbatim. Type specifiers of placeholders without
+       an argument aren't checked either. */
+    CORRADE_COMPARE(formatString(CORRADE_FORMAT("{} + {} = {13:.2x}!"), 42, "a"), "42 + a = {13:.2x}!");
+
+    char buffer[32];
+    CORRADE_COMPARE(formatInto(buffer, CORRADE_FORMAT("{} + {} = {13}!"), 42, "a"), 14);
+    CORRADE_COMPARE((std::string{buffer, 14}), "42 + a = {13}!");
+}
+
+void FormatTest::compiledParseError() {
+    /* Invalid format strings are a compile-time error, so it's not possible
+       to test them through CORRADE_FORMAT(). Verify the underlying parser
+       reports the same errors as the runtime variant instead. */
+    #define error(format) Implementation::formatError(format, sizeof(format) - 1, 0)
+    constexpr Implementation::FormatError valid = error("{} {0:.3x} {{}}");
+    CORRADE_VERIFY(valid == Implementation::FormatError::None);
+    CORRADE_VERIFY(error("{") == Implementation::FormatError::UnexpectedEnd);
+    CORRADE_VERIFY(error("{123545") == Implementation::FormatError::UnexpectedEnd);
+    CORRADE_VERIFY(error("struct { int a; } foo;") == Implementation::FormatError::UnknownPlaceholderContent);
+    CORRADE_VERIFY(error("}") == Implementation::FormatError::MismatchedDelimiter);
+    CORRADE_VERIFY(error("a; } foo;") == Implementation::FormatError::MismatchedDelimiter);
+    CORRADE_VERIFY(error("{name}") == Implementation::FormatError::UnknownPlaceholderContent);
+    CORRADE_VERIFY(error("{1oh}") == Implementation::FormatError::UnknownPlaceholderContent);
+    CORRADE_VERIFY(error("{1:xe}") == Implementation::FormatError::UnknownPlaceholderContent);
+    CORRADE_VERIFY(error("{:.}") == Implementation::FormatError::InvalidPrecision);
+    CORRADE_VERIFY(error("{1:.x}") == Implementation::FormatError::InvalidPrecision);
+    CORRADE_VERIFY(error("{:H}") == Implementation::FormatError::InvalidType);
+    #undef error
+
+    /* Type specifiers not matching argument types */
+    constexpr Implementation::FormatChunk chunks[]{
+        Implementation::formatChunk("{:x}{:f}{}", 10, 0),
+        Implementation::formatChunk("{:x}{:f}{}", 10, 1),
+        Implementation::formatChunk("{:x}{:f}{}", 10, 2)
+    };
+    constexpr Implementation::FormatKind good[]{Implementation::FormatKind::Integer, Implementation::FormatKind::Float, Implementation::FormatKind::String};
+    constexpr Implementation::FormatKind bad1[]{Implementation::FormatKind::Float, Implementation::FormatKind::Float, Implementation::FormatKind::String};
+    constexpr Implementation::FormatKind bad2[]{Implementation::FormatKind::Integer, Implementation::FormatKind::String, Implementation::FormatKind::String};
+    constexpr bool matches = Implementation::formatTypesMatch(chunks, 3, good, 3);
+    CORRADE_VERIFY(matches);
+    CORRADE_VERIFY(!Implementation::formatTypesMatch(chunks, 3, bad1, 3));
+    CORRADE_VERIFY(!Implementation::formatTypesMatch(chunks, 3, bad2, 3));
+    /* Not checked if there's no argument for it */
+    CORRADE_VERIFY(Implementation::formatTypesMatch(chunks, 3, bad2, 1));
+}
+
 void FormatTest::benchmarkFormat() {
-    char buffer[1024];
+    /* Zero-initialized, as formatInto() doesn't write a null terminator */
+    char buffer[1024]{};
 
     CORRADE_BENCHMARK(1000)
         formatInto(buffer, "hello, {}! {1} + {2} = {} = {2} + {1}", "people", 42, 1337, 42 + 1337);
@@ -852,6 +1047,34 @@ void FormatTest::benchmarkFormat() {
     CORRADE_COMPARE(std::string{buffer}, "hello, people! 42 + 1337 = 1379 = 1337 + 42");
 }
 
+void FormatTest::benchmarkFormatCompiled() {
+    /* Zero-initialized, as formatInto() doesn't write a null terminator */
+    char buffer[1024]{};
+
+    CORRADE_BENCHMARK(1000)
+        formatInto(buffer, CORRADE_FORMAT("hello, {}! {1} + {2} = {} = {2} + {1}"), "people", 42, 1337, 42 + 1337);
+
+    CORRADE_COMPARE(std::string{buffer}, "hello, people! 42 + 1337 = 1379 = 1337 + 42");
+}
+
+void FormatTest::benchmarkFormatString() {
+    std::string out;
+
+    CORRADE_BENCHMARK(1000)
+        formatInto(out, 0, "hello, {}! {1} + {2} = {} = {2} + {1}", "people", 42, 1337, 42 + 1337);
+
+    CORRADE_COMPARE(out, "hello, people! 42 + 1337 = 1379 = 1337 + 42");
+}
+
+void FormatTest::benchmarkFormatStringCompiled() {
+    std::string out;
+
+    CORRADE_BENCHMARK(1000)
+        formatInto(out, 0, CORRADE_FORMAT("hello, {}! {1} + {2} = {} = {2} + {1}"), "people", 42, 1337, 42 + 1337);
+
+    CORRADE_COMPARE(out, "hello, people! 42 + 1337 = 1379 = 1337 + 42");
+}
+
 void FormatTest::benchmarkSnprintf() {
     char buffer[1024];
 
@@ -888,7 +1111,8 @@ void FormatTest::benchmarkDebug() {
 }
 
 void FormatTest::benchmarkFloatFormat() {
-    char buffer[1024];
+    /* Zero-initialized, as formatInto() doesn't write a null terminator */
+    char buffer[1024]{};
 
     CORRADE_BENCHMARK(1000)
         formatInto(buffer, "hello, {}! {1} + {2} = {} = {2} + {1}", "people", 4.2, 13.37, 4.2 + 13.37);
@@ -931,6 +1155,82 @@ void FormatTest::benchmarkFloatDebug() {
     CORRADE_COMPARE(out.str(), "hello, people! 4.2 + 13.37 = 17.57 = 13.37 + 4.2");
 }
 
+void FormatTest::benchmarkFormatterInteger() {
+    char buffer[64];
+    std::size_t size = 0;
+
+    CORRADE_BENCHMARK(1000) {
+        size += Implementation::Formatter<int>::format(buffer, 42, -1, Implementation::FormatType::Unspecified);
+        size += Implementation::Formatter<int>::format(buffer, -1337, 6, Implementation::FormatType::Unspecified);
+        size += Implementation::Formatter<long long>::format(buffer, 24568780984912ll, -1, Implementation::FormatType::Unspecified);
+        size += Implementation::Formatter<unsigned int>::format(buffer, 0xdeadbeef, -1, Implementation::FormatType::Hexadecimal);
+    }
+
+    CORRADE_COMPARE(size, 1000*(2 + 7 + 14 + 8));
+}
+
+void FormatTest::benchmarkFormatterIntegerSnprintf() {
+    /* What Formatter used to do before the native encoders */
+    char buffer[64];
+    std::size_t size = 0;
+
+    CORRADE_BENCHMARK(1000) {
+        {
+            const char format[]{ '%', '.', '*', 'i', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 1, 42);
+        } {
+            const char format[]{ '%', '.', '*', 'i', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 6, -1337);
+        } {
+            const char format[]{ '%', '.', '*', 'l', 'l', 'i', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 1, 24568780984912ll);
+        } {
+            const char format[]{ '%', '.', '*', 'x', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 1, 0xdeadbeef);
+        }
+    }
+
+    CORRADE_COMPARE(size, 1000*(2 + 7 + 14 + 8));
+}
+
+void FormatTest::benchmarkFormatterFloat() {
+    char buffer[64];
+    std::size_t size = 0;
+
+    CORRADE_BENCHMARK(1000) {
+        size += Implementation::Formatter<double>::format(buffer, 4.2, -1, Implementation::FormatType::Unspecified);
+        size += Implementation::Formatter<double>::format(buffer, 13.37, -1, Implementation::FormatType::Unspecified);
+        size += Implementation::Formatter<float>::format(buffer, 1234.5678f, -1, Implementation::FormatType::Unspecified);
+        size += Implementation::Formatter<double>::format(buffer, 0.1, 3, Implementation::FormatType::FloatFixed);
+    }
+
+    CORRADE_COMPARE(size, 1000*(3 + 5 + 7 + 5));
+}
+
+void FormatTest::benchmarkFormatterFloatSnprintf() {
+    /* What Formatter used to do before the native encoders */
+    char buffer[64];
+    std::size_t size = 0;
+
+    CORRADE_BENCHMARK(1000) {
+        {
+            const char format[]{ '%', '.', '*', 'g', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 15, 4.2);
+        } {
+            const char format[]{ '%', '.', '*', 'g', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 15, 13.37);
+        } {
+            const char format[]{ '%', '.', '*', 'g', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 6, double(1234.5678f));
+        } {
+            const char format[]{ '%', '.', '*', 'f', 0 };
+            size += std::snprintf(buffer, sizeof(buffer), format, 3, 0.1);
+        }
+    }
+
+    CORRADE_COMPARE(size, 1000*(3 + 5 + 7 + 5));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::FormatTest)
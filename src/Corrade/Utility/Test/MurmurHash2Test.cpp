@@ -37,12 +37,16 @@ struct MurmurHash2Test: TestSuite::Tester {
     void test32();
     void test64();
     void constructor();
+    void constexprMatchesRuntime();
+    void literalConstexpr();
 };
 
 MurmurHash2Test::MurmurHash2Test() {
     addTests({&MurmurHash2Test::test32,
               &MurmurHash2Test::test64,
-              &MurmurHash2Test::constructor});
+              &MurmurHash2Test::constructor,
+              &MurmurHash2Test::constexprMatchesRuntime,
+              &MurmurHash2Test::literalConstexpr});
 }
 
 void MurmurHash2Test::test32() {
@@ -61,6 +65,33 @@ void MurmurHash2Test::constructor() {
     CORRADE_COMPARE(MurmurHash2()(std::string("hello")), MurmurHash2()("hello", 5));
 }
 
+void MurmurHash2Test::constexprMatchesRuntime() {
+    std::string data(Implementation::MurmurHash2ConstexprSizeLimit + 17, '\0');
+    for(std::size_t i = 0; i != data.size(); ++i)
+        data[i] = char(i*37 + 11);
+
+    /* Every size up to the limit goes through the constexpr code path, which
+       has to give exactly the same results as the runtime loop */
+    for(std::size_t size = 0; size <= data.size(); ++size) {
+        CORRADE_COMPARE(Implementation::MurmurHash2<4>{}(23, data.data(), size),
+                        Implementation::MurmurHash2<4>::runtime(23, data.data(), size));
+        CORRADE_COMPARE(Implementation::MurmurHash2<8>{}(23, data.data(), size),
+                        Implementation::MurmurHash2<8>::runtime(23, data.data(), size));
+    }
+}
+
+void MurmurHash2Test::literalConstexpr() {
+    constexpr unsigned int a = Implementation::MurmurHash2<4>{}(23, "string", 6);
+    constexpr unsigned long long b = Implementation::MurmurHash2<8>{}(23, "eightbit", 8);
+    CORRADE_COMPARE(a, 3435905073u);
+    CORRADE_COMPARE(b, 14685337704530366946ull);
+
+    constexpr MurmurHash2::Digest digest = MurmurHash2{}("hello");
+    constexpr char first = digest.byteArray()[0];
+    CORRADE_COMPARE(digest, MurmurHash2()(std::string("hello")));
+    CORRADE_COMPARE(first, MurmurHash2()(std::string("hello")).byteArray()[0]);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::MurmurHash2Test)
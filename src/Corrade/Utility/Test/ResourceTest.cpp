@@ -30,6 +30,7 @@
 #include "Corrade/TestSuite/Compare/StringToFile.h"
 #include "Corrade/Utility/Directory.h"
 #include "Corrade/Utility/Resource.h"
+#include "Corrade/Utility/Implementation/lz4.h"
 
 #include "configure.h"
 
@@ -41,6 +42,8 @@ struct ResourceTest: TestSuite::Tester {
     void compile();
     void compileNothing();
     void compileEmptyFile();
+    void compileStringLiterals();
+    void compileStringLiteralsEmptyFile();
 
     void compileFrom();
     void compileFromUtf8Filenames();
@@ -49,25 +52,113 @@ struct ResourceTest: TestSuite::Tester {
     void compileFromEmptyGroup();
     void compileFromEmptyFilename();
     void compileFromEmptyAlias();
+    void compileFromCompressed();
+    void compileFromParallel();
+    void compileFromParallelNonexistentFile();
+
+    void compileBinary();
+    void compileBinaryFrom();
+    void compileBinaryDuplicates();
 
     void hasGroup();
     void list();
     void get();
     void getEmptyFile();
     void getNonexistent();
+    void getNullFilename();
     void getNothing();
+    void getStringLiterals();
+    void getArrayView();
+    void getCompressed();
+
+    void compressionRoundtrip();
+    void decompressInvalid();
 
     void overrideGroup();
     void overrideGroupFallback();
     void overrideNonexistentFile();
     void overrideNonexistentGroup();
     void overrideDifferentGroup();
+
+    void registerPack();
+    void registerPackFile();
+    void registerPackEmptyFile();
+    void registerPackInvalid();
+    void registerPackAlreadyRegistered();
+    void registerPackFileNonexistent();
+
+    void benchmarkCompile();
+};
+
+constexpr struct {
+    const char* name;
+    Resource::CompileFlags flags;
+} BenchmarkCompileData[]{
+    {"hexadecimal", {}},
+    {"string literals", Resource::CompileFlag::StringLiterals}
+};
+
+std::string randomData(std::size_t size) {
+    std::string out(size, '\0');
+    unsigned int state = 1;
+    for(char& c: out) {
+        state = state*1103515245 + 12345;
+        c = char(state >> 24);
+    }
+    return out;
+}
+
+/* Executors processing the files out of order to verify the output doesn't
+   depend on it */
+void parallelForReverse(const std::size_t count, void(*const function)(void*, std::size_t), void* const state) {
+    for(std::size_t i = count; i != 0; --i) function(state, i - 1);
+}
+
+void parallelForInterleaved(const std::size_t count, void(*const function)(void*, std::size_t), void* const state) {
+    for(std::size_t i = 1; i < count; i += 2) function(state, i);
+    for(std::size_t i = 0; i < count; i += 2) function(state, i);
+}
+
+constexpr struct {
+    const char* name;
+    Resource::ParallelFor parallelFor;
+} ParallelForData[]{
+    {"reverse order", parallelForReverse},
+    {"interleaved order", parallelForInterleaved}
+};
+
+const struct {
+    const char* name;
+    std::string data;
+} CompressionRoundtripData[]{
+    {"empty", ""},
+    {"shorter than the match limit", "hello hello"},
+    {"one repeated byte", std::string(100000, 'a')},
+    {"long literal run", randomData(1000)},
+    {"incompressible", randomData(200000)},
+    {"text", std::string(5000, 'x') + randomData(300) + "the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy dog"}
 };
 
+/* Testing escaping of quotes, backslashes, question marks (trigraphs) and
+   octal escapes followed by digits */
+const std::vector<std::pair<std::string, std::string>> StringLiteralsInput{
+    {"predisposition.bin", "\xba\xdc\x0f\xfe\xeb\xad\xf0\x0d"},
+    {"consequence.bin", std::string{"\xd1\x5e\xa5\xed\xea\xdd\x00\x0d", 8}},
+    {"quotes?\?=.txt", "\"Why?\" \\ \x01" "23\n"}};
+
+std::vector<std::string> toStrings(const Containers::ArrayView<const Containers::ArrayView<const char>> views) {
+    std::vector<std::string> out;
+    for(const Containers::ArrayView<const char> view: views)
+        out.emplace_back(view, view.size());
+    return out;
+}
+
 ResourceTest::ResourceTest() {
     addTests({&ResourceTest::compile,
               &ResourceTest::compileNothing,
               &ResourceTest::compileEmptyFile,
+              &ResourceTest::compileStringLiterals,
+              &ResourceTest::compileStringLiteralsEmptyFile,
 
               &ResourceTest::compileFrom,
               &ResourceTest::compileFromUtf8Filenames,
@@ -76,19 +167,49 @@ ResourceTest::ResourceTest() {
               &ResourceTest::compileFromEmptyGroup,
               &ResourceTest::compileFromEmptyFilename,
               &ResourceTest::compileFromEmptyAlias,
+              &ResourceTest::compileFromCompressed,
+
+              &ResourceTest::compileBinary,
+              &ResourceTest::compileBinaryFrom,
+              &ResourceTest::compileBinaryDuplicates,
 
               &ResourceTest::hasGroup,
               &ResourceTest::list,
               &ResourceTest::get,
               &ResourceTest::getEmptyFile,
               &ResourceTest::getNonexistent,
+              &ResourceTest::getNullFilename,
               &ResourceTest::getNothing,
+              &ResourceTest::getStringLiterals,
+              &ResourceTest::getArrayView,
+              &ResourceTest::getCompressed,
 
               &ResourceTest::overrideGroup,
               &ResourceTest::overrideGroupFallback,
               &ResourceTest::overrideNonexistentFile,
               &ResourceTest::overrideNonexistentGroup,
-              &ResourceTest::overrideDifferentGroup});
+              &ResourceTest::overrideDifferentGroup,
+
+              &ResourceTest::registerPack,
+              &ResourceTest::registerPackFile,
+              &ResourceTest::registerPackEmptyFile,
+              &ResourceTest::registerPackInvalid,
+              &ResourceTest::registerPackAlreadyRegistered,
+              &ResourceTest::registerPackFileNonexistent});
+
+    addInstancedTests({&ResourceTest::compileFromParallel,
+                       &ResourceTest::compileFromParallelNonexistentFile},
+        Containers::arraySize(ParallelForData));
+
+    addInstancedTests({&ResourceTest::compressionRoundtrip},
+        Containers::arraySize(CompressionRoundtripData));
+
+    addTests({&ResourceTest::decompressInvalid});
+
+    addInstancedBenchmarks({&ResourceTest::benchmarkCompile}, 1,
+        Containers::arraySize(BenchmarkCompileData));
+
+    Directory::mkpath(RESOURCE_WRITE_TEST_DIR);
 }
 
 void ResourceTest::compile() {
@@ -115,6 +236,70 @@ void ResourceTest::compileEmptyFile() {
                        TestSuite::Compare::StringToFile);
 }
 
+void ResourceTest::compileStringLiterals() {
+    /* The output is also compiled into the test, checked in
+       getStringLiterals() */
+    CORRADE_COMPARE_AS(Resource::compile("ResourceTestStringLiteralsData", "literals", StringLiteralsInput, Resource::CompileFlag::StringLiterals),
+                       Directory::join(RESOURCE_TEST_DIR, "compiled-literals.cpp"),
+                       TestSuite::Compare::StringToFile);
+}
+
+void ResourceTest::compileStringLiteralsEmptyFile() {
+    /* Zero-length data array is not allowed, so it should be commented out
+       the same way as with hexadecimal output */
+    const std::string compiled = Resource::compile("ResourceTestData", "test", {{"empty.bin", ""}}, Resource::CompileFlag::StringLiterals);
+    CORRADE_VERIFY(compiled.find("static const unsigned char resourceFilenames[] =\n"
+        "    /* empty.bin */\n"
+        "    \"empty.bin\";\n\n"
+        "// static const unsigned char resourceData[] = {\n"
+        "    /* empty.bin */\n"
+        "// };\n\n") != std::string::npos);
+    CORRADE_VERIFY(compiled.find("resourceFilenames, nullptr);") != std::string::npos);
+}
+
+void ResourceTest::compileFromCompressed() {
+    const std::string compiled = Resource::compileFrom("ResourceTestCompressedData",
+        Directory::join(RESOURCE_TEST_DIR, "resources-compressed.conf"));
+    CORRADE_COMPARE_AS(compiled, Directory::join(RESOURCE_TEST_DIR, "compiled-compressed.cpp"),
+        TestSuite::Compare::StringToFile);
+}
+
+void ResourceTest::compileFromParallel() {
+    auto&& data = ParallelForData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The output should be the same as with a serial compilation */
+    CORRADE_COMPARE_AS(Resource::compileFrom("ResourceTestData",
+        Directory::join(RESOURCE_TEST_DIR, "resources.conf"), {}, data.parallelFor),
+        Directory::join(RESOURCE_TEST_DIR, "compiled.cpp"),
+        TestSuite::Compare::StringToFile);
+    CORRADE_COMPARE_AS(Resource::compileFrom("ResourceTestCompressedData",
+        Directory::join(RESOURCE_TEST_DIR, "resources-compressed.conf"), {}, data.parallelFor),
+        Directory::join(RESOURCE_TEST_DIR, "compiled-compressed.cpp"),
+        TestSuite::Compare::StringToFile);
+    CORRADE_COMPARE_AS(Resource::compile("ResourceTestStringLiteralsData", "literals", StringLiteralsInput, Resource::CompileFlag::StringLiterals, data.parallelFor),
+        Directory::join(RESOURCE_TEST_DIR, "compiled-literals.cpp"),
+        TestSuite::Compare::StringToFile);
+    CORRADE_COMPARE_AS(Resource::compileBinaryFrom(
+        Directory::join(RESOURCE_TEST_DIR, "resources.conf"), data.parallelFor),
+        Directory::join(RESOURCE_TEST_DIR, "compiled.pack"),
+        TestSuite::Compare::StringToFile);
+}
+
+void ResourceTest::compileFromParallelNonexistentFile() {
+    auto&& data = ParallelForData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    /* The first failing file should be reported, same as with a serial
+       compilation */
+    CORRADE_VERIFY(Resource::compileFrom("ResourceTestData",
+        Directory::join(RESOURCE_TEST_DIR, "resources-nonexistent-multiple.conf"), {}, data.parallelFor).empty());
+    CORRADE_COMPARE(out.str(), "    Error: cannot open file /nonexistent.dat of file 2 in group name\n");
+}
+
 void ResourceTest::compileFrom() {
     const std::string compiled = Resource::compileFrom("ResourceTestData",
         Directory::join(RESOURCE_TEST_DIR, "resources.conf"));
@@ -179,6 +364,35 @@ void ResourceTest::compileFromEmptyAlias() {
     CORRADE_COMPARE(out.str(), "    Error: filename or alias of file 1 in group name is empty\n");
 }
 
+void ResourceTest::compileBinary() {
+    /* Testing also null bytes and signed overflow, don't change binaries.
+       The files get sorted in the output. */
+    std::vector<std::pair<std::string, std::string>> input{
+        {"predisposition.bin", Directory::readString(Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"))},
+        {"consequence.bin", Directory::readString(Directory::join(RESOURCE_TEST_DIR, "consequence.bin"))}};
+    CORRADE_COMPARE_AS(Resource::compileBinary("test", input),
+                       Directory::join(RESOURCE_TEST_DIR, "compiled.pack"),
+                       TestSuite::Compare::StringToFile);
+}
+
+void ResourceTest::compileBinaryFrom() {
+    const std::string compiled = Resource::compileBinaryFrom(
+        Directory::join(RESOURCE_TEST_DIR, "resources.conf"));
+    CORRADE_COMPARE_AS(compiled, Directory::join(RESOURCE_TEST_DIR, "compiled.pack"),
+                       TestSuite::Compare::StringToFile);
+}
+
+void ResourceTest::compileBinaryDuplicates() {
+    /* The first occurence wins, same as with compiled-in resources */
+    const std::string pack = Resource::compileBinary("test", {
+        {"b", "first"},
+        {"a", "a"},
+        {"b", "second"}});
+    CORRADE_COMPARE(pack, Resource::compileBinary("test", {
+        {"a", "a"},
+        {"b", "first"}}));
+}
+
 void ResourceTest::hasGroup() {
     CORRADE_VERIFY(Resource::hasGroup("test"));
     CORRADE_VERIFY(!Resource::hasGroup("nonexistent"));
@@ -186,7 +400,7 @@ void ResourceTest::hasGroup() {
 
 void ResourceTest::list() {
     Resource r("test");
-    CORRADE_COMPARE_AS(r.list(),
+    CORRADE_COMPARE_AS(toStrings(r.list()),
                        (std::vector<std::string>{"consequence.bin", "predisposition.bin"}),
                        TestSuite::Compare::Container);
 }
@@ -201,6 +415,57 @@ void ResourceTest::get() {
                        TestSuite::Compare::StringToFile);
 }
 
+void ResourceTest::getStringLiterals() {
+    Resource r("literals");
+    CORRADE_COMPARE(toStrings(r.list()), (std::vector<std::string>{
+        "consequence.bin", "predisposition.bin", "quotes?\?=.txt"}));
+    for(const auto& file: StringLiteralsInput)
+        CORRADE_COMPARE(r.get(file.first), file.second);
+}
+
+void ResourceTest::getArrayView() {
+    Resource r("test");
+
+    /* The key doesn't need to be null-terminated */
+    const char filenames[] = "predisposition.binconsequence.bin";
+    const Containers::ArrayView<const char> predisposition = r.getRaw(Containers::ArrayView<const char>{filenames, 18});
+    const Containers::ArrayView<const char> consequence = r.getRaw(Containers::ArrayView<const char>{filenames + 18, 15});
+    CORRADE_COMPARE_AS(std::string(predisposition, predisposition.size()),
+                       Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"),
+                       TestSuite::Compare::StringToFile);
+    CORRADE_COMPARE_AS(r.get(Containers::ArrayView<const char>{filenames + 18, 15}),
+                       Directory::join(RESOURCE_TEST_DIR, "consequence.bin"),
+                       TestSuite::Compare::StringToFile);
+
+    /* The data point directly to the compiled-in data and the list is not
+       built anew every time */
+    CORRADE_COMPARE(static_cast<const void*>(consequence.data()), static_cast<const void*>(r.getRaw("consequence.bin").data()));
+    CORRADE_COMPARE(r.list().size(), 2);
+    CORRADE_COMPARE(static_cast<const void*>(r.list().data()), static_cast<const void*>(Resource{"test"}.list().data()));
+}
+
+void ResourceTest::getCompressed() {
+    Resource r("compressed");
+    CORRADE_COMPARE_AS(toStrings(r.list()),
+                       (std::vector<std::string>{"compressible.txt", "consequence.bin", "predisposition.bin"}),
+                       TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(r.get("compressible.txt"),
+                       Directory::join(RESOURCE_TEST_DIR, "compressible.txt"),
+                       TestSuite::Compare::StringToFile);
+    CORRADE_COMPARE_AS(r.get("predisposition.bin"),
+                       Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"),
+                       TestSuite::Compare::StringToFile);
+    CORRADE_COMPARE_AS(r.get("consequence.bin"),
+                       Directory::join(RESOURCE_TEST_DIR, "consequence.bin"),
+                       TestSuite::Compare::StringToFile);
+
+    /* The file is decompressed only once and then cached for the whole
+       group */
+    const Containers::ArrayView<const char> data = r.getRaw("compressible.txt");
+    CORRADE_COMPARE(static_cast<const void*>(data.data()), static_cast<const void*>(r.getRaw("compressible.txt").data()));
+    CORRADE_COMPARE(static_cast<const void*>(data.data()), static_cast<const void*>(Resource{"compressed"}.getRaw("compressible.txt").data()));
+}
+
 void ResourceTest::getEmptyFile() {
     Resource r("empty");
     CORRADE_VERIFY(!r.getRaw("empty.bin"));
@@ -230,6 +495,15 @@ void ResourceTest::getNonexistent() {
     CORRADE_VERIFY(!data.size());
 }
 
+void ResourceTest::getNullFilename() {
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    Resource r("test");
+    CORRADE_VERIFY(!r.getRaw(static_cast<const char*>(nullptr)));
+    CORRADE_COMPARE(out.str(), "Utility::Resource::getRaw(): filename can't be null\n");
+}
+
 void ResourceTest::getNothing() {
     std::ostringstream out;
     Error redirectError{&out};
@@ -302,6 +576,177 @@ void ResourceTest::overrideDifferentGroup() {
     CORRADE_COMPARE(out.str(), "Utility::Resource: overriden with different group, found 'wat' but expected 'test'\n");
 }
 
+void ResourceTest::registerPack() {
+    /* The data need to stay in scope for the whole registration lifetime */
+    const std::string pack = Resource::compileBinary("pack", {
+        {"predisposition.bin", Directory::readString(Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"))},
+        {"consequence.bin", Directory::readString(Directory::join(RESOURCE_TEST_DIR, "consequence.bin"))}});
+
+    CORRADE_VERIFY(!Resource::hasGroup("pack"));
+    CORRADE_VERIFY(Resource::registerPack({pack.data(), pack.size()}));
+    CORRADE_VERIFY(Resource::hasGroup("pack"));
+
+    {
+        Resource r("pack");
+        CORRADE_COMPARE_AS(toStrings(r.list()),
+                           (std::vector<std::string>{"consequence.bin", "predisposition.bin"}),
+                           TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(r.get("predisposition.bin"),
+                           Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"),
+                           TestSuite::Compare::StringToFile);
+        CORRADE_COMPARE_AS(r.get("consequence.bin"),
+                           Directory::join(RESOURCE_TEST_DIR, "consequence.bin"),
+                           TestSuite::Compare::StringToFile);
+
+        /* The data are not copied and the blobs are aligned */
+        const Containers::ArrayView<const char> data = r.getRaw("consequence.bin");
+        CORRADE_VERIFY(data.begin() >= pack.data() && data.end() <= pack.data() + pack.size());
+        CORRADE_COMPARE((data.begin() - pack.data()) % 16, 0);
+    }
+
+    Resource::unregisterPack("pack");
+    CORRADE_VERIFY(!Resource::hasGroup("pack"));
+}
+
+void ResourceTest::registerPackFile() {
+    const std::string filename = Directory::join(RESOURCE_WRITE_TEST_DIR, "file.pack");
+    CORRADE_VERIFY(Directory::writeString(filename, Resource::compileBinary("packFile", {
+        {"predisposition.bin", Directory::readString(Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"))},
+        {"consequence.bin", Directory::readString(Directory::join(RESOURCE_TEST_DIR, "consequence.bin"))}})));
+
+    CORRADE_VERIFY(Resource::registerPackFile(filename));
+
+    {
+        Resource r("packFile");
+        CORRADE_COMPARE_AS(r.get("predisposition.bin"),
+                           Directory::join(RESOURCE_TEST_DIR, "predisposition.bin"),
+                           TestSuite::Compare::StringToFile);
+        CORRADE_COMPARE_AS(r.get("consequence.bin"),
+                           Directory::join(RESOURCE_TEST_DIR, "consequence.bin"),
+                           TestSuite::Compare::StringToFile);
+        CORRADE_COMPARE(reinterpret_cast<std::uintptr_t>(r.getRaw("consequence.bin").data()) % 16, 0);
+    }
+
+    Resource::unregisterPack("packFile");
+    CORRADE_VERIFY(!Resource::hasGroup("packFile"));
+}
+
+void ResourceTest::registerPackEmptyFile() {
+    const std::string pack = Resource::compileBinary("packEmpty", {{"empty.bin", ""}});
+    CORRADE_VERIFY(Resource::registerPack({pack.data(), pack.size()}));
+
+    {
+        Resource r("packEmpty");
+        CORRADE_VERIFY(!r.getRaw("empty.bin"));
+        CORRADE_COMPARE(r.get("empty.bin"), "");
+    }
+
+    Resource::unregisterPack("packEmpty");
+}
+
+void ResourceTest::registerPackInvalid() {
+    std::string pack = Resource::compileBinary("packInvalid", {{"a.txt", "hello"}});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    std::string invalidSignature = pack;
+    invalidSignature[1] = 'X';
+    CORRADE_VERIFY(!Resource::registerPack({invalidSignature.data(), invalidSignature.size()}));
+    CORRADE_VERIFY(!Resource::registerPack({pack.data(), 15}));
+
+    std::string invalidVersion = pack;
+    invalidVersion[4] = 2;
+    CORRADE_VERIFY(!Resource::registerPack({invalidVersion.data(), invalidVersion.size()}));
+
+    std::string invalidEndianness = pack;
+    invalidEndianness[5] ^= 1;
+    CORRADE_VERIFY(!Resource::registerPack({invalidEndianness.data(), invalidEndianness.size()}));
+
+    /* Group size that would wrap around when aligned */
+    std::string invalidGroupSize = pack;
+    invalidGroupSize.replace(12, 4, "\xff\xff\xff\xff");
+    CORRADE_VERIFY(!Resource::registerPack({invalidGroupSize.data(), invalidGroupSize.size()}));
+
+    /* Header + group name + part of the index */
+    CORRADE_VERIFY(!Resource::registerPack({pack.data(), 16 + 12 + 8}));
+
+    /* Data of the file cut off */
+    CORRADE_VERIFY(!Resource::registerPack({pack.data(), pack.size() - 1}));
+
+    CORRADE_VERIFY(!Resource::hasGroup("packInvalid"));
+    CORRADE_COMPARE(out.str(),
+        "Utility::Resource::registerPack(): invalid pack signature\n"
+        "Utility::Resource::registerPack(): invalid pack signature\n"
+        "Utility::Resource::registerPack(): unsupported pack version 2\n"
+        "Utility::Resource::registerPack(): pack endianness doesn't match the platform\n"
+        "Utility::Resource::registerPack(): group name out of bounds\n"
+        "Utility::Resource::registerPack(): pack index out of bounds\n"
+        "Utility::Resource::registerPack(): file 0 out of bounds\n");
+}
+
+void ResourceTest::registerPackAlreadyRegistered() {
+    const std::string pack = Resource::compileBinary("test", {{"a.txt", "hello"}});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!Resource::registerPack({pack.data(), pack.size()}));
+    CORRADE_COMPARE(out.str(), "Utility::Resource::registerPack(): group 'test' is already registered\n");
+}
+
+void ResourceTest::registerPackFileNonexistent() {
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!Resource::registerPackFile("nonexistent.pack"));
+    CORRADE_COMPARE(out.str(), "Utility::Directory::mapRead(): can't open nonexistent.pack\n"
+        "Utility::Resource::registerPackFile(): cannot read nonexistent.pack\n");
+}
+
+void ResourceTest::compressionRoundtrip() {
+    auto&& data = CompressionRoundtripData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string compressed = Implementation::lz4Compress(data.data.data(), data.data.size());
+    std::string decompressed(data.data.size(), '\0');
+    CORRADE_VERIFY(Implementation::lz4Decompress(compressed.data(), compressed.size(), &decompressed[0], decompressed.size()));
+    CORRADE_COMPARE(decompressed, data.data);
+}
+
+void ResourceTest::decompressInvalid() {
+    const std::string data = std::string(1000, 'a') + "bcdefghijklmnop";
+    const std::string compressed = Implementation::lz4Compress(data.data(), data.size());
+    CORRADE_VERIFY(compressed.size() < 100);
+
+    std::string out(data.size(), '\0');
+
+    /* Truncated input */
+    CORRADE_VERIFY(!Implementation::lz4Decompress(compressed.data(), compressed.size() - 1, &out[0], out.size()));
+    CORRADE_VERIFY(!Implementation::lz4Decompress(compressed.data(), 3, &out[0], out.size()));
+
+    /* Output size doesn't match */
+    CORRADE_VERIFY(!Implementation::lz4Decompress(compressed.data(), compressed.size(), &out[0], out.size() - 1));
+    CORRADE_VERIFY(!Implementation::lz4Decompress(compressed.data(), compressed.size(), &out[0], out.size() + 1));
+
+    /* Match offset pointing before the output start */
+    const char invalidOffset[]{'\x14', 'a', '\x02', '\x00', '\x00'};
+    CORRADE_VERIFY(!Implementation::lz4Decompress(invalidOffset, sizeof(invalidOffset), &out[0], 10));
+}
+
+void ResourceTest::benchmarkCompile() {
+    auto&& data = BenchmarkCompileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* 64 MB of pseudorandom data with a mixture of printable and
+       non-printable characters */
+    const std::vector<std::pair<std::string, std::string>> files{{"data.bin", randomData(64*1024*1024)}};
+
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1)
+        size += Resource::compile("ResourceTestBenchmarkData", "benchmark", files, data.flags).size();
+
+    CORRADE_VERIFY(size > files[0].second.size());
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::ResourceTest)
@@ -0,0 +1,67 @@
+/* Compiled resource file. DO NOT EDIT! */
+
+#include "Corrade/Corrade.h"
+#include "Corrade/Utility/Macros.h"
+#include "Corrade/Utility/Resource.h"
+
+CORRADE_ALIGNAS(4) static const unsigned char resourcePositions[] = {
+    0x10,0x00,0x00,0x00,
+    0xb2,0x00,0x00,0x00,
+    0x22,0x00,0x00,0x00,
+    0xba,0x00,0x00,0x00,
+    0x31,0x00,0x00,0x00,
+    0xc2,0x00,0x00,0x00
+};
+
+CORRADE_ALIGNAS(4) static const unsigned char resourceUncompressedSizes[] = {
+    0xf0,0x01,0x00,0x00,
+    0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00
+};
+
+static const unsigned char resourceFilenames[] = {
+    /* compressible.txt */
+    0x63,0x6f,0x6d,0x70,0x72,0x65,0x73,0x73,0x69,0x62,0x6c,0x65,0x2e,0x74,0x78,
+    0x74,
+
+    /* predisposition.bin */
+    0x70,0x72,0x65,0x64,0x69,0x73,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2e,
+    0x62,0x69,0x6e,
+
+    /* consequence.bin */
+    0x63,0x6f,0x6e,0x73,0x65,0x71,0x75,0x65,0x6e,0x63,0x65,0x2e,0x62,0x69,0x6e
+};
+
+static const unsigned char resourceData[] = {
+    /* compressible.txt */
+    0xf2,0x57,0x4c,0x6f,0x72,0x65,0x6d,0x20,0x69,0x70,0x73,0x75,0x6d,0x20,0x64,
+    0x6f,0x6c,0x6f,0x72,0x20,0x73,0x69,0x74,0x20,0x61,0x6d,0x65,0x74,0x2c,0x20,
+    0x63,0x6f,0x6e,0x73,0x65,0x63,0x74,0x65,0x74,0x75,0x72,0x20,0x61,0x64,0x69,
+    0x70,0x69,0x73,0x63,0x69,0x6e,0x67,0x20,0x65,0x6c,0x69,0x74,0x2c,0x20,0x73,
+    0x65,0x64,0x20,0x64,0x6f,0x20,0x65,0x69,0x75,0x73,0x6d,0x6f,0x64,0x0a,0x74,
+    0x65,0x6d,0x70,0x6f,0x72,0x20,0x69,0x6e,0x63,0x69,0x64,0x69,0x64,0x75,0x6e,
+    0x74,0x20,0x75,0x74,0x20,0x6c,0x61,0x62,0x6f,0x72,0x65,0x20,0x65,0x74,0x5b,
+    0x00,0xff,0x01,0x65,0x20,0x6d,0x61,0x67,0x6e,0x61,0x20,0x61,0x6c,0x69,0x71,
+    0x75,0x61,0x2e,0x20,0x7c,0x00,0x02,0x1f,0x0a,0x7c,0x00,0x1e,0x1f,0x20,0x7c,
+    0x00,0x08,0x1f,0x0a,0x7c,0x00,0x1a,0x0f,0xf8,0x00,0x0a,0x1f,0x0a,0xf8,0x00,
+    0x01,0x0f,0x7c,0x00,0x09,0x0f,0xf8,0x00,0x05,0x1f,0x0a,0xf8,0x00,0x02,0x0f,
+    0x7c,0x00,0x0a,0x0f,0x74,0x01,0x32,0x50,0x71,0x75,0x61,0x2e,0x0a,
+
+    /* predisposition.bin */
+    0xba,0xdc,0x0f,0xfe,0xeb,0xad,0xf0,0x0d,
+
+    /* consequence.bin */
+    0xd1,0x5e,0xa5,0xed,0xea,0xdd,0x00,0x0d
+};
+
+int resourceInitializer_ResourceTestCompressedData();
+int resourceInitializer_ResourceTestCompressedData() {
+    Corrade::Utility::Resource::registerData("compressed", 3, resourcePositions, resourceFilenames, resourceData, resourceUncompressedSizes);
+    return 1;
+} CORRADE_AUTOMATIC_INITIALIZER(resourceInitializer_ResourceTestCompressedData)
+
+int resourceFinalizer_ResourceTestCompressedData();
+int resourceFinalizer_ResourceTestCompressedData() {
+    Corrade::Utility::Resource::unregisterData("compressed");
+    return 1;
+} CORRADE_AUTOMATIC_FINALIZER(resourceFinalizer_ResourceTestCompressedData)
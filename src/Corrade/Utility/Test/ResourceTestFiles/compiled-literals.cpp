@@ -0,0 +1,46 @@
+/* Compiled resource file. DO NOT EDIT! */
+
+#include "Corrade/Corrade.h"
+#include "Corrade/Utility/Macros.h"
+#include "Corrade/Utility/Resource.h"
+
+CORRADE_ALIGNAS(4) static const unsigned char resourcePositions[] = {
+    0x12,0x00,0x00,0x00,
+    0x08,0x00,0x00,0x00,
+    0x21,0x00,0x00,0x00,
+    0x10,0x00,0x00,0x00,
+    0x2e,0x00,0x00,0x00,
+    0x1d,0x00,0x00,0x00
+};
+
+static const unsigned char resourceFilenames[] =
+    /* predisposition.bin */
+    "predisposition.bin"
+
+    /* consequence.bin */
+    "consequence.bin"
+
+    /* quotes??=.txt */
+    "quotes\077\077=.txt";
+
+static const unsigned char resourceData[] =
+    /* predisposition.bin */
+    "\272\334\017\376\353\255\360\015"
+
+    /* consequence.bin */
+    "\321^\245\355\352\335\000\015"
+
+    /* quotes??=.txt */
+    "\042Why\077\042 \134 \00123\012";
+
+int resourceInitializer_ResourceTestStringLiteralsData();
+int resourceInitializer_ResourceTestStringLiteralsData() {
+    Corrade::Utility::Resource::registerData("literals", 3, resourcePositions, resourceFilenames, resourceData);
+    return 1;
+} CORRADE_AUTOMATIC_INITIALIZER(resourceInitializer_ResourceTestStringLiteralsData)
+
+int resourceFinalizer_ResourceTestStringLiteralsData();
+int resourceFinalizer_ResourceTestStringLiteralsData() {
+    Corrade::Utility::Resource::unregisterData("literals");
+    return 1;
+} CORRADE_AUTOMATIC_FINALIZER(resourceFinalizer_ResourceTestStringLiteralsData)
@@ -43,7 +43,44 @@ struct Sha1Test: TestSuite::Tester {
     void twoBlockPadding();
 
     void iterative();
+    void iterativeArrayView();
     void reuse();
+    void literal();
+
+    void kernel();
+    void multiple();
+    void multipleEmpty();
+
+    void benchmark();
+    void benchmarkPieces();
+    void benchmarkMultiple();
+};
+
+constexpr struct {
+    const char* name;
+    Implementation::Sha1Kernel kernel;
+} KernelData[] {
+    {"scalar", Implementation::Sha1Kernel::Scalar},
+    {"SHA-NI", Implementation::Sha1Kernel::ShaNi},
+    {"ARMv8 crypto", Implementation::Sha1Kernel::ArmCrypto}
+};
+
+constexpr struct {
+    const char* name;
+    std::size_t size;
+} PieceData[] {
+    {"1 B", 1},
+    {"63 B", 63},
+    {"4 kB", 4096},
+    {"1 MB", 1024*1024}
+};
+
+constexpr struct {
+    const char* name;
+    Implementation::Sha1MultiBufferKernel kernel;
+} MultiBufferKernelData[] {
+    {"serial", Implementation::Sha1MultiBufferKernel::Serial},
+    {"AVX2", Implementation::Sha1MultiBufferKernel::Avx2}
 };
 
 Sha1Test::Sha1Test() {
@@ -52,9 +89,28 @@ Sha1Test::Sha1Test() {
               &Sha1Test::exactOneBlockPadding,
               &Sha1Test::twoBlockPadding});
 
-    addRepeatedTests({&Sha1Test::iterative}, 128);
+    addRepeatedTests({&Sha1Test::iterative,
+                      &Sha1Test::iterativeArrayView}, 128);
 
-    addTests({&Sha1Test::reuse});
+    addTests({&Sha1Test::reuse,
+              &Sha1Test::literal});
+
+    addInstancedTests({&Sha1Test::kernel},
+        Containers::arraySize(KernelData));
+
+    addInstancedTests({&Sha1Test::multiple},
+        Containers::arraySize(MultiBufferKernelData));
+
+    addTests({&Sha1Test::multipleEmpty});
+
+    addInstancedBenchmarks({&Sha1Test::benchmark}, 10,
+        Containers::arraySize(KernelData));
+
+    addInstancedBenchmarks({&Sha1Test::benchmarkPieces}, 10,
+        Containers::arraySize(PieceData));
+
+    addInstancedBenchmarks({&Sha1Test::benchmarkMultiple}, 10,
+        Containers::arraySize(MultiBufferKernelData));
 }
 
 void Sha1Test::emptyString() {
@@ -98,6 +154,14 @@ void Sha1Test::iterative() {
     CORRADE_COMPARE(hasher.digest(), Sha1::Digest::fromHexString("cd36b370758a259b34845084a6cc38473cb95e27"));
 }
 
+void Sha1Test::iterativeArrayView() {
+    Sha1 hasher;
+    for(std::size_t offset = 0; offset < String.size(); offset += testCaseRepeatId() + 1)
+        hasher << String.slice(offset, std::min(offset + testCaseRepeatId() + 1, String.size()));
+
+    CORRADE_COMPARE(hasher.digest(), Sha1::Digest::fromHexString("cd36b370758a259b34845084a6cc38473cb95e27"));
+}
+
 void Sha1Test::reuse() {
     Sha1 hasher;
     hasher << std::string{String.data(), String.size()};
@@ -111,6 +175,134 @@ void Sha1Test::reuse() {
     CORRADE_COMPARE(hasher.digest(), Sha1::Digest::fromHexString("cd36b370758a259b34845084a6cc38473cb95e27"));
 }
 
+void Sha1Test::literal() {
+    /* The null terminator shouldn't be included */
+    CORRADE_COMPARE(Sha1::digest("123456789a123456789b123456789c123456789d123456789e12345"),
+        Sha1::digest(std::string{"123456789a123456789b123456789c123456789d123456789e12345"}));
+    CORRADE_COMPARE((Sha1{} << "").digest(),
+        Sha1::Digest::fromHexString("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+}
+
+void Sha1Test::kernel() {
+    const auto& data = KernelData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!Implementation::sha1KernelSupported(data.kernel))
+        CORRADE_SKIP("Not supported on this platform.");
+
+    /* Process all full chunks with the kernel under test and the rest with
+       the default implementation, the result should be the same */
+    const std::size_t chunkCount = String.size()/64;
+    unsigned int digest[5]{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    Implementation::sha1ProcessChunks(data.kernel, digest, String.data(), chunkCount);
+
+    unsigned int expected[5]{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    Implementation::sha1ProcessChunks(Implementation::Sha1Kernel::Scalar, expected, String.data(), chunkCount);
+
+    CORRADE_COMPARE(digest[0], expected[0]);
+    CORRADE_COMPARE(digest[1], expected[1]);
+    CORRADE_COMPARE(digest[2], expected[2]);
+    CORRADE_COMPARE(digest[3], expected[3]);
+    CORRADE_COMPARE(digest[4], expected[4]);
+
+    /* The default kernel should give the same result through the public
+       API */
+    CORRADE_COMPARE(Sha1::digest(std::string{String.data(), String.size()}),
+        Sha1::Digest::fromHexString("cd36b370758a259b34845084a6cc38473cb95e27"));
+}
+
+void Sha1Test::multiple() {
+    const auto& data = MultiBufferKernelData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!Implementation::sha1MultiBufferKernelSupported(data.kernel))
+        CORRADE_SKIP("Not supported on this platform.");
+
+    /* Prefixes of all sizes of the test string, in an order that's not
+       sorted by size and with a count that's not divisible by eight so all
+       corner cases of the lane grouping get tested */
+    Containers::Array<Containers::ArrayView<const char>> inputs{String.size() + 1};
+    for(std::size_t i = 0; i != inputs.size(); ++i)
+        inputs[i] = String.prefix((i*7) % (String.size() + 1));
+
+    Containers::Array<Sha1::Digest> digests{inputs.size()};
+    Implementation::sha1DigestMultiBuffer(data.kernel, inputs, reinterpret_cast<char*>(digests.data()));
+
+    for(std::size_t i = 0; i != inputs.size(); ++i)
+        CORRADE_COMPARE(digests[i], Sha1::digest(inputs[i]));
+
+    /* The default kernel should give the same result through the public
+       API */
+    Containers::Array<Sha1::Digest> defaultDigests = Sha1::digest(inputs);
+    CORRADE_COMPARE(defaultDigests.size(), inputs.size());
+    for(std::size_t i = 0; i != inputs.size(); ++i)
+        CORRADE_COMPARE(defaultDigests[i], digests[i]);
+}
+
+void Sha1Test::multipleEmpty() {
+    CORRADE_VERIFY(Sha1::digest(Containers::ArrayView<const Containers::ArrayView<const char>>{}).empty());
+}
+
+void Sha1Test::benchmark() {
+    const auto& data = KernelData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!Implementation::sha1KernelSupported(data.kernel))
+        CORRADE_SKIP("Not supported on this platform.");
+
+    /* Hashing 1 MB of data, so the measured time is directly the time it
+       takes to process a megabyte */
+    Containers::Array<char> bytes{Containers::ValueInit, 1024*1024};
+    for(std::size_t i = 0; i != bytes.size(); ++i)
+        bytes[i] = char(i*37);
+
+    unsigned int digest[5]{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    CORRADE_BENCHMARK(1)
+        Implementation::sha1ProcessChunks(data.kernel, digest, bytes.data(), bytes.size()/64);
+
+    CORRADE_VERIFY(digest[0] || digest[1] || digest[2] || digest[3] || digest[4]);
+}
+
+void Sha1Test::benchmarkPieces() {
+    const auto& data = PieceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Feeding 1 MB of data in pieces of given size */
+    Containers::Array<char> bytes{Containers::ValueInit, 1024*1024};
+    for(std::size_t i = 0; i != bytes.size(); ++i)
+        bytes[i] = char(i*37);
+
+    Sha1 hasher;
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t offset = 0; offset < bytes.size(); offset += data.size)
+            hasher << bytes.slice(offset, std::min(offset + data.size, bytes.size()));
+    }
+
+    CORRADE_VERIFY(hasher.digest() != Sha1::Digest{});
+}
+
+void Sha1Test::benchmarkMultiple() {
+    const auto& data = MultiBufferKernelData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!Implementation::sha1MultiBufferKernelSupported(data.kernel))
+        CORRADE_SKIP("Not supported on this platform.");
+
+    /* 4096 inputs of 64 to 319 bytes */
+    Containers::Array<char> bytes{Containers::ValueInit, 4097*256};
+    for(std::size_t i = 0; i != bytes.size(); ++i)
+        bytes[i] = char(i*37);
+    Containers::Array<Containers::ArrayView<const char>> inputs{4096};
+    for(std::size_t i = 0; i != inputs.size(); ++i)
+        inputs[i] = bytes.slice(i*256, i*256 + 64 + (i*13) % 256);
+
+    Containers::Array<Sha1::Digest> digests{inputs.size()};
+    CORRADE_BENCHMARK(1)
+        Implementation::sha1DigestMultiBuffer(data.kernel, inputs, reinterpret_cast<char*>(digests.data()));
+
+    CORRADE_COMPARE(digests[17], Sha1::digest(inputs[17]));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Corrade::Utility::Test::Sha1Test)
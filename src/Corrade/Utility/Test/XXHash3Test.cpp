@@ -0,0 +1,391 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+
+#include "Corrade/Containers/Array.h"
+#include "Corrade/TestSuite/Tester.h"
+#include "Corrade/Utility/MurmurHash2.h"
+#include "Corrade/Utility/Sha1.h"
+#include "Corrade/Utility/XXHash3.h"
+
+namespace Corrade { namespace Utility { namespace Test { namespace {
+
+struct XXHash3Test: TestSuite::Tester {
+    explicit XXHash3Test();
+
+    void digest64();
+    void digest128();
+    void iterative64();
+    void iterative128();
+    void reuse();
+    void literal();
+    void literalConstexpr();
+
+    void benchmarkXXHash3x64();
+    void benchmarkXXHash3x128();
+    void benchmarkMurmurHash2();
+    void benchmarkSha1();
+};
+
+/* Reference digests calculated with the xxHash library, for data filled with
+   the same pattern as in data() below. Covers all code paths and their
+   boundaries. */
+constexpr struct {
+    std::size_t size;
+    const char* digest64;
+    const char* digest64Seeded;
+    const char* digest128;
+    const char* digest128Seeded;
+} ReferenceData[] {
+    {0, "2d06800538d394c2", "602b0e2cd6662c8b",
+        "99aa06d3014798d86001c324468d497f",
+        "d142977a2cca554b4ca5176998171787"},
+    {1, "8a21d78b1538b1c0", "30e3e5af4b171b5b",
+        "79d2c79e874f72cd8a21d78b1538b1c0",
+        "96e7ba58e13cb0ad30e3e5af4b171b5b"},
+    {2, "51a687ed1e9ceea7", "6f51161e1a76f12c",
+        "3cd3b8bcc3b7990f51a687ed1e9ceea7",
+        "4920a9c90cb52bfb6f51161e1a76f12c"},
+    {3, "b7e23e9c1ad24e4b", "3fec8b5afc0b6938",
+        "4f9954a896acfbd8b7e23e9c1ad24e4b",
+        "61ee2ece7074769f3fec8b5afc0b6938"},
+    {4, "3fc0c554cc1bfd24", "18138666502e18da",
+        "af1b419a8ddc87f652bbd0c712381014",
+        "0269b699ab316765ed0964728c151833"},
+    {7, "c3f8d792dd3799d8", "807663f0a7143402",
+        "8cf8bad19172c4e0a89ebe4ad9947cb5",
+        "de21b76bcd8653999812b437d4ef9476"},
+    {8, "8e9d87b2621686c2", "5bd9aef540099c40",
+        "eee0a0dadb25d3106c2266d17e099079",
+        "5ecad17ab399c5d6ea826853fdef6bbd"},
+    {9, "d78b2e5e6eee1a29", "e0941413093e1110",
+        "d23c8913cb9d50252e72f92915271a59",
+        "529eed88194156b707f0fdc673b74f46"},
+    {15, "707855fafaad9bd1", "1e8a944602f1f486",
+        "de28d4c059e8632c063f23aa88b8e01d",
+        "091d7e2c953055d849d5bccd23fb8af7"},
+    {16, "2255ac040382fb28", "ae3166cef3da7aa2",
+        "8125e3ecc5edefae7752b788b476b433",
+        "87cc241a448f47eb7cfea6c14acce471"},
+    {17, "80297144ea363493", "eb676bac156e641a",
+        "b78b58b8131963349f8529371239a893",
+        "9f31f435859da359d71228c7d3fc7376"},
+    {32, "16fee2662e59e552", "f64a201c4210479e",
+        "06ab8a9970bed88c0cafb981442713b1",
+        "a4a78fb5e4cf9da1357f98cd1ef88c06"},
+    {33, "b3448912bbd87087", "0ad8fa4d48d1f249",
+        "18e5b7663ffb61b9e8963e6b8bdb3d13",
+        "e21027b53ccf060fa52b1f70dac84e33"},
+    {64, "6bac8aff06c2031b", "a9a5ffeb849628cc",
+        "8d12b3d0cb863a69c644796ee16fbb4a",
+        "536063a429bd09ff8548898a76f31221"},
+    {65, "fa378035e9d04f75", "7b6927e3b78b760d",
+        "1dff71fd7c80b7b3ceab95f20c988acb",
+        "712224d2f266b6dbf0a293273ce43171"},
+    {96, "58d628124d830ab0", "080a8e43191ae395",
+        "40dc2ba48b6def23e5ce8b0c58467b78",
+        "c60c19a0ac39115c1bef48a82a59d26e"},
+    {97, "d4ac9d5aab7bf154", "7ac69dbded90f617",
+        "a616f9b2ffbc6e6e13ee58a779f57315",
+        "9dde8e59aa898318a996048e2f41f8ac"},
+    {128, "a03b5825ff901dc3", "0fad73038d400f90",
+        "d23df5aaea0b61dc9d7b73bb6311487a",
+        "72fd40862a1d457c9405553a05255029"},
+    {129, "41ec3e4722a25af7", "6fd4822e61eaacd5",
+        "56afb4345d259ddc64e832264f95c4fc",
+        "13d1afd6de95ec7c652d9ee8ac056504"},
+    {159, "05b5b42aa9da0bd5", "ebec05a5df237999",
+        "06b786ab87ce10f84837363db3c7649c",
+        "ee386d5654eb63835393500f770562c4"},
+    {160, "921cb0ac7bd2ab03", "7c760022a4c96087",
+        "5da349d390c5eb813514de626002b6c0",
+        "058c5285b2103935b7ef7b1e9040d68e"},
+    {191, "9bfe342eb48c0315", "52e249628f9cc622",
+        "281f50741833ac6c93f14748ceb8de5a",
+        "09fd6dfebfd9d1b22611b5577848a3a1"},
+    {192, "acafc4cba410b189", "46ea2ea20c7dbac8",
+        "eead0d20afac804c9e1fc5b2dfed79e1",
+        "d6bd3d0f9a66c57eb7196752f215cc89"},
+    {240, "38b97a24f68efc13", "d4dda5f8c94e6be0",
+        "7d8b4b8353e7cf75573f933fdb17e57a",
+        "fcd7bdddc109152c7c4195ee4e264817"},
+    {241, "a59556a86c6a6ea6", "3e2657c9a5892ce5",
+        "f819661966936645a59556a86c6a6ea6",
+        "78a2e5e2dbaecf483e2657c9a5892ce5"},
+    {255, "ff0daaec3864e03e", "a32156e728b52a63",
+        "d8be70ede254364dff0daaec3864e03e",
+        "e26701b951d5e0d1a32156e728b52a63"},
+    {256, "a778510b7ac1383e", "d8e4f4b286f67dbf",
+        "7dd1be33fbfa02e2a778510b7ac1383e",
+        "529ffa7f32fa929dd8e4f4b286f67dbf"},
+    {1023, "611e946468eda60d", "dc107953f93d614c",
+        "4e1fd364a57622f5611e946468eda60d",
+        "6adcbf44d177f1c2dc107953f93d614c"},
+    {1024, "f9c1054610f5a6a3", "f718a3782af76ac2",
+        "962589ec3e4a772ff9c1054610f5a6a3",
+        "e3006691357da361f718a3782af76ac2"},
+    {1025, "67372fe80e1bef4f", "566d53c06ea56df0",
+        "d5ce7481b597034567372fe80e1bef4f",
+        "3d3726404817b75b566d53c06ea56df0"},
+    {2111, "5ac39cd1826f9024", "98591bedc310558a",
+        "47dd692769833c265ac39cd1826f9024",
+        "c69ce8818e050b8798591bedc310558a"},
+    {5000, "ec87cfeee2fc5df7", "46776d9dbe7c58bc",
+        "e58a9b98eed74d48ec87cfeee2fc5df7",
+        "928be2cb0a17a1a946776d9dbe7c58bc"},
+    {100000, "806b2ff4d823e1cc", "107626c0433eed42",
+        "39ad9805d87c2ff3806b2ff4d823e1cc",
+        "466c3c57fe2ffe01107626c0433eed42"},
+};
+
+constexpr unsigned long long Seed = 0x9e3779b97f4a7c15ull;
+
+constexpr struct {
+    const char* name;
+    std::size_t size;
+} PieceData[] {
+    {"1 B", 1},
+    {"63 B", 63},
+    {"64 B", 64},
+    {"255 B", 255},
+    {"257 B", 257},
+    {"1 kB", 1024},
+    {"4 kB + 1 B", 4097}
+};
+
+constexpr struct {
+    const char* name;
+    std::size_t size;
+} BenchmarkData[] {
+    {"16 B", 16},
+    {"240 B", 240},
+    {"4 kB", 4096},
+    {"1 MB", 1024*1024}
+};
+
+XXHash3Test::XXHash3Test() {
+    addInstancedTests({&XXHash3Test::digest64,
+                       &XXHash3Test::digest128},
+        Containers::arraySize(ReferenceData));
+
+    addInstancedTests({&XXHash3Test::iterative64,
+                       &XXHash3Test::iterative128},
+        Containers::arraySize(PieceData));
+
+    addTests({&XXHash3Test::reuse,
+              &XXHash3Test::literal,
+              &XXHash3Test::literalConstexpr});
+
+    addInstancedBenchmarks({&XXHash3Test::benchmarkXXHash3x64,
+                            &XXHash3Test::benchmarkXXHash3x128,
+                            &XXHash3Test::benchmarkMurmurHash2,
+                            &XXHash3Test::benchmarkSha1}, 10,
+        Containers::arraySize(BenchmarkData));
+}
+
+Containers::Array<char> data(std::size_t size) {
+    Containers::Array<char> out{Containers::NoInit, size};
+    for(std::size_t i = 0; i != size; ++i)
+        out[i] = char(i*7 + 13);
+    return out;
+}
+
+void XXHash3Test::digest64() {
+    const auto& data = ReferenceData[testCaseInstanceId()];
+    setTestCaseDescription(std::to_string(data.size));
+
+    Containers::Array<char> bytes = Test::data(data.size);
+    CORRADE_COMPARE(XXHash3<8>::digest(bytes),
+        XXHash3<8>::Digest::fromHexString(data.digest64));
+    CORRADE_COMPARE(XXHash3<8>::digest(bytes, Seed),
+        XXHash3<8>::Digest::fromHexString(data.digest64Seeded));
+
+    /* Streaming all at once should give the same result */
+    CORRADE_COMPARE((XXHash3<8>{} << bytes).digest(),
+        XXHash3<8>::Digest::fromHexString(data.digest64));
+    CORRADE_COMPARE((XXHash3<8>{Seed} << bytes).digest(),
+        XXHash3<8>::Digest::fromHexString(data.digest64Seeded));
+}
+
+void XXHash3Test::digest128() {
+    const auto& data = ReferenceData[testCaseInstanceId()];
+    setTestCaseDescription(std::to_string(data.size));
+
+    Containers::Array<char> bytes = Test::data(data.size);
+    CORRADE_COMPARE(XXHash3<16>::digest(bytes),
+        XXHash3<16>::Digest::fromHexString(data.digest128));
+    CORRADE_COMPARE(XXHash3<16>::digest(bytes, Seed),
+        XXHash3<16>::Digest::fromHexString(data.digest128Seeded));
+
+    CORRADE_COMPARE((XXHash3<16>{} << bytes).digest(),
+        XXHash3<16>::Digest::fromHexString(data.digest128));
+    CORRADE_COMPARE((XXHash3<16>{Seed} << bytes).digest(),
+        XXHash3<16>::Digest::fromHexString(data.digest128Seeded));
+}
+
+void XXHash3Test::iterative64() {
+    const auto& data = PieceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Check every few sizes from the reference data, fed in pieces */
+    for(std::size_t i = 0; i < Containers::arraySize(ReferenceData); i += 3) {
+        Containers::Array<char> bytes = Test::data(ReferenceData[i].size);
+        XXHash3<8> hasher{Seed};
+        for(std::size_t offset = 0; offset < bytes.size(); offset += data.size)
+            hasher << bytes.slice(offset, std::min(offset + data.size, bytes.size()));
+        CORRADE_COMPARE(hasher.digest(),
+            XXHash3<8>::Digest::fromHexString(ReferenceData[i].digest64Seeded));
+    }
+}
+
+void XXHash3Test::iterative128() {
+    const auto& data = PieceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    for(std::size_t i = 0; i < Containers::arraySize(ReferenceData); i += 3) {
+        Containers::Array<char> bytes = Test::data(ReferenceData[i].size);
+        XXHash3<16> hasher;
+        for(std::size_t offset = 0; offset < bytes.size(); offset += data.size)
+            hasher << bytes.slice(offset, std::min(offset + data.size, bytes.size()));
+        CORRADE_COMPARE(hasher.digest(),
+            XXHash3<16>::Digest::fromHexString(ReferenceData[i].digest128));
+    }
+}
+
+void XXHash3Test::reuse() {
+    Containers::Array<char> bytes = data(5000);
+
+    /* Calling digest() resets the state, but not the seed */
+    XXHash3<8> hasher{Seed};
+    hasher << bytes;
+    CORRADE_COMPARE(hasher.digest(),
+        XXHash3<8>::Digest::fromHexString("46776d9dbe7c58bc"));
+    hasher << bytes.prefix(9);
+    CORRADE_COMPARE(hasher.digest(),
+        XXHash3<8>::Digest::fromHexString("e0941413093e1110"));
+    CORRADE_COMPARE(hasher.digest(),
+        XXHash3<8>::Digest::fromHexString("602b0e2cd6662c8b"));
+}
+
+void XXHash3Test::literal() {
+    /* The null terminator isn't included */
+    CORRADE_COMPARE(XXHash3<8>::digest(""),
+        XXHash3<8>::Digest::fromHexString("2d06800538d394c2"));
+    CORRADE_COMPARE(XXHash3<8>::digest("hello"),
+        XXHash3<8>::Digest::fromHexString("9555e8555c62dcfd"));
+    CORRADE_COMPARE(XXHash3<8>::digest("hello", 1),
+        XXHash3<8>::Digest::fromHexString("74b07ed397a89e92"));
+    CORRADE_COMPARE(XXHash3<8>::digest(std::string{"hello"}),
+        XXHash3<8>::Digest::fromHexString("9555e8555c62dcfd"));
+    CORRADE_COMPARE((XXHash3<8>{} << "hel" << std::string{"lo"}).digest(),
+        XXHash3<8>::Digest::fromHexString("9555e8555c62dcfd"));
+    CORRADE_COMPARE(XXHash3<16>::digest("hello"),
+        XXHash3<16>::Digest::fromHexString("b5e9c1ad071b3e7fc779cfaa5e523818"));
+    CORRADE_COMPARE((XXHash3<16>{} << "hel" << std::string{"lo"}).digest(),
+        XXHash3<16>::Digest::fromHexString("b5e9c1ad071b3e7fc779cfaa5e523818"));
+}
+
+void XXHash3Test::literalConstexpr() {
+    constexpr XXHash3<8>::Digest empty = XXHash3<8>::digest("");
+    constexpr XXHash3<8>::Digest hello = XXHash3<8>::digest("hello");
+    constexpr XXHash3<8>::Digest helloSeeded = XXHash3<8>::digest("hello", 1);
+    /* 200 bytes, goes through the 129-240 byte code path */
+    constexpr XXHash3<8>::Digest mid = XXHash3<8>::digest(
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+    constexpr char first = hello.byteArray()[0];
+    CORRADE_COMPARE(first, '\x95');
+
+    CORRADE_COMPARE(empty, XXHash3<8>::Digest::fromHexString("2d06800538d394c2"));
+    CORRADE_COMPARE(hello, XXHash3<8>::Digest::fromHexString("9555e8555c62dcfd"));
+    CORRADE_COMPARE(helloSeeded, XXHash3<8>::Digest::fromHexString("74b07ed397a89e92"));
+    CORRADE_COMPARE(mid, XXHash3<8>::Digest::fromHexString("ac2bd404bce6c995"));
+}
+
+/* All benchmarks hash 1 MB of data in pieces of given size, so the measured
+   time is directly the time it takes to process a megabyte */
+
+void XXHash3Test::benchmarkXXHash3x64() {
+    const auto& data = BenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> bytes = Test::data(1024*1024);
+    std::size_t result = 0;
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t offset = 0; offset + data.size <= bytes.size(); offset += data.size)
+            result += static_cast<unsigned char>(XXHash3<8>::digest(bytes.slice(offset, offset + data.size)).byteArray()[0]);
+    }
+
+    CORRADE_VERIFY(result);
+}
+
+void XXHash3Test::benchmarkXXHash3x128() {
+    const auto& data = BenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> bytes = Test::data(1024*1024);
+    std::size_t result = 0;
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t offset = 0; offset + data.size <= bytes.size(); offset += data.size)
+            result += static_cast<unsigned char>(XXHash3<16>::digest(bytes.slice(offset, offset + data.size)).byteArray()[0]);
+    }
+
+    CORRADE_VERIFY(result);
+}
+
+void XXHash3Test::benchmarkMurmurHash2() {
+    const auto& data = BenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> bytes = Test::data(1024*1024);
+    std::size_t result = 0;
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t offset = 0; offset + data.size <= bytes.size(); offset += data.size)
+            result += static_cast<unsigned char>(MurmurHash2{}(bytes.data() + offset, data.size).byteArray()[0]);
+    }
+
+    CORRADE_VERIFY(result);
+}
+
+void XXHash3Test::benchmarkSha1() {
+    const auto& data = BenchmarkData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> bytes = Test::data(1024*1024);
+    std::size_t result = 0;
+    CORRADE_BENCHMARK(1) {
+        for(std::size_t offset = 0; offset + data.size <= bytes.size(); offset += data.size)
+            result += static_cast<unsigned char>(Sha1::digest(bytes.slice(offset, offset + data.size)).byteArray()[0]);
+    }
+
+    CORRADE_VERIFY(result);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Corrade::Utility::Test::XXHash3Test)
@@ -27,6 +27,7 @@
 
 #include <cstring>
 #include <set>
+#include <algorithm>
 #include <unordered_map>
 
 #include "Corrade/Utility/Assert.h"
@@ -43,7 +44,7 @@ namespace {
 
     struct File {
         std::string watchPath;
-        FileWatcher watcher;
+        std::size_t watchId;
         std::vector<Implementation::TweakableVariable> variables;
     };
 }
@@ -53,6 +54,7 @@ struct Tweakable::Data {
 
     std::string prefix, replace;
     std::unordered_map<std::string, File> files;
+    FileWatcherSet watchers;
 
     void(*currentScopeLambda)(void(*)(), void*) = nullptr;
     void(*currentScopeUserCall)() = nullptr;
@@ -116,7 +118,7 @@ std::pair<bool, void*> Tweakable::registerVariable(const char* const file, const
         const std::string watchPath = Directory::join(_data->replace, stripped);
 
         Debug{} << "Utility::Tweakable: watching for changes in" << watchPath;
-        found = _data->files.emplace(file, File{watchPath, FileWatcher{watchPath}, {}}).first;
+        found = _data->files.emplace(file, File{watchPath, _data->watchers.add(watchPath), {}}).first;
     }
 
     /* Extend the variable list to contain this one as well */
@@ -600,11 +602,16 @@ TweakableState Tweakable::update() {
        have a hash specialization. */
     std::set<std::tuple<void(*)(void(*)(), void*), void(*)(), void*>> scopes;
 
-    /* Go through all watchers and check for changes */
+    /* Check all watched files at once. The returned IDs are sorted, so
+       look up the files in them. There's usually nothing changed, so it's
+       not worth having a reverse mapping. */
+    const Containers::ArrayView<const std::size_t> changed = _data->watchers.changed();
+    if(changed.empty()) return TweakableState::NoChange;
+
     TweakableState state = TweakableState::NoChange;
     for(auto& file: _data->files) {
         /** @todo suggest recompile if the watcher is not valid anymore */
-        if(!file.second.watcher.hasChanged()) continue;
+        if(!std::binary_search(changed.begin(), changed.end(), file.second.watchId)) continue;
 
         /* First go through all defines and search if there is any alias. There
            shouldn't be many. If no alias is found, assume CORRADE_TWEAKABLE. */
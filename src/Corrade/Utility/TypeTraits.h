@@ -29,6 +29,7 @@
  * @brief Macros @ref CORRADE_HAS_TYPE(), alias @ref Corrade::Utility::IsIterable
  */
 
+#include <cstddef>
 #include <type_traits>
 
 namespace Corrade { namespace Utility {
@@ -66,6 +67,21 @@ namespace Implementation {
     CORRADE_HAS_TYPE(HasMemberEnd, decltype(std::declval<T>().end()));
     CORRADE_HAS_TYPE(HasBegin, decltype(begin(std::declval<T>())));
     CORRADE_HAS_TYPE(HasEnd, decltype(end(std::declval<T>())));
+
+    /* Used by operator<<(Debug&, std::tuple<>...) and compile-time parsed
+       format strings */
+    /** @todo C++14: use std::make_index_sequence and std::integer_sequence */
+    template<std::size_t ...> struct Sequence {};
+
+    #ifndef DOXYGEN_GENERATING_OUTPUT
+    /* E.g. GenerateSequence<3>::Type is Sequence<0, 1, 2> */
+    template<std::size_t N, std::size_t ...sequence> struct GenerateSequence:
+        GenerateSequence<N-1, N-1, sequence...> {};
+
+    template<std::size_t ...sequence> struct GenerateSequence<0, sequence...> {
+        typedef Sequence<sequence...> Type;
+    };
+    #endif
 }
 
 /**
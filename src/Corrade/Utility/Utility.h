@@ -44,14 +44,20 @@ template<std::size_t> class HashDigest;
 
 class Configuration;
 class ConfigurationGroup;
+class ConfigurationParser;
 enum class ConfigurationValueFlag: std::uint8_t;
 typedef Containers::EnumSet<ConfigurationValueFlag> ConfigurationValueFlags;
 template<class> struct ConfigurationValue;
 #if defined(DOXYGEN_GENERATING_OUTPUT) || defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)) || defined(CORRADE_TARGET_EMSCRIPTEN)
+class DirectoryWatcher;
 class FileWatcher;
+class FileWatcherSet;
 #endif
 
 class Debug;
+class DebugCategory;
+class DebugSink;
+class DebugTrace;
 class Warning;
 class Error;
 class Fatal;
@@ -62,6 +68,7 @@ class MurmurHash2;
 /* Resource doesn't need forward declaration */
 class Sha1;
 class Translator;
+template<std::size_t> class XXHash3;
 
 #if defined(DOXYGEN_GENERATING_OUTPUT) || defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT)) || defined(CORRADE_TARGET_EMSCRIPTEN)
 /* Tweakable doesn't need forward declaration */
@@ -0,0 +1,430 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "XXHash3.h"
+
+#include <algorithm>
+#include <cstring>
+
+/* SSE2 is always available on x86-64, on 32-bit x86 only if the compiler is
+   told so */
+#if defined(CORRADE_TARGET_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CORRADE_UTILITY_XXHASH3_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Corrade { namespace Utility { namespace Implementation {
+
+namespace {
+
+constexpr const unsigned long long InitialAccumulators[8]{
+    XXHash3Prime32_3, XXHash3Prime64_1, XXHash3Prime64_2, XXHash3Prime64_3,
+    XXHash3Prime64_4, XXHash3Prime32_2, XXHash3Prime64_5, XXHash3Prime32_1
+};
+
+/* Long inputs are processed in 64-byte stripes, each next stripe uses the
+   secret shifted by 8 bytes. After 16 stripes (a 1 kB block) the accumulators
+   get scrambled. */
+enum: std::size_t {
+    StripeSize = 64,
+    SecretConsumeRate = 8,
+    StripesPerBlock = (XXHash3SecretSize - StripeSize)/SecretConsumeRate,
+    BlockSize = StripeSize*StripesPerBlock,
+    BufferSize = 256,
+    ShortInputMax = 240,
+    SecretScrambleOffset = XXHash3SecretSize - StripeSize,
+    SecretLastStripeOffset = XXHash3SecretSize - StripeSize - 7,
+    SecretMergeOffset = 11
+};
+
+static_assert(StripesPerBlock == 16, "unexpected secret size");
+
+#ifdef CORRADE_UTILITY_XXHASH3_SSE2
+void accumulate(unsigned long long(&accumulators)[8], const char* data, const char* secret, std::size_t stripeCount) {
+    __m128i acc[4];
+    for(std::size_t i = 0; i != 4; ++i)
+        acc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulators) + i);
+
+    for(std::size_t s = 0; s != stripeCount; ++s) {
+        const __m128i* const stripe = reinterpret_cast<const __m128i*>(data + s*StripeSize);
+        const __m128i* const key = reinterpret_cast<const __m128i*>(secret + s*SecretConsumeRate);
+        for(std::size_t i = 0; i != 4; ++i) {
+            const __m128i value = _mm_loadu_si128(stripe + i);
+            const __m128i keyed = _mm_xor_si128(value, _mm_loadu_si128(key + i));
+            /* Low 32 bits of each lane multiplied with the high 32 bits */
+            const __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            /* The original value is added to the neighbor lane */
+            acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+    }
+
+    for(std::size_t i = 0; i != 4; ++i)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulators) + i, acc[i]);
+}
+
+void scramble(unsigned long long(&accumulators)[8], const char* secret) {
+    const __m128i prime = _mm_set1_epi32(int(XXHash3Prime32_1));
+    for(std::size_t i = 0; i != 4; ++i) {
+        __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulators) + i);
+        acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 47));
+        acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+        /* 64x32 multiplication done as two 32x32 ones */
+        const __m128i low = _mm_mul_epu32(acc, prime);
+        const __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(acc, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulators) + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+    }
+}
+#else
+void accumulate(unsigned long long(&accumulators)[8], const char* data, const char* secret, std::size_t stripeCount) {
+    for(std::size_t s = 0; s != stripeCount; ++s) {
+        const char* const stripe = data + s*StripeSize;
+        const char* const key = secret + s*SecretConsumeRate;
+        for(std::size_t i = 0; i != 8; ++i) {
+            const unsigned long long value = xxhash3Read64(stripe + 8*i);
+            const unsigned long long keyed = value ^ xxhash3Read64(key + 8*i);
+            accumulators[i ^ 1] += value;
+            accumulators[i] += (keyed & 0xffffffffull)*(keyed >> 32);
+        }
+    }
+}
+
+void scramble(unsigned long long(&accumulators)[8], const char* secret) {
+    for(std::size_t i = 0; i != 8; ++i) {
+        unsigned long long acc = xxhash3XorShift(accumulators[i], 47);
+        acc ^= xxhash3Read64(secret + 8*i);
+        accumulators[i] = acc*XXHash3Prime32_1;
+    }
+}
+#endif
+
+/* Processes given amount of stripes, scrambling the accumulators at block
+   boundaries. Returns pointer past the processed data. */
+const char* consumeStripes(unsigned long long(&accumulators)[8], std::size_t& stripesSoFar, const char* data, std::size_t stripeCount, const char* secret) {
+    const char* blockSecret = secret + stripesSoFar*SecretConsumeRate;
+    if(stripeCount >= StripesPerBlock - stripesSoFar) {
+        std::size_t stripesThisBlock = StripesPerBlock - stripesSoFar;
+        do {
+            accumulate(accumulators, data, blockSecret, stripesThisBlock);
+            scramble(accumulators, secret + SecretScrambleOffset);
+            data += stripesThisBlock*StripeSize;
+            stripeCount -= stripesThisBlock;
+            stripesThisBlock = StripesPerBlock;
+            blockSecret = secret;
+        } while(stripeCount >= StripesPerBlock);
+        stripesSoFar = 0;
+    }
+
+    if(stripeCount) {
+        accumulate(accumulators, data, blockSecret, stripeCount);
+        data += stripeCount*StripeSize;
+        stripesSoFar += stripeCount;
+    }
+
+    return data;
+}
+
+void accumulateLong(unsigned long long(&accumulators)[8], const char* const data, const std::size_t size, const char* const secret) {
+    std::copy(InitialAccumulators, InitialAccumulators + 8, accumulators);
+
+    const std::size_t blockCount = (size - 1)/BlockSize;
+    for(std::size_t i = 0; i != blockCount; ++i) {
+        accumulate(accumulators, data + i*BlockSize, secret, StripesPerBlock);
+        scramble(accumulators, secret + SecretScrambleOffset);
+    }
+
+    /* The last partial block and then the last stripe, which can overlap the
+       already processed data */
+    accumulate(accumulators, data + blockCount*BlockSize, secret, ((size - 1) - blockCount*BlockSize)/StripeSize);
+    accumulate(accumulators, data + size - StripeSize, secret + SecretLastStripeOffset, 1);
+}
+
+unsigned long long mergeAccumulators(const unsigned long long(&accumulators)[8], const char* const secret, const unsigned long long start) {
+    unsigned long long result = start;
+    for(std::size_t i = 0; i != 4; ++i)
+        result += xxhash3Mul128Fold64(
+            accumulators[2*i] ^ xxhash3Read64(secret + 16*i),
+            accumulators[2*i + 1] ^ xxhash3Read64(secret + 16*i + 8));
+    return xxhash3Avalanche(result);
+}
+
+void write64(char* const out, const unsigned long long value) {
+    for(std::size_t i = 0; i != 8; ++i) out[i] = char(value >> 8*i);
+}
+
+/* With a non-zero seed, long inputs use a secret derived from it */
+void initSecret(char(&out)[XXHash3SecretSize], const unsigned long long seed) {
+    for(std::size_t i = 0; i != XXHash3SecretSize/16; ++i) {
+        write64(out + 16*i, xxhash3Read64(XXHash3Secret + 16*i) + seed);
+        write64(out + 16*i + 8, xxhash3Read64(XXHash3Secret + 16*i + 8) - seed);
+    }
+}
+
+struct Hash128 {
+    unsigned long long low, high;
+};
+
+Hash128 mul64To128(const unsigned long long a, const unsigned long long b) {
+    #ifdef __SIZEOF_INT128__
+    const XXHash3UnsignedInt128 product = XXHash3UnsignedInt128(a)*b;
+    return {static_cast<unsigned long long>(product), static_cast<unsigned long long>(product >> 64)};
+    #else
+    const unsigned long long loLo = (a & 0xffffffffull)*(b & 0xffffffffull);
+    const unsigned long long hiLo = (a >> 32)*(b & 0xffffffffull);
+    const unsigned long long loHi = (a & 0xffffffffull)*(b >> 32);
+    const unsigned long long hiHi = (a >> 32)*(b >> 32);
+    const unsigned long long cross = (loLo >> 32) + (hiLo & 0xffffffffull) + loHi;
+    return {(cross << 32) | (loLo & 0xffffffffull), (hiLo >> 32) + (cross >> 32) + hiHi};
+    #endif
+}
+
+Hash128 size0x128(const unsigned long long seed) {
+    return {
+        xxhash3Avalanche64(seed ^ xxhash3Read64(XXHash3Secret + 64) ^ xxhash3Read64(XXHash3Secret + 72)),
+        xxhash3Avalanche64(seed ^ xxhash3Read64(XXHash3Secret + 80) ^ xxhash3Read64(XXHash3Secret + 88))
+    };
+}
+
+Hash128 size1To3x128(const char* const data, const std::size_t size, const unsigned long long seed) {
+    const unsigned int combinedLow =
+        xxhash3Byte(data[0]) << 16 |
+        xxhash3Byte(data[size >> 1]) << 24 |
+        xxhash3Byte(data[size - 1]) |
+        static_cast<unsigned int>(size) << 8;
+    const unsigned int swapped = xxhash3Swap32(combinedLow);
+    const unsigned int combinedHigh = (swapped << 13) | (swapped >> 19);
+    return {
+        xxhash3Avalanche64(combinedLow ^ (static_cast<unsigned long long>(xxhash3Read32(XXHash3Secret) ^ xxhash3Read32(XXHash3Secret + 4)) + seed)),
+        xxhash3Avalanche64(combinedHigh ^ (static_cast<unsigned long long>(xxhash3Read32(XXHash3Secret + 8) ^ xxhash3Read32(XXHash3Secret + 12)) - seed))
+    };
+}
+
+Hash128 size4To8x128(const char* const data, const std::size_t size, unsigned long long seed) {
+    seed ^= static_cast<unsigned long long>(xxhash3Swap32(static_cast<unsigned int>(seed))) << 32;
+    const unsigned long long value = xxhash3Read32(data) + (static_cast<unsigned long long>(xxhash3Read32(data + size - 4)) << 32);
+    const unsigned long long keyed = value ^ ((xxhash3Read64(XXHash3Secret + 16) ^ xxhash3Read64(XXHash3Secret + 24)) + seed);
+
+    Hash128 m = mul64To128(keyed, XXHash3Prime64_1 + (size << 2));
+    m.high += m.low << 1;
+    m.low ^= m.high >> 3;
+    m.low = xxhash3XorShift(m.low, 35)*XXHash3PrimeMx2;
+    m.low = xxhash3XorShift(m.low, 28);
+    m.high = xxhash3Avalanche(m.high);
+    return m;
+}
+
+Hash128 size9To16x128(const char* const data, const std::size_t size, const unsigned long long seed) {
+    const unsigned long long bitflipLow = (xxhash3Read64(XXHash3Secret + 32) ^ xxhash3Read64(XXHash3Secret + 40)) - seed;
+    const unsigned long long bitflipHigh = (xxhash3Read64(XXHash3Secret + 48) ^ xxhash3Read64(XXHash3Secret + 56)) + seed;
+    const unsigned long long low = xxhash3Read64(data);
+    unsigned long long high = xxhash3Read64(data + size - 8);
+
+    Hash128 m = mul64To128(low ^ high ^ bitflipLow, XXHash3Prime64_1);
+    m.low += static_cast<unsigned long long>(size - 1) << 54;
+    high ^= bitflipHigh;
+    m.high += high + (high & 0xffffffffull)*(XXHash3Prime32_2 - 1);
+    m.low ^= xxhash3Swap64(m.high);
+
+    Hash128 h = mul64To128(m.low, XXHash3Prime64_2);
+    h.high += m.high*XXHash3Prime64_2;
+    return {xxhash3Avalanche(h.low), xxhash3Avalanche(h.high)};
+}
+
+void mix32x128(Hash128& acc, const char* const a, const char* const b, const char* const secret, const unsigned long long seed) {
+    acc.low += xxhash3Mix16(a, secret, seed);
+    acc.low ^= xxhash3Read64(b) + xxhash3Read64(b + 8);
+    acc.high += xxhash3Mix16(b, secret + 16, seed);
+    acc.high ^= xxhash3Read64(a) + xxhash3Read64(a + 8);
+}
+
+Hash128 finalizeMidx128(const Hash128& acc, const std::size_t size, const unsigned long long seed) {
+    return {
+        xxhash3Avalanche(acc.low + acc.high),
+        0 - xxhash3Avalanche(acc.low*XXHash3Prime64_1 + acc.high*XXHash3Prime64_4 + (size - seed)*XXHash3Prime64_2)
+    };
+}
+
+Hash128 size17To128x128(const char* const data, const std::size_t size, const unsigned long long seed) {
+    Hash128 acc{size*XXHash3Prime64_1, 0};
+    for(std::size_t i = (size - 1)/32 + 1; i != 0; --i)
+        mix32x128(acc, data + 16*(i - 1), data + size - 16*i, XXHash3Secret + 32*(i - 1), seed);
+    return finalizeMidx128(acc, size, seed);
+}
+
+Hash128 size129To240x128(const char* const data, const std::size_t size, const unsigned long long seed) {
+    Hash128 acc{size*XXHash3Prime64_1, 0};
+    for(std::size_t i = 0; i != 4; ++i)
+        mix32x128(acc, data + 32*i, data + 32*i + 16, XXHash3Secret + 32*i, seed);
+    acc.low = xxhash3Avalanche(acc.low);
+    acc.high = xxhash3Avalanche(acc.high);
+    for(std::size_t i = 4, end = size/32; i < end; ++i)
+        mix32x128(acc, data + 32*i, data + 32*i + 16, XXHash3Secret + 3 + 32*(i - 4), seed);
+    mix32x128(acc, data + size - 16, data + size - 32, XXHash3Secret + 136 - 17 - 16, 0 - seed);
+    return finalizeMidx128(acc, size, seed);
+}
+
+Hash128 mergeAccumulatorsx128(const unsigned long long(&accumulators)[8], const char* const secret, const std::size_t size) {
+    return {
+        mergeAccumulators(accumulators, secret + SecretMergeOffset, size*XXHash3Prime64_1),
+        mergeAccumulators(accumulators, secret + XXHash3SecretSize - sizeof(accumulators) - SecretMergeOffset, ~(size*XXHash3Prime64_2))
+    };
+}
+
+Hash128 shortx128(const char* const data, const std::size_t size, const unsigned long long seed) {
+    if(size <= 16) {
+        if(size > 8) return size9To16x128(data, size, seed);
+        if(size >= 4) return size4To8x128(data, size, seed);
+        if(size) return size1To3x128(data, size, seed);
+        return size0x128(seed);
+    }
+    if(size <= 128) return size17To128x128(data, size, seed);
+    return size129To240x128(data, size, seed);
+}
+
+}
+
+unsigned long long xxhash3Long64(const char* const data, const std::size_t size, const unsigned long long seed) {
+    char customSecret[XXHash3SecretSize];
+    const char* secret = XXHash3Secret;
+    if(seed) {
+        initSecret(customSecret, seed);
+        secret = customSecret;
+    }
+
+    unsigned long long accumulators[8];
+    accumulateLong(accumulators, data, size, secret);
+    return mergeAccumulators(accumulators, secret + SecretMergeOffset, size*XXHash3Prime64_1);
+}
+
+void xxhash3x128(const char* const data, const std::size_t size, const unsigned long long seed, unsigned long long(&out)[2]) {
+    Hash128 hash;
+    if(size <= ShortInputMax) hash = shortx128(data, size, seed);
+    else {
+        char customSecret[XXHash3SecretSize];
+        const char* secret = XXHash3Secret;
+        if(seed) {
+            initSecret(customSecret, seed);
+            secret = customSecret;
+        }
+
+        unsigned long long accumulators[8];
+        accumulateLong(accumulators, data, size, secret);
+        hash = mergeAccumulatorsx128(accumulators, secret, size);
+    }
+
+    out[0] = hash.high;
+    out[1] = hash.low;
+}
+
+XXHash3State::XXHash3State(const unsigned long long seed): _seed{seed} {
+    if(seed) initSecret(_secret, seed);
+    else std::memcpy(_secret, XXHash3Secret, XXHash3SecretSize);
+    reset();
+}
+
+void XXHash3State::reset() {
+    std::copy(InitialAccumulators, InitialAccumulators + 8, _accumulators);
+    _dataSize = 0;
+    _bufferSize = 0;
+    _stripeCount = 0;
+}
+
+void XXHash3State::add(const Containers::ArrayView<const char> data) {
+    if(data.empty()) return;
+
+    const char* in = data.data();
+    const char* const end = in + data.size();
+    _dataSize += data.size();
+
+    /* Not enough data to fill the buffer, just copy it */
+    if(data.size() <= BufferSize - _bufferSize) {
+        std::memcpy(_buffer + _bufferSize, in, data.size());
+        _bufferSize += data.size();
+        return;
+    }
+
+    /* Fill the rest of the buffer and process it */
+    if(_bufferSize) {
+        const std::size_t fill = BufferSize - _bufferSize;
+        std::memcpy(_buffer + _bufferSize, in, fill);
+        in += fill;
+        consumeStripes(_accumulators, _stripeCount, _buffer, BufferSize/StripeSize, _secret);
+        _bufferSize = 0;
+    }
+
+    /* Process stripes directly from the input, always keeping at least one
+       byte for the buffer. The last processed stripe is copied to the end of
+       the buffer as the final stripe may need to overlap it. */
+    if(std::size_t(end - in) > BufferSize) {
+        in = consumeStripes(_accumulators, _stripeCount, in, (end - in - 1)/StripeSize, _secret);
+        std::memcpy(_buffer + BufferSize - StripeSize, in - StripeSize, StripeSize);
+    }
+
+    std::memcpy(_buffer, in, end - in);
+    _bufferSize = end - in;
+}
+
+void XXHash3State::digestLong(unsigned long long(&accumulators)[8]) const {
+    std::copy(_accumulators, _accumulators + 8, accumulators);
+
+    /* Process the remaining full stripes on a copy, so the state stays
+       untouched. If there's less than a stripe in the buffer, take the rest
+       from the end of the previously processed data. */
+    char lastStripe[StripeSize];
+    const char* lastStripeData;
+    if(_bufferSize >= StripeSize) {
+        std::size_t stripeCount = _stripeCount;
+        consumeStripes(accumulators, stripeCount, _buffer, (_bufferSize - 1)/StripeSize, _secret);
+        lastStripeData = _buffer + _bufferSize - StripeSize;
+    } else {
+        const std::size_t catchup = StripeSize - _bufferSize;
+        std::memcpy(lastStripe, _buffer + BufferSize - catchup, catchup);
+        std::memcpy(lastStripe + catchup, _buffer, _bufferSize);
+        lastStripeData = lastStripe;
+    }
+
+    accumulate(accumulators, lastStripeData, _secret + SecretLastStripeOffset, 1);
+}
+
+unsigned long long XXHash3State::digest64() const {
+    if(_dataSize <= ShortInputMax)
+        return xxhash3x64(_buffer, _dataSize, _seed);
+
+    unsigned long long accumulators[8];
+    digestLong(accumulators);
+    return mergeAccumulators(accumulators, _secret + SecretMergeOffset, _dataSize*XXHash3Prime64_1);
+}
+
+void XXHash3State::digest128(unsigned long long(&out)[2]) const {
+    if(_dataSize <= ShortInputMax)
+        return xxhash3x128(_buffer, _dataSize, _seed, out);
+
+    unsigned long long accumulators[8];
+    digestLong(accumulators);
+    const Hash128 hash = mergeAccumulatorsx128(accumulators, _secret, _dataSize);
+    out[0] = hash.high;
+    out[1] = hash.low;
+}
+
+}}}
@@ -0,0 +1,395 @@
+#ifndef Corrade_Utility_XXHash3_h
+#define Corrade_Utility_XXHash3_h
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Corrade::Utility::XXHash3
+ */
+
+#include <cstddef>
+#include <string>
+
+#include "Corrade/Containers/ArrayView.h"
+#include "Corrade/Utility/AbstractHash.h"
+#include "Corrade/Utility/visibility.h"
+
+namespace Corrade { namespace Utility {
+
+namespace Implementation {
+    /* Default secret of the algorithm */
+    constexpr char XXHash3Secret[] =
+        "\xb8\xfe\x6c\x39\x23\xa4\x4b\xbe\x7c\x01\x81\x2c\xf7\x21\xad\x1c"
+        "\xde\xd4\x6d\xe9\x83\x90\x97\xdb\x72\x40\xa4\xa4\xb7\xb3\x67\x1f"
+        "\xcb\x79\xe6\x4e\xcc\xc0\xe5\x78\x82\x5a\xd0\x7d\xcc\xff\x72\x21"
+        "\xb8\x08\x46\x74\xf7\x43\x24\x8e\xe0\x35\x90\xe6\x81\x3a\x26\x4c"
+        "\x3c\x28\x52\xbb\x91\xc3\x00\xcb\x88\xd0\x65\x8b\x1b\x53\x2e\xa3"
+        "\x71\x64\x48\x97\xa2\x0d\xf9\x4e\x38\x19\xef\x46\xa9\xde\xac\xd8"
+        "\xa8\xfa\x76\x3f\xe3\x9c\x34\x3f\xf9\xdc\xbb\xc7\xc7\x0b\x4f\x1d"
+        "\x8a\x51\xe0\x4b\xcd\xb4\x59\x31\xc8\x9f\x7e\xc9\xd9\x78\x73\x64"
+        "\xea\xc5\xac\x83\x34\xd3\xeb\xc3\xc5\x81\xa0\xff\xfa\x13\x63\xeb"
+        "\x17\x0d\xdd\x51\xb7\xf0\xda\x49\xd3\x16\x55\x26\x29\xd4\x68\x9e"
+        "\x2b\x16\xbe\x58\x7d\x47\xa1\xfc\x8f\xf8\xb8\xd1\x7a\xd0\x31\xce"
+        "\x45\xcb\x3a\x8f\x95\x16\x04\x28\xaf\xd7\xfb\xca\xbb\x4b\x40\x7e";
+    enum: std::size_t { XXHash3SecretSize = sizeof(XXHash3Secret) - 1 };
+
+    enum: unsigned long long {
+        XXHash3Prime32_1 = 0x9e3779b1ull,
+        XXHash3Prime32_2 = 0x85ebca77ull,
+        XXHash3Prime32_3 = 0xc2b2ae3dull,
+        XXHash3Prime64_1 = 0x9e3779b185ebca87ull,
+        XXHash3Prime64_2 = 0xc2b2ae3d27d4eb4full,
+        XXHash3Prime64_3 = 0x165667b19e3779f9ull,
+        XXHash3Prime64_4 = 0x85ebca77c2b2ae63ull,
+        XXHash3Prime64_5 = 0x27d4eb2f165667c5ull,
+        XXHash3PrimeMx1 = 0x165667919e3779f9ull,
+        XXHash3PrimeMx2 = 0x9fb21c651e98df25ull
+    };
+
+    /* The short-input code paths (up to 240 bytes) are written as C++11
+       constexpr functions so digests of string literals can be calculated
+       at compile time. The runtime implementation in XXHash3.cpp reuses
+       them, byte-wise little-endian reads get recognized as plain loads by
+       the optimizer. */
+    constexpr unsigned int xxhash3Byte(char data) {
+        return static_cast<unsigned char>(data);
+    }
+
+    constexpr unsigned int xxhash3Read32(const char* data) {
+        return xxhash3Byte(data[0]) |
+               xxhash3Byte(data[1]) << 8 |
+               xxhash3Byte(data[2]) << 16 |
+               xxhash3Byte(data[3]) << 24;
+    }
+
+    constexpr unsigned long long xxhash3Read64(const char* data) {
+        return xxhash3Read32(data) | static_cast<unsigned long long>(xxhash3Read32(data + 4)) << 32;
+    }
+
+    constexpr unsigned int xxhash3Swap32(unsigned int value) {
+        return (value << 24) | ((value << 8) & 0x00ff0000u) |
+               ((value >> 8) & 0x0000ff00u) | (value >> 24);
+    }
+
+    constexpr unsigned long long xxhash3Swap64(unsigned long long value) {
+        return static_cast<unsigned long long>(xxhash3Swap32(static_cast<unsigned int>(value))) << 32 | xxhash3Swap32(static_cast<unsigned int>(value >> 32));
+    }
+
+    constexpr unsigned long long xxhash3Rotl64(unsigned long long value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    constexpr unsigned long long xxhash3XorShift(unsigned long long value, int shift) {
+        return value ^ (value >> shift);
+    }
+
+    /* 64x64 -> 128 multiplication, with the high and low half of the result
+       XORed together. Where the compiler has a 128-bit integer type it's a
+       single instruction (and still constexpr), otherwise it's done from four
+       32x32 -> 64 partial products. */
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 XXHash3UnsignedInt128;
+
+    constexpr unsigned long long xxhash3Fold64(XXHash3UnsignedInt128 product) {
+        return static_cast<unsigned long long>(product) ^ static_cast<unsigned long long>(product >> 64);
+    }
+    constexpr unsigned long long xxhash3Mul128Fold64(unsigned long long a, unsigned long long b) {
+        return xxhash3Fold64(XXHash3UnsignedInt128(a)*b);
+    }
+#else
+    constexpr unsigned long long xxhash3Mul128Fold64Cross(unsigned long long loLo, unsigned long long hiLo, unsigned long long hiHi, unsigned long long cross) {
+        return ((hiLo >> 32) + (cross >> 32) + hiHi) ^ ((cross << 32) | (loLo & 0xffffffffull));
+    }
+    constexpr unsigned long long xxhash3Mul128Fold64Partial(unsigned long long loLo, unsigned long long hiLo, unsigned long long loHi, unsigned long long hiHi) {
+        return xxhash3Mul128Fold64Cross(loLo, hiLo, hiHi, (loLo >> 32) + (hiLo & 0xffffffffull) + loHi);
+    }
+    constexpr unsigned long long xxhash3Mul128Fold64(unsigned long long a, unsigned long long b) {
+        return xxhash3Mul128Fold64Partial(
+            (a & 0xffffffffull)*(b & 0xffffffffull),
+            (a >> 32)*(b & 0xffffffffull),
+            (a & 0xffffffffull)*(b >> 32),
+            (a >> 32)*(b >> 32));
+    }
+#endif
+
+    constexpr unsigned long long xxhash3Avalanche(unsigned long long h) {
+        return xxhash3XorShift(xxhash3XorShift(h, 37)*XXHash3PrimeMx1, 32);
+    }
+
+    constexpr unsigned long long xxhash3Avalanche64(unsigned long long h) {
+        return xxhash3XorShift(xxhash3XorShift(xxhash3XorShift(h, 33)*XXHash3Prime64_2, 29)*XXHash3Prime64_3, 32);
+    }
+
+    constexpr unsigned long long xxhash3RrmxmxMultiplied(unsigned long long h, std::size_t size) {
+        return xxhash3XorShift((h ^ ((h >> 35) + size))*XXHash3PrimeMx2, 28);
+    }
+    constexpr unsigned long long xxhash3Rrmxmx(unsigned long long h, std::size_t size) {
+        return xxhash3RrmxmxMultiplied((h ^ xxhash3Rotl64(h, 49) ^ xxhash3Rotl64(h, 24))*XXHash3PrimeMx2, size);
+    }
+
+    constexpr unsigned long long xxhash3Mix16(const char* data, const char* secret, unsigned long long seed) {
+        return xxhash3Mul128Fold64(
+            xxhash3Read64(data) ^ (xxhash3Read64(secret) + seed),
+            xxhash3Read64(data + 8) ^ (xxhash3Read64(secret + 8) - seed));
+    }
+
+    constexpr unsigned long long xxhash3Size0(unsigned long long seed) {
+        return xxhash3Avalanche64(seed ^ xxhash3Read64(XXHash3Secret + 56) ^ xxhash3Read64(XXHash3Secret + 64));
+    }
+
+    constexpr unsigned long long xxhash3Size1To3(const char* data, std::size_t size, unsigned long long seed) {
+        return xxhash3Avalanche64(static_cast<unsigned long long>(
+            xxhash3Byte(data[0]) << 16 |
+            xxhash3Byte(data[size >> 1]) << 24 |
+            xxhash3Byte(data[size - 1]) |
+            static_cast<unsigned int>(size) << 8) ^
+            (static_cast<unsigned long long>(xxhash3Read32(XXHash3Secret) ^ xxhash3Read32(XXHash3Secret + 4)) + seed));
+    }
+
+    constexpr unsigned long long xxhash3Size4To8Seeded(const char* data, std::size_t size, unsigned long long seed) {
+        return xxhash3Rrmxmx(
+            (static_cast<unsigned long long>(xxhash3Read32(data + size - 4)) + (static_cast<unsigned long long>(xxhash3Read32(data)) << 32)) ^
+            ((xxhash3Read64(XXHash3Secret + 8) ^ xxhash3Read64(XXHash3Secret + 16)) - seed), size);
+    }
+    constexpr unsigned long long xxhash3Size4To8(const char* data, std::size_t size, unsigned long long seed) {
+        return xxhash3Size4To8Seeded(data, size, seed ^ (static_cast<unsigned long long>(xxhash3Swap32(static_cast<unsigned int>(seed))) << 32));
+    }
+
+    constexpr unsigned long long xxhash3Size9To16Keyed(unsigned long long low, unsigned long long high, std::size_t size) {
+        return xxhash3Avalanche(size + xxhash3Swap64(low) + high + xxhash3Mul128Fold64(low, high));
+    }
+    constexpr unsigned long long xxhash3Size9To16(const char* data, std::size_t size, unsigned long long seed) {
+        return xxhash3Size9To16Keyed(
+            xxhash3Read64(data) ^ ((xxhash3Read64(XXHash3Secret + 24) ^ xxhash3Read64(XXHash3Secret + 32)) + seed),
+            xxhash3Read64(data + size - 8) ^ ((xxhash3Read64(XXHash3Secret + 40) ^ xxhash3Read64(XXHash3Secret + 48)) - seed), size);
+    }
+
+    constexpr unsigned long long xxhash3Size17To128Rounds(const char* data, std::size_t size, unsigned long long seed, std::size_t i) {
+        return xxhash3Mix16(data + 16*i, XXHash3Secret + 32*i, seed) +
+               xxhash3Mix16(data + size - 16*(i + 1), XXHash3Secret + 32*i + 16, seed) +
+               (i ? xxhash3Size17To128Rounds(data, size, seed, i - 1) : 0);
+    }
+    constexpr unsigned long long xxhash3Size17To128(const char* data, std::size_t size, unsigned long long seed) {
+        return xxhash3Avalanche(size*XXHash3Prime64_1 + xxhash3Size17To128Rounds(data, size, seed, (size - 1)/32));
+    }
+
+    constexpr unsigned long long xxhash3Size129To240FirstRounds(const char* data, unsigned long long seed, std::size_t i) {
+        return xxhash3Mix16(data + 16*i, XXHash3Secret + 16*i, seed) +
+               (i ? xxhash3Size129To240FirstRounds(data, seed, i - 1) : 0);
+    }
+    constexpr unsigned long long xxhash3Size129To240NextRounds(const char* data, unsigned long long seed, std::size_t i, std::size_t end) {
+        return i < end ? xxhash3Mix16(data + 16*i, XXHash3Secret + 16*(i - 8) + 3, seed) +
+               xxhash3Size129To240NextRounds(data, seed, i + 1, end) : 0;
+    }
+    constexpr unsigned long long xxhash3Size129To240(const char* data, std::size_t size, unsigned long long seed) {
+        return xxhash3Avalanche(
+            xxhash3Avalanche(size*XXHash3Prime64_1 + xxhash3Size129To240FirstRounds(data, seed, 7)) +
+            xxhash3Size129To240NextRounds(data, seed, 8, size/16) +
+            xxhash3Mix16(data + size - 16, XXHash3Secret + 136 - 17, seed));
+    }
+
+    /* Inputs longer than 240 bytes, never constexpr */
+    CORRADE_UTILITY_EXPORT unsigned long long xxhash3Long64(const char* data, std::size_t size, unsigned long long seed);
+
+    constexpr unsigned long long xxhash3x64(const char* data, std::size_t size, unsigned long long seed) {
+        return size <= 16 ?
+            (size > 8 ? xxhash3Size9To16(data, size, seed) :
+             size >= 4 ? xxhash3Size4To8(data, size, seed) :
+             size ? xxhash3Size1To3(data, size, seed) :
+             xxhash3Size0(seed)) :
+            size <= 128 ? xxhash3Size17To128(data, size, seed) :
+            size <= 240 ? xxhash3Size129To240(data, size, seed) :
+            xxhash3Long64(data, size, seed);
+    }
+
+    /* The 128-bit variant is runtime-only. Result is high and low half. */
+    CORRADE_UTILITY_EXPORT void xxhash3x128(const char* data, std::size_t size, unsigned long long seed, unsigned long long(&out)[2]);
+
+    /* Streaming state shared by both digest sizes */
+    class CORRADE_UTILITY_EXPORT XXHash3State {
+        public:
+            explicit XXHash3State(unsigned long long seed);
+
+            void reset();
+            void add(Containers::ArrayView<const char> data);
+            unsigned long long digest64() const;
+            void digest128(unsigned long long(&out)[2]) const;
+
+        private:
+            CORRADE_UTILITY_LOCAL void digestLong(unsigned long long(&accumulators)[8]) const;
+
+            unsigned long long _accumulators[8];
+            char _secret[XXHash3SecretSize];
+            char _buffer[256];
+            unsigned long long _seed;
+            unsigned long long _dataSize;
+            std::size_t _bufferSize;
+            std::size_t _stripeCount;
+    };
+
+    template<std::size_t> struct XXHash3Digest;
+    template<> struct XXHash3Digest<8> {
+        static constexpr HashDigest<8> fromHash(unsigned long long hash) {
+            return HashDigest<8>{hash >> 56, hash >> 48, hash >> 40, hash >> 32,
+                                 hash >> 24, hash >> 16, hash >> 8, hash};
+        }
+
+        static constexpr HashDigest<8> digest(const char* data, std::size_t size, unsigned long long seed) {
+            return fromHash(xxhash3x64(data, size, seed));
+        }
+
+        static HashDigest<8> digest(const XXHash3State& state) {
+            return fromHash(state.digest64());
+        }
+    };
+    template<> struct XXHash3Digest<16> {
+        static HashDigest<16> fromHash(const unsigned long long(&hash)[2]) {
+            return HashDigest<16>{
+                hash[0] >> 56, hash[0] >> 48, hash[0] >> 40, hash[0] >> 32,
+                hash[0] >> 24, hash[0] >> 16, hash[0] >> 8, hash[0],
+                hash[1] >> 56, hash[1] >> 48, hash[1] >> 40, hash[1] >> 32,
+                hash[1] >> 24, hash[1] >> 16, hash[1] >> 8, hash[1]};
+        }
+
+        static HashDigest<16> digest(const char* data, std::size_t size, unsigned long long seed) {
+            unsigned long long hash[2];
+            xxhash3x128(data, size, seed, hash);
+            return fromHash(hash);
+        }
+
+        static HashDigest<16> digest(const XXHash3State& state) {
+            unsigned long long hash[2];
+            state.digest128(hash);
+            return fromHash(hash);
+        }
+    };
+}
+
+/**
+@brief XXH3 hash
+
+Fast non-cryptographic hash, implementing the XXH3 algorithm by Yann Collet,
+https://github.com/Cyan4973/xxHash. The @p digestSize can be either @cpp 8 @ce
+for the 64-bit variant or @cpp 16 @ce for the 128-bit variant. The digest
+bytes are in the canonical big-endian order, so @ref HashDigest::hexString()
+gives the same result as the `xxhsum` utility.
+
+Compared to @ref MurmurHash2 the hash processes long inputs several times
+faster, using SSE2 on x86 and an eight-lane scalar loop elsewhere, and
+provides a streaming interface. It's however not a cryptographic hash and
+thus not a replacement for @ref Sha1 in situations where collisions could be
+maliciously crafted. It's well suited for content-based deduplication or hash
+table keys.
+
+The 64-bit digest of string literals up to 240 bytes long can be calculated
+at compile time:
+
+@code{.cpp}
+constexpr Utility::XXHash3<8>::Digest digest = Utility::XXHash3<8>::digest("hello");
+@endcode
+*/
+template<std::size_t digestSize> class XXHash3: public AbstractHash<digestSize> {
+    static_assert(digestSize == 8 || digestSize == 16, "Utility::XXHash3: only 64- and 128-bit digests are supported");
+
+    public:
+        /** @brief Hash digest */
+        typedef typename AbstractHash<digestSize>::Digest Digest;
+
+        /**
+         * @brief Digest of given data
+         *
+         * Equivalent to @cpp (Utility::XXHash3<digestSize>{seed} << data).digest() @ce,
+         * but without going through the intermediate buffer.
+         */
+        static Digest digest(Containers::ArrayView<const char> data, unsigned long long seed = 0) {
+            return Implementation::XXHash3Digest<digestSize>::digest(data.data(), data.size(), seed);
+        }
+
+        /** @overload */
+        static Digest digest(const std::string& data, unsigned long long seed = 0) {
+            return Implementation::XXHash3Digest<digestSize>::digest(data.data(), data.size(), seed);
+        }
+
+        /**
+         * @overload
+         *
+         * The trailing null terminator is not included in the digest. For the
+         * 64-bit variant and literals up to 240 bytes the function is
+         * @cpp constexpr @ce.
+         */
+        template<std::size_t size> constexpr static Digest digest(const char(&data)[size], unsigned long long seed = 0) {
+            return Implementation::XXHash3Digest<digestSize>::digest(data, size - 1, seed);
+        }
+
+        /**
+         * @brief Constructor
+         * @param seed      Seed to initialize the hash
+         */
+        explicit XXHash3(unsigned long long seed = 0): _state{seed} {}
+
+        /**
+         * @brief Add data for digesting
+         *
+         * The data are processed directly from the view in 64-byte stripes,
+         * only the trailing part is copied to an internal fixed-size buffer.
+         * Adding data doesn't allocate.
+         */
+        XXHash3<digestSize>& operator<<(Containers::ArrayView<const char> data) {
+            _state.add(data);
+            return *this;
+        }
+
+        /** @overload */
+        XXHash3<digestSize>& operator<<(const std::string& data) {
+            return operator<<(Containers::ArrayView<const char>{data.data(), data.size()});
+        }
+
+        /**
+         * @overload
+         *
+         * The trailing null terminator is not included in the digest.
+         */
+        template<std::size_t size> XXHash3<digestSize>& operator<<(const char(&data)[size]) {
+            return operator<<(Containers::ArrayView<const char>{data, size - 1});
+        }
+
+        /**
+         * @brief Digest of all added data
+         *
+         * Resets the state afterwards, keeping the seed.
+         */
+        Digest digest() {
+            const Digest d = Implementation::XXHash3Digest<digestSize>::digest(_state);
+            _state.reset();
+            return d;
+        }
+
+    private:
+        Implementation::XXHash3State _state;
+};
+
+}}
+
+#endif
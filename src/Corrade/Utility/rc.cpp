@@ -23,7 +23,11 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Corrade/Utility/Arguments.h"
 #include "Corrade/Utility/Debug.h"
@@ -57,25 +61,62 @@ for more information.
 @section corrade-rc-usage Usage
 
 @code{.sh}
-corrade-rc [-h|--help] [--] name resources.conf outfile.cpp
+corrade-rc [-h|--help] [--binary] [--string-literals] [-j|--jobs N] [--]
+    name resources.conf outfile.cpp
 @endcode
 
 Arguments:
 
+-   `name` --- resource name (see @ref CORRADE_RESOURCE_INITIALIZE()), unused
+    with `--binary`
 -   `resources.conf` --- resource configuration file (see @ref Utility::Resource
     for format description)
 -   `outfile.cpp` --- output file
 -   `-h`, `--help` --- display this help message and exit
+-   `--binary` --- produce a binary resource pack instead of a C++ file, see
+    @ref Utility-Resource-pack for more information
+-   `--string-literals` --- emit the data as C string literals instead of
+    hexadecimal values, see @ref Utility::Resource::CompileFlag::StringLiterals
+    for more information
+-   `-j`, `--jobs N` --- count of threads used for reading, compressing and
+    encoding the files, @cpp 0 @ce means all hardware threads. The output is
+    the same regardless of the thread count. Default is @cpp 1 @ce.
 */
 
 }
 
 #ifndef DOXYGEN_GENERATING_OUTPUT /* LCOV_EXCL_START */
+namespace {
+
+/* Set from the --jobs option, zero means all hardware threads */
+unsigned int threadCount;
+
+/* Calls function(state, i) for all i in [0, count) on threadCount threads,
+   including the calling one */
+void parallelFor(const std::size_t count, void(*const function)(void*, std::size_t), void* const state) {
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        for(std::size_t i; (i = next++) < count; ) function(state, i);
+    };
+
+    const std::size_t actualThreadCount = std::min<std::size_t>(threadCount ? threadCount : std::max(std::thread::hardware_concurrency(), 1u), count);
+    std::vector<std::thread> threads;
+    for(std::size_t i = 1; i < actualThreadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread& thread: threads) thread.join();
+}
+
+}
+
 int main(int argc, char** argv) {
     Corrade::Utility::Arguments args;
     args.addArgument("name")
         .addArgument("conf").setHelp("conf", "resource configuration file", "resources.conf")
         .addArgument("out").setHelp("out", "output file", "outfile.cpp")
+        .addBooleanOption("binary").setHelp("binary", "produce a binary resource pack instead of a C++ file")
+        .addBooleanOption("string-literals").setHelp("string-literals", "emit the data as C string literals instead of hexadecimal values")
+        .addOption('j', "jobs", "1").setHelp("jobs", "count of threads used for processing the files, 0 means all hardware threads", "N")
         .setCommand("corrade-rc")
         .setHelp("Resource compiler for Corrade.")
         .parse(argc, argv);
@@ -84,7 +125,13 @@ int main(int argc, char** argv) {
     Corrade::Utility::Directory::rm(args.value("out"));
 
     /* Compile file */
-    const std::string compiled = Corrade::Utility::Resource::compileFrom(args.value("name"), args.value("conf"));
+    threadCount = args.value<unsigned int>("jobs");
+    const Corrade::Utility::Resource::ParallelFor executor = threadCount == 1 ? nullptr : parallelFor;
+    const std::string compiled = args.isSet("binary") ?
+        Corrade::Utility::Resource::compileBinaryFrom(args.value("conf"), executor) :
+        Corrade::Utility::Resource::compileFrom(args.value("name"), args.value("conf"),
+            args.isSet("string-literals") ? Corrade::Utility::Resource::CompileFlag::StringLiterals : Corrade::Utility::Resource::CompileFlags{},
+            executor);
 
     /* Compilation failed */
     if(compiled.empty()) return 2;
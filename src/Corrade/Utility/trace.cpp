@@ -0,0 +1,95 @@
+/*
+    This file is part of Corrade.
+
+    Copyright © 2007, 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016,
+                2017, 2018, 2019 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Corrade/Containers/Array.h"
+#include "Corrade/Utility/Arguments.h"
+#include "Corrade/Utility/Debug.h"
+#include "Corrade/Utility/DebugTrace.h"
+#include "Corrade/Utility/Directory.h"
+
+namespace Corrade {
+
+/** @page corrade-trace Debug trace decoder
+@brief Utility for converting binary debug traces to text.
+
+Decodes a binary trace recorded with @ref Utility::DebugTrace and writes the
+resulting text to standard output or to a file. The text is the same as the
+@ref Utility::Debug output would be when writing to a stream directly.
+
+This utility is built if both `WITH_UTILITY` and `WITH_RC` are enabled when
+building Corrade. To use it from CMake, request the `trace` component of the
+`Corrade` package and use the `Corrade::trace` target.
+
+@section corrade-trace-usage Usage
+
+@code{.sh}
+corrade-trace [-h|--help] [-o|--output outfile.txt] [--] trace.bin
+@endcode
+
+Arguments:
+
+-   `trace.bin` --- trace file produced by @ref Utility::DebugTrace
+-   `-h`, `--help` --- display this help message and exit
+-   `-o`, `--output outfile.txt` --- write the text to given file instead of
+    standard output
+*/
+
+}
+
+#ifndef DOXYGEN_GENERATING_OUTPUT /* LCOV_EXCL_START */
+int main(int argc, char** argv) {
+    Corrade::Utility::Arguments args;
+    args.addArgument("trace").setHelp("trace", "trace file", "trace.bin")
+        .addOption('o', "output").setHelp("output", "write the text to given file instead of standard output", "outfile.txt")
+        .setCommand("corrade-trace")
+        .setHelp("Debug trace decoder for Corrade.")
+        .parse(argc, argv);
+
+    if(!Corrade::Utility::Directory::exists(args.value("trace"))) {
+        Corrade::Utility::Error() << "Cannot open input file" << '\'' + args.value("trace") + '\'';
+        return 1;
+    }
+
+    const Corrade::Containers::Array<char> data = Corrade::Utility::Directory::read(args.value("trace"));
+
+    /* Write to standard output */
+    if(args.value("output").empty())
+        return Corrade::Utility::DebugTrace::decode(data, std::cout) ? 0 : 2;
+
+    /* Write to a file */
+    std::ofstream out{args.value("output"), std::ofstream::binary};
+    if(!out) {
+        Corrade::Utility::Error() << "Cannot open output file" << '\'' + args.value("output") + '\'';
+        return 3;
+    }
+
+    return Corrade::Utility::DebugTrace::decode(data, out) ? 0 : 2;
+}
+#endif /* LCOV_EXCL_STOP */
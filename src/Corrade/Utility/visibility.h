@@ -39,9 +39,21 @@
     #define CORRADE_UTILITY_EXPORT CORRADE_VISIBILITY_STATIC
 #endif
 #define CORRADE_UTILITY_LOCAL CORRADE_VISIBILITY_LOCAL
+
+/* DebugSink is in a separate library */
+#ifndef CORRADE_BUILD_STATIC
+    #ifdef CorradeDebugSink_EXPORTS
+        #define CORRADE_DEBUGSINK_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define CORRADE_DEBUGSINK_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define CORRADE_DEBUGSINK_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
 #else
 #define CORRADE_UTILITY_EXPORT
 #define CORRADE_UTILITY_LOCAL
+#define CORRADE_DEBUGSINK_EXPORT
 #endif
 
 #endif